@@ -51,7 +51,7 @@ const T& min(const T& lhs, const T& rhs)
 template <class T, class Compare>
 const T& min(const T& lhs, const T& rhs, Compare compare)
 {
-    return compare(lhs, rhs) ? rhs : lhs;
+    return compare(rhs, lhs) ? rhs : lhs;
 }
 
 /*****************************************************************************************/
@@ -120,12 +120,10 @@ unchecked_copy(Tp* first, Tp* last, Up* result)
     return result + n;
 }
 
+// copy 的定义在 move_backward 之后：先按分段迭代器拆分区间，再调用 unchecked_copy
 template <class InputIter, class OutputIter>
 OutputIter
-copy(InputIter first, InputIter last, OutputIter result)
-{
-    return unchecked_copy(first, last, result);
-}
+copy(InputIter first, InputIter last, OutputIter result);
 
 /*****************************************************************************************/
 // copy_backward
@@ -195,7 +193,7 @@ template <class InputIter, class OutputIter, class UnaryPredicate>
 OutputIter
 copy_if(InputIter first, InputIter last, OutputIter result, UnaryPredicate unary_pred)
 {
-    for (; first != last, ++first)
+    for (; first != last; ++first)
     {
         if (unary_pred(*(first)))
             *result++ = *first;
@@ -232,7 +230,7 @@ template <class InputIter, class Size, class OutputIter>
 ctstl::pair<InputIter, OutputIter>
 copy_n(InputIter first, Size n, OutputIter result)
 {
-    return unchecked_copy_n(first, n, last, iterator_category(first));
+    return unchecked_copy_n(first, n, result, iterator_category(first));
 }
 
 /*****************************************************************************************/
@@ -245,11 +243,11 @@ OutputIter
 unchecked_move_cat(InputIter first, InputIter last, OutputIter result,
                    ctstl::input_iterator_tag)
 {
-    for (; first != last; ++first, ++last)
+    for (; first != last; ++first, ++result)
     {
-        *result = ctstl::move(first);
+        *result = ctstl::move(*first);
     }
-    return resutl;
+    return result;
 }
 
 // ramdom_access_iterator_tag 版本
@@ -286,11 +284,9 @@ unchecked_move(Tp* first, Tp* last, Up* result)
     return result + n;
 }
 
+// move 的定义在 move_backward 之后：先按分段迭代器拆分区间，再调用 unchecked_move
 template <class InputIter, class OutputIter>
-OutputIter move(InputIter first, InputIter last, OutputIter result)
-{
-    return unchecked_move(first, last, result);
-}
+OutputIter move(InputIter first, InputIter last, OutputIter result);
 
 /*****************************************************************************************/
 // move_backward
@@ -350,19 +346,251 @@ move_backward(BidirectionalIter1 first, BidirectionalIter1 last, BidirectionalIt
   return unchecked_move_backward(first, last, result);
 }
 
+/*****************************************************************************************/
+// 分段迭代器（见 iterator.h 中的 segmented_iterator_traits）上的 copy / move
+// [first, last) 是分段迭代器时逐块处理；只有 result 是分段迭代器时，按 result 的块切分 [first, last)；
+// 块内的迭代器是普通指针，可平凡复制的类型因此会用上 memmove
+/*****************************************************************************************/
+template <class Iter>
+struct is_segmented_iterator : segmented_iterator_traits<Iter>::is_segmented_iterator {};
+
+struct segmented_copy_op
+{
+    template <class InputIter, class OutputIter>
+    static OutputIter apply(InputIter first, InputIter last, OutputIter result)
+    {
+        return ctstl::copy(first, last, result);
+    }
+
+    template <class InputIter, class OutputIter>
+    static OutputIter unchecked(InputIter first, InputIter last, OutputIter result)
+    {
+        return ctstl::unchecked_copy(first, last, result);
+    }
+};
+
+struct segmented_move_op
+{
+    template <class InputIter, class OutputIter>
+    static OutputIter apply(InputIter first, InputIter last, OutputIter result)
+    {
+        return ctstl::move(first, last, result);
+    }
+
+    template <class InputIter, class OutputIter>
+    static OutputIter unchecked(InputIter first, InputIter last, OutputIter result)
+    {
+        return ctstl::unchecked_move(first, last, result);
+    }
+};
+
+// 两边都不是分段迭代器
+template <class Op, class InputIter, class OutputIter>
+OutputIter
+segmented_transfer(InputIter first, InputIter last, OutputIter result,
+                   std::false_type, std::false_type)
+{
+    return Op::unchecked(first, last, result);
+}
+
+// [first, last) 是分段迭代器，逐块处理，result 是否分段由块内的调用再判断
+template <class Op, class SegIter, class OutputIter, class OutSegmented>
+OutputIter
+segmented_transfer(SegIter first, SegIter last, OutputIter result,
+                   std::true_type, OutSegmented)
+{
+    typedef segmented_iterator_traits<SegIter> traits;
+    typename traits::segment_iterator sfirst = traits::segment(first);
+    typename traits::segment_iterator slast = traits::segment(last);
+    if (sfirst == slast)
+        return Op::apply(traits::local(first), traits::local(last), result);
+    result = Op::apply(traits::local(first), traits::end(sfirst), result);
+    for (++sfirst; sfirst != slast; ++sfirst)
+        result = Op::apply(traits::begin(sfirst), traits::end(sfirst), result);
+    return Op::apply(traits::begin(slast), traits::local(last), result);
+}
+
+// 只有 result 是分段迭代器，[first, last) 不能随机访问时逐个处理
+template <class Op, class InputIter, class SegIter>
+SegIter
+segmented_transfer_out(InputIter first, InputIter last, SegIter result,
+                       ctstl::input_iterator_tag)
+{
+    return Op::unchecked(first, last, result);
+}
+
+template <class Op, class RandomIter, class SegIter>
+SegIter
+segmented_transfer_out(RandomIter first, RandomIter last, SegIter result,
+                       ctstl::random_access_iterator_tag)
+{
+    typedef segmented_iterator_traits<SegIter> traits;
+    auto n = last - first;
+    if (n <= 0)
+        return result;
+    typename traits::segment_iterator seg = traits::segment(result);
+    typename traits::local_iterator local = traits::local(result);
+    while (true)
+    {
+        auto room = traits::end(seg) - local;
+        auto step = n < room ? n : room;
+        local = Op::unchecked(first, first + step, local);
+        first += step;
+        n -= step;
+        if (n == 0)
+            return traits::compose(seg, local);
+        ++seg;
+        local = traits::begin(seg);
+    }
+}
+
+template <class Op, class InputIter, class SegIter>
+SegIter
+segmented_transfer(InputIter first, InputIter last, SegIter result,
+                   std::false_type, std::true_type)
+{
+    return ctstl::segmented_transfer_out<Op>(first, last, result, iterator_category(first));
+}
+
+template <class InputIter, class OutputIter>
+OutputIter
+copy(InputIter first, InputIter last, OutputIter result)
+{
+    return ctstl::segmented_transfer<segmented_copy_op>(first, last, result,
+                                                        is_segmented_iterator<InputIter>(),
+                                                        is_segmented_iterator<OutputIter>());
+}
+
+template <class InputIter, class OutputIter>
+OutputIter move(InputIter first, InputIter last, OutputIter result)
+{
+    return ctstl::segmented_transfer<segmented_move_op>(first, last, result,
+                                                        is_segmented_iterator<InputIter>(),
+                                                        is_segmented_iterator<OutputIter>());
+}
+
 /*****************************************************************************************/
 // equal
 // 比较第一序列在 [first, last)区间上的元素值是否和第二序列相等
 /*****************************************************************************************/
+// 返回是否相等，以及第二序列比较结束的位置，供分段迭代器逐块比较时接着往下走
 template <class InputIter1, class InputIter2>
-bool equal(InputIter1 first1, InputIter1 last1, InputIter2 first2, InputIter2 last2)
+ctstl::pair<bool, InputIter2>
+unchecked_equal(InputIter1 first1, InputIter1 last1, InputIter2 first2)
 {
     for (; first1 != last1; ++first1, ++first2)
     {
         if (*first1 != *first2)
-            return false;
+            return ctstl::pair<bool, InputIter2>(false, first2);
     }
-    return true;
+    return ctstl::pair<bool, InputIter2>(true, first2);
+}
+
+// 为整数、指针类型提供特化版本，按位相同即相等，使用 memcmp
+template <class Tp, class Up>
+typename std::enable_if<
+    std::is_same<typename std::remove_const<Tp>::type, typename std::remove_const<Up>::type>::value &&
+    (std::is_integral<Up>::value || std::is_pointer<Up>::value),
+    ctstl::pair<bool, Up*>>::type
+unchecked_equal(Tp* first1, Tp* last1, Up* first2)
+{
+    const size_t n = static_cast<size_t>(last1 - first1);
+    const bool same = n == 0 || std::memcmp(first1, first2, n * sizeof(Up)) == 0;
+    return ctstl::pair<bool, Up*>(same, first2 + n);
+}
+
+template <class InputIter1, class InputIter2>
+ctstl::pair<bool, InputIter2>
+equal_dispatch(InputIter1 first1, InputIter1 last1, InputIter2 first2);
+
+// 两边都不是分段迭代器
+template <class InputIter1, class InputIter2>
+ctstl::pair<bool, InputIter2>
+segmented_equal(InputIter1 first1, InputIter1 last1, InputIter2 first2,
+                std::false_type, std::false_type)
+{
+    return ctstl::unchecked_equal(first1, last1, first2);
+}
+
+// 第一序列是分段迭代器，逐块比较
+template <class SegIter, class InputIter2, class Segmented2>
+ctstl::pair<bool, InputIter2>
+segmented_equal(SegIter first1, SegIter last1, InputIter2 first2,
+                std::true_type, Segmented2)
+{
+    typedef segmented_iterator_traits<SegIter> traits;
+    typename traits::segment_iterator sfirst = traits::segment(first1);
+    typename traits::segment_iterator slast = traits::segment(last1);
+    if (sfirst == slast)
+        return ctstl::equal_dispatch(traits::local(first1), traits::local(last1), first2);
+    ctstl::pair<bool, InputIter2> r =
+        ctstl::equal_dispatch(traits::local(first1), traits::end(sfirst), first2);
+    for (++sfirst; r.first && sfirst != slast; ++sfirst)
+        r = ctstl::equal_dispatch(traits::begin(sfirst), traits::end(sfirst), r.second);
+    if (!r.first)
+        return r;
+    return ctstl::equal_dispatch(traits::begin(slast), traits::local(last1), r.second);
+}
+
+// 只有第二序列是分段迭代器，第一序列不能随机访问时逐个比较
+template <class InputIter1, class SegIter>
+ctstl::pair<bool, SegIter>
+segmented_equal_second(InputIter1 first1, InputIter1 last1, SegIter first2,
+                       ctstl::input_iterator_tag)
+{
+    return ctstl::unchecked_equal(first1, last1, first2);
+}
+
+template <class RandomIter, class SegIter>
+ctstl::pair<bool, SegIter>
+segmented_equal_second(RandomIter first1, RandomIter last1, SegIter first2,
+                       ctstl::random_access_iterator_tag)
+{
+    typedef segmented_iterator_traits<SegIter> traits;
+    auto n = last1 - first1;
+    if (n <= 0)
+        return ctstl::pair<bool, SegIter>(true, first2);
+    typename traits::segment_iterator seg = traits::segment(first2);
+    typename traits::local_iterator local = traits::local(first2);
+    while (true)
+    {
+        auto room = traits::end(seg) - local;
+        auto step = n < room ? n : room;
+        ctstl::pair<bool, typename traits::local_iterator> r =
+            ctstl::unchecked_equal(first1, first1 + step, local);
+        if (!r.first)
+            return ctstl::pair<bool, SegIter>(false, traits::compose(seg, r.second));
+        local = r.second;
+        first1 += step;
+        n -= step;
+        if (n == 0)
+            return ctstl::pair<bool, SegIter>(true, traits::compose(seg, local));
+        ++seg;
+        local = traits::begin(seg);
+    }
+}
+
+template <class InputIter1, class SegIter>
+ctstl::pair<bool, SegIter>
+segmented_equal(InputIter1 first1, InputIter1 last1, SegIter first2,
+                std::false_type, std::true_type)
+{
+    return ctstl::segmented_equal_second(first1, last1, first2, iterator_category(first1));
+}
+
+template <class InputIter1, class InputIter2>
+ctstl::pair<bool, InputIter2>
+equal_dispatch(InputIter1 first1, InputIter1 last1, InputIter2 first2)
+{
+    return ctstl::segmented_equal(first1, last1, first2,
+                                  is_segmented_iterator<InputIter1>(),
+                                  is_segmented_iterator<InputIter2>());
+}
+
+template <class InputIter1, class InputIter2>
+bool equal(InputIter1 first1, InputIter1 last1, InputIter2 first2, InputIter2 /*last2*/)
+{
+    return ctstl::equal_dispatch(first1, last1, first2).first;
 }
 
 // 重载版本使用函数对象 comp 代替比较操作
@@ -432,15 +660,39 @@ template <class RandomIter, class T>
 void fill_cat(RandomIter first, RandomIter last, const T& value,
               ctstl::random_access_iterator_tag)
 {
-  fill_n(first, last - first, value);
+  ctstl::fill_n(first, last - first, value);
 }
 
+// 分段迭代器逐块填充，块内是普通指针，单字节类型会用上 memset
 template <class ForwardIter, class T>
-void fill(ForwardIter first, ForwardIter last, const T& value)
+void fill_segmented(ForwardIter first, ForwardIter last, const T& value, std::false_type)
 {
   fill_cat(first, last, value, iterator_category(first));
 }
 
+template <class SegIter, class T>
+void fill_segmented(SegIter first, SegIter last, const T& value, std::true_type)
+{
+  typedef segmented_iterator_traits<SegIter> traits;
+  typename traits::segment_iterator sfirst = traits::segment(first);
+  typename traits::segment_iterator slast = traits::segment(last);
+  if (sfirst == slast)
+  {
+    ctstl::fill_segmented(traits::local(first), traits::local(last), value, std::false_type());
+    return;
+  }
+  ctstl::fill_segmented(traits::local(first), traits::end(sfirst), value, std::false_type());
+  for (++sfirst; sfirst != slast; ++sfirst)
+    ctstl::fill_segmented(traits::begin(sfirst), traits::end(sfirst), value, std::false_type());
+  ctstl::fill_segmented(traits::begin(slast), traits::local(last), value, std::false_type());
+}
+
+template <class ForwardIter, class T>
+void fill(ForwardIter first, ForwardIter last, const T& value)
+{
+  ctstl::fill_segmented(first, last, value, is_segmented_iterator<ForwardIter>());
+}
+
 /*****************************************************************************************/
 // lexicographical_compare
 // 以字典序排列对两个序列进行比较，当在某个位置发现第一组不相等元素时，有下列几种情况：
@@ -453,7 +705,7 @@ template <class InputIter1, class InputIter2>
 bool lexicographical_compare(InputIter1 first1, InputIter1 last1,
                              InputIter2 first2, InputIter2 last2)
 {
-    for (; firs1 != last1 && first2 != last2; ++first1, ++last2)
+    for (; first1 != last1 && first2 != last2; ++first1, ++first2)
     {
         if (*first1 < *first2)
             return true;
@@ -479,7 +731,7 @@ bool lexicographical_compare(InputIter1 first1, InputIter1 last1,
 }
 
 // 针对 const unsigned char* 的特化版本
-bool lexicographical_compare(const unsigned char* first1,
+inline bool lexicographical_compare(const unsigned char* first1,
                              const unsigned char* last1,
                              const unsigned char* first2,
                              const unsigned char* last2)
@@ -518,7 +770,7 @@ mismatch(InputIter1 first1, InputIter1 last1, InputIter2 first2, Compred comp)
     ++first1;
     ++first2;
   }
-  return mystl::pair<InputIter1, InputIter2>(first1, first2);
+  return ctstl::pair<InputIter1, InputIter2>(first1, first2);
 }
 
 } // namespace ctstl
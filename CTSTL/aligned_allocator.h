@@ -0,0 +1,427 @@
+#ifndef CTSTL_ALIGNED_ALLOCATOR_H_
+#define CTSTL_ALIGNED_ALLOCATOR_H_
+
+// 这个头文件包含两个与 allocator 接口相同的空间配置器
+// aligned_allocator   : 按模板参数 Align 对齐分配内存，适合 SIMD 运算使用的缓冲区
+// huge_page_allocator : 超过阈值的请求使用按 2 MB 对齐的 mmap 内存，并通过 madvise 建议内核使用大页，减少 TLB 缺失
+// realloc_allocator   : 提供 reallocate，小块内存用 realloc 扩展，大块内存用 mmap 映射并用 mremap 扩展，
+//                       供元素可以平凡重定位的 vector 在原来的内存块上扩容
+
+#include <new>
+#include <cstddef>
+#include <cstdlib>
+#include <cstring>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/mman.h>
+#include <unistd.h>
+#define CTSTL_HAS_MMAP 1
+#if defined(__linux__) && defined(MREMAP_MAYMOVE)
+#define CTSTL_HAS_MREMAP 1
+#endif
+#endif
+
+#include "construct.h"
+#include "util.h"
+
+namespace ctstl
+{
+
+// 分配 bytes 大小、按 align 对齐的内存，align 必须为 2 的幂
+inline void* aligned_operator_new(size_t bytes, size_t align)
+{
+#if defined(__cpp_aligned_new)
+    return ::operator new(bytes, static_cast<std::align_val_t>(align));
+#else
+    // 多申请一部分空间手动对齐，并在对齐后的地址前面记录原始地址
+    char* raw = static_cast<char*>(::operator new(bytes + align + sizeof(void*)));
+    char* aligned = reinterpret_cast<char*>(
+        (reinterpret_cast<size_t>(raw + sizeof(void*)) + align - 1) & ~(align - 1));
+    reinterpret_cast<void**>(aligned)[-1] = raw;
+    return aligned;
+#endif
+}
+
+// 释放 aligned_operator_new 得到的内存，align 必须与分配时相同
+inline void aligned_operator_delete(void* p, size_t align) noexcept
+{
+#if defined(__cpp_aligned_new)
+    ::operator delete(p, static_cast<std::align_val_t>(align));
+#else
+    (void)align;
+    ::operator delete(static_cast<void**>(p)[-1]);
+#endif
+}
+
+// 模板类：aligned_allocator
+// 模板参数 Align 表示对齐大小，必须为 2 的幂，并且不小于 alignof(T)
+template <class T, size_t Align = 64>
+class aligned_allocator
+{
+    static_assert((Align & (Align - 1)) == 0, "Align must be a power of two");
+    static_assert(Align >= alignof(T), "Align must not be smaller than alignof(T)");
+
+public:
+    typedef T           value_type;
+    typedef T*          pointer;
+    typedef const T*    const_pointer;
+    typedef T&          reference;
+    typedef const T&    const_reference;
+    typedef size_t      size_type;
+    typedef ptrdiff_t   difference_type;
+
+    template <class U>
+    struct rebind
+    {
+        typedef aligned_allocator<U, (Align > alignof(U) ? Align : alignof(U))> other;
+    };
+
+public:
+    static T* allocate()
+    {
+        return static_cast<T*>(aligned_operator_new(sizeof(T), Align));
+    }
+
+    static T* allocate(size_type n)
+    {
+        if (n == 0)
+            return nullptr;
+        return static_cast<T*>(aligned_operator_new(n * sizeof(T), Align));
+    }
+
+    static void deallocate(T* ptr)
+    {
+        if (ptr == nullptr)
+            return;
+        aligned_operator_delete(ptr, Align);
+    }
+
+    static void deallocate(T* ptr, size_type /*n*/)
+    {
+        if (ptr == nullptr)
+            return;
+        aligned_operator_delete(ptr, Align);
+    }
+
+    static void construct(T* ptr)                  { ctstl::construct(ptr); }
+    static void construct(T* ptr, const T& value)  { ctstl::construct(ptr, value); }
+    static void construct(T* ptr, T&& value)       { ctstl::construct(ptr, ctstl::move(value)); }
+
+    template <class... Args>
+    static void construct(T* ptr, Args&& ...args)
+    {
+        ctstl::construct(ptr, ctstl::forward<Args>(args)...);
+    }
+
+    static void destroy(T* ptr)                    { ctstl::destroy(ptr); }
+    static void destroy(T* first, T* last)         { ctstl::destroy(first, last); }
+};
+
+// 大页的大小
+enum { EHugePageSize = 2 * 1024 * 1024 };
+
+// 映射一块 bytes 大小、按大页对齐的内存，并建议内核使用透明大页
+inline void* huge_page_map(size_t bytes)
+{
+    const size_t page = EHugePageSize;
+    const size_t size = (bytes + page - 1) & ~(page - 1);
+#if defined(CTSTL_HAS_MMAP)
+    // 多映射一个大页，再把首尾多余的部分解除映射，得到按 2 MB 对齐的区域
+    void* raw = ::mmap(nullptr, size + page, PROT_READ | PROT_WRITE,
+                       MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (raw == MAP_FAILED)
+        throw std::bad_alloc();
+    char* begin = static_cast<char*>(raw);
+    char* aligned = reinterpret_cast<char*>(
+        (reinterpret_cast<size_t>(begin) + page - 1) & ~(page - 1));
+    if (aligned != begin)
+        ::munmap(begin, aligned - begin);
+    char* tail = aligned + size;
+    if (tail != begin + size + page)
+        ::munmap(tail, begin + size + page - tail);
+#if defined(MADV_HUGEPAGE)
+    ::madvise(aligned, size, MADV_HUGEPAGE);
+#endif
+    return aligned;
+#else
+    // 没有 mmap 的平台上退化为按大页对齐的普通内存
+    return aligned_operator_new(size, page);
+#endif
+}
+
+// 解除 huge_page_map 得到的映射，bytes 必须与映射时相同
+inline void huge_page_unmap(void* p, size_t bytes) noexcept
+{
+    const size_t page = EHugePageSize;
+#if defined(CTSTL_HAS_MMAP)
+    ::munmap(p, (bytes + page - 1) & ~(page - 1));
+#else
+    (void)bytes;
+    aligned_operator_delete(p, page);
+#endif
+}
+
+// 模板类：huge_page_allocator
+// 大小不小于 Threshold 的请求使用 huge_page_map，更小的请求按 alignof(T) 正常分配
+// 释放时根据 n * sizeof(T) 判断内存来自哪一边，因此 deallocate 的 n 必须与 allocate 时相同
+template <class T, size_t Threshold = EHugePageSize>
+class huge_page_allocator
+{
+public:
+    typedef T           value_type;
+    typedef T*          pointer;
+    typedef const T*    const_pointer;
+    typedef T&          reference;
+    typedef const T&    const_reference;
+    typedef size_t      size_type;
+    typedef ptrdiff_t   difference_type;
+
+    template <class U>
+    struct rebind
+    {
+        typedef huge_page_allocator<U, Threshold> other;
+    };
+
+public:
+    static T* allocate()
+    {
+        return allocate(1);
+    }
+
+    static T* allocate(size_type n)
+    {
+        if (n == 0)
+            return nullptr;
+        const size_t bytes = n * sizeof(T);
+        if (bytes >= Threshold)
+            return static_cast<T*>(huge_page_map(bytes));
+        return static_cast<T*>(::operator new(bytes));
+    }
+
+    static void deallocate(T* ptr)
+    {
+        deallocate(ptr, 1);
+    }
+
+    static void deallocate(T* ptr, size_type n)
+    {
+        if (ptr == nullptr)
+            return;
+        const size_t bytes = n * sizeof(T);
+        if (bytes >= Threshold)
+            huge_page_unmap(ptr, bytes);
+        else
+            ::operator delete(ptr);
+    }
+
+    static void construct(T* ptr)                  { ctstl::construct(ptr); }
+    static void construct(T* ptr, const T& value)  { ctstl::construct(ptr, value); }
+    static void construct(T* ptr, T&& value)       { ctstl::construct(ptr, ctstl::move(value)); }
+
+    template <class... Args>
+    static void construct(T* ptr, Args&& ...args)
+    {
+        ctstl::construct(ptr, ctstl::forward<Args>(args)...);
+    }
+
+    static void destroy(T* ptr)                    { ctstl::destroy(ptr); }
+    static void destroy(T* first, T* last)         { ctstl::destroy(first, last); }
+};
+
+// 系统的页大小
+inline size_t mmap_page_size() noexcept
+{
+#if defined(CTSTL_HAS_MMAP)
+    static const size_t size = static_cast<size_t>(::sysconf(_SC_PAGESIZE));
+    return size;
+#else
+    return 4096;
+#endif
+}
+
+// 不小于这个大小的请求，realloc_allocator 默认使用 mmap 映射的内存
+enum { EReallocMmapThreshold = 1024 * 1024 };
+
+// 结构体：realloc_result
+// reallocate 的结果，in_place 表示内存块是在原地扩展（或收缩）的，原来的指针仍然有效
+template <class T>
+struct realloc_result
+{
+    T*   ptr;
+    bool in_place;
+};
+
+// 模板类：realloc_allocator
+// 小于 Threshold 字节的请求使用 malloc / realloc / free，不小于 Threshold 的请求使用按页映射的 mmap 内存，
+// 在 Linux 上用 mremap(MREMAP_MAYMOVE) 扩展：内核只需要重新映射页表，不复制数据，也不会出现新旧两块内存同时存在的峰值
+// reallocate 按字节搬移元素，只能用于可以平凡重定位的类型
+// 释放时根据 n * sizeof(T) 判断内存来自哪一边，因此 deallocate 的 n 必须与 allocate / reallocate 时相同
+template <class T, size_t Threshold = EReallocMmapThreshold>
+class realloc_allocator
+{
+public:
+    typedef T           value_type;
+    typedef T*          pointer;
+    typedef const T*    const_pointer;
+    typedef T&          reference;
+    typedef const T&    const_reference;
+    typedef size_t      size_type;
+    typedef ptrdiff_t   difference_type;
+
+    template <class U>
+    struct rebind
+    {
+        typedef realloc_allocator<U, Threshold> other;
+    };
+
+public:
+    static T* allocate()
+    {
+        return allocate(1);
+    }
+
+    static T* allocate(size_type n)
+    {
+        if (n == 0)
+            return nullptr;
+        const size_t bytes = n * sizeof(T);
+        void* p = is_mapped(bytes) ? M_map(bytes) : malloc(bytes);
+        if (p == nullptr)
+            throw std::bad_alloc();
+        return static_cast<T*>(p);
+    }
+
+    static void deallocate(T* ptr)
+    {
+        deallocate(ptr, 1);
+    }
+
+    static void deallocate(T* ptr, size_type n)
+    {
+        if (ptr == nullptr)
+            return;
+        const size_t bytes = n * sizeof(T);
+        if (is_mapped(bytes))
+            M_unmap(ptr, bytes);
+        else
+            free(ptr);
+    }
+
+    // 把 ptr 开始、容量为 old_n 的内存块调整为容量 new_n，前 min(old_n, new_n) 个元素的内容保持不变
+    // 失败时抛出 std::bad_alloc，原来的内存块不变
+    static realloc_result<T> reallocate(T* ptr, size_type old_n, size_type new_n)
+    {
+        realloc_result<T> result = { nullptr, false };
+        if (ptr == nullptr || old_n == 0)
+        {
+            result.ptr = allocate(new_n);
+            return result;
+        }
+        if (new_n == 0)
+        {
+            deallocate(ptr, old_n);
+            return result;
+        }
+        const size_t old_bytes = old_n * sizeof(T);
+        const size_t new_bytes = new_n * sizeof(T);
+        void* p = nullptr;
+        if (!is_mapped(old_bytes) && !is_mapped(new_bytes))
+        {
+            p = realloc(ptr, new_bytes);
+        }
+        else if (is_mapped(old_bytes) && is_mapped(new_bytes))
+        {
+            p = M_remap(ptr, old_bytes, new_bytes);
+        }
+        else
+        {   // 跨过阈值时内存的来源不同，只能分配新的内存块再复制
+            p = is_mapped(new_bytes) ? M_map(new_bytes) : malloc(new_bytes);
+            if (p != nullptr)
+            {
+                memcpy(p, ptr, old_bytes < new_bytes ? old_bytes : new_bytes);
+                deallocate(ptr, old_n);
+            }
+        }
+        if (p == nullptr)
+            throw std::bad_alloc();
+        result.ptr = static_cast<T*>(p);
+        result.in_place = result.ptr == ptr;
+        return result;
+    }
+
+    static void construct(T* ptr)                  { ctstl::construct(ptr); }
+    static void construct(T* ptr, const T& value)  { ctstl::construct(ptr, value); }
+    static void construct(T* ptr, T&& value)       { ctstl::construct(ptr, ctstl::move(value)); }
+
+    template <class... Args>
+    static void construct(T* ptr, Args&& ...args)
+    {
+        ctstl::construct(ptr, ctstl::forward<Args>(args)...);
+    }
+
+    static void destroy(T* ptr)                    { ctstl::destroy(ptr); }
+    static void destroy(T* first, T* last)         { ctstl::destroy(first, last); }
+
+private:
+    static bool is_mapped(size_t bytes) noexcept
+    {
+#if defined(CTSTL_HAS_MMAP)
+        return bytes >= Threshold;
+#else
+        (void)bytes;
+        return false;
+#endif
+    }
+
+    static size_t M_round_up(size_t bytes) noexcept
+    {
+        return (bytes + mmap_page_size() - 1) & ~(mmap_page_size() - 1);
+    }
+
+    // 失败时返回 nullptr
+    static void* M_map(size_t bytes) noexcept
+    {
+#if defined(CTSTL_HAS_MMAP)
+        void* p = ::mmap(nullptr, M_round_up(bytes), PROT_READ | PROT_WRITE,
+                         MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        return p == MAP_FAILED ? nullptr : p;
+#else
+        return malloc(bytes);
+#endif
+    }
+
+    static void M_unmap(void* p, size_t bytes) noexcept
+    {
+#if defined(CTSTL_HAS_MMAP)
+        ::munmap(p, M_round_up(bytes));
+#else
+        (void)bytes;
+        free(p);
+#endif
+    }
+
+    // 失败时返回 nullptr，原来的映射不变
+    static void* M_remap(void* p, size_t old_bytes, size_t new_bytes) noexcept
+    {
+        const size_t old_size = M_round_up(old_bytes);
+        const size_t new_size = M_round_up(new_bytes);
+        if (old_size == new_size)
+            return p;
+#if defined(CTSTL_HAS_MREMAP)
+        void* q = ::mremap(p, old_size, new_size, MREMAP_MAYMOVE);
+        return q == MAP_FAILED ? nullptr : q;
+#else
+        // 没有 mremap 的平台上映射新的区域再复制
+        void* q = M_map(new_bytes);
+        if (q != nullptr)
+        {
+            memcpy(q, p, old_bytes < new_bytes ? old_bytes : new_bytes);
+            M_unmap(p, old_bytes);
+        }
+        return q;
+#endif
+    }
+};
+
+} // namespace ctstl
+#endif // !CTSTL_ALIGNED_ALLOCATOR_H_
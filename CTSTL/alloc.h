@@ -0,0 +1,367 @@
+#ifndef CTSTL_ALLOC_H_
+#define CTSTL_ALLOC_H_
+
+// 这个头文件包含 SGI 风格的二级空间配置器 pool_alloc_template，以及以它为后端的模板类 pool_allocator
+// 小于等于 256 bytes 的区块由自由链表管理，链表为空时从内存池中一次补充多个区块
+// 大于 256 bytes 的区块直接交给 ::operator new / ::operator delete（第一级配置器）
+
+#include <new>
+#include <cstddef>
+#include <cstring>
+#include <mutex>
+
+#include "construct.h"
+#include "util.h"
+
+namespace ctstl
+{
+
+// 共用体: FreeList
+// 采用链表的方式管理小区块，区块空闲时前几个字节被用来存放下一个区块的地址，不需要额外的空间
+union FreeList
+{
+    union FreeList* next;  // 指向下一个区块
+    char data[1];          // 储存本块内存的首地址
+};
+
+// 小区块的上调边界
+enum { EAlign = 8 };
+
+// 小对象的内存大小上限，超过这个大小的请求直接交给第一级配置器
+enum { ESmallObjectBytes = 256 };
+
+// free lists 个数，每个 size class 对应一条链表: 8, 16, 24, ..., 256
+enum { EFreeListsNumber = ESmallObjectBytes / EAlign };
+
+// 一次补充的区块个数
+enum { ERefillObjects = 20 };
+
+// 模板类：pool_alloc_template
+// 模板参数 Threads 表示是否需要加锁，多个线程共用同一个内存池时应为 true
+// 静态成员放在类模板中，使得整个实现可以只存在于头文件里
+template <bool Threads>
+class pool_alloc_template
+{
+private:
+    static char*     start_free;                      // 内存池起始位置
+    static char*     end_free;                        // 内存池结束位置
+    static size_t    heap_size;                       // 已向系统申请的总大小，用于决定下一次申请的附加量
+    static FreeList* free_list[EFreeListsNumber];     // 自由链表
+    static std::mutex pool_mutex;                     // Threads 为 true 时保护上面所有的成员
+
+public:
+    static void* allocate(size_t n);
+    static void  deallocate(void* p, size_t n);
+    static void* reallocate(void* p, size_t old_size, size_t new_size);
+
+private:
+    static size_t M_round_up(size_t bytes);
+    static size_t M_freelist_index(size_t bytes);
+    static void*  M_refill(size_t n);
+    static char*  M_chunk_alloc(size_t size, size_t& nobj);
+
+    // 根据 Threads 决定是否真正加锁
+    class lock
+    {
+    public:
+        lock()  { if (Threads) pool_mutex.lock(); }
+        ~lock() { if (Threads) pool_mutex.unlock(); }
+    private:
+        lock(const lock&);
+        void operator=(const lock&);
+    };
+};
+
+// 静态成员变量初始化
+
+template <bool Threads>
+char* pool_alloc_template<Threads>::start_free = nullptr;
+
+template <bool Threads>
+char* pool_alloc_template<Threads>::end_free = nullptr;
+
+template <bool Threads>
+size_t pool_alloc_template<Threads>::heap_size = 0;
+
+template <bool Threads>
+FreeList* pool_alloc_template<Threads>::free_list[EFreeListsNumber] = {};
+
+template <bool Threads>
+std::mutex pool_alloc_template<Threads>::pool_mutex;
+
+// 分配大小为 n 的空间， n > 0
+template <bool Threads>
+void* pool_alloc_template<Threads>::allocate(size_t n)
+{
+    if (n > static_cast<size_t>(ESmallObjectBytes))
+        return ::operator new(n);
+    lock guard;
+    FreeList** my_free_list = free_list + M_freelist_index(n);
+    FreeList* result = *my_free_list;
+    if (result == nullptr)
+    {   // 链表为空，从内存池中补充
+        return M_refill(M_round_up(n));
+    }
+    *my_free_list = result->next;
+    return result;
+}
+
+// 释放 p 指向的大小为 n 的空间, p 不能为 0
+// n 必须与 allocate 时传入的大小一致，否则区块会被挂到错误的链表上
+template <bool Threads>
+void pool_alloc_template<Threads>::deallocate(void* p, size_t n)
+{
+    if (n > static_cast<size_t>(ESmallObjectBytes))
+    {
+        ::operator delete(p);
+        return;
+    }
+    lock guard;
+    FreeList* q = reinterpret_cast<FreeList*>(p);
+    FreeList** my_free_list = free_list + M_freelist_index(n);
+    q->next = *my_free_list;
+    *my_free_list = q;
+}
+
+// 重新分配空间，接受三个参数，参数一为指向新空间的指针，参数二为原来空间的大小，参数三为申请空间的大小
+template <bool Threads>
+void* pool_alloc_template<Threads>::reallocate(void* p, size_t old_size, size_t new_size)
+{
+    if (old_size > static_cast<size_t>(ESmallObjectBytes) &&
+        new_size > static_cast<size_t>(ESmallObjectBytes))
+    {
+        void* result = ::operator new(new_size);
+        std::memcpy(result, p, old_size < new_size ? old_size : new_size);
+        ::operator delete(p);
+        return result;
+    }
+    if (M_round_up(old_size) == M_round_up(new_size))
+        return p;  // 同一个 size class，原地即可
+    void* result = allocate(new_size);
+    std::memcpy(result, p, old_size < new_size ? old_size : new_size);
+    deallocate(p, old_size);
+    return result;
+}
+
+// bytes 对应上调大小
+template <bool Threads>
+size_t pool_alloc_template<Threads>::M_round_up(size_t bytes)
+{
+    return ((bytes + EAlign - 1) & ~(static_cast<size_t>(EAlign) - 1));
+}
+
+// 根据区块大小，选择第 n 个 free lists
+template <bool Threads>
+size_t pool_alloc_template<Threads>::M_freelist_index(size_t bytes)
+{
+    return bytes == 0 ? 0 : (bytes + EAlign - 1) / EAlign - 1;
+}
+
+// 重新填充 free list，调用者必须已经持有锁
+template <bool Threads>
+void* pool_alloc_template<Threads>::M_refill(size_t n)
+{
+    size_t nblock = ERefillObjects;
+    char* c = M_chunk_alloc(n, nblock);
+    // 如果只有一个区块，就把这个区块返回给调用者，free list 没有增加新节点
+    if (nblock == 1)
+        return c;
+    // 否则第一个区块返回给调用者，其余区块串成链表挂到 free list 上
+    FreeList** my_free_list = free_list + M_freelist_index(n);
+    FreeList* result = reinterpret_cast<FreeList*>(c);
+    FreeList* cur = reinterpret_cast<FreeList*>(c + n);
+    *my_free_list = cur;
+    for (size_t i = 1; ; ++i)
+    {
+        FreeList* next = reinterpret_cast<FreeList*>(reinterpret_cast<char*>(cur) + n);
+        if (nblock - 1 == i)
+        {
+            cur->next = nullptr;
+            break;
+        }
+        cur->next = next;
+        cur = next;
+    }
+    return result;
+}
+
+// 从内存池中取空间给 free list 使用，条件不允许时，会调整 nblock
+template <bool Threads>
+char* pool_alloc_template<Threads>::M_chunk_alloc(size_t size, size_t& nblock)
+{
+    char* result;
+    size_t need_bytes = size * nblock;
+    size_t pool_bytes = end_free - start_free;
+
+    // 如果内存池剩余大小完全满足需求量，返回它
+    if (pool_bytes >= need_bytes)
+    {
+        result = start_free;
+        start_free += need_bytes;
+        return result;
+    }
+
+    // 如果内存池剩余大小不能完全满足需求量，但至少可以分配一个或一个以上的区块，就返回它
+    if (pool_bytes >= size)
+    {
+        nblock = pool_bytes / size;
+        need_bytes = size * nblock;
+        result = start_free;
+        start_free += need_bytes;
+        return result;
+    }
+
+    // 如果内存池剩余大小连一个区块都无法满足
+    // 先把内存池中的残余零头挂到对应的 free list 上（零头一定是 EAlign 的倍数）
+    if (pool_bytes > 0)
+    {
+        FreeList** my_free_list = free_list + M_freelist_index(pool_bytes);
+        reinterpret_cast<FreeList*>(start_free)->next = *my_free_list;
+        *my_free_list = reinterpret_cast<FreeList*>(start_free);
+    }
+    // 申请 heap 空间，附加量随已申请的总量增长
+    size_t bytes_to_get = (need_bytes << 1) + M_round_up(heap_size >> 4);
+    start_free = static_cast<char*>(::operator new(bytes_to_get, std::nothrow));
+    if (start_free == nullptr)
+    {
+        // heap 空间也不够，尝试从更大的 free list 中借一个区块当作内存池
+        for (size_t i = size; i <= ESmallObjectBytes; i += EAlign)
+        {
+            FreeList** my_free_list = free_list + M_freelist_index(i);
+            FreeList* p = *my_free_list;
+            if (p != nullptr)
+            {
+                *my_free_list = p->next;
+                start_free = reinterpret_cast<char*>(p);
+                end_free = start_free + i;
+                return M_chunk_alloc(size, nblock);
+            }
+        }
+        // 山穷水尽，交给会抛出 std::bad_alloc 的 ::operator new
+        end_free = nullptr;
+        start_free = static_cast<char*>(::operator new(bytes_to_get));
+    }
+    end_free = start_free + bytes_to_get;
+    heap_size += bytes_to_get;
+    return M_chunk_alloc(size, nblock);
+}
+
+// 默认使用的内存池，多个线程共用，带锁
+typedef pool_alloc_template<true>  pool_alloc;
+
+// 单线程使用的内存池，不加锁
+typedef pool_alloc_template<false> single_thread_pool_alloc;
+
+// 模板类：pool_allocator
+// 与 allocator 的接口完全相同，可以作为容器的 Alloc 模板参数替换默认的 allocator
+// 第二个模板参数为实际管理内存的二级配置器
+template <class T, class PoolAlloc = pool_alloc>
+class pool_allocator
+{
+    // 小区块只按 EAlign 对齐，对齐要求更高的类型不能放在里面
+    static_assert(alignof(T) <= EAlign, "pool_allocator does not support types aligned beyond EAlign");
+
+public:
+    typedef T           value_type;
+    typedef T*          pointer;
+    typedef const T*    const_pointer;
+    typedef T&          reference;
+    typedef const T&    const_reference;
+    typedef size_t      size_type;
+    typedef ptrdiff_t   difference_type;
+
+    template <class U>
+    struct rebind
+    {
+        typedef pool_allocator<U, PoolAlloc> other;
+    };
+
+public:
+    static T* allocate();
+    static T* allocate(size_type n);
+
+    static void deallocate(T* ptr);
+    static void deallocate(T* ptr, size_type n);
+
+    static void construct(T* ptr);
+    static void construct(T* ptr, const T& value);
+    static void construct(T* ptr, T&& value);
+
+    template <class... Args>
+    static void construct(T* ptr, Args&& ...args);
+
+    static void destroy(T* ptr);
+    static void destroy(T* first, T* last);
+};
+
+template <class T, class PoolAlloc>
+T* pool_allocator<T, PoolAlloc>::allocate()
+{
+    return static_cast<T*>(PoolAlloc::allocate(sizeof(T)));
+}
+
+template <class T, class PoolAlloc>
+T* pool_allocator<T, PoolAlloc>::allocate(size_type n)
+{
+    if (n == 0)
+        return nullptr;
+    return static_cast<T*>(PoolAlloc::allocate(n * sizeof(T)));
+}
+
+// 不带大小的版本只能用来释放 allocate() 得到的单个对象
+template <class T, class PoolAlloc>
+void pool_allocator<T, PoolAlloc>::deallocate(T* ptr)
+{
+    if (ptr == nullptr)
+        return;
+    PoolAlloc::deallocate(ptr, sizeof(T));
+}
+
+// n 必须与 allocate(n) 时相同，用来找到区块所属的 size class
+template <class T, class PoolAlloc>
+void pool_allocator<T, PoolAlloc>::deallocate(T* ptr, size_type n)
+{
+    if (ptr == nullptr)
+        return;
+    PoolAlloc::deallocate(ptr, n * sizeof(T));
+}
+
+template <class T, class PoolAlloc>
+void pool_allocator<T, PoolAlloc>::construct(T* ptr)
+{
+    ctstl::construct(ptr);
+}
+
+template <class T, class PoolAlloc>
+void pool_allocator<T, PoolAlloc>::construct(T* ptr, const T& value)
+{
+    ctstl::construct(ptr, value);
+}
+
+template <class T, class PoolAlloc>
+void pool_allocator<T, PoolAlloc>::construct(T* ptr, T&& value)
+{
+    ctstl::construct(ptr, ctstl::move(value));
+}
+
+template <class T, class PoolAlloc>
+template <class ...Args>
+void pool_allocator<T, PoolAlloc>::construct(T* ptr, Args&& ...args)
+{
+    ctstl::construct(ptr, ctstl::forward<Args>(args)...);
+}
+
+template <class T, class PoolAlloc>
+void pool_allocator<T, PoolAlloc>::destroy(T* ptr)
+{
+    ctstl::destroy(ptr);
+}
+
+template <class T, class PoolAlloc>
+void pool_allocator<T, PoolAlloc>::destroy(T* first, T* last)
+{
+    ctstl::destroy(first, last);
+}
+
+} // namespace ctstl
+#endif // !CTSTL_ALLOC_H_
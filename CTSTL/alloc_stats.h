@@ -0,0 +1,247 @@
+#ifndef CTSTL_ALLOC_STATS_H_
+#define CTSTL_ALLOC_STATS_H_
+
+// 这个头文件包含空间配置器的统计信息：按类型记录分配 / 释放次数、字节数、存活字节、峰值以及大小分布
+// 只有定义了宏 CTSTL_ALLOC_STATS 时，allocator 才会调用这里的记录函数，否则没有任何开销
+// 每个线程写自己的分片（shard），记录时不需要加锁；snapshot 时把所有分片合并
+
+#include <cstddef>
+#include <cstdint>
+#include <atomic>
+#include <mutex>
+#include <typeinfo>
+
+namespace ctstl
+{
+
+// 大小分布的桶数：第 i 个桶统计大小在 (2^(i-1), 2^i] 之间的请求，最后一个桶统计所有更大的请求
+enum { EAllocHistogramBuckets = 24 };
+
+// 结构体：alloc_stats_snapshot
+// 某个类型在某一时刻的统计信息
+struct alloc_stats_snapshot
+{
+    const char* type_name;         // typeid(T).name()
+    uint64_t    allocations;       // allocate 次数
+    uint64_t    deallocations;     // deallocate 次数
+    uint64_t    bytes_allocated;   // allocate 的总字节数
+    uint64_t    bytes_deallocated; // deallocate 的总字节数
+    int64_t     live_bytes;        // 当前存活的字节数，不受 reset 影响
+    uint64_t    peak_bytes;        // 各分片峰值之和，是真实峰值的上界，只有一个线程时是精确值
+    uint64_t    histogram[EAllocHistogramBuckets];
+};
+
+// 一个线程对一个类型的统计分片，只由所属线程写入，snapshot / reset 可以由任意线程进行
+struct alloc_stats_shard
+{
+    std::atomic<uint64_t> allocations;
+    std::atomic<uint64_t> deallocations;
+    std::atomic<uint64_t> bytes_allocated;
+    std::atomic<uint64_t> bytes_deallocated;
+    std::atomic<int64_t>  live_bytes;
+    std::atomic<int64_t>  peak_bytes;
+    std::atomic<uint64_t> histogram[EAllocHistogramBuckets];
+    std::atomic<bool>     in_use;  // 所属线程退出后为 false，可以被新线程复用
+    alloc_stats_shard*    next;    // 同一类型的分片串成单链表，只在持有注册锁时修改
+    char                  pad[64]; // 使得不同线程的分片不会落在同一条 cache line 上
+
+    alloc_stats_shard()
+        : allocations(0), deallocations(0), bytes_allocated(0), bytes_deallocated(0),
+          live_bytes(0), peak_bytes(0), in_use(true), next(nullptr)
+    {
+        for (size_t i = 0; i < EAllocHistogramBuckets; ++i)
+            histogram[i].store(0, std::memory_order_relaxed);
+    }
+};
+
+// 类：alloc_stats_registry
+// 一个类型的全部分片，以及所有类型组成的全局链表，供 for_each_alloc_stats 遍历
+class alloc_stats_registry
+{
+private:
+    const char*                         type_name_;
+    std::atomic<alloc_stats_shard*>     shards_;  // 分片只增不减，新分片从头部插入
+    std::mutex                          mutex_;   // 只在注册 / 复用分片时使用
+    alloc_stats_registry*               next_;
+
+public:
+    explicit alloc_stats_registry(const char* type_name)
+        : type_name_(type_name), shards_(nullptr), next_(nullptr)
+    {
+        std::lock_guard<std::mutex> lock(global_mutex());
+        next_ = global_head();
+        global_head() = this;
+    }
+
+    // 为当前线程取得一个分片：优先复用已经退出的线程留下的分片
+    alloc_stats_shard* acquire_shard()
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (alloc_stats_shard* s = shards_.load(std::memory_order_relaxed); s; s = s->next)
+        {
+            if (!s->in_use.load(std::memory_order_relaxed))
+            {
+                s->in_use.store(true, std::memory_order_relaxed);
+                return s;
+            }
+        }
+        alloc_stats_shard* s = new alloc_stats_shard();
+        s->next = shards_.load(std::memory_order_relaxed);
+        shards_.store(s, std::memory_order_release);
+        return s;
+    }
+
+    // 合并所有分片
+    alloc_stats_snapshot snapshot() const
+    {
+        alloc_stats_snapshot result = {};
+        result.type_name = type_name_;
+        for (alloc_stats_shard* s = shards_.load(std::memory_order_acquire); s; s = s->next)
+        {
+            result.allocations       += s->allocations.load(std::memory_order_relaxed);
+            result.deallocations     += s->deallocations.load(std::memory_order_relaxed);
+            result.bytes_allocated   += s->bytes_allocated.load(std::memory_order_relaxed);
+            result.bytes_deallocated += s->bytes_deallocated.load(std::memory_order_relaxed);
+            result.live_bytes        += s->live_bytes.load(std::memory_order_relaxed);
+            const int64_t peak = s->peak_bytes.load(std::memory_order_relaxed);
+            if (peak > 0)
+                result.peak_bytes += static_cast<uint64_t>(peak);
+            for (size_t i = 0; i < EAllocHistogramBuckets; ++i)
+                result.histogram[i] += s->histogram[i].load(std::memory_order_relaxed);
+        }
+        return result;
+    }
+
+    // 把计数器清零，峰值重置为当前存活字节数，存活字节数保持不变
+    void reset()
+    {
+        for (alloc_stats_shard* s = shards_.load(std::memory_order_acquire); s; s = s->next)
+        {
+            s->allocations.exchange(0, std::memory_order_relaxed);
+            s->deallocations.exchange(0, std::memory_order_relaxed);
+            s->bytes_allocated.exchange(0, std::memory_order_relaxed);
+            s->bytes_deallocated.exchange(0, std::memory_order_relaxed);
+            s->peak_bytes.store(s->live_bytes.load(std::memory_order_relaxed),
+                                std::memory_order_relaxed);
+            for (size_t i = 0; i < EAllocHistogramBuckets; ++i)
+                s->histogram[i].exchange(0, std::memory_order_relaxed);
+        }
+    }
+
+    // 遍历所有已经发生过分配的类型
+    template <class Func>
+    static void for_each(Func f)
+    {
+        std::lock_guard<std::mutex> lock(global_mutex());
+        for (alloc_stats_registry* r = global_head(); r; r = r->next_)
+            f(r->snapshot());
+    }
+
+    static void reset_all()
+    {
+        std::lock_guard<std::mutex> lock(global_mutex());
+        for (alloc_stats_registry* r = global_head(); r; r = r->next_)
+            r->reset();
+    }
+
+private:
+    alloc_stats_registry(const alloc_stats_registry&);
+    void operator=(const alloc_stats_registry&);
+
+    static std::mutex& global_mutex()
+    {
+        static std::mutex m;
+        return m;
+    }
+
+    static alloc_stats_registry*& global_head()
+    {
+        static alloc_stats_registry* head = nullptr;
+        return head;
+    }
+};
+
+// 线程退出时归还分片，分片里的计数保留下来
+class alloc_stats_shard_holder
+{
+private:
+    alloc_stats_shard* shard_;
+
+public:
+    explicit alloc_stats_shard_holder(alloc_stats_shard* s) : shard_(s) {}
+    ~alloc_stats_shard_holder() { shard_->in_use.store(false, std::memory_order_relaxed); }
+    alloc_stats_shard* get() const noexcept { return shard_; }
+
+private:
+    alloc_stats_shard_holder(const alloc_stats_shard_holder&);
+    void operator=(const alloc_stats_shard_holder&);
+};
+
+// 请求大小对应的桶
+inline size_t alloc_stats_bucket(size_t bytes) noexcept
+{
+    size_t bucket = 0;
+    while (bucket + 1 < EAllocHistogramBuckets && (static_cast<size_t>(1) << bucket) < bytes)
+        ++bucket;
+    return bucket;
+}
+
+// 模板类：alloc_stats
+// 每个类型 T 一份统计信息，由 allocator<T> 在 allocate / deallocate 时调用
+template <class T>
+class alloc_stats
+{
+public:
+    static void record_allocate(size_t bytes)
+    {
+        alloc_stats_shard* s = local_shard();
+        s->allocations.fetch_add(1, std::memory_order_relaxed);
+        s->bytes_allocated.fetch_add(bytes, std::memory_order_relaxed);
+        s->histogram[alloc_stats_bucket(bytes)].fetch_add(1, std::memory_order_relaxed);
+        const int64_t live = s->live_bytes.fetch_add(static_cast<int64_t>(bytes),
+                                                     std::memory_order_relaxed)
+                             + static_cast<int64_t>(bytes);
+        if (live > s->peak_bytes.load(std::memory_order_relaxed))
+            s->peak_bytes.store(live, std::memory_order_relaxed);
+    }
+
+    static void record_deallocate(size_t bytes)
+    {
+        alloc_stats_shard* s = local_shard();
+        s->deallocations.fetch_add(1, std::memory_order_relaxed);
+        s->bytes_deallocated.fetch_add(bytes, std::memory_order_relaxed);
+        s->live_bytes.fetch_sub(static_cast<int64_t>(bytes), std::memory_order_relaxed);
+    }
+
+    static alloc_stats_snapshot snapshot() { return registry().snapshot(); }
+    static void reset()                    { registry().reset(); }
+
+private:
+    static alloc_stats_registry& registry()
+    {
+        static alloc_stats_registry r(typeid(T).name());
+        return r;
+    }
+
+    static alloc_stats_shard* local_shard()
+    {
+        static thread_local alloc_stats_shard_holder holder(registry().acquire_shard());
+        return holder.get();
+    }
+};
+
+// 遍历所有类型的统计信息，f 接受一个 const alloc_stats_snapshot&，供指标导出使用
+template <class Func>
+void for_each_alloc_stats(Func f)
+{
+    alloc_stats_registry::for_each(f);
+}
+
+// 重置所有类型的统计信息
+inline void reset_all_alloc_stats()
+{
+    alloc_stats_registry::reset_all();
+}
+
+} // namespace ctstl
+#endif // !CTSTL_ALLOC_STATS_H_
@@ -5,6 +5,16 @@
 #include "construct.h"
 #include "util.h"
 
+// 定义了 CTSTL_ALLOC_STATS 时，记录每个类型的分配统计信息，见 alloc_stats.h
+#ifdef CTSTL_ALLOC_STATS
+#include "alloc_stats.h"
+#define CTSTL_RECORD_ALLOCATE(T, bytes)   ctstl::alloc_stats<T>::record_allocate(bytes)
+#define CTSTL_RECORD_DEALLOCATE(T, bytes) ctstl::alloc_stats<T>::record_deallocate(bytes)
+#else
+#define CTSTL_RECORD_ALLOCATE(T, bytes)   ((void)(bytes))
+#define CTSTL_RECORD_DEALLOCATE(T, bytes) ((void)(bytes))
+#endif // CTSTL_ALLOC_STATS
+
 namespace ctstl
 {
 
@@ -22,6 +32,13 @@ public:
     typedef size_t      size_type;
     typedef ptrdiff_t   difference_type;
 
+    // 让容器可以得到同一种配置器下其它类型（比如节点类型）的版本
+    template <class U>
+    struct rebind
+    {
+        typedef allocator<U> other;
+    };
+
 public:
     static T* allocate();
     static T* allocate(size_type n);
@@ -43,13 +60,17 @@ public:
 template <class T>
 T* allocator<T>::allocate()
 {
-    return static_cast<T*>(::operator new(sizeof(T)));
+    T* ptr = static_cast<T*>(::operator new(sizeof(T)));
+    CTSTL_RECORD_ALLOCATE(T, sizeof(T));  // 分配成功之后才记录
+    return ptr;
 }
 
 template <class T>
 T* allocator<T>::allocate(size_type n)
 {
-    return static_cast<T*>(::operator new(n * sizeof(T)));
+    T* ptr = static_cast<T*>(::operator new(n * sizeof(T)));
+    CTSTL_RECORD_ALLOCATE(T, n * sizeof(T));
+    return ptr;
 }
 
 template <class T>
@@ -57,14 +78,16 @@ void allocator<T>::deallocate(T* ptr)
 {
     if (ptr == nullptr)
         return;
+    CTSTL_RECORD_DEALLOCATE(T, sizeof(T));
     ::operator delete(ptr);
 }
 
 template <class T>
-void allocator<T>::deallocate(T* ptr, size_type /*size*/)
+void allocator<T>::deallocate(T* ptr, size_type n)
 {
     if (ptr == nullptr) 
         return;
+    CTSTL_RECORD_DEALLOCATE(T, n * sizeof(T));
     ::operator delete(ptr);
 }
 
@@ -105,5 +128,46 @@ void allocator<T>::destroy(T* first, T* last)
     ctstl::destroy(first, last);
 }
 
+// 由配置器 a 得到另一个配置器 Other（通常是 rebind 得到的其它类型的版本）
+// 有状态的配置器（比如 polymorphic_allocator）通过转换构造函数把状态传递过去，只有静态接口的配置器直接默认构造
+template <class Other, class Alloc>
+Other rebind_allocator(const Alloc& a, std::true_type)
+{
+    return Other(a);
+}
+
+template <class Other, class Alloc>
+Other rebind_allocator(const Alloc&, std::false_type)
+{
+    return Other();
+}
+
+template <class Other, class Alloc>
+Other rebind_allocator(const Alloc& a)
+{
+    return ctstl::rebind_allocator<Other>(a, std::is_constructible<Other, const Alloc&>{});
+}
+
+// 两个配置器能否释放彼此分配的空间
+// 只有静态接口的配置器（空类）总是相等，有状态的配置器（比如 polymorphic_allocator）用 operator== 比较
+// 容器的移动赋值、swap 不会改变自身的配置器，只有配置器相等时才能直接接管对方的空间
+template <class Alloc>
+bool allocator_equal(const Alloc&, const Alloc&, std::true_type) noexcept
+{
+    return true;
+}
+
+template <class Alloc>
+bool allocator_equal(const Alloc& lhs, const Alloc& rhs, std::false_type) noexcept
+{
+    return lhs == rhs;
+}
+
+template <class Alloc>
+bool allocator_equal(const Alloc& lhs, const Alloc& rhs) noexcept
+{
+    return ctstl::allocator_equal(lhs, rhs, std::is_empty<Alloc>{});
+}
+
 } // !CTSTL_ALLOCATOR_H_
 #endif 
\ No newline at end of file
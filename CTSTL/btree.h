@@ -0,0 +1,1127 @@
+#ifndef CTSTL_BTREE_H_
+#define CTSTL_BTREE_H_
+
+// 这个头文件包含一个模板类 btree，作为 btree_map / btree_set 的底层
+//
+// 1. 结构
+// 每个节点保存多个有序的元素，节点大小约为 EBtreeNodeBytes（几个缓存行），查找时在节点内二分，
+// 树高只有红黑树的几分之一，同一节点内的元素在内存中连续，顺序遍历几乎不会缓存未命中
+// 叶节点没有孩子数组，内部节点在叶节点的布局之后附加 ENodeSlots + 1 个孩子指针
+// 元素以可修改的 slot 类型保存（btree_map 中为 pair<Key, T>），在节点之间搬动时可以直接移动键值，
+// 对外总是以 value_type（pair<const Key, T>）的形式出现
+//
+// 2. 插入
+// 总是插入到叶节点，节点满时分裂，中间的元素上移到父节点，父节点满时先分裂父节点
+// 分裂点偏向插入的位置：在节点末尾插入时旧节点几乎保持全满，因此顺序插入得到的节点接近全满，
+// 配合插入位置提示（hint），有序输入的插入是均摊 O(1) 的，从有序序列构造只需 O(n)
+//
+// 3. 删除
+// 内部节点中的元素先用它的前驱（位于叶节点）替换，再从叶节点删除
+// 节点元素少于一半时与相邻的兄弟合并，合并不下时从较满的兄弟借一部分元素
+//
+// 插入、删除会使迭代器失效；元素的移动构造、移动赋值不应抛出异常
+
+#include <initializer_list>
+#include <type_traits>
+
+#include "iterator.h"
+#include "memory.h"
+#include "functional.h"
+#include "util.h"
+#include "exceptdef.h"
+
+namespace ctstl
+{
+
+// 节点的目标大小
+enum { EBtreeNodeBytes = 256 };
+
+// 每个节点的元素个数：填满 EBtreeNodeBytes，至少 3 个，最多 255 个（计数为一个字节）
+template <class Slot>
+struct btree_node_slots
+{
+    static constexpr size_t bytes = EBtreeNodeBytes - sizeof(void*) - 4;
+    static constexpr size_t value = bytes / sizeof(Slot) < 3 ? 3
+                                  : bytes / sizeof(Slot) > 255 ? 255
+                                  : bytes / sizeof(Slot);
+};
+
+template <class Slot, size_t N>
+struct btree_internal_node;
+
+// 节点，叶节点只分配到这里为止
+template <class Slot, size_t N>
+struct btree_node
+{
+    typedef btree_internal_node<Slot, N> internal_node;
+
+    btree_node*    parent;    // 根节点的 parent 为 nullptr
+    unsigned char  position;  // 是父节点的第几个孩子
+    unsigned char  count;     // 元素个数
+    bool           leaf;
+    typename std::aligned_storage<sizeof(Slot), alignof(Slot)>::type slots[N];
+
+    Slot*       slot(int i) noexcept       { return reinterpret_cast<Slot*>(slots + i); }
+    const Slot* slot(int i) const noexcept { return reinterpret_cast<const Slot*>(slots + i); }
+
+    btree_node*& child(int i) noexcept
+    { return static_cast<internal_node*>(this)->children[i]; }
+    btree_node*  child(int i) const noexcept
+    { return static_cast<const internal_node*>(this)->children[i]; }
+
+    // 第 i 个孩子放入 c，并更新 c 的 parent 与 position
+    void set_child(int i, btree_node* c) noexcept
+    {
+        child(i) = c;
+        c->parent = this;
+        c->position = static_cast<unsigned char>(i);
+    }
+};
+
+// 内部节点
+template <class Slot, size_t N>
+struct btree_internal_node : public btree_node<Slot, N>
+{
+    btree_node<Slot, N>* children[N + 1];
+};
+
+// btree 的迭代器，end() 位于最右叶节点的最后一个元素之后
+template <class Node, class T, class Ref, class Ptr>
+struct btree_iterator : public iterator<bidirectional_iterator_tag, T, ptrdiff_t, Ptr, Ref>
+{
+    typedef btree_iterator<Node, T, T&, T*>             iterator;
+    typedef btree_iterator<Node, T, const T&, const T*> const_iterator;
+    typedef btree_iterator                              self;
+
+    typedef T            value_type;
+    typedef Ptr          pointer;
+    typedef Ref          reference;
+
+    Node* node;
+    int   position;
+
+    btree_iterator() noexcept : node(nullptr), position(0) {}
+    btree_iterator(Node* n, int pos) noexcept : node(n), position(pos) {}
+    btree_iterator(const iterator& rhs) noexcept : node(rhs.node), position(rhs.position) {}
+
+    self& operator=(const iterator& rhs) noexcept
+    {
+        node = rhs.node;
+        position = rhs.position;
+        return *this;
+    }
+
+    reference operator*()  const { return *reinterpret_cast<T*>(node->slot(position)); }
+    pointer   operator->() const { return ctstl::address_of(operator*()); }
+
+    self& operator++()
+    {
+        if (node->leaf && ++position < node->count)
+            return *this;
+        increment_slow();
+        return *this;
+    }
+    self operator++(int)
+    {
+        self tmp = *this;
+        ++*this;
+        return tmp;
+    }
+
+    self& operator--()
+    {
+        if (node->leaf && --position >= 0)
+            return *this;
+        decrement_slow();
+        return *this;
+    }
+    self operator--(int)
+    {
+        self tmp = *this;
+        --*this;
+        return tmp;
+    }
+
+    bool operator==(const self& rhs) const { return node == rhs.node && position == rhs.position; }
+    bool operator!=(const self& rhs) const { return !(*this == rhs); }
+
+    // 叶节点中 position 已经走到 count，或者位于内部节点
+    void increment_slow() noexcept
+    {
+        if (node->leaf)
+        {
+            const self save = *this;
+            while (position == node->count && node->parent != nullptr)
+            {
+                position = node->position;
+                node = node->parent;
+            }
+            if (position == node->count)  // 已经是最后一个元素，回到 end()
+                *this = save;
+        }
+        else
+        {
+            node = node->child(position + 1);
+            while (!node->leaf)
+                node = node->child(0);
+            position = 0;
+        }
+    }
+
+    // 叶节点中 position 已经走到 -1，或者位于内部节点
+    void decrement_slow() noexcept
+    {
+        if (node->leaf)
+        {
+            const self save = *this;
+            while (position < 0 && node->parent != nullptr)
+            {
+                position = node->position - 1;
+                node = node->parent;
+            }
+            if (position < 0)
+                *this = save;
+        }
+        else
+        {
+            node = node->child(position);
+            while (!node->leaf)
+                node = node->child(node->count);
+            position = node->count - 1;
+        }
+    }
+};
+
+// 模板类 btree
+// Value 为元素类型，KeyOfValue 从元素中取出 Key，Compare 为键值比较方式
+// Slot 为元素实际保存的类型，必须与 Value 布局相同，并且可以由 Value 构造
+template <class Value, class Key, class KeyOfValue, class Compare, class Alloc, class Slot = Value>
+class btree
+{
+public:
+    typedef Value                                          value_type;
+    typedef Key                                            key_type;
+    typedef Compare                                        key_compare;
+    typedef Alloc                                          allocator_type;
+
+    typedef value_type*                                    pointer;
+    typedef const value_type*                              const_pointer;
+    typedef value_type&                                    reference;
+    typedef const value_type&                              const_reference;
+    typedef size_t                                         size_type;
+    typedef ptrdiff_t                                      difference_type;
+
+private:
+    typedef Slot                                           slot_type;
+
+    enum { ENodeSlots = btree_node_slots<Slot>::value };
+    enum { EMinSlots = ENodeSlots / 2 };  // 删除后少于这个数时合并或借元素
+
+    typedef btree_node<Slot, ENodeSlots>                   node_type;
+    typedef btree_internal_node<Slot, ENodeSlots>          internal_type;
+
+    typedef typename Alloc::template rebind<node_type>::other      leaf_allocator_type;
+    typedef typename Alloc::template rebind<internal_type>::other  internal_allocator_type;
+
+public:
+    typedef btree_iterator<node_type, Value, Value&, Value*>             iterator;
+    typedef btree_iterator<node_type, Value, const Value&, const Value*> const_iterator;
+    typedef ctstl::reverse_iterator<iterator>                            reverse_iterator;
+    typedef ctstl::reverse_iterator<const_iterator>                      const_reverse_iterator;
+
+    allocator_type get_allocator() const { return size_.first(); }
+
+private:
+    node_type*                                  root_;
+    node_type*                                  leftmost_;   // begin() 所在的叶节点
+    node_type*                                  rightmost_;  // end() 所在的叶节点
+    key_compare                                 comp_;
+    compressed_pair<allocator_type, size_type>  size_;       // 配置器，以及元素个数
+
+public:
+    // 构造、复制、移动、析构函数
+    explicit btree(const key_compare& comp = key_compare(),
+                   const allocator_type& a = allocator_type())
+        : root_(nullptr), leftmost_(nullptr), rightmost_(nullptr), comp_(comp), size_(a, 0) {}
+
+    btree(const btree& rhs)
+        : root_(nullptr), leftmost_(nullptr), rightmost_(nullptr),
+          comp_(rhs.comp_), size_(rhs.size_.first(), 0)
+    {
+        try
+        {
+            for (const_iterator it = rhs.begin(); it != rhs.end(); ++it)
+                append_back(*it);
+        }
+        catch (...)
+        {
+            clear();
+            throw;
+        }
+    }
+
+    btree(btree&& rhs) noexcept
+        : root_(rhs.root_), leftmost_(rhs.leftmost_), rightmost_(rhs.rightmost_),
+          comp_(ctstl::move(rhs.comp_)),
+          size_(ctstl::move(rhs.size_.first()), rhs.size_.second())
+    {
+        rhs.root_ = rhs.leftmost_ = rhs.rightmost_ = nullptr;
+        rhs.size_.second() = 0;
+    }
+
+    // 赋值时配置器保持不变，临时的 btree 使用自己的配置器
+    btree& operator=(const btree& rhs)
+    {
+        if (this != &rhs)
+        {
+            btree tmp(rhs.comp_, get_allocator());
+            for (const_iterator it = rhs.begin(); it != rhs.end(); ++it)
+                tmp.append_back(*it);
+            swap(tmp);
+        }
+        return *this;
+    }
+
+    // 与 rhs 的配置器相等时直接接管 rhs 的节点，否则逐个移动元素
+    btree& operator=(btree&& rhs) noexcept(std::is_empty<Alloc>::value)
+    {
+        if (this == &rhs)
+            return *this;
+        if (ctstl::allocator_equal(size_.first(), rhs.size_.first()))
+        {
+            btree tmp(ctstl::move(rhs));
+            swap(tmp);
+        }
+        else
+        {
+            btree tmp(rhs.comp_, get_allocator());
+            for (iterator it = rhs.begin(); it != rhs.end(); ++it)
+                tmp.append_back(ctstl::move(*it));
+            swap(tmp);
+            rhs.clear();
+        }
+        return *this;
+    }
+
+    ~btree()
+    {
+        clear();
+    }
+
+    // 迭代器相关操作
+    iterator       begin()         noexcept { return iterator(leftmost_, 0); }
+    const_iterator begin()   const noexcept { return const_iterator(leftmost_, 0); }
+    iterator       end()           noexcept
+    { return iterator(rightmost_, rightmost_ != nullptr ? rightmost_->count : 0); }
+    const_iterator end()     const noexcept
+    { return const_iterator(rightmost_, rightmost_ != nullptr ? rightmost_->count : 0); }
+
+    reverse_iterator       rbegin()        noexcept { return reverse_iterator(end()); }
+    const_reverse_iterator rbegin()  const noexcept { return const_reverse_iterator(end()); }
+    reverse_iterator       rend()          noexcept { return reverse_iterator(begin()); }
+    const_reverse_iterator rend()    const noexcept { return const_reverse_iterator(begin()); }
+
+    const_iterator         cbegin()  const noexcept { return begin(); }
+    const_iterator         cend()    const noexcept { return end(); }
+    const_reverse_iterator crbegin() const noexcept { return rbegin(); }
+    const_reverse_iterator crend()   const noexcept { return rend(); }
+
+    // 容量相关操作
+    bool      empty()    const noexcept { return size() == 0; }
+    size_type size()     const noexcept { return size_.second(); }
+    size_type max_size() const noexcept { return static_cast<size_type>(-1) / sizeof(value_type); }
+
+    // 修改容器相关操作
+
+    template <class ...Args>
+    ctstl::pair<iterator, bool> emplace_unique(Args&& ...args);
+
+    template <class ...Args>
+    iterator emplace_unique_hint(const_iterator hint, Args&& ...args)
+    {
+        slot_type tmp(ctstl::forward<Args>(args)...);
+        return insert_unique_hint(hint, ctstl::move(tmp));
+    }
+
+    ctstl::pair<iterator, bool> insert_unique(const value_type& value)
+    { return insert_unique_impl(value); }
+    ctstl::pair<iterator, bool> insert_unique(value_type&& value)
+    { return insert_unique_impl(ctstl::move(value)); }
+
+    iterator insert_unique(const_iterator hint, const value_type& value)
+    { return insert_unique_hint(hint, value); }
+    iterator insert_unique(const_iterator hint, value_type&& value)
+    { return insert_unique_hint(hint, ctstl::move(value)); }
+
+    // 以 end() 为提示逐个插入，输入有序时为 O(n)
+    template <class IIter>
+    void insert_unique(IIter first, IIter last)
+    {
+        for (; first != last; ++first)
+            insert_unique_hint(cend(), *first);
+    }
+
+    // [first, last) 必须严格递增，直接依次放到末尾，不做任何比较
+    template <class IIter>
+    void assign_sorted_unique(IIter first, IIter last)
+    {
+        clear();
+        for (; first != last; ++first)
+        {
+            CTSTL_DEBUG(empty() || comp_(key_of(*rbegin()), key_of(*first)));
+            append_back(*first);
+        }
+    }
+
+    // 查找 key，找不到时返回应该插入的位置（总是位于叶节点），以及是否已经存在
+    // 插入位置需要紧接着用 emplace_at 构造元素
+    template <class K>
+    ctstl::pair<iterator, bool> find_or_prepare_insert(const K& key);
+
+    template <class ...Args>
+    iterator emplace_at(iterator pos, Args&& ...args)
+    {
+        slot_type tmp(ctstl::forward<Args>(args)...);
+        return insert_at(pos, ctstl::move(tmp));
+    }
+
+    // erase / clear
+    iterator  erase(const_iterator pos);
+    iterator  erase(const_iterator first, const_iterator last);
+    template <class K>
+    size_type erase_unique(const K& key);
+    void      clear() noexcept;
+
+    void      swap(btree& rhs) noexcept;
+
+    // 查找相关操作
+    template <class K>
+    iterator find(const K& key)
+    {
+        if (root_ == nullptr)
+            return end();
+        const ctstl::pair<iterator, bool> res = locate(key);
+        return res.second ? res.first : end();
+    }
+    template <class K>
+    const_iterator find(const K& key) const
+    {
+        return const_cast<btree*>(this)->find(key);
+    }
+
+    template <class K>
+    size_type count_unique(const K& key) const
+    {
+        return root_ != nullptr && const_cast<btree*>(this)->locate(key).second ? 1 : 0;
+    }
+
+    template <class K>
+    iterator lower_bound(const K& key)
+    { return internal_bound(key, false); }
+    template <class K>
+    const_iterator lower_bound(const K& key) const
+    { return const_cast<btree*>(this)->internal_bound(key, false); }
+
+    template <class K>
+    iterator upper_bound(const K& key)
+    { return internal_bound(key, true); }
+    template <class K>
+    const_iterator upper_bound(const K& key) const
+    { return const_cast<btree*>(this)->internal_bound(key, true); }
+
+    template <class K>
+    ctstl::pair<iterator, iterator> equal_range_unique(const K& key)
+    {
+        iterator it = lower_bound(key);
+        if (it != end() && !comp_(key, key_of(*it)))
+        {
+            iterator next = it;
+            return ctstl::pair<iterator, iterator>(it, ++next);
+        }
+        return ctstl::pair<iterator, iterator>(it, it);
+    }
+    template <class K>
+    ctstl::pair<const_iterator, const_iterator> equal_range_unique(const K& key) const
+    {
+        const ctstl::pair<iterator, iterator> res = const_cast<btree*>(this)->equal_range_unique(key);
+        return ctstl::pair<const_iterator, const_iterator>(res.first, res.second);
+    }
+
+    key_compare key_comp() const { return comp_; }
+
+    // 树高，空树为 0
+    size_type height() const noexcept
+    {
+        size_type h = 0;
+        for (const node_type* n = root_; n != nullptr; n = n->leaf ? nullptr : n->child(0))
+            ++h;
+        return h;
+    }
+
+private:
+    // helper functions
+
+    leaf_allocator_type leaf_allocator() const
+    {
+        return ctstl::rebind_allocator<leaf_allocator_type>(size_.first());
+    }
+
+    internal_allocator_type internal_allocator() const
+    {
+        return ctstl::rebind_allocator<internal_allocator_type>(size_.first());
+    }
+
+    const key_type& key_of(const value_type& value) const
+    {
+        return KeyOfValue()(value);
+    }
+
+    const key_type& key_of(const node_type* n, int i) const
+    {
+        return KeyOfValue()(*reinterpret_cast<const value_type*>(n->slot(i)));
+    }
+
+    // node
+    node_type* create_node(bool leaf);
+    void       destroy_node(node_type* n) noexcept;
+    void       destroy_subtree(node_type* n) noexcept;
+
+    // 节点内查找：第一个不小于 / 大于 key 的位置
+    template <class K>
+    int node_lower_bound(const node_type* n, const K& key) const;
+    template <class K>
+    int node_upper_bound(const node_type* n, const K& key) const;
+
+    template <class K>
+    ctstl::pair<iterator, bool> locate(const K& key);
+    template <class K>
+    iterator internal_bound(const K& key, bool upper);
+    iterator internal_end(iterator it) noexcept;
+
+    // insert
+    template <class V>
+    ctstl::pair<iterator, bool> insert_unique_impl(V&& value);
+    template <class V>
+    iterator insert_unique_hint(const_iterator hint, V&& value);
+    template <class V>
+    iterator append_back(V&& value)
+    {
+        slot_type tmp(ctstl::forward<V>(value));
+        return insert_at(end(), ctstl::move(tmp));
+    }
+    iterator insert_at(iterator pos, slot_type&& value);
+    void     split(node_type*& n, int& pos);
+
+    // 节点内的元素搬动，都不抛出异常
+    static void insert_slot(node_type* n, int pos, slot_type&& value) noexcept;
+    static void erase_slot(node_type* n, int pos) noexcept;
+
+    // erase
+    void merge_nodes(node_type* left, node_type* right) noexcept;
+    void rebalance_left_to_right(node_type* left, node_type* right, iterator& it) noexcept;
+    void rebalance_right_to_left(node_type* left, node_type* right, iterator& it) noexcept;
+    void rebalance_after_erase(iterator& it) noexcept;
+};
+
+/*****************************************************************************************/
+
+template <class Value, class Key, class KeyOfValue, class Compare, class Alloc, class Slot>
+template <class ...Args>
+ctstl::pair<typename btree<Value, Key, KeyOfValue, Compare, Alloc, Slot>::iterator, bool>
+btree<Value, Key, KeyOfValue, Compare, Alloc, Slot>::emplace_unique(Args&& ...args)
+{
+    slot_type tmp(ctstl::forward<Args>(args)...);
+    if (root_ == nullptr)
+        return ctstl::pair<iterator, bool>(insert_at(end(), ctstl::move(tmp)), true);
+    const ctstl::pair<iterator, bool> res = locate(key_of(*reinterpret_cast<value_type*>(&tmp)));
+    if (res.second)
+        return ctstl::pair<iterator, bool>(res.first, false);
+    return ctstl::pair<iterator, bool>(insert_at(res.first, ctstl::move(tmp)), true);
+}
+
+template <class Value, class Key, class KeyOfValue, class Compare, class Alloc, class Slot>
+template <class K>
+ctstl::pair<typename btree<Value, Key, KeyOfValue, Compare, Alloc, Slot>::iterator, bool>
+btree<Value, Key, KeyOfValue, Compare, Alloc, Slot>::find_or_prepare_insert(const K& key)
+{
+    if (root_ == nullptr)
+        return ctstl::pair<iterator, bool>(end(), false);
+    return locate(key);
+}
+
+// 删除 pos 处的元素，返回下一个元素
+template <class Value, class Key, class KeyOfValue, class Compare, class Alloc, class Slot>
+typename btree<Value, Key, KeyOfValue, Compare, Alloc, Slot>::iterator
+btree<Value, Key, KeyOfValue, Compare, Alloc, Slot>::erase(const_iterator pos)
+{
+    CTSTL_DEBUG(pos != cend());
+    iterator it(pos.node, pos.position);
+    const bool internal_delete = !it.node->leaf;
+    if (internal_delete)
+    {   // 用前驱替换，再删除前驱
+        iterator pred = it;
+        --pred;
+        *it.node->slot(it.position) = ctstl::move(*pred.node->slot(pred.position));
+        it = pred;
+    }
+    erase_slot(it.node, it.position);
+    --size_.second();
+    rebalance_after_erase(it);
+    it = internal_end(it);
+    if (internal_delete)  // it 现在指向替换上去的前驱
+        ++it;
+    return it;
+}
+
+template <class Value, class Key, class KeyOfValue, class Compare, class Alloc, class Slot>
+typename btree<Value, Key, KeyOfValue, Compare, Alloc, Slot>::iterator
+btree<Value, Key, KeyOfValue, Compare, Alloc, Slot>::
+erase(const_iterator first, const_iterator last)
+{
+    if (first == cbegin() && last == cend())
+    {
+        clear();
+        return end();
+    }
+    // 每次删除都可能搬动元素，用剩余个数而不是 last 来控制循环
+    size_type n = 0;
+    for (const_iterator it = first; it != last; ++it)
+        ++n;
+    iterator it(first.node, first.position);
+    for (; n > 0; --n)
+        it = erase(it);
+    return it;
+}
+
+template <class Value, class Key, class KeyOfValue, class Compare, class Alloc, class Slot>
+template <class K>
+typename btree<Value, Key, KeyOfValue, Compare, Alloc, Slot>::size_type
+btree<Value, Key, KeyOfValue, Compare, Alloc, Slot>::erase_unique(const K& key)
+{
+    iterator it = find(key);
+    if (it == end())
+        return 0;
+    erase(it);
+    return 1;
+}
+
+template <class Value, class Key, class KeyOfValue, class Compare, class Alloc, class Slot>
+void btree<Value, Key, KeyOfValue, Compare, Alloc, Slot>::clear() noexcept
+{
+    if (root_ != nullptr)
+    {
+        destroy_subtree(root_);
+        root_ = leftmost_ = rightmost_ = nullptr;
+        size_.second() = 0;
+    }
+}
+
+template <class Value, class Key, class KeyOfValue, class Compare, class Alloc, class Slot>
+void btree<Value, Key, KeyOfValue, Compare, Alloc, Slot>::swap(btree& rhs) noexcept
+{
+    if (this != &rhs)
+    {
+        CTSTL_DEBUG(ctstl::allocator_equal(size_.first(), rhs.size_.first()));
+        ctstl::swap(root_, rhs.root_);
+        ctstl::swap(leftmost_, rhs.leftmost_);
+        ctstl::swap(rightmost_, rhs.rightmost_);
+        ctstl::swap(comp_, rhs.comp_);
+        ctstl::swap(size_.second(), rhs.size_.second());
+    }
+}
+
+/*****************************************************************************************/
+// helper function
+
+template <class Value, class Key, class KeyOfValue, class Compare, class Alloc, class Slot>
+typename btree<Value, Key, KeyOfValue, Compare, Alloc, Slot>::node_type*
+btree<Value, Key, KeyOfValue, Compare, Alloc, Slot>::create_node(bool leaf)
+{
+    node_type* n = leaf
+        ? leaf_allocator().allocate(1)
+        : static_cast<node_type*>(internal_allocator().allocate(1));
+    n->parent = nullptr;
+    n->position = 0;
+    n->count = 0;
+    n->leaf = leaf;
+    return n;
+}
+
+template <class Value, class Key, class KeyOfValue, class Compare, class Alloc, class Slot>
+void btree<Value, Key, KeyOfValue, Compare, Alloc, Slot>::destroy_node(node_type* n) noexcept
+{
+    if (n->leaf)
+        leaf_allocator().deallocate(n, 1);
+    else
+        internal_allocator().deallocate(static_cast<internal_type*>(n), 1);
+}
+
+template <class Value, class Key, class KeyOfValue, class Compare, class Alloc, class Slot>
+void btree<Value, Key, KeyOfValue, Compare, Alloc, Slot>::destroy_subtree(node_type* n) noexcept
+{
+    if (!n->leaf)
+    {
+        for (int i = 0; i <= n->count; ++i)
+            destroy_subtree(n->child(i));
+    }
+    for (int i = 0; i < n->count; ++i)
+        ctstl::destroy(n->slot(i));
+    destroy_node(n);
+}
+
+template <class Value, class Key, class KeyOfValue, class Compare, class Alloc, class Slot>
+template <class K>
+int btree<Value, Key, KeyOfValue, Compare, Alloc, Slot>::
+node_lower_bound(const node_type* n, const K& key) const
+{
+    int first = 0, len = n->count;
+    while (len > 0)
+    {
+        const int half = len >> 1;
+        if (comp_(key_of(n, first + half), key))
+        {
+            first += half + 1;
+            len -= half + 1;
+        }
+        else
+        {
+            len = half;
+        }
+    }
+    return first;
+}
+
+template <class Value, class Key, class KeyOfValue, class Compare, class Alloc, class Slot>
+template <class K>
+int btree<Value, Key, KeyOfValue, Compare, Alloc, Slot>::
+node_upper_bound(const node_type* n, const K& key) const
+{
+    int first = 0, len = n->count;
+    while (len > 0)
+    {
+        const int half = len >> 1;
+        if (!comp_(key, key_of(n, first + half)))
+        {
+            first += half + 1;
+            len -= half + 1;
+        }
+        else
+        {
+            len = half;
+        }
+    }
+    return first;
+}
+
+// 自根向下查找 key，找到时返回它的位置，否则返回叶节点中的插入位置，树不能为空
+template <class Value, class Key, class KeyOfValue, class Compare, class Alloc, class Slot>
+template <class K>
+ctstl::pair<typename btree<Value, Key, KeyOfValue, Compare, Alloc, Slot>::iterator, bool>
+btree<Value, Key, KeyOfValue, Compare, Alloc, Slot>::locate(const K& key)
+{
+    node_type* n = root_;
+    for (;;)
+    {
+        const int pos = node_lower_bound(n, key);
+        if (pos < n->count && !comp_(key, key_of(n, pos)))
+            return ctstl::pair<iterator, bool>(iterator(n, pos), true);
+        if (n->leaf)
+            return ctstl::pair<iterator, bool>(iterator(n, pos), false);
+        n = n->child(pos);
+    }
+}
+
+template <class Value, class Key, class KeyOfValue, class Compare, class Alloc, class Slot>
+template <class K>
+typename btree<Value, Key, KeyOfValue, Compare, Alloc, Slot>::iterator
+btree<Value, Key, KeyOfValue, Compare, Alloc, Slot>::internal_bound(const K& key, bool upper)
+{
+    if (root_ == nullptr)
+        return end();
+    node_type* n = root_;
+    for (;;)
+    {
+        const int pos = upper ? node_upper_bound(n, key) : node_lower_bound(n, key);
+        if (n->leaf)
+            return internal_end(iterator(n, pos));
+        n = n->child(pos);
+    }
+}
+
+// 把位于节点末尾之后的位置调整为下一个元素，没有下一个元素时为 end()
+template <class Value, class Key, class KeyOfValue, class Compare, class Alloc, class Slot>
+typename btree<Value, Key, KeyOfValue, Compare, Alloc, Slot>::iterator
+btree<Value, Key, KeyOfValue, Compare, Alloc, Slot>::internal_end(iterator it) noexcept
+{
+    if (it.node == nullptr)
+        return end();
+    while (it.position == it.node->count && it.node->parent != nullptr)
+    {
+        it.position = it.node->position;
+        it.node = it.node->parent;
+    }
+    return it.position == it.node->count ? end() : it;
+}
+
+template <class Value, class Key, class KeyOfValue, class Compare, class Alloc, class Slot>
+template <class V>
+ctstl::pair<typename btree<Value, Key, KeyOfValue, Compare, Alloc, Slot>::iterator, bool>
+btree<Value, Key, KeyOfValue, Compare, Alloc, Slot>::insert_unique_impl(V&& value)
+{
+    if (root_ == nullptr)
+        return ctstl::pair<iterator, bool>(append_back(ctstl::forward<V>(value)), true);
+    const ctstl::pair<iterator, bool> res = locate(key_of(value));
+    if (res.second)
+        return ctstl::pair<iterator, bool>(res.first, false);
+    return ctstl::pair<iterator, bool>(emplace_at(res.first, ctstl::forward<V>(value)), true);
+}
+
+// hint 正好是插入位置时不需要从根查找
+template <class Value, class Key, class KeyOfValue, class Compare, class Alloc, class Slot>
+template <class V>
+typename btree<Value, Key, KeyOfValue, Compare, Alloc, Slot>::iterator
+btree<Value, Key, KeyOfValue, Compare, Alloc, Slot>::
+insert_unique_hint(const_iterator hint, V&& value)
+{
+    if (root_ != nullptr)
+    {
+        const key_type& key = key_of(*reinterpret_cast<const value_type*>(ctstl::address_of(value)));
+        iterator pos(hint.node, hint.position);
+        if (pos == end() || comp_(key, key_of(*pos)))
+        {
+            iterator prev = pos;
+            if (pos == begin() || comp_(key_of(*--prev), key))
+                return emplace_at(pos, ctstl::forward<V>(value));
+        }
+        else if (comp_(key_of(*pos), key))
+        {
+            iterator next = pos;
+            ++next;
+            if (next == end() || comp_(key, key_of(*next)))
+                return emplace_at(next, ctstl::forward<V>(value));
+        }
+        else
+        {   // 与 hint 处的元素相等
+            return pos;
+        }
+    }
+    return insert_unique_impl(ctstl::forward<V>(value)).first;
+}
+
+// 在 pos 之前插入 value，pos 位于内部节点时改为插入到前驱所在叶节点的末尾
+template <class Value, class Key, class KeyOfValue, class Compare, class Alloc, class Slot>
+typename btree<Value, Key, KeyOfValue, Compare, Alloc, Slot>::iterator
+btree<Value, Key, KeyOfValue, Compare, Alloc, Slot>::insert_at(iterator pos, slot_type&& value)
+{
+    if (root_ == nullptr)
+    {
+        root_ = leftmost_ = rightmost_ = create_node(true);
+        pos = iterator(root_, 0);
+    }
+    node_type* n = pos.node;
+    int p = pos.position;
+    if (!n->leaf)
+    {
+        --pos;
+        n = pos.node;
+        p = pos.position + 1;
+    }
+    if (n->count == ENodeSlots)
+        split(n, p);
+    insert_slot(n, p, ctstl::move(value));
+    ++size_.second();
+    return iterator(n, p);
+}
+
+// 分裂已满的节点 n，分裂后 n 与 pos 指向插入位置所在的节点与位置
+template <class Value, class Key, class KeyOfValue, class Compare, class Alloc, class Slot>
+void btree<Value, Key, KeyOfValue, Compare, Alloc, Slot>::split(node_type*& n, int& pos)
+{
+    node_type* sibling = create_node(n->leaf);
+    try
+    {   // 保证父节点还有空位
+        if (n->parent == nullptr)
+        {
+            node_type* root = create_node(false);
+            root->set_child(0, n);
+            root_ = root;
+        }
+        else if (n->parent->count == ENodeSlots)
+        {
+            node_type* parent = n->parent;
+            int ppos = n->position;
+            split(parent, ppos);
+        }
+    }
+    catch (...)
+    {
+        destroy_node(sibling);
+        throw;
+    }
+
+    // 在开头插入时右边几乎全满，在末尾插入时左边几乎全满，否则平分
+    const int count = n->count;
+    const int to_move = pos == 0 ? count - 1 : pos == count ? 0 : count / 2;
+    const int left = count - to_move - 1;
+
+    for (int i = 0; i < to_move; ++i)
+    {
+        ctstl::construct(sibling->slot(i), ctstl::move(*n->slot(left + 1 + i)));
+        ctstl::destroy(n->slot(left + 1 + i));
+    }
+    if (!n->leaf)
+    {
+        for (int i = 0; i <= to_move; ++i)
+            sibling->set_child(i, n->child(left + 1 + i));
+    }
+    sibling->count = static_cast<unsigned char>(to_move);
+
+    // 中间的元素上移到父节点，sibling 成为它右边的孩子
+    node_type* parent = n->parent;
+    const int ppos = n->position;
+    insert_slot(parent, ppos, ctstl::move(*n->slot(left)));
+    ctstl::destroy(n->slot(left));
+    for (int i = parent->count; i > ppos + 1; --i)
+        parent->set_child(i, parent->child(i - 1));
+    parent->set_child(ppos + 1, sibling);
+    n->count = static_cast<unsigned char>(left);
+
+    if (n == rightmost_)
+        rightmost_ = sibling;
+    if (pos > left)
+    {
+        n = sibling;
+        pos -= left + 1;
+    }
+}
+
+template <class Value, class Key, class KeyOfValue, class Compare, class Alloc, class Slot>
+void btree<Value, Key, KeyOfValue, Compare, Alloc, Slot>::
+insert_slot(node_type* n, int pos, slot_type&& value) noexcept
+{
+    const int count = n->count;
+    if (pos == count)
+    {
+        ctstl::construct(n->slot(pos), ctstl::move(value));
+    }
+    else
+    {
+        ctstl::construct(n->slot(count), ctstl::move(*n->slot(count - 1)));
+        for (int i = count - 1; i > pos; --i)
+            *n->slot(i) = ctstl::move(*n->slot(i - 1));
+        *n->slot(pos) = ctstl::move(value);
+    }
+    ++n->count;
+}
+
+template <class Value, class Key, class KeyOfValue, class Compare, class Alloc, class Slot>
+void btree<Value, Key, KeyOfValue, Compare, Alloc, Slot>::
+erase_slot(node_type* n, int pos) noexcept
+{
+    const int count = n->count;
+    for (int i = pos; i + 1 < count; ++i)
+        *n->slot(i) = ctstl::move(*n->slot(i + 1));
+    ctstl::destroy(n->slot(count - 1));
+    --n->count;
+}
+
+// 把 right 以及它们在父节点中的分隔元素并入 left，释放 right
+template <class Value, class Key, class KeyOfValue, class Compare, class Alloc, class Slot>
+void btree<Value, Key, KeyOfValue, Compare, Alloc, Slot>::
+merge_nodes(node_type* left, node_type* right) noexcept
+{
+    node_type* parent = left->parent;
+    const int sep = left->position;
+    const int lcount = left->count;
+    const int rcount = right->count;
+
+    ctstl::construct(left->slot(lcount), ctstl::move(*parent->slot(sep)));
+    for (int i = 0; i < rcount; ++i)
+    {
+        ctstl::construct(left->slot(lcount + 1 + i), ctstl::move(*right->slot(i)));
+        ctstl::destroy(right->slot(i));
+    }
+    if (!left->leaf)
+    {
+        for (int i = 0; i <= rcount; ++i)
+            left->set_child(lcount + 1 + i, right->child(i));
+    }
+    left->count = static_cast<unsigned char>(lcount + 1 + rcount);
+
+    // 从父节点中去掉分隔元素与 right
+    const int pcount = parent->count;
+    erase_slot(parent, sep);
+    for (int i = sep + 1; i < pcount; ++i)
+        parent->set_child(i, parent->child(i + 1));
+
+    if (right == rightmost_)
+        rightmost_ = left;
+    destroy_node(right);
+}
+
+// 把 left 末尾的若干元素经过父节点移给 right
+template <class Value, class Key, class KeyOfValue, class Compare, class Alloc, class Slot>
+void btree<Value, Key, KeyOfValue, Compare, Alloc, Slot>::
+rebalance_left_to_right(node_type* left, node_type* right, iterator& it) noexcept
+{
+    node_type* parent = left->parent;
+    const int sep = left->position;
+    const int lcount = left->count;
+    const int rcount = right->count;
+    const int k = (lcount - rcount) / 2;
+    const int new_lcount = lcount - k;
+
+    // right 中原有的元素后移 k 个位置
+    for (int i = rcount - 1; i >= 0; --i)
+    {
+        if (i + k >= rcount)
+            ctstl::construct(right->slot(i + k), ctstl::move(*right->slot(i)));
+        else
+            *right->slot(i + k) = ctstl::move(*right->slot(i));
+    }
+    // right 开头的 k 个位置依次放入 left[new_lcount + 1, lcount) 与分隔元素
+    for (int i = 0; i < k; ++i)
+    {
+        slot_type& src = i + 1 < k ? *left->slot(new_lcount + 1 + i) : *parent->slot(sep);
+        if (i >= rcount)
+            ctstl::construct(right->slot(i), ctstl::move(src));
+        else
+            *right->slot(i) = ctstl::move(src);
+    }
+    *parent->slot(sep) = ctstl::move(*left->slot(new_lcount));
+    for (int i = new_lcount; i < lcount; ++i)
+        ctstl::destroy(left->slot(i));
+
+    if (!right->leaf)
+    {
+        for (int i = rcount; i >= 0; --i)
+            right->set_child(i + k, right->child(i));
+        for (int i = 0; i < k; ++i)
+            right->set_child(i, left->child(new_lcount + 1 + i));
+    }
+    left->count = static_cast<unsigned char>(new_lcount);
+    right->count = static_cast<unsigned char>(rcount + k);
+
+    if (it.node == right)
+    {
+        it.position += k;
+    }
+    else if (it.node == left && it.position >= new_lcount)
+    {
+        if (it.position == new_lcount)
+            it = iterator(parent, sep);
+        else
+            it = iterator(right, it.position - new_lcount - 1);
+    }
+}
+
+// 把 right 开头的若干元素经过父节点移给 left
+template <class Value, class Key, class KeyOfValue, class Compare, class Alloc, class Slot>
+void btree<Value, Key, KeyOfValue, Compare, Alloc, Slot>::
+rebalance_right_to_left(node_type* left, node_type* right, iterator& it) noexcept
+{
+    node_type* parent = left->parent;
+    const int sep = left->position;
+    const int lcount = left->count;
+    const int rcount = right->count;
+    const int k = (rcount - lcount) / 2;
+
+    ctstl::construct(left->slot(lcount), ctstl::move(*parent->slot(sep)));
+    for (int i = 0; i + 1 < k; ++i)
+        ctstl::construct(left->slot(lcount + 1 + i), ctstl::move(*right->slot(i)));
+    *parent->slot(sep) = ctstl::move(*right->slot(k - 1));
+    for (int i = k; i < rcount; ++i)
+        *right->slot(i - k) = ctstl::move(*right->slot(i));
+    for (int i = rcount - k; i < rcount; ++i)
+        ctstl::destroy(right->slot(i));
+
+    if (!left->leaf)
+    {
+        for (int i = 0; i < k; ++i)
+            left->set_child(lcount + 1 + i, right->child(i));
+        for (int i = k; i <= rcount; ++i)
+            right->set_child(i - k, right->child(i));
+    }
+    left->count = static_cast<unsigned char>(lcount + k);
+    right->count = static_cast<unsigned char>(rcount - k);
+
+    if (it.node == right)
+    {
+        if (it.position >= k)
+            it.position -= k;
+        else if (it.position == k - 1)
+            it = iterator(parent, sep);
+        else
+            it = iterator(left, lcount + 1 + it.position);
+    }
+}
+
+// 删除之后自 it 所在的节点向上修复，it 跟随元素的搬动，仍然指向原来的位置
+template <class Value, class Key, class KeyOfValue, class Compare, class Alloc, class Slot>
+void btree<Value, Key, KeyOfValue, Compare, Alloc, Slot>::
+rebalance_after_erase(iterator& it) noexcept
+{
+    node_type* n = it.node;
+    for (;;)
+    {
+        if (n == root_)
+        {
+            if (n->count == 0)
+            {
+                if (n->leaf)
+                {   // 树已经空了
+                    destroy_node(n);
+                    root_ = leftmost_ = rightmost_ = nullptr;
+                    it = iterator(nullptr, 0);
+                }
+                else
+                {   // 根只剩一个孩子，树高减一
+                    root_ = n->child(0);
+                    root_->parent = nullptr;
+                    root_->position = 0;
+                    destroy_node(n);
+                }
+            }
+            return;
+        }
+        if (n->count >= EMinSlots)
+            return;
+
+        node_type* parent = n->parent;
+        const int pos = n->position;
+        node_type* left = pos > 0 ? parent->child(pos - 1) : nullptr;
+        node_type* right = pos < parent->count ? parent->child(pos + 1) : nullptr;
+
+        if (left != nullptr && left->count + 1 + n->count <= ENodeSlots)
+        {
+            if (it.node == n)
+            {
+                it.node = left;
+                it.position += left->count + 1;
+            }
+            merge_nodes(left, n);
+            n = parent;
+            continue;
+        }
+        if (right != nullptr && n->count + 1 + right->count <= ENodeSlots)
+        {
+            if (it.node == right)
+            {
+                it.node = n;
+                it.position += n->count + 1;
+            }
+            merge_nodes(n, right);
+            n = parent;
+            continue;
+        }
+        // 合并不下，从较满的兄弟借一半差额
+        if (left != nullptr && (right == nullptr || left->count >= right->count))
+            rebalance_left_to_right(left, n, it);
+        else
+            rebalance_right_to_left(n, right, it);
+        return;
+    }
+}
+
+} // namespace ctstl
+#endif // !CTSTL_BTREE_H_
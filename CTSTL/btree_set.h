@@ -0,0 +1,254 @@
+#ifndef CTSTL_BTREE_SET_H_
+#define CTSTL_BTREE_SET_H_
+
+// 这个头文件包含一个模板类 btree_set
+// btree_set : 有序集合，键值不允许重复，底层为 btree，每个节点保存多个元素
+// 与 node 式的红黑树不同，插入、删除会使迭代器和元素的引用失效
+
+#include <initializer_list>
+
+#include "btree.h"
+#include "algobase.h"
+
+namespace ctstl
+{
+
+// 模板类 btree_set
+// 参数一代表键值类型，参数二代表键值比较方式，缺省使用 ctstl::less，参数三代表空间配置器
+template <class Key, class Compare = ctstl::less<Key>, class Alloc = ctstl::allocator<Key>>
+class btree_set
+{
+public:
+    // btree_set 的型别定义
+    typedef Key        key_type;
+    typedef Key        value_type;
+    typedef Compare    key_compare;
+    typedef Compare    value_compare;
+
+private:
+    typedef btree<Key, Key, ctstl::identity<Key>, key_compare, Alloc> base_type;
+    base_type tree_;
+
+public:
+    // 使用 btree 的型别
+    typedef typename base_type::allocator_type          allocator_type;
+    typedef typename base_type::size_type               size_type;
+    typedef typename base_type::difference_type         difference_type;
+    typedef typename base_type::pointer                 pointer;
+    typedef typename base_type::const_pointer           const_pointer;
+    typedef typename base_type::reference               reference;
+    typedef typename base_type::const_reference         const_reference;
+
+    // 元素即键值，不允许通过迭代器修改
+    typedef typename base_type::const_iterator          iterator;
+    typedef typename base_type::const_iterator          const_iterator;
+    typedef typename base_type::const_reverse_iterator  reverse_iterator;
+    typedef typename base_type::const_reverse_iterator  const_reverse_iterator;
+
+    allocator_type get_allocator() const { return tree_.get_allocator(); }
+    key_compare    key_comp()      const { return tree_.key_comp(); }
+    value_compare  value_comp()    const { return tree_.key_comp(); }
+
+public:
+    // 构造、复制、移动函数
+
+    btree_set() = default;
+
+    explicit btree_set(const key_compare& comp, const allocator_type& a = allocator_type())
+        : tree_(comp, a) {}
+
+    template <class InputIterator>
+    btree_set(InputIterator first, InputIterator last,
+              const key_compare& comp = key_compare(),
+              const allocator_type& a = allocator_type())
+        : tree_(comp, a)
+    {
+        tree_.insert_unique(first, last);
+    }
+
+    // 从严格递增的序列构造，O(n)
+    template <class InputIterator>
+    btree_set(sorted_unique_t, InputIterator first, InputIterator last,
+              const key_compare& comp = key_compare(),
+              const allocator_type& a = allocator_type())
+        : tree_(comp, a)
+    {
+        tree_.assign_sorted_unique(first, last);
+    }
+
+    btree_set(std::initializer_list<value_type> ilist,
+              const key_compare& comp = key_compare(),
+              const allocator_type& a = allocator_type())
+        : tree_(comp, a)
+    {
+        tree_.insert_unique(ilist.begin(), ilist.end());
+    }
+
+    btree_set(const btree_set& rhs)
+        : tree_(rhs.tree_) {}
+    btree_set(btree_set&& rhs) noexcept
+        : tree_(ctstl::move(rhs.tree_)) {}
+
+    btree_set& operator=(const btree_set& rhs)
+    {
+        tree_ = rhs.tree_;
+        return *this;
+    }
+    btree_set& operator=(btree_set&& rhs) noexcept(std::is_empty<Alloc>::value)
+    {
+        tree_ = ctstl::move(rhs.tree_);
+        return *this;
+    }
+
+    btree_set& operator=(std::initializer_list<value_type> ilist)
+    {
+        tree_.clear();
+        tree_.insert_unique(ilist.begin(), ilist.end());
+        return *this;
+    }
+
+    ~btree_set() = default;
+
+    // 迭代器相关
+    iterator               begin()   const noexcept { return tree_.begin(); }
+    iterator               end()     const noexcept { return tree_.end(); }
+    reverse_iterator       rbegin()  const noexcept { return tree_.rbegin(); }
+    reverse_iterator       rend()    const noexcept { return tree_.rend(); }
+
+    const_iterator         cbegin()  const noexcept { return tree_.cbegin(); }
+    const_iterator         cend()    const noexcept { return tree_.cend(); }
+    const_reverse_iterator crbegin() const noexcept { return tree_.crbegin(); }
+    const_reverse_iterator crend()   const noexcept { return tree_.crend(); }
+
+    // 容量相关
+    bool      empty()    const noexcept { return tree_.empty(); }
+    size_type size()     const noexcept { return tree_.size(); }
+    size_type max_size() const noexcept { return tree_.max_size(); }
+
+    // 修改容器操作
+
+    // emplace / emplace_hint
+    template <class ...Args>
+    ctstl::pair<iterator, bool> emplace(Args&& ...args)
+    {
+        ctstl::pair<typename base_type::iterator, bool> res = tree_.emplace_unique(ctstl::forward<Args>(args)...);
+        return ctstl::pair<iterator, bool>(res.first, res.second);
+    }
+
+    template <class ...Args>
+    iterator emplace_hint(const_iterator hint, Args&& ...args)
+    { return tree_.emplace_unique_hint(hint, ctstl::forward<Args>(args)...); }
+
+    // insert
+    ctstl::pair<iterator, bool> insert(const value_type& value)
+    {
+        ctstl::pair<typename base_type::iterator, bool> res = tree_.insert_unique(value);
+        return ctstl::pair<iterator, bool>(res.first, res.second);
+    }
+    ctstl::pair<iterator, bool> insert(value_type&& value)
+    {
+        ctstl::pair<typename base_type::iterator, bool> res = tree_.insert_unique(ctstl::move(value));
+        return ctstl::pair<iterator, bool>(res.first, res.second);
+    }
+
+    iterator insert(const_iterator hint, const value_type& value)
+    { return tree_.insert_unique(hint, value); }
+    iterator insert(const_iterator hint, value_type&& value)
+    { return tree_.insert_unique(hint, ctstl::move(value)); }
+
+    template <class InputIterator>
+    void insert(InputIterator first, InputIterator last)
+    { tree_.insert_unique(first, last); }
+
+    void insert(std::initializer_list<value_type> ilist)
+    { tree_.insert_unique(ilist.begin(), ilist.end()); }
+
+    // erase / clear
+    iterator  erase(const_iterator it)
+    { return tree_.erase(it); }
+    iterator  erase(const_iterator first, const_iterator last)
+    { return tree_.erase(first, last); }
+    size_type erase(const key_type& key)
+    { return tree_.erase_unique(key); }
+
+    void      clear() noexcept
+    { tree_.clear(); }
+
+    void      swap(btree_set& other) noexcept
+    { tree_.swap(other.tree_); }
+
+    // 查找相关
+
+    size_type      count(const key_type& key) const
+    { return tree_.count_unique(key); }
+
+    bool           contains(const key_type& key) const
+    { return tree_.count_unique(key) != 0; }
+
+    const_iterator find(const key_type& key) const
+    { return tree_.find(key); }
+
+    const_iterator lower_bound(const key_type& key) const
+    { return tree_.lower_bound(key); }
+
+    const_iterator upper_bound(const key_type& key) const
+    { return tree_.upper_bound(key); }
+
+    ctstl::pair<const_iterator, const_iterator>
+                   equal_range(const key_type& key) const
+    { return tree_.equal_range_unique(key); }
+
+    // 树高，可以用来观察节点的填充程度
+    size_type      height() const noexcept
+    { return tree_.height(); }
+
+public:
+    friend bool operator==(const btree_set& lhs, const btree_set& rhs)
+    {
+        return lhs.size() == rhs.size() && ctstl::equal(lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
+    }
+    friend bool operator<(const btree_set& lhs, const btree_set& rhs)
+    {
+        return ctstl::lexicographical_compare(lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
+    }
+};
+
+// 重载比较操作符
+template <class Key, class Compare, class Alloc>
+bool operator!=(const btree_set<Key, Compare, Alloc>& lhs,
+                const btree_set<Key, Compare, Alloc>& rhs)
+{
+    return !(lhs == rhs);
+}
+
+template <class Key, class Compare, class Alloc>
+bool operator>(const btree_set<Key, Compare, Alloc>& lhs,
+               const btree_set<Key, Compare, Alloc>& rhs)
+{
+    return rhs < lhs;
+}
+
+template <class Key, class Compare, class Alloc>
+bool operator<=(const btree_set<Key, Compare, Alloc>& lhs,
+                const btree_set<Key, Compare, Alloc>& rhs)
+{
+    return !(rhs < lhs);
+}
+
+template <class Key, class Compare, class Alloc>
+bool operator>=(const btree_set<Key, Compare, Alloc>& lhs,
+                const btree_set<Key, Compare, Alloc>& rhs)
+{
+    return !(lhs < rhs);
+}
+
+// 重载 ctstl 的 swap
+template <class Key, class Compare, class Alloc>
+void swap(btree_set<Key, Compare, Alloc>& lhs,
+          btree_set<Key, Compare, Alloc>& rhs) noexcept
+{
+    lhs.swap(rhs);
+}
+
+} // namespace ctstl
+#endif // !CTSTL_BTREE_SET_H_
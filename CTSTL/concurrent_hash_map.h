@@ -0,0 +1,899 @@
+#ifndef CTSTL_CONCURRENT_HASH_MAP_H_
+#define CTSTL_CONCURRENT_HASH_MAP_H_
+
+// 这个头文件包含一个模板类 concurrent_hash_map，可以被多个线程同时读写的哈希映射
+//
+// 1. 结构
+// 链式哈希，桶数总是 2 的幂，并且是锁条带数 EConcurrentStripes 的倍数
+// 桶 i 属于条带 i % EConcurrentStripes，扩容时桶 i 拆分为新表的桶 i 与 i + n，二者仍然属于同一个条带
+//
+// 2. 读
+// 查找不加锁：节点发布之后只有 next 指针会改变，元素本身不再修改，更新实值时换上一个新节点
+// 读者在 epoch_guard 的保护下沿链表查找，找到即返回；没有找到时检查条带的序号，
+// 如果期间这个条带的桶被迁移过（链表被拆分，可能漏掉节点），重新查找
+//
+// 3. 写
+// 插入、删除、更新只锁住 key 所在的条带，摘下的节点放入条带的待回收链表，
+// 等到纪元表明不再有读者持有它时才释放（见 epoch.h）
+//
+// 4. 扩容
+// 某个条带的元素个数超过它所占的桶数时分配一张两倍大小的新表，之后每个写操作顺带迁移 EConcurrentMigrateChunk 个桶，
+// 迁移完的桶置为转发标记，读写遇到转发标记时转到新表；全部迁移完成后新表替换旧表
+// 迁移一个桶只锁住它所在的条带，任何时刻都不会停下全部线程
+//
+// 不提供迭代器：find 返回实值的拷贝，visit 在保护下把元素交给函数对象；size 在有并发写时只是近似值
+// 容器本身不能复制、移动，析构时不能再有其它线程访问
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+
+#include "epoch.h"
+#include "functional.h"
+#include "memory.h"
+#include "util.h"
+#include "exceptdef.h"
+
+namespace ctstl
+{
+
+// 锁条带的个数，必须是 2 的幂
+enum { EConcurrentStripes = 64 };
+
+// 最小的桶数，不小于锁条带的个数
+enum { EConcurrentMinBuckets = EConcurrentStripes };
+
+// 每个写操作顺带迁移的桶数
+enum { EConcurrentMigrateChunk = 16 };
+
+// 每个条带每退休这么多节点，尝试推进一次全局纪元
+enum { EConcurrentAdvanceInterval = 64 };
+
+// 节点
+template <class T>
+struct concurrent_hash_node
+{
+    std::atomic<concurrent_hash_node*> next;
+    size_t                             hash;
+    concurrent_hash_node*              retire_next;  // 待回收链表
+    T                                  value;
+};
+
+// 一张桶数组，扩容时旧表通过 next 指向新表
+template <class T>
+struct concurrent_hash_buckets
+{
+    typedef concurrent_hash_node<T> node;
+
+    size_t                                mask;      // 桶数 - 1
+    std::atomic<node*>*                   buckets;
+    std::atomic<concurrent_hash_buckets*> next;      // 迁移的目标
+    std::atomic<size_t>                   claimed;   // 已经被领取迁移的桶数
+    std::atomic<size_t>                   moved;     // 已经迁移完成的桶数
+    concurrent_hash_buckets*              retire_next;
+    uint64_t                              retire_epoch;
+};
+
+// 模板类 concurrent_hash_map
+// 参数一代表键值类型，参数二代表实值类型，参数三代表哈希函数，参数四代表键值比较方式，参数五代表空间配置器
+template <class Key, class T, class Hash = ctstl::hash<Key>, class KeyEqual = ctstl::equal_to<Key>,
+          class Alloc = ctstl::allocator<ctstl::pair<const Key, T>>>
+class concurrent_hash_map
+{
+public:
+    typedef Key                          key_type;
+    typedef T                            mapped_type;
+    typedef ctstl::pair<const Key, T>    value_type;
+    typedef Hash                         hasher;
+    typedef KeyEqual                     key_equal;
+    typedef Alloc                        allocator_type;
+    typedef size_t                       size_type;
+
+private:
+    typedef concurrent_hash_node<value_type>     node;
+    typedef concurrent_hash_buckets<value_type>  table;
+
+    typedef typename Alloc::template rebind<node>::other                node_allocator_type;
+    typedef typename Alloc::template rebind<table>::other               table_allocator_type;
+    typedef typename Alloc::template rebind<std::atomic<node*>>::other  bucket_allocator_type;
+
+    // 锁条带，待回收的节点按摘下时的纪元分为三代，纪元 e 摘下的节点放入 limbo[e % 3]
+    struct stripe
+    {
+        std::mutex             mutex;
+        std::atomic<size_type> seq;              // 迁移本条带的桶时为奇数
+        std::atomic<size_type> count;            // 本条带的元素个数，只在持有锁时修改
+        node*                  limbo[3];
+        uint64_t               limbo_epoch[3];
+        size_type              retired;
+        char                   pad[64];          // 避免相邻条带的锁落在同一个缓存行
+    };
+
+    stripe                                stripes_[EConcurrentStripes];
+    std::atomic<table*>                   table_;
+    std::mutex                            resize_mutex_;    // 开始扩容、回收旧表时使用
+    table*                                retired_tables_;  // 由 resize_mutex_ 保护
+    compressed_pair<hasher, key_equal>    funcs_;
+    allocator_type                        alloc_;
+
+public:
+    // 构造、析构函数
+
+    concurrent_hash_map()
+        : concurrent_hash_map(0) {}
+
+    explicit concurrent_hash_map(size_type bucket_count,
+                                 const hasher& hash = hasher(),
+                                 const key_equal& equal = key_equal(),
+                                 const allocator_type& a = allocator_type());
+
+    concurrent_hash_map(const concurrent_hash_map&) = delete;
+    concurrent_hash_map& operator=(const concurrent_hash_map&) = delete;
+
+    ~concurrent_hash_map();
+
+public:
+    // 容量相关操作，有并发写时只是某一时刻的近似值
+
+    bool      empty()        const noexcept { return size() == 0; }
+    size_type size()         const noexcept;
+    size_type bucket_count() const noexcept;
+
+    hasher         hash_function() const { return funcs_.first(); }
+    key_equal      key_eq()        const { return funcs_.second(); }
+    allocator_type get_allocator() const { return alloc_; }
+
+    // 插入，key 已经存在时不做任何事，返回 false
+
+    template <class ...Args>
+    bool emplace(Args&& ...args);
+
+    bool insert(const value_type& value) { return emplace(value); }
+    bool insert(value_type&& value)      { return emplace(ctstl::move(value)); }
+
+    // 只有 key 不存在时才构造元素
+    template <class ...Args>
+    bool try_emplace(const key_type& key, Args&& ...args);
+
+    // key 已经存在时换上新的实值，返回是否是新插入的
+    template <class M>
+    bool insert_or_assign(const key_type& key, M&& obj);
+
+    // 在 key 对应实值的拷贝上调用 f(mapped_type&)，再用它替换原来的元素，key 不存在时返回 false
+    template <class F>
+    bool update(const key_type& key, F f);
+
+    // 删除
+    size_type erase(const key_type& key);
+    void      clear();
+
+    // 查找，不加锁
+
+    // 找到时把实值复制到 value 中
+    bool find(const key_type& key, mapped_type& value) const;
+
+    // 找到时调用 f(const value_type&)，f 执行期间元素不会被释放
+    template <class F>
+    bool visit(const key_type& key, F f) const;
+
+    bool      contains(const key_type& key) const;
+    size_type count(const key_type& key)    const { return contains(key) ? 1 : 0; }
+
+    // 依次对每个元素调用 f(const value_type&)，每次锁住一个条带，f 中不能修改这个容器
+    template <class F>
+    void for_each(F f) const;
+
+    // 扩容到至少 bucket_count 个桶，并等待迁移完成
+    void reserve(size_type bucket_count);
+
+private:
+    // helper functions
+
+    node_allocator_type node_allocator() const
+    {
+        return ctstl::rebind_allocator<node_allocator_type>(alloc_);
+    }
+    table_allocator_type table_allocator() const
+    {
+        return ctstl::rebind_allocator<table_allocator_type>(alloc_);
+    }
+    bucket_allocator_type bucket_allocator() const
+    {
+        return ctstl::rebind_allocator<bucket_allocator_type>(alloc_);
+    }
+
+    // 已经迁移的桶中保存的转发标记，只比较地址，不会解引用
+    static node* moved_mark() noexcept
+    {
+        static std::max_align_t tag;
+        return reinterpret_cast<node*>(&tag);
+    }
+
+    size_type hash_of(const key_type& key) const
+    {
+        const size_type h = funcs_.first()(key);
+        return hash_is_avalanching<hasher>::value ? h : hash_mix(h);
+    }
+
+    stripe& stripe_of(size_type h) const
+    {
+        return const_cast<stripe&>(stripes_[h & (EConcurrentStripes - 1)]);
+    }
+
+    // node / table
+    template <class ...Args>
+    node*  create_node(Args&& ...args);
+    void   destroy_node(node* p) noexcept;
+    table* create_table(size_type n);
+    void   destroy_table(table* t) noexcept;
+
+    // 持有条带锁时使用
+    std::atomic<node*>* locked_bucket(size_type h) const;
+    std::atomic<node*>* find_link(std::atomic<node*>* bucket, size_type h,
+                                  const key_type& key) const;
+    size_type           insert_node(node* n);
+    void                retire_node(stripe& s, node* p) noexcept;
+    void                reclaim(stripe& s) noexcept;
+
+    template <class F>
+    bool visit_impl(const key_type& key, F& f) const;
+    template <class F>
+    void for_each_bucket(table* t, size_type i, F& f) const;
+
+    // resize
+    void after_insert(size_type stripe_count) noexcept;
+    bool start_resize(table* t);
+    bool help_migrate();
+    void migrate_bucket(table* t, table* nt, size_type i) noexcept;
+    void retire_table(table* t) noexcept;
+    void reclaim_tables(bool force) noexcept;
+};
+
+/*****************************************************************************************/
+
+template <class Key, class T, class Hash, class KeyEqual, class Alloc>
+concurrent_hash_map<Key, T, Hash, KeyEqual, Alloc>::
+concurrent_hash_map(size_type bucket_count, const hasher& hash,
+                    const key_equal& equal, const allocator_type& a)
+    : table_(nullptr), retired_tables_(nullptr), funcs_(hash, equal), alloc_(a)
+{
+    for (auto& s : stripes_)
+    {
+        s.seq.store(0, std::memory_order_relaxed);
+        s.count.store(0, std::memory_order_relaxed);
+        s.limbo[0] = s.limbo[1] = s.limbo[2] = nullptr;
+        s.limbo_epoch[0] = s.limbo_epoch[1] = s.limbo_epoch[2] = 0;
+        s.retired = 0;
+    }
+    size_type n = static_cast<size_type>(EConcurrentMinBuckets);
+    while (n < bucket_count)
+        n <<= 1;
+    table_.store(create_table(n), std::memory_order_release);
+}
+
+template <class Key, class T, class Hash, class KeyEqual, class Alloc>
+concurrent_hash_map<Key, T, Hash, KeyEqual, Alloc>::~concurrent_hash_map()
+{
+    for (table* t = table_.load(std::memory_order_acquire); t != nullptr;)
+    {
+        for (size_type i = 0; i <= t->mask; ++i)
+        {
+            node* p = t->buckets[i].load(std::memory_order_relaxed);
+            if (p == moved_mark())
+                continue;
+            while (p != nullptr)
+            {
+                node* next = p->next.load(std::memory_order_relaxed);
+                destroy_node(p);
+                p = next;
+            }
+        }
+        table* next = t->next.load(std::memory_order_relaxed);
+        destroy_table(t);
+        t = next;
+    }
+    // 不再有读者，待回收的节点与旧表可以直接释放
+    for (auto& s : stripes_)
+    {
+        for (node*& head : s.limbo)
+        {
+            while (head != nullptr)
+            {
+                node* next = head->retire_next;
+                destroy_node(head);
+                head = next;
+            }
+        }
+    }
+    reclaim_tables(true);
+}
+
+template <class Key, class T, class Hash, class KeyEqual, class Alloc>
+typename concurrent_hash_map<Key, T, Hash, KeyEqual, Alloc>::size_type
+concurrent_hash_map<Key, T, Hash, KeyEqual, Alloc>::size() const noexcept
+{
+    size_type n = 0;
+    for (auto& s : stripes_)
+        n += s.count.load(std::memory_order_relaxed);
+    return n;
+}
+
+template <class Key, class T, class Hash, class KeyEqual, class Alloc>
+typename concurrent_hash_map<Key, T, Hash, KeyEqual, Alloc>::size_type
+concurrent_hash_map<Key, T, Hash, KeyEqual, Alloc>::bucket_count() const noexcept
+{
+    epoch_guard guard;
+    table* t = table_.load(std::memory_order_acquire);
+    table* nt = t->next.load(std::memory_order_acquire);
+    return (nt != nullptr ? nt->mask : t->mask) + 1;
+}
+
+// 先构造节点，再检查 key 是否已经存在
+template <class Key, class T, class Hash, class KeyEqual, class Alloc>
+template <class ...Args>
+bool concurrent_hash_map<Key, T, Hash, KeyEqual, Alloc>::emplace(Args&& ...args)
+{
+    node* n = create_node(ctstl::forward<Args>(args)...);
+    try
+    {
+        n->hash = hash_of(n->value.first);
+    }
+    catch (...)
+    {
+        destroy_node(n);
+        throw;
+    }
+    epoch_guard guard;
+    const size_type count = insert_node(n);
+    if (count == 0)
+    {
+        destroy_node(n);
+        return false;
+    }
+    after_insert(count);
+    return true;
+}
+
+template <class Key, class T, class Hash, class KeyEqual, class Alloc>
+template <class ...Args>
+bool concurrent_hash_map<Key, T, Hash, KeyEqual, Alloc>::
+try_emplace(const key_type& key, Args&& ...args)
+{
+    const size_type h = hash_of(key);
+    stripe& s = stripe_of(h);
+    epoch_guard guard;
+    size_type count = 0;
+    {
+        std::lock_guard<std::mutex> lock(s.mutex);
+        std::atomic<node*>* b = locked_bucket(h);
+        if (find_link(b, h, key) != nullptr)
+            return false;
+        node* n = create_node(ctstl::piecewise_construct, std::forward_as_tuple(key),
+                              std::forward_as_tuple(ctstl::forward<Args>(args)...));
+        n->hash = h;
+        n->next.store(b->load(std::memory_order_relaxed), std::memory_order_relaxed);
+        b->store(n, std::memory_order_release);
+        count = s.count.load(std::memory_order_relaxed) + 1;
+        s.count.store(count, std::memory_order_relaxed);
+    }
+    after_insert(count);
+    return true;
+}
+
+template <class Key, class T, class Hash, class KeyEqual, class Alloc>
+template <class M>
+bool concurrent_hash_map<Key, T, Hash, KeyEqual, Alloc>::
+insert_or_assign(const key_type& key, M&& obj)
+{
+    const size_type h = hash_of(key);
+    node* n = create_node(key, ctstl::forward<M>(obj));
+    n->hash = h;
+    stripe& s = stripe_of(h);
+    epoch_guard guard;
+    size_type count = 0;
+    {
+        std::lock_guard<std::mutex> lock(s.mutex);
+        std::atomic<node*>* b = locked_bucket(h);
+        std::atomic<node*>* link = find_link(b, h, key);
+        if (link != nullptr)
+        {   // 换上新节点，读者看到的要么是旧值，要么是新值
+            node* old = link->load(std::memory_order_relaxed);
+            n->next.store(old->next.load(std::memory_order_relaxed), std::memory_order_relaxed);
+            link->store(n, std::memory_order_release);
+            retire_node(s, old);
+            return false;
+        }
+        n->next.store(b->load(std::memory_order_relaxed), std::memory_order_relaxed);
+        b->store(n, std::memory_order_release);
+        count = s.count.load(std::memory_order_relaxed) + 1;
+        s.count.store(count, std::memory_order_relaxed);
+    }
+    after_insert(count);
+    return true;
+}
+
+template <class Key, class T, class Hash, class KeyEqual, class Alloc>
+template <class F>
+bool concurrent_hash_map<Key, T, Hash, KeyEqual, Alloc>::update(const key_type& key, F f)
+{
+    const size_type h = hash_of(key);
+    stripe& s = stripe_of(h);
+    epoch_guard guard;
+    std::lock_guard<std::mutex> lock(s.mutex);
+    std::atomic<node*>* link = find_link(locked_bucket(h), h, key);
+    if (link == nullptr)
+        return false;
+    node* old = link->load(std::memory_order_relaxed);
+    node* n = create_node(old->value);
+    try
+    {
+        f(n->value.second);
+    }
+    catch (...)
+    {
+        destroy_node(n);
+        throw;
+    }
+    n->hash = h;
+    n->next.store(old->next.load(std::memory_order_relaxed), std::memory_order_relaxed);
+    link->store(n, std::memory_order_release);
+    retire_node(s, old);
+    return true;
+}
+
+template <class Key, class T, class Hash, class KeyEqual, class Alloc>
+typename concurrent_hash_map<Key, T, Hash, KeyEqual, Alloc>::size_type
+concurrent_hash_map<Key, T, Hash, KeyEqual, Alloc>::erase(const key_type& key)
+{
+    const size_type h = hash_of(key);
+    stripe& s = stripe_of(h);
+    epoch_guard guard;
+    std::lock_guard<std::mutex> lock(s.mutex);
+    std::atomic<node*>* link = find_link(locked_bucket(h), h, key);
+    if (link == nullptr)
+        return 0;
+    // 被摘下的节点的 next 保持不变，正停在它上面的读者仍然可以走下去
+    node* old = link->load(std::memory_order_relaxed);
+    link->store(old->next.load(std::memory_order_relaxed), std::memory_order_release);
+    s.count.store(s.count.load(std::memory_order_relaxed) - 1, std::memory_order_relaxed);
+    retire_node(s, old);
+    return 1;
+}
+
+// 按顺序锁住全部条带，摘下所有节点
+template <class Key, class T, class Hash, class KeyEqual, class Alloc>
+void concurrent_hash_map<Key, T, Hash, KeyEqual, Alloc>::clear()
+{
+    epoch_guard guard;
+    for (auto& s : stripes_)
+        s.mutex.lock();
+    for (table* t = table_.load(std::memory_order_acquire); t != nullptr;
+         t = t->next.load(std::memory_order_acquire))
+    {
+        for (size_type i = 0; i <= t->mask; ++i)
+        {
+            node* p = t->buckets[i].load(std::memory_order_relaxed);
+            if (p == moved_mark() || p == nullptr)
+                continue;
+            t->buckets[i].store(nullptr, std::memory_order_release);
+            stripe& s = stripes_[i & (EConcurrentStripes - 1)];
+            while (p != nullptr)
+            {
+                node* next = p->next.load(std::memory_order_relaxed);
+                retire_node(s, p);
+                p = next;
+            }
+        }
+    }
+    for (auto& s : stripes_)
+    {
+        s.count.store(0, std::memory_order_relaxed);
+        s.mutex.unlock();
+    }
+}
+
+template <class Key, class T, class Hash, class KeyEqual, class Alloc>
+bool concurrent_hash_map<Key, T, Hash, KeyEqual, Alloc>::
+find(const key_type& key, mapped_type& value) const
+{
+    auto f = [&value](const value_type& v) { value = v.second; };
+    epoch_guard guard;
+    return visit_impl(key, f);
+}
+
+template <class Key, class T, class Hash, class KeyEqual, class Alloc>
+template <class F>
+bool concurrent_hash_map<Key, T, Hash, KeyEqual, Alloc>::visit(const key_type& key, F f) const
+{
+    epoch_guard guard;
+    return visit_impl(key, f);
+}
+
+template <class Key, class T, class Hash, class KeyEqual, class Alloc>
+bool concurrent_hash_map<Key, T, Hash, KeyEqual, Alloc>::contains(const key_type& key) const
+{
+    auto f = [](const value_type&) {};
+    epoch_guard guard;
+    return visit_impl(key, f);
+}
+
+template <class Key, class T, class Hash, class KeyEqual, class Alloc>
+template <class F>
+void concurrent_hash_map<Key, T, Hash, KeyEqual, Alloc>::for_each(F f) const
+{
+    epoch_guard guard;
+    for (size_type si = 0; si < static_cast<size_type>(EConcurrentStripes); ++si)
+    {
+        std::lock_guard<std::mutex> lock(stripe_of(si).mutex);
+        table* t = table_.load(std::memory_order_acquire);
+        for (size_type i = si; i <= t->mask; i += EConcurrentStripes)
+            for_each_bucket(t, i, f);
+    }
+}
+
+template <class Key, class T, class Hash, class KeyEqual, class Alloc>
+void concurrent_hash_map<Key, T, Hash, KeyEqual, Alloc>::reserve(size_type bucket_count)
+{
+    for (;;)
+    {
+        epoch_guard guard;
+        table* t = table_.load(std::memory_order_acquire);
+        if (t->next.load(std::memory_order_acquire) != nullptr)
+        {   // 正在迁移，帮忙迁移完
+            if (!help_migrate())
+                std::this_thread::yield();
+            continue;
+        }
+        if (bucket_count <= t->mask + 1)
+            return;
+        start_resize(t);
+    }
+}
+
+/*****************************************************************************************/
+// helper function
+
+template <class Key, class T, class Hash, class KeyEqual, class Alloc>
+template <class ...Args>
+typename concurrent_hash_map<Key, T, Hash, KeyEqual, Alloc>::node*
+concurrent_hash_map<Key, T, Hash, KeyEqual, Alloc>::create_node(Args&& ...args)
+{
+    node* p = node_allocator().allocate(1);
+    try
+    {
+        ctstl::construct(ctstl::address_of(p->value), ctstl::forward<Args>(args)...);
+    }
+    catch (...)
+    {
+        node_allocator().deallocate(p, 1);
+        throw;
+    }
+    ctstl::construct(&p->next, nullptr);
+    p->hash = 0;
+    p->retire_next = nullptr;
+    return p;
+}
+
+template <class Key, class T, class Hash, class KeyEqual, class Alloc>
+void concurrent_hash_map<Key, T, Hash, KeyEqual, Alloc>::destroy_node(node* p) noexcept
+{
+    ctstl::destroy(ctstl::address_of(p->value));
+    node_allocator().deallocate(p, 1);
+}
+
+template <class Key, class T, class Hash, class KeyEqual, class Alloc>
+typename concurrent_hash_map<Key, T, Hash, KeyEqual, Alloc>::table*
+concurrent_hash_map<Key, T, Hash, KeyEqual, Alloc>::create_table(size_type n)
+{
+    std::atomic<node*>* buckets = bucket_allocator().allocate(n);
+    for (size_type i = 0; i < n; ++i)
+        ctstl::construct(buckets + i, nullptr);
+    table* t = nullptr;
+    try
+    {
+        t = table_allocator().allocate(1);
+    }
+    catch (...)
+    {
+        bucket_allocator().deallocate(buckets, n);
+        throw;
+    }
+    t->mask = n - 1;
+    t->buckets = buckets;
+    ctstl::construct(&t->next, nullptr);
+    ctstl::construct(&t->claimed, 0);
+    ctstl::construct(&t->moved, 0);
+    t->retire_next = nullptr;
+    t->retire_epoch = 0;
+    return t;
+}
+
+template <class Key, class T, class Hash, class KeyEqual, class Alloc>
+void concurrent_hash_map<Key, T, Hash, KeyEqual, Alloc>::destroy_table(table* t) noexcept
+{
+    bucket_allocator().deallocate(t->buckets, t->mask + 1);
+    table_allocator().deallocate(t, 1);
+}
+
+// 找到 h 当前所在的桶，跳过已经迁移的旧表，必须持有 h 所在条带的锁
+template <class Key, class T, class Hash, class KeyEqual, class Alloc>
+std::atomic<typename concurrent_hash_map<Key, T, Hash, KeyEqual, Alloc>::node*>*
+concurrent_hash_map<Key, T, Hash, KeyEqual, Alloc>::locked_bucket(size_type h) const
+{
+    table* t = table_.load(std::memory_order_acquire);
+    std::atomic<node*>* b = t->buckets + (h & t->mask);
+    while (b->load(std::memory_order_relaxed) == moved_mark())
+    {
+        t = t->next.load(std::memory_order_acquire);
+        b = t->buckets + (h & t->mask);
+    }
+    return b;
+}
+
+// 返回指向 key 所在节点的链接（桶或前一个节点的 next），不存在时返回 nullptr
+template <class Key, class T, class Hash, class KeyEqual, class Alloc>
+std::atomic<typename concurrent_hash_map<Key, T, Hash, KeyEqual, Alloc>::node*>*
+concurrent_hash_map<Key, T, Hash, KeyEqual, Alloc>::
+find_link(std::atomic<node*>* bucket, size_type h, const key_type& key) const
+{
+    std::atomic<node*>* link = bucket;
+    for (node* p = link->load(std::memory_order_relaxed); p != nullptr;
+         p = link->load(std::memory_order_relaxed))
+    {
+        if (p->hash == h && funcs_.second()(p->value.first, key))
+            return link;
+        link = &p->next;
+    }
+    return nullptr;
+}
+
+// 插入成功时返回插入后条带中的元素个数，key 已经存在时返回 0
+template <class Key, class T, class Hash, class KeyEqual, class Alloc>
+typename concurrent_hash_map<Key, T, Hash, KeyEqual, Alloc>::size_type
+concurrent_hash_map<Key, T, Hash, KeyEqual, Alloc>::insert_node(node* n)
+{
+    stripe& s = stripe_of(n->hash);
+    std::lock_guard<std::mutex> lock(s.mutex);
+    std::atomic<node*>* b = locked_bucket(n->hash);
+    if (find_link(b, n->hash, n->value.first) != nullptr)
+        return 0;
+    n->next.store(b->load(std::memory_order_relaxed), std::memory_order_relaxed);
+    b->store(n, std::memory_order_release);
+    const size_type count = s.count.load(std::memory_order_relaxed) + 1;
+    s.count.store(count, std::memory_order_relaxed);
+    return count;
+}
+
+// 把已经摘下的节点放入条带的待回收链表，必须持有条带的锁
+template <class Key, class T, class Hash, class KeyEqual, class Alloc>
+void concurrent_hash_map<Key, T, Hash, KeyEqual, Alloc>::
+retire_node(stripe& s, node* p) noexcept
+{
+    // 摘下节点的写入必须先于读取纪元
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    const uint64_t e = epoch_domain::current();
+    const size_type slot = static_cast<size_type>(e % 3);
+    if (s.limbo_epoch[slot] != e)
+    {   // 这一代的节点至少是三个纪元之前摘下的，已经可以释放
+        for (node* q = s.limbo[slot]; q != nullptr;)
+        {
+            node* next = q->retire_next;
+            destroy_node(q);
+            q = next;
+        }
+        s.limbo[slot] = nullptr;
+        s.limbo_epoch[slot] = e;
+    }
+    p->retire_next = s.limbo[slot];
+    s.limbo[slot] = p;
+    if (++s.retired % EConcurrentAdvanceInterval == 0)
+    {
+        epoch_domain::try_advance();
+        reclaim(s);
+    }
+}
+
+// 释放条带中已经安全的待回收节点
+template <class Key, class T, class Hash, class KeyEqual, class Alloc>
+void concurrent_hash_map<Key, T, Hash, KeyEqual, Alloc>::reclaim(stripe& s) noexcept
+{
+    for (size_type slot = 0; slot < 3; ++slot)
+    {
+        if (s.limbo[slot] == nullptr || !epoch_domain::is_safe(s.limbo_epoch[slot]))
+            continue;
+        for (node* q = s.limbo[slot]; q != nullptr;)
+        {
+            node* next = q->retire_next;
+            destroy_node(q);
+            q = next;
+        }
+        s.limbo[slot] = nullptr;
+    }
+}
+
+// 不加锁的查找，必须处于 epoch_guard 的保护之下
+template <class Key, class T, class Hash, class KeyEqual, class Alloc>
+template <class F>
+bool concurrent_hash_map<Key, T, Hash, KeyEqual, Alloc>::
+visit_impl(const key_type& key, F& f) const
+{
+    const size_type h = hash_of(key);
+    const stripe& s = stripe_of(h);
+    for (;;)
+    {
+        const size_type seq = s.seq.load(std::memory_order_acquire);
+        if ((seq & 1) != 0)
+        {   // 这个条带的桶正在迁移
+            std::this_thread::yield();
+            continue;
+        }
+        table* t = table_.load(std::memory_order_acquire);
+        node* p = t->buckets[h & t->mask].load(std::memory_order_acquire);
+        while (p == moved_mark())
+        {
+            t = t->next.load(std::memory_order_acquire);
+            p = t->buckets[h & t->mask].load(std::memory_order_acquire);
+        }
+        for (; p != nullptr; p = p->next.load(std::memory_order_acquire))
+        {
+            if (p->hash == h && funcs_.second()(p->value.first, key))
+            {
+                f(p->value);
+                return true;
+            }
+        }
+        // 没有找到，只有期间没有发生迁移时结论才成立
+        if (s.seq.load(std::memory_order_acquire) == seq)
+            return false;
+    }
+}
+
+template <class Key, class T, class Hash, class KeyEqual, class Alloc>
+template <class F>
+void concurrent_hash_map<Key, T, Hash, KeyEqual, Alloc>::
+for_each_bucket(table* t, size_type i, F& f) const
+{
+    node* p = t->buckets[i].load(std::memory_order_acquire);
+    if (p == moved_mark())
+    {
+        table* nt = t->next.load(std::memory_order_acquire);
+        for_each_bucket(nt, i, f);
+        for_each_bucket(nt, i + t->mask + 1, f);
+        return;
+    }
+    for (; p != nullptr; p = p->next.load(std::memory_order_acquire))
+        f(static_cast<const value_type&>(p->value));
+}
+
+// 插入之后检查是否需要扩容，并顺带迁移一部分桶
+// 扩容只是为了维持查找的速度，分配失败时放弃，下一次插入再尝试
+template <class Key, class T, class Hash, class KeyEqual, class Alloc>
+void concurrent_hash_map<Key, T, Hash, KeyEqual, Alloc>::
+after_insert(size_type stripe_count) noexcept
+{
+    try
+    {
+        epoch_guard guard;
+        table* t = table_.load(std::memory_order_acquire);
+        if (t->next.load(std::memory_order_acquire) == nullptr)
+        {
+            // 每个条带占有 (mask + 1) / EConcurrentStripes 个桶
+            if (stripe_count > (t->mask + 1) / EConcurrentStripes)
+                start_resize(t);
+        }
+        help_migrate();
+    }
+    catch (...)
+    {
+    }
+}
+
+// 为 t 分配两倍大小的新表，开始迁移
+template <class Key, class T, class Hash, class KeyEqual, class Alloc>
+bool concurrent_hash_map<Key, T, Hash, KeyEqual, Alloc>::start_resize(table* t)
+{
+    std::lock_guard<std::mutex> lock(resize_mutex_);
+    if (table_.load(std::memory_order_relaxed) != t ||
+        t->next.load(std::memory_order_relaxed) != nullptr)
+        return false;
+    reclaim_tables(false);
+    table* nt = create_table((t->mask + 1) * 2);
+    t->next.store(nt, std::memory_order_release);
+    return true;
+}
+
+// 领取并迁移 EConcurrentMigrateChunk 个桶，最后一个完成的线程用新表替换旧表
+// 没有领取到桶时返回 false，必须处于 epoch_guard 的保护之下
+template <class Key, class T, class Hash, class KeyEqual, class Alloc>
+bool concurrent_hash_map<Key, T, Hash, KeyEqual, Alloc>::help_migrate()
+{
+    table* t = table_.load(std::memory_order_acquire);
+    table* nt = t->next.load(std::memory_order_acquire);
+    if (nt == nullptr)
+        return false;
+    const size_type n = t->mask + 1;
+    const size_type first = t->claimed.fetch_add(EConcurrentMigrateChunk, std::memory_order_relaxed);
+    if (first >= n)
+        return false;
+    const size_type last = first + EConcurrentMigrateChunk < n ? first + EConcurrentMigrateChunk : n;
+    for (size_type i = first; i < last; ++i)
+        migrate_bucket(t, nt, i);
+    if (t->moved.fetch_add(last - first, std::memory_order_acq_rel) + (last - first) == n)
+    {
+        table_.store(nt, std::memory_order_release);
+        std::lock_guard<std::mutex> lock(resize_mutex_);
+        retire_table(t);
+    }
+    return true;
+}
+
+// 把旧表的桶 i 拆分到新表的桶 i 与 i + n，节点原地重新链接，保持原来的相对顺序
+// 重新链接期间读者可能漏掉节点，因此前后各把条带的序号加一
+template <class Key, class T, class Hash, class KeyEqual, class Alloc>
+void concurrent_hash_map<Key, T, Hash, KeyEqual, Alloc>::
+migrate_bucket(table* t, table* nt, size_type i) noexcept
+{
+    stripe& s = stripes_[i & (EConcurrentStripes - 1)];
+    std::lock_guard<std::mutex> lock(s.mutex);
+    s.seq.fetch_add(1, std::memory_order_acq_rel);
+    const size_type n = t->mask + 1;
+    node* heads[2] = { nullptr, nullptr };
+    node* tails[2] = { nullptr, nullptr };
+    for (node* p = t->buckets[i].load(std::memory_order_relaxed); p != nullptr;)
+    {
+        node* next = p->next.load(std::memory_order_relaxed);
+        const int k = (p->hash & n) != 0 ? 1 : 0;
+        if (tails[k] != nullptr)
+            tails[k]->next.store(p, std::memory_order_release);
+        else
+            heads[k] = p;
+        tails[k] = p;
+        p = next;
+    }
+    for (int k = 0; k < 2; ++k)
+    {
+        if (tails[k] != nullptr)
+            tails[k]->next.store(nullptr, std::memory_order_release);
+    }
+    nt->buckets[i].store(heads[0], std::memory_order_release);
+    nt->buckets[i + n].store(heads[1], std::memory_order_release);
+    t->buckets[i].store(moved_mark(), std::memory_order_release);
+    s.seq.fetch_add(1, std::memory_order_release);
+}
+
+// 旧表可能还有读者在访问，等纪元安全后再释放，必须持有 resize_mutex_
+template <class Key, class T, class Hash, class KeyEqual, class Alloc>
+void concurrent_hash_map<Key, T, Hash, KeyEqual, Alloc>::retire_table(table* t) noexcept
+{
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    t->retire_epoch = epoch_domain::current();
+    t->retire_next = retired_tables_;
+    retired_tables_ = t;
+}
+
+// 释放已经安全的旧表，force 为 true 时全部释放
+template <class Key, class T, class Hash, class KeyEqual, class Alloc>
+void concurrent_hash_map<Key, T, Hash, KeyEqual, Alloc>::reclaim_tables(bool force) noexcept
+{
+    if (!force)
+        epoch_domain::try_advance();
+    table** link = &retired_tables_;
+    while (*link != nullptr)
+    {
+        table* t = *link;
+        if (force || epoch_domain::is_safe(t->retire_epoch))
+        {
+            *link = t->retire_next;
+            destroy_table(t);
+        }
+        else
+        {
+            link = &t->retire_next;
+        }
+    }
+}
+
+} // namespace ctstl
+#endif // !CTSTL_CONCURRENT_HASH_MAP_H_
@@ -9,6 +9,7 @@
 
 #include "type_traits.h"
 #include "iterator.h"
+#include "util.h"
 
 /*
 用于控制 Microsoft Visual C++ 编译器的警告行为的。具体来说：
@@ -50,7 +51,7 @@ void construct(Ty1* ptr, const Ty2& value)
 template <class Ty1, class... Args>
 void construct(Ty1* ptr, Args&&... args)
 {
-    ::new ((void*)ptr) Ty1(value);
+    ::new ((void*)ptr) Ty1(ctstl::forward<Args>(args)...);
 }
 
 // destroy 将对象析构
@@ -69,6 +70,9 @@ void destroy_one(Ty* pointer, std::false_type)
     }
 }
 
+template <class Ty>
+void destroy(Ty* pointer);
+
 template <class ForwardIter>
 void destroy_cat(ForwardIter, ForwardIter, std::true_type) {}
 
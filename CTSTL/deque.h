@@ -0,0 +1,1425 @@
+#ifndef CTSTL_DEQUE_H_
+#define CTSTL_DEQUE_H_
+
+// 这个头文件包含了一个模板类 deque
+// deque: 双端队列
+//
+// 1. deque 的结构
+// 元素保存在若干大小固定（BlockSize 个元素）的块中，map_ 是指向各块的指针数组，
+// 块在 map_ 中连续排列，[begin_.node, end_.node] 之间的块都已经分配，其它位置为 nullptr。
+// 在两端插入、删除元素不会移动其它元素，只在 map_ 用完时重新分配 map_ 本身。
+//
+// 2. 分段迭代器
+// deque 的迭代器是分段迭代器（见 iterator.h 中的 segmented_iterator_traits），
+// algobase.h 中的 copy / move / fill / equal 在 deque 上逐块处理，块内使用指针版本的 memmove / memset / memcmp。
+//
+// 异常保证：
+// emplace_front / emplace_back / push_front / push_back 提供强异常安全保证，
+// 在中间插入、删除元素只提供基本保证
+
+#include <initializer_list>
+#include <type_traits>
+
+#include "iterator.h"
+#include "memory.h"
+#include "util.h"
+#include "exceptdef.h"
+
+namespace ctstl
+{
+
+#ifdef max
+#pragma message("#undefing marco max")
+#undef max
+#endif // max
+
+#ifdef min
+#pragma message("#undefing marco min")
+#undef min
+#endif // min
+
+// deque 的 map 初始化的大小
+enum { EDequeMapInitSize = 8 };
+
+// 默认的块大小：每块大约 4096 字节，至少 16 个元素
+template <class T>
+struct deque_block_size
+{
+    static constexpr size_t value = sizeof(T) < 256 ? 4096 / sizeof(T) : 16;
+};
+
+// deque 的迭代器设计
+template <class T, class Ref, class Ptr, size_t BlockSize>
+struct deque_iterator : public iterator<random_access_iterator_tag, T, ptrdiff_t, Ptr, Ref>
+{
+    typedef deque_iterator<T, T&, T*, BlockSize>             iterator;
+    typedef deque_iterator<T, const T&, const T*, BlockSize> const_iterator;
+    typedef deque_iterator                                   self;
+
+    typedef T            value_type;
+    typedef Ptr          pointer;
+    typedef Ref          reference;
+    typedef size_t       size_type;
+    typedef ptrdiff_t    difference_type;
+    typedef T*           value_pointer;
+    typedef T**          map_pointer;
+
+    // 迭代器所含成员数据
+    value_pointer cur;    // 指向所在块的当前元素
+    value_pointer first;  // 指向所在块的头部
+    value_pointer last;   // 指向所在块的尾部
+    map_pointer   node;   // 块所在的 map 节点
+
+    // 构造、复制、移动函数
+    deque_iterator() noexcept
+        : cur(nullptr), first(nullptr), last(nullptr), node(nullptr) {}
+
+    deque_iterator(value_pointer v, map_pointer n)
+        : cur(v), first(*n), last(*n + BlockSize), node(n) {}
+
+    deque_iterator(const iterator& rhs)
+        : cur(rhs.cur), first(rhs.first), last(rhs.last), node(rhs.node) {}
+
+    self& operator=(const iterator& rhs)
+    {
+        cur = rhs.cur;
+        first = rhs.first;
+        last = rhs.last;
+        node = rhs.node;
+        return *this;
+    }
+
+    // 转到另一个块
+    void set_node(map_pointer new_node)
+    {
+        node = new_node;
+        first = *new_node;
+        last = first + BlockSize;
+    }
+
+    // 重载运算符
+    reference operator*()  const { return *cur; }
+    pointer   operator->() const { return cur; }
+
+    difference_type operator-(const self& x) const
+    {
+        return static_cast<difference_type>(BlockSize) * (node - x.node)
+            + (cur - first) - (x.cur - x.first);
+    }
+
+    self& operator++()
+    {
+        ++cur;
+        if (cur == last)
+        {   // 如果到达块的尾部，转到下一块的头部
+            set_node(node + 1);
+            cur = first;
+        }
+        return *this;
+    }
+    self operator++(int)
+    {
+        self tmp = *this;
+        ++*this;
+        return tmp;
+    }
+
+    self& operator--()
+    {
+        if (cur == first)
+        {   // 如果到达块的头部，转到前一块的尾部
+            set_node(node - 1);
+            cur = last;
+        }
+        --cur;
+        return *this;
+    }
+    self operator--(int)
+    {
+        self tmp = *this;
+        --*this;
+        return tmp;
+    }
+
+    self& operator+=(difference_type n)
+    {
+        const difference_type offset = n + (cur - first);
+        if (offset >= 0 && offset < static_cast<difference_type>(BlockSize))
+        {   // 仍在当前块
+            cur += n;
+        }
+        else
+        {   // 要跳到其它的块
+            const difference_type block = static_cast<difference_type>(BlockSize);
+            const difference_type node_offset = offset > 0
+                ? offset / block
+                : -static_cast<difference_type>((-offset - 1) / block) - 1;
+            set_node(node + node_offset);
+            cur = first + (offset - node_offset * block);
+        }
+        return *this;
+    }
+    self operator+(difference_type n) const
+    {
+        self tmp = *this;
+        return tmp += n;
+    }
+    self& operator-=(difference_type n)
+    {
+        return *this += -n;
+    }
+    self operator-(difference_type n) const
+    {
+        self tmp = *this;
+        return tmp -= n;
+    }
+
+    reference operator[](difference_type n) const { return *(*this + n); }
+
+    // 重载比较操作符
+    bool operator==(const self& rhs) const { return cur == rhs.cur; }
+    bool operator< (const self& rhs) const
+    { return node == rhs.node ? (cur < rhs.cur) : (node < rhs.node); }
+    bool operator!=(const self& rhs) const { return !(*this == rhs); }
+    bool operator> (const self& rhs) const { return rhs < *this; }
+    bool operator<=(const self& rhs) const { return !(rhs < *this); }
+    bool operator>=(const self& rhs) const { return !(*this < rhs); }
+};
+
+// deque 的迭代器是分段迭代器，块之间用 map 节点移动，块内是普通指针
+template <class T, class Ref, class Ptr, size_t BlockSize>
+struct segmented_iterator_traits<deque_iterator<T, Ref, Ptr, BlockSize>>
+{
+    typedef std::true_type                            is_segmented_iterator;
+    typedef deque_iterator<T, Ref, Ptr, BlockSize>    iterator;
+    typedef T**                                       segment_iterator;
+    typedef Ptr                                       local_iterator;
+
+    static segment_iterator segment(const iterator& it) { return it.node; }
+    static local_iterator   local(const iterator& it)   { return it.cur; }
+    static local_iterator   begin(segment_iterator s)   { return *s; }
+    static local_iterator   end(segment_iterator s)     { return *s + BlockSize; }
+
+    static iterator compose(segment_iterator s, local_iterator l)
+    {
+        if (l == *s + BlockSize)
+        {   // 迭代器不会停在块的尾部
+            ++s;
+            l = *s;
+        }
+        return iterator(const_cast<T*>(l), s);
+    }
+};
+
+// 模板类 deque
+// 模板参数 T 代表数据类型，Alloc 代表空间配置器，BlockSize 代表每一块的元素个数
+template <class T, class Alloc = ctstl::allocator<T>, size_t BlockSize = deque_block_size<T>::value>
+class deque
+{
+    static_assert(BlockSize > 0, "deque needs a non-zero block size");
+
+public:
+    // deque 的型别定义
+    typedef Alloc                                      allocator_type;
+
+    typedef T                                          value_type;
+    typedef T*                                         pointer;
+    typedef const T*                                   const_pointer;
+    typedef T&                                         reference;
+    typedef const T&                                   const_reference;
+    typedef size_t                                     size_type;
+    typedef ptrdiff_t                                  difference_type;
+    typedef pointer*                                   map_pointer;
+    typedef const_pointer*                             const_map_pointer;
+
+    typedef deque_iterator<T, T&, T*, BlockSize>             iterator;
+    typedef deque_iterator<T, const T&, const T*, BlockSize> const_iterator;
+    typedef ctstl::reverse_iterator<iterator>                reverse_iterator;
+    typedef ctstl::reverse_iterator<const_iterator>          const_reverse_iterator;
+
+    static constexpr size_type block_size = BlockSize;
+
+    allocator_type get_allocator() const { return map_.first(); }
+
+private:
+    typedef typename Alloc::template rebind<T*>::other map_allocator_type;
+
+    // 用以下数据来表现一个 deque
+    iterator                                      begin_;     // 指向第一个节点
+    iterator                                      end_;       // 指向最后一个结点
+    compressed_pair<allocator_type, map_pointer>  map_;       // 配置器，以及指向一块 map，map 中的每个元素都是一个指针，指向一个块
+    size_type                                     map_size_;  // map 内指针的数目
+
+public:
+    // 构造、复制、移动、析构函数
+    deque()
+        : map_(allocator_type(), nullptr), map_size_(0)
+    {
+        fill_init(0);
+    }
+
+    explicit deque(const allocator_type& a)
+        : map_(a, nullptr), map_size_(0)
+    {
+        fill_init(0);
+    }
+
+    explicit deque(size_type n, const allocator_type& a = allocator_type())
+        : map_(a, nullptr), map_size_(0)
+    {
+        fill_init(n);
+    }
+
+    deque(size_type n, const value_type& value, const allocator_type& a = allocator_type())
+        : map_(a, nullptr), map_size_(0)
+    {
+        fill_init(n, value);
+    }
+
+    template <class IIter, typename std::enable_if<
+        ctstl::is_input_iterator<IIter>::value, int>::type = 0>
+    deque(IIter first, IIter last, const allocator_type& a = allocator_type())
+        : map_(a, nullptr), map_size_(0)
+    {
+        copy_init(first, last, iterator_category(first));
+    }
+
+    deque(std::initializer_list<value_type> ilist, const allocator_type& a = allocator_type())
+        : map_(a, nullptr), map_size_(0)
+    {
+        copy_init(ilist.begin(), ilist.end(), ctstl::forward_iterator_tag());
+    }
+
+    deque(const deque& rhs)
+        : map_(rhs.map_.first(), nullptr), map_size_(0)
+    {
+        copy_init(rhs.begin(), rhs.end(), ctstl::forward_iterator_tag());
+    }
+
+    // 被移动的 deque 不再拥有任何块，再次插入元素时才重新分配 map
+    deque(deque&& rhs) noexcept
+        : begin_(rhs.begin_), end_(rhs.end_),
+          map_(ctstl::move(rhs.map_.first()), rhs.map_.second()), map_size_(rhs.map_size_)
+    {
+        rhs.map_.second() = nullptr;
+        rhs.map_size_ = 0;
+        rhs.begin_ = rhs.end_ = iterator();
+    }
+
+    deque& operator=(const deque& rhs);
+    deque& operator=(deque&& rhs) noexcept(std::is_empty<Alloc>::value);
+
+    deque& operator=(std::initializer_list<value_type> ilist)
+    {
+        deque tmp(ilist, map_.first());
+        swap(tmp);
+        return *this;
+    }
+
+    ~deque()
+    {
+        release();
+    }
+
+public:
+    // 迭代器相关操作
+    iterator               begin()         noexcept { return begin_; }
+    const_iterator         begin()   const noexcept { return begin_; }
+    iterator               end()           noexcept { return end_; }
+    const_iterator         end()     const noexcept { return end_; }
+
+    reverse_iterator       rbegin()        noexcept { return reverse_iterator(end()); }
+    const_reverse_iterator rbegin()  const noexcept { return const_reverse_iterator(end()); }
+    reverse_iterator       rend()          noexcept { return reverse_iterator(begin()); }
+    const_reverse_iterator rend()    const noexcept { return const_reverse_iterator(begin()); }
+
+    const_iterator         cbegin()  const noexcept { return begin(); }
+    const_iterator         cend()    const noexcept { return end(); }
+    const_reverse_iterator crbegin() const noexcept { return rbegin(); }
+    const_reverse_iterator crend()   const noexcept { return rend(); }
+
+    // 容量相关操作
+    bool      empty()    const noexcept { return begin_ == end_; }
+    size_type size()     const noexcept { return static_cast<size_type>(end_ - begin_); }
+    size_type max_size() const noexcept { return static_cast<size_type>(-1) / sizeof(T); }
+    void      resize(size_type new_size) { resize_impl(new_size); }
+    void      resize(size_type new_size, const value_type& value) { resize_impl(new_size, value); }
+    void      shrink_to_fit() noexcept;
+
+    // 访问元素相关操作
+    reference operator[](size_type n)
+    {
+        CTSTL_DEBUG(n < size());
+        return begin_[static_cast<difference_type>(n)];
+    }
+    const_reference operator[](size_type n) const
+    {
+        CTSTL_DEBUG(n < size());
+        return begin_[static_cast<difference_type>(n)];
+    }
+
+    reference at(size_type n)
+    {
+        THROW_OUT_RANGE_IF(!(n < size()), "deque<T>::at() subscript out of range");
+        return (*this)[n];
+    }
+    const_reference at(size_type n) const
+    {
+        THROW_OUT_RANGE_IF(!(n < size()), "deque<T>::at() subscript out of range");
+        return (*this)[n];
+    }
+
+    reference front()
+    {
+        CTSTL_DEBUG(!empty());
+        return *begin();
+    }
+    const_reference front() const
+    {
+        CTSTL_DEBUG(!empty());
+        return *begin();
+    }
+    reference back()
+    {
+        CTSTL_DEBUG(!empty());
+        return *(end() - 1);
+    }
+    const_reference back() const
+    {
+        CTSTL_DEBUG(!empty());
+        return *(end() - 1);
+    }
+
+    // 修改容器相关操作
+
+    // assign
+    void assign(size_type n, const value_type& value)
+    {
+        fill_assign(n, value);
+    }
+
+    template <class IIter, typename std::enable_if<
+        ctstl::is_input_iterator<IIter>::value, int>::type = 0>
+    void assign(IIter first, IIter last)
+    {
+        copy_assign(first, last, iterator_category(first));
+    }
+
+    void assign(std::initializer_list<value_type> ilist)
+    {
+        copy_assign(ilist.begin(), ilist.end(), ctstl::forward_iterator_tag{});
+    }
+
+    // emplace_front / emplace_back / emplace
+    template <class ...Args>
+    reference emplace_front(Args&& ...args);
+    template <class ...Args>
+    reference emplace_back(Args&& ...args);
+    template <class ...Args>
+    iterator  emplace(const_iterator pos, Args&& ...args);
+
+    // push_front / push_back
+    void push_front(const value_type& value) { emplace_front(value); }
+    void push_back(const value_type& value)  { emplace_back(value); }
+    void push_front(value_type&& value)      { emplace_front(ctstl::move(value)); }
+    void push_back(value_type&& value)       { emplace_back(ctstl::move(value)); }
+
+    // pop_back / pop_front
+    void pop_front();
+    void pop_back();
+
+    // insert
+    iterator insert(const_iterator pos, const value_type& value)
+    {
+        return emplace(pos, value);
+    }
+    iterator insert(const_iterator pos, value_type&& value)
+    {
+        return emplace(pos, ctstl::move(value));
+    }
+    iterator insert(const_iterator pos, size_type n, const value_type& value);
+
+    template <class IIter, typename std::enable_if<
+        ctstl::is_input_iterator<IIter>::value, int>::type = 0>
+    iterator insert(const_iterator pos, IIter first, IIter last)
+    {
+        return range_insert(to_mutable(pos), first, last, iterator_category(first));
+    }
+
+    iterator insert(const_iterator pos, std::initializer_list<value_type> ilist)
+    {
+        return range_insert(to_mutable(pos), ilist.begin(), ilist.end(),
+                            ctstl::forward_iterator_tag());
+    }
+
+    // erase / clear
+    iterator erase(const_iterator pos);
+    iterator erase(const_iterator first, const_iterator last);
+    void     clear() noexcept;
+
+    // swap
+    void     swap(deque& rhs) noexcept;
+
+private:
+    // helper functions
+
+    iterator to_mutable(const_iterator pos) const
+    {
+        return pos.node == nullptr ? iterator() : iterator(const_cast<pointer>(pos.cur), pos.node);
+    }
+
+    map_allocator_type map_allocator() const
+    {
+        return ctstl::rebind_allocator<map_allocator_type>(map_.first());
+    }
+
+    // create node / destroy node
+    map_pointer create_map(size_type size);
+    void        create_buffer(map_pointer nstart, map_pointer nfinish);
+    void        destroy_buffer(map_pointer nstart, map_pointer nfinish) noexcept;
+
+    // initialize
+    void        map_init(size_type n);
+    template <class... Value>
+    void        fill_init(size_type n, const Value&... value);
+    template <class IIter>
+    void        copy_init(IIter, IIter, input_iterator_tag);
+    template <class FIter>
+    void        copy_init(FIter, FIter, forward_iterator_tag);
+    void        release() noexcept;
+
+    // assign
+    void        fill_assign(size_type n, const value_type& value);
+    template <class IIter>
+    void        copy_assign(IIter first, IIter last, input_iterator_tag);
+    template <class FIter>
+    void        copy_assign(FIter first, FIter last, forward_iterator_tag);
+
+    // insert
+    template <class... Args>
+    iterator    insert_aux(iterator pos, Args&& ...args);
+    iterator    fill_insert(iterator pos, size_type n, const value_type& value);
+    template <class FIter>
+    iterator    copy_insert(iterator pos, FIter first, FIter last, size_type n);
+    template <class IIter>
+    iterator    range_insert(iterator pos, IIter first, IIter last, input_iterator_tag);
+    template <class FIter>
+    iterator    range_insert(iterator pos, FIter first, FIter last, forward_iterator_tag);
+
+    template <class... Value>
+    void        resize_impl(size_type new_size, const Value&... value);
+
+    // reallocate
+    void        require_capacity(size_type n, bool front);
+    void        reallocate_map_at_front(size_type need);
+    void        reallocate_map_at_back(size_type need);
+};
+
+/*****************************************************************************************/
+
+// 复制赋值运算符
+template <class T, class Alloc, size_t BlockSize>
+deque<T, Alloc, BlockSize>&
+deque<T, Alloc, BlockSize>::operator=(const deque& rhs)
+{
+    if (this != &rhs)
+        copy_assign(rhs.begin(), rhs.end(), ctstl::forward_iterator_tag());
+    return *this;
+}
+
+// 移动赋值运算符
+// 配置器保持不变：与 rhs 的配置器相等时直接接管 rhs 的 map 和块，否则逐个移动元素
+template <class T, class Alloc, size_t BlockSize>
+deque<T, Alloc, BlockSize>&
+deque<T, Alloc, BlockSize>::operator=(deque&& rhs) noexcept(std::is_empty<Alloc>::value)
+{
+    if (this == &rhs)
+        return *this;
+    if (ctstl::allocator_equal(map_.first(), rhs.map_.first()))
+    {
+        release();
+        begin_ = rhs.begin_;
+        end_ = rhs.end_;
+        map_.second() = rhs.map_.second();
+        map_size_ = rhs.map_size_;
+        rhs.map_.second() = nullptr;
+        rhs.map_size_ = 0;
+        rhs.begin_ = rhs.end_ = iterator();
+    }
+    else
+    {
+        clear();
+        for (iterator it = rhs.begin_; it != rhs.end_; ++it)
+            emplace_back(ctstl::move(*it));
+        rhs.clear();
+    }
+    return *this;
+}
+
+// 减小容器容量：释放 [begin_.node, end_.node] 之外仍然保留的块
+template <class T, class Alloc, size_t BlockSize>
+void deque<T, Alloc, BlockSize>::shrink_to_fit() noexcept
+{
+    if (map_.second() == nullptr)
+        return;
+    for (map_pointer cur = map_.second(); cur < begin_.node; ++cur)
+        destroy_buffer(cur, cur);
+    for (map_pointer cur = end_.node + 1; cur < map_.second() + map_size_; ++cur)
+        destroy_buffer(cur, cur);
+}
+
+// 在头部就地构建元素
+template <class T, class Alloc, size_t BlockSize>
+template <class ...Args>
+typename deque<T, Alloc, BlockSize>::reference
+deque<T, Alloc, BlockSize>::emplace_front(Args&& ...args)
+{
+    if (begin_.cur != begin_.first)
+    {
+        ctstl::construct(begin_.cur - 1, ctstl::forward<Args>(args)...);
+        --begin_.cur;
+    }
+    else
+    {
+        require_capacity(1, true);
+        try
+        {
+            ctstl::construct(*(begin_.node - 1) + (BlockSize - 1), ctstl::forward<Args>(args)...);
+        }
+        catch (...)
+        {
+            destroy_buffer(begin_.node - 1, begin_.node - 1);
+            throw;
+        }
+        --begin_;
+    }
+    return *begin_;
+}
+
+// 在尾部就地构建元素
+template <class T, class Alloc, size_t BlockSize>
+template <class ...Args>
+typename deque<T, Alloc, BlockSize>::reference
+deque<T, Alloc, BlockSize>::emplace_back(Args&& ...args)
+{
+    if (end_.last - end_.cur > 1)
+    {
+        ctstl::construct(end_.cur, ctstl::forward<Args>(args)...);
+        ++end_.cur;
+    }
+    else
+    {
+        // end_ 不会停在块的尾部，先准备好下一块
+        require_capacity(1, false);
+        try
+        {
+            ctstl::construct(end_.cur, ctstl::forward<Args>(args)...);
+        }
+        catch (...)
+        {
+            destroy_buffer(end_.node + 1, end_.node + 1);
+            throw;
+        }
+        ++end_;
+    }
+    return *(end_ - 1);
+}
+
+// 在 pos 位置就地构建元素
+template <class T, class Alloc, size_t BlockSize>
+template <class ...Args>
+typename deque<T, Alloc, BlockSize>::iterator
+deque<T, Alloc, BlockSize>::emplace(const_iterator pos, Args&& ...args)
+{
+    iterator xpos = to_mutable(pos);
+    if (xpos.cur == begin_.cur)
+    {
+        emplace_front(ctstl::forward<Args>(args)...);
+        return begin_;
+    }
+    else if (xpos.cur == end_.cur)
+    {
+        emplace_back(ctstl::forward<Args>(args)...);
+        return end_ - 1;
+    }
+    return insert_aux(xpos, ctstl::forward<Args>(args)...);
+}
+
+// 在头部删除元素
+template <class T, class Alloc, size_t BlockSize>
+void deque<T, Alloc, BlockSize>::pop_front()
+{
+    CTSTL_DEBUG(!empty());
+    if (begin_.cur != begin_.last - 1)
+    {
+        ctstl::destroy(begin_.cur);
+        ++begin_.cur;
+    }
+    else
+    {
+        ctstl::destroy(begin_.cur);
+        ++begin_;
+        destroy_buffer(begin_.node - 1, begin_.node - 1);
+    }
+}
+
+// 在尾部删除元素
+template <class T, class Alloc, size_t BlockSize>
+void deque<T, Alloc, BlockSize>::pop_back()
+{
+    CTSTL_DEBUG(!empty());
+    if (end_.cur != end_.first)
+    {
+        --end_.cur;
+        ctstl::destroy(end_.cur);
+    }
+    else
+    {
+        --end_;
+        ctstl::destroy(end_.cur);
+        destroy_buffer(end_.node + 1, end_.node + 1);
+    }
+}
+
+// 在 pos 处插入 n 个元素
+template <class T, class Alloc, size_t BlockSize>
+typename deque<T, Alloc, BlockSize>::iterator
+deque<T, Alloc, BlockSize>::insert(const_iterator pos, size_type n, const value_type& value)
+{
+    iterator xpos = to_mutable(pos);
+    if (n == 0)
+        return xpos;
+    const value_type value_copy = value;  // value 可能引用容器中的元素
+    if (xpos.cur == begin_.cur)
+    {
+        require_capacity(n, true);
+        iterator new_begin = begin_ - static_cast<difference_type>(n);
+        try
+        {
+            ctstl::uninitialized_fill_n(new_begin, n, value_copy);
+        }
+        catch (...)
+        {
+            destroy_buffer(new_begin.node, begin_.node - 1);
+            throw;
+        }
+        begin_ = new_begin;
+        return begin_;
+    }
+    else if (xpos.cur == end_.cur)
+    {
+        require_capacity(n, false);
+        iterator new_end = end_ + static_cast<difference_type>(n);
+        try
+        {
+            ctstl::uninitialized_fill_n(end_, n, value_copy);
+        }
+        catch (...)
+        {
+            destroy_buffer(end_.node + 1, new_end.node);
+            throw;
+        }
+        end_ = new_end;
+        return end_ - static_cast<difference_type>(n);
+    }
+    return fill_insert(xpos, n, value_copy);
+}
+
+// 删除 pos 处的元素
+template <class T, class Alloc, size_t BlockSize>
+typename deque<T, Alloc, BlockSize>::iterator
+deque<T, Alloc, BlockSize>::erase(const_iterator pos)
+{
+    CTSTL_DEBUG(pos >= cbegin() && pos < cend());
+    iterator xpos = to_mutable(pos);
+    iterator next = xpos;
+    ++next;
+    const difference_type elems_before = xpos - begin_;
+    if (static_cast<size_type>(elems_before) < (size() / 2))
+    {
+        ctstl::move_backward(begin_, xpos, next);
+        pop_front();
+    }
+    else
+    {
+        ctstl::move(next, end_, xpos);
+        pop_back();
+    }
+    return begin_ + elems_before;
+}
+
+// 删除[first, last)上的元素
+template <class T, class Alloc, size_t BlockSize>
+typename deque<T, Alloc, BlockSize>::iterator
+deque<T, Alloc, BlockSize>::erase(const_iterator first, const_iterator last)
+{
+    CTSTL_DEBUG(first >= cbegin() && last <= cend() && !(last < first));
+    iterator xfirst = to_mutable(first);
+    iterator xlast = to_mutable(last);
+    if (xfirst == xlast)
+        return xfirst;
+    if (xfirst == begin_ && xlast == end_)
+    {
+        clear();
+        return end_;
+    }
+    const difference_type len = xlast - xfirst;
+    const difference_type elems_before = xfirst - begin_;
+    if (elems_before < static_cast<difference_type>((size() - len) / 2))
+    {
+        ctstl::move_backward(begin_, xfirst, xlast);
+        iterator new_begin = begin_ + len;
+        ctstl::destroy(begin_, new_begin);
+        destroy_buffer(begin_.node, new_begin.node - 1);
+        begin_ = new_begin;
+    }
+    else
+    {
+        ctstl::move(xlast, end_, xfirst);
+        iterator new_end = end_ - len;
+        ctstl::destroy(new_end, end_);
+        destroy_buffer(new_end.node + 1, end_.node);
+        end_ = new_end;
+    }
+    return begin_ + elems_before;
+}
+
+// 清空 deque，保留头部的块
+template <class T, class Alloc, size_t BlockSize>
+void deque<T, Alloc, BlockSize>::clear() noexcept
+{
+    if (map_.second() == nullptr)
+        return;
+    for (map_pointer cur = begin_.node + 1; cur < end_.node; ++cur)
+        ctstl::destroy(*cur, *cur + BlockSize);
+    if (begin_.node != end_.node)
+    {   // 有两个以上的块
+        ctstl::destroy(begin_.cur, begin_.last);
+        ctstl::destroy(end_.first, end_.cur);
+    }
+    else
+    {
+        ctstl::destroy(begin_.cur, end_.cur);
+    }
+    destroy_buffer(begin_.node + 1, end_.node);
+    end_ = begin_;
+}
+
+// 交换两个 deque
+template <class T, class Alloc, size_t BlockSize>
+void deque<T, Alloc, BlockSize>::swap(deque& rhs) noexcept
+{
+    if (this != &rhs)
+    {
+        CTSTL_DEBUG(ctstl::allocator_equal(map_.first(), rhs.map_.first()));
+        ctstl::swap(begin_, rhs.begin_);
+        ctstl::swap(end_, rhs.end_);
+        ctstl::swap(map_.second(), rhs.map_.second());
+        ctstl::swap(map_size_, rhs.map_size_);
+    }
+}
+
+/*****************************************************************************************/
+// helper function
+
+// create_map 函数
+template <class T, class Alloc, size_t BlockSize>
+typename deque<T, Alloc, BlockSize>::map_pointer
+deque<T, Alloc, BlockSize>::create_map(size_type size)
+{
+    map_pointer mp = map_allocator().allocate(size);
+    for (size_type i = 0; i < size; ++i)
+        *(mp + i) = nullptr;
+    return mp;
+}
+
+// create_buffer 函数，为 [nstart, nfinish] 分配块，失败时释放本次分配的块
+template <class T, class Alloc, size_t BlockSize>
+void deque<T, Alloc, BlockSize>::create_buffer(map_pointer nstart, map_pointer nfinish)
+{
+    map_pointer cur = nstart;
+    try
+    {
+        for (; cur <= nfinish; ++cur)
+            *cur = map_.first().allocate(BlockSize);
+    }
+    catch (...)
+    {
+        while (cur != nstart)
+        {
+            --cur;
+            map_.first().deallocate(*cur, BlockSize);
+            *cur = nullptr;
+        }
+        throw;
+    }
+}
+
+// destroy_buffer 函数，释放 [nstart, nfinish] 的块
+template <class T, class Alloc, size_t BlockSize>
+void deque<T, Alloc, BlockSize>::destroy_buffer(map_pointer nstart, map_pointer nfinish) noexcept
+{
+    for (map_pointer n = nstart; n <= nfinish; ++n)
+    {
+        if (*n != nullptr)
+        {
+            map_.first().deallocate(*n, BlockSize);
+            *n = nullptr;
+        }
+    }
+}
+
+// map_init 函数，为 n 个元素准备 map 与块
+template <class T, class Alloc, size_t BlockSize>
+void deque<T, Alloc, BlockSize>::map_init(size_type n)
+{
+    const size_type nNode = n / BlockSize + 1;  // 需要分配的块数
+    map_size_ = ctstl::max(static_cast<size_type>(EDequeMapInitSize), nNode + 2);
+    map_.second() = create_map(map_size_);
+
+    // 让 nstart 和 nfinish 都指向 map_ 最中央的区域，方便向头尾扩充
+    map_pointer nstart = map_.second() + (map_size_ - nNode) / 2;
+    map_pointer nfinish = nstart + nNode - 1;
+    try
+    {
+        create_buffer(nstart, nfinish);
+    }
+    catch (...)
+    {
+        map_allocator().deallocate(map_.second(), map_size_);
+        map_.second() = nullptr;
+        map_size_ = 0;
+        throw;
+    }
+    begin_.set_node(nstart);
+    end_.set_node(nfinish);
+    begin_.cur = begin_.first;
+    end_.cur = end_.first + (n % BlockSize);
+}
+
+// fill_init 函数，value 为空时值初始化 n 个元素
+template <class T, class Alloc, size_t BlockSize>
+template <class... Value>
+void deque<T, Alloc, BlockSize>::fill_init(size_type n, const Value&... value)
+{
+    map_init(n);
+    iterator cur = begin_;
+    try
+    {
+        for (; cur != end_; ++cur)
+            ctstl::construct(cur.cur, value...);
+    }
+    catch (...)
+    {
+        ctstl::destroy(begin_, cur);
+        end_ = begin_;
+        release();
+        throw;
+    }
+}
+
+// copy_init 函数
+template <class T, class Alloc, size_t BlockSize>
+template <class IIter>
+void deque<T, Alloc, BlockSize>::copy_init(IIter first, IIter last, input_iterator_tag)
+{
+    map_init(0);
+    try
+    {
+        for (; first != last; ++first)
+            emplace_back(*first);
+    }
+    catch (...)
+    {
+        release();
+        throw;
+    }
+}
+
+template <class T, class Alloc, size_t BlockSize>
+template <class FIter>
+void deque<T, Alloc, BlockSize>::copy_init(FIter first, FIter last, forward_iterator_tag)
+{
+    const size_type n = static_cast<size_type>(ctstl::distance(first, last));
+    map_init(n);
+    try
+    {
+        ctstl::uninitialized_copy(first, last, begin_);
+    }
+    catch (...)
+    {
+        end_ = begin_;
+        release();
+        throw;
+    }
+}
+
+// release 函数，析构所有元素，释放所有块与 map
+template <class T, class Alloc, size_t BlockSize>
+void deque<T, Alloc, BlockSize>::release() noexcept
+{
+    if (map_.second() == nullptr)
+        return;
+    clear();
+    destroy_buffer(begin_.node, begin_.node);
+    shrink_to_fit();
+    map_allocator().deallocate(map_.second(), map_size_);
+    map_.second() = nullptr;
+    map_size_ = 0;
+    begin_ = end_ = iterator();
+}
+
+// fill_assign 函数
+template <class T, class Alloc, size_t BlockSize>
+void deque<T, Alloc, BlockSize>::fill_assign(size_type n, const value_type& value)
+{
+    if (n > size())
+    {
+        ctstl::fill(begin(), end(), value);
+        insert(end(), n - size(), value);
+    }
+    else
+    {
+        erase(begin() + static_cast<difference_type>(n), end());
+        ctstl::fill(begin(), end(), value);
+    }
+}
+
+// copy_assign 函数
+template <class T, class Alloc, size_t BlockSize>
+template <class IIter>
+void deque<T, Alloc, BlockSize>::copy_assign(IIter first, IIter last, input_iterator_tag)
+{
+    iterator first1 = begin();
+    iterator last1 = end();
+    for (; first != last && first1 != last1; ++first, ++first1)
+        *first1 = *first;
+    if (first1 != last1)
+        erase(first1, end_);
+    else
+        range_insert(end_, first, last, input_iterator_tag());
+}
+
+template <class T, class Alloc, size_t BlockSize>
+template <class FIter>
+void deque<T, Alloc, BlockSize>::copy_assign(FIter first, FIter last, forward_iterator_tag)
+{
+    const size_type len1 = size();
+    const size_type len2 = static_cast<size_type>(ctstl::distance(first, last));
+    if (len1 < len2)
+    {
+        FIter next = first;
+        ctstl::advance(next, len1);
+        ctstl::copy(first, next, begin_);
+        range_insert(end_, next, last, forward_iterator_tag());
+    }
+    else
+    {
+        erase(ctstl::copy(first, last, begin_), end_);
+    }
+}
+
+// insert_aux 函数，在中间插入一个元素
+template <class T, class Alloc, size_t BlockSize>
+template <class... Args>
+typename deque<T, Alloc, BlockSize>::iterator
+deque<T, Alloc, BlockSize>::insert_aux(iterator pos, Args&& ...args)
+{
+    value_type value_copy(ctstl::forward<Args>(args)...);  // 参数可能引用容器中的元素
+    const difference_type elems_before = pos - begin_;
+    if (static_cast<size_type>(elems_before) < (size() / 2))
+    {   // 在前半段就在队头插入
+        emplace_front(ctstl::move(front()));
+        iterator front1 = begin_;
+        ++front1;
+        iterator front2 = front1;
+        ++front2;
+        pos = begin_ + elems_before;
+        iterator pos1 = pos;
+        ++pos1;
+        ctstl::move(front2, pos1, front1);
+    }
+    else
+    {   // 在后半段就在队尾插入
+        emplace_back(ctstl::move(back()));
+        iterator back1 = end_;
+        --back1;
+        iterator back2 = back1;
+        --back2;
+        pos = begin_ + elems_before;
+        ctstl::move_backward(pos, back2, back1);
+    }
+    *pos = ctstl::move(value_copy);
+    return pos;
+}
+
+// fill_insert 函数，在中间插入 n 个 value，value 不引用容器中的元素
+template <class T, class Alloc, size_t BlockSize>
+typename deque<T, Alloc, BlockSize>::iterator
+deque<T, Alloc, BlockSize>::fill_insert(iterator pos, size_type n, const value_type& value)
+{
+    const difference_type elems_before = pos - begin_;
+    const difference_type dn = static_cast<difference_type>(n);
+    const size_type len = size();
+    if (static_cast<size_type>(elems_before) < (len / 2))
+    {
+        require_capacity(n, true);
+        iterator old_begin = begin_;
+        iterator new_begin = begin_ - dn;
+        pos = begin_ + elems_before;
+        try
+        {
+            if (elems_before >= dn)
+            {
+                iterator begin_n = begin_ + dn;
+                ctstl::uninitialized_move(begin_, begin_n, new_begin);
+                begin_ = new_begin;
+                ctstl::move(begin_n, pos, old_begin);
+                ctstl::fill(pos - dn, pos, value);
+            }
+            else
+            {
+                ctstl::uninitialized_fill(ctstl::uninitialized_move(begin_, pos, new_begin),
+                                          begin_, value);
+                begin_ = new_begin;
+                ctstl::fill(old_begin, pos, value);
+            }
+        }
+        catch (...)
+        {
+            if (begin_ != new_begin)
+                destroy_buffer(new_begin.node, begin_.node - 1);
+            throw;
+        }
+    }
+    else
+    {
+        require_capacity(n, false);
+        iterator old_end = end_;
+        iterator new_end = end_ + dn;
+        const difference_type elems_after = static_cast<difference_type>(len) - elems_before;
+        pos = end_ - elems_after;
+        try
+        {
+            if (elems_after > dn)
+            {
+                iterator end_n = end_ - dn;
+                ctstl::uninitialized_move(end_n, end_, end_);
+                end_ = new_end;
+                ctstl::move_backward(pos, end_n, old_end);
+                ctstl::fill(pos, pos + dn, value);
+            }
+            else
+            {
+                ctstl::uninitialized_fill(end_, pos + dn, value);
+                ctstl::uninitialized_move(pos, end_, pos + dn);
+                end_ = new_end;
+                ctstl::fill(pos, old_end, value);
+            }
+        }
+        catch (...)
+        {
+            if (end_ != new_end)
+                destroy_buffer(end_.node + 1, new_end.node);
+            throw;
+        }
+    }
+    return begin_ + elems_before;
+}
+
+// copy_insert 函数，在中间插入 [first, last) 的 n 个元素
+template <class T, class Alloc, size_t BlockSize>
+template <class FIter>
+typename deque<T, Alloc, BlockSize>::iterator
+deque<T, Alloc, BlockSize>::copy_insert(iterator pos, FIter first, FIter last, size_type n)
+{
+    const difference_type elems_before = pos - begin_;
+    const difference_type dn = static_cast<difference_type>(n);
+    const size_type len = size();
+    if (static_cast<size_type>(elems_before) < (len / 2))
+    {
+        require_capacity(n, true);
+        iterator old_begin = begin_;
+        iterator new_begin = begin_ - dn;
+        pos = begin_ + elems_before;
+        try
+        {
+            if (elems_before >= dn)
+            {
+                iterator begin_n = begin_ + dn;
+                ctstl::uninitialized_move(begin_, begin_n, new_begin);
+                begin_ = new_begin;
+                ctstl::move(begin_n, pos, old_begin);
+                ctstl::copy(first, last, pos - dn);
+            }
+            else
+            {
+                FIter mid = first;
+                ctstl::advance(mid, dn - elems_before);
+                ctstl::uninitialized_copy(first, mid,
+                                          ctstl::uninitialized_move(begin_, pos, new_begin));
+                begin_ = new_begin;
+                ctstl::copy(mid, last, old_begin);
+            }
+        }
+        catch (...)
+        {
+            if (begin_ != new_begin)
+                destroy_buffer(new_begin.node, begin_.node - 1);
+            throw;
+        }
+    }
+    else
+    {
+        require_capacity(n, false);
+        iterator old_end = end_;
+        iterator new_end = end_ + dn;
+        const difference_type elems_after = static_cast<difference_type>(len) - elems_before;
+        pos = end_ - elems_after;
+        try
+        {
+            if (elems_after > dn)
+            {
+                iterator end_n = end_ - dn;
+                ctstl::uninitialized_move(end_n, end_, end_);
+                end_ = new_end;
+                ctstl::move_backward(pos, end_n, old_end);
+                ctstl::copy(first, last, pos);
+            }
+            else
+            {
+                FIter mid = first;
+                ctstl::advance(mid, elems_after);
+                ctstl::uninitialized_copy(mid, last, end_);
+                ctstl::uninitialized_move(pos, end_, pos + dn);
+                end_ = new_end;
+                ctstl::copy(first, mid, pos);
+            }
+        }
+        catch (...)
+        {
+            if (end_ != new_end)
+                destroy_buffer(end_.node + 1, new_end.node);
+            throw;
+        }
+    }
+    return begin_ + elems_before;
+}
+
+// range_insert 函数
+template <class T, class Alloc, size_t BlockSize>
+template <class IIter>
+typename deque<T, Alloc, BlockSize>::iterator
+deque<T, Alloc, BlockSize>::range_insert(iterator pos, IIter first, IIter last, input_iterator_tag)
+{
+    const difference_type offset = pos - begin_;
+    for (difference_type i = offset; first != last; ++first, ++i)
+        emplace(begin_ + i, *first);
+    return begin_ + offset;
+}
+
+template <class T, class Alloc, size_t BlockSize>
+template <class FIter>
+typename deque<T, Alloc, BlockSize>::iterator
+deque<T, Alloc, BlockSize>::range_insert(iterator pos, FIter first, FIter last, forward_iterator_tag)
+{
+    const size_type n = static_cast<size_type>(ctstl::distance(first, last));
+    if (n == 0)
+        return pos;
+    if (pos.cur == begin_.cur)
+    {
+        require_capacity(n, true);
+        iterator new_begin = begin_ - static_cast<difference_type>(n);
+        try
+        {
+            ctstl::uninitialized_copy(first, last, new_begin);
+        }
+        catch (...)
+        {
+            destroy_buffer(new_begin.node, begin_.node - 1);
+            throw;
+        }
+        begin_ = new_begin;
+        return begin_;
+    }
+    else if (pos.cur == end_.cur)
+    {
+        require_capacity(n, false);
+        iterator new_end = end_ + static_cast<difference_type>(n);
+        try
+        {
+            ctstl::uninitialized_copy(first, last, end_);
+        }
+        catch (...)
+        {
+            destroy_buffer(end_.node + 1, new_end.node);
+            throw;
+        }
+        iterator result = end_;
+        end_ = new_end;
+        return result;
+    }
+    return copy_insert(pos, first, last, n);
+}
+
+// resize_impl 函数，value 为空时值初始化新的元素
+template <class T, class Alloc, size_t BlockSize>
+template <class... Value>
+void deque<T, Alloc, BlockSize>::resize_impl(size_type new_size, const Value&... value)
+{
+    const size_type len = size();
+    if (new_size < len)
+    {
+        erase(begin_ + static_cast<difference_type>(new_size), end_);
+    }
+    else
+    {
+        for (size_type i = len; i < new_size; ++i)
+            emplace_back(value...);
+    }
+}
+
+// require_capacity 函数，保证头部或尾部至少还能放下 n 个元素
+template <class T, class Alloc, size_t BlockSize>
+void deque<T, Alloc, BlockSize>::require_capacity(size_type n, bool front)
+{
+    if (map_.second() == nullptr)  // 被移动过的 deque
+        map_init(0);
+    if (front && (static_cast<size_type>(begin_.cur - begin_.first) < n))
+    {
+        const size_type need_buffer = (n - (begin_.cur - begin_.first) + BlockSize - 1) / BlockSize;
+        if (need_buffer > static_cast<size_type>(begin_.node - map_.second()))
+        {
+            reallocate_map_at_front(need_buffer);
+            return;
+        }
+        create_buffer(begin_.node - need_buffer, begin_.node - 1);
+    }
+    else if (!front && (static_cast<size_type>(end_.last - end_.cur - 1) < n))
+    {
+        const size_type need_buffer = (n - (end_.last - end_.cur - 1) + BlockSize - 1) / BlockSize;
+        if (need_buffer > static_cast<size_type>((map_.second() + map_size_) - end_.node - 1))
+        {
+            reallocate_map_at_back(need_buffer);
+            return;
+        }
+        create_buffer(end_.node + 1, end_.node + need_buffer);
+    }
+}
+
+// reallocate_map_at_front 函数
+template <class T, class Alloc, size_t BlockSize>
+void deque<T, Alloc, BlockSize>::reallocate_map_at_front(size_type need_buffer)
+{
+    const size_type new_map_size = ctstl::max(map_size_ << 1,
+                                              map_size_ + need_buffer + EDequeMapInitSize);
+    map_pointer new_map = create_map(new_map_size);
+    const size_type old_buffer = end_.node - begin_.node + 1;
+    const size_type new_buffer = old_buffer + need_buffer;
+
+    // 另新的 map 中的指针指向原来的 buffer，并开辟新的 buffer
+    map_pointer begin = new_map + (new_map_size - new_buffer) / 2;
+    map_pointer mid = begin + need_buffer;
+    map_pointer end = mid + old_buffer;
+    try
+    {
+        create_buffer(begin, mid - 1);
+    }
+    catch (...)
+    {
+        map_allocator().deallocate(new_map, new_map_size);
+        throw;
+    }
+    for (map_pointer begin1 = mid, begin2 = begin_.node; begin1 != end; ++begin1, ++begin2)
+        *begin1 = *begin2;
+
+    // 更新数据
+    map_allocator().deallocate(map_.second(), map_size_);
+    map_.second() = new_map;
+    map_size_ = new_map_size;
+    begin_ = iterator(*mid + (begin_.cur - begin_.first), mid);
+    end_ = iterator(*(end - 1) + (end_.cur - end_.first), end - 1);
+}
+
+// reallocate_map_at_back 函数
+template <class T, class Alloc, size_t BlockSize>
+void deque<T, Alloc, BlockSize>::reallocate_map_at_back(size_type need_buffer)
+{
+    const size_type new_map_size = ctstl::max(map_size_ << 1,
+                                              map_size_ + need_buffer + EDequeMapInitSize);
+    map_pointer new_map = create_map(new_map_size);
+    const size_type old_buffer = end_.node - begin_.node + 1;
+    const size_type new_buffer = old_buffer + need_buffer;
+
+    // 另新的 map 中的指针指向原来的 buffer，并开辟新的 buffer
+    map_pointer begin = new_map + ((new_map_size - new_buffer) / 2);
+    map_pointer mid = begin + old_buffer;
+    map_pointer end = mid + need_buffer;
+    try
+    {
+        create_buffer(mid, end - 1);
+    }
+    catch (...)
+    {
+        map_allocator().deallocate(new_map, new_map_size);
+        throw;
+    }
+    for (map_pointer begin1 = begin, begin2 = begin_.node; begin1 != mid; ++begin1, ++begin2)
+        *begin1 = *begin2;
+
+    // 更新数据
+    map_allocator().deallocate(map_.second(), map_size_);
+    map_.second() = new_map;
+    map_size_ = new_map_size;
+    begin_ = iterator(*begin + (begin_.cur - begin_.first), begin);
+    end_ = iterator(*(mid - 1) + (end_.cur - end_.first), mid - 1);
+}
+
+// 重载比较操作符
+template <class T, class Alloc, size_t BlockSize>
+bool operator==(const deque<T, Alloc, BlockSize>& lhs, const deque<T, Alloc, BlockSize>& rhs)
+{
+    return lhs.size() == rhs.size() &&
+        ctstl::equal(lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
+}
+
+template <class T, class Alloc, size_t BlockSize>
+bool operator<(const deque<T, Alloc, BlockSize>& lhs, const deque<T, Alloc, BlockSize>& rhs)
+{
+    return ctstl::lexicographical_compare(
+        lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
+}
+
+template <class T, class Alloc, size_t BlockSize>
+bool operator!=(const deque<T, Alloc, BlockSize>& lhs, const deque<T, Alloc, BlockSize>& rhs)
+{
+    return !(lhs == rhs);
+}
+
+template <class T, class Alloc, size_t BlockSize>
+bool operator>(const deque<T, Alloc, BlockSize>& lhs, const deque<T, Alloc, BlockSize>& rhs)
+{
+    return rhs < lhs;
+}
+
+template <class T, class Alloc, size_t BlockSize>
+bool operator<=(const deque<T, Alloc, BlockSize>& lhs, const deque<T, Alloc, BlockSize>& rhs)
+{
+    return !(rhs < lhs);
+}
+
+template <class T, class Alloc, size_t BlockSize>
+bool operator>=(const deque<T, Alloc, BlockSize>& lhs, const deque<T, Alloc, BlockSize>& rhs)
+{
+    return !(lhs < rhs);
+}
+
+// 重载 ctstl 的 swap
+template <class T, class Alloc, size_t BlockSize>
+void swap(deque<T, Alloc, BlockSize>& lhs, deque<T, Alloc, BlockSize>& rhs) noexcept
+{
+    lhs.swap(rhs);
+}
+
+} // namespace ctstl
+#endif // !CTSTL_DEQUE_H_
@@ -0,0 +1,196 @@
+#ifndef CTSTL_EPOCH_H_
+#define CTSTL_EPOCH_H_
+
+// 这个头文件包含基于纪元的内存回收（epoch-based reclamation）：epoch_domain 与 epoch_guard
+// 读者不加锁地访问共享结构，进入临界区时在自己的线程记录中登记当前全局纪元，离开时撤销登记
+// 写者把摘下的节点标记上摘下时的全局纪元，放入自己的待回收链表
+// 只有当所有处于临界区的线程都已登记了当前纪元时，全局纪元才能前进一步，
+// 因此全局纪元比节点上的标记大 2 时，不可能还有读者持有这个节点，可以安全释放
+// 待回收链表由使用者自己维护（例如 concurrent_hash_map 在每个锁条带中保存一份），
+// epoch_domain 只负责纪元的登记与推进
+
+#include <atomic>
+#include <cstdint>
+
+namespace ctstl
+{
+
+// 线程记录，每个使用过 epoch_domain 的线程占用一个，线程退出后可以被其它线程复用
+// 记录一旦发布就不会释放
+struct epoch_record
+{
+    std::atomic<uint64_t> state;    // (epoch << 1) | 1 表示线程处于临界区，0 表示不在
+    std::atomic<bool>     in_use;
+    epoch_record*         next;
+    unsigned              nesting;  // 临界区嵌套层数，只由拥有者线程访问
+};
+
+// 模板类：epoch_domain_template
+// 模板参数 Inst 只用于区分互不相干的多个实例
+template <int Inst>
+class epoch_domain_template
+{
+private:
+    // 线程本地部分，只包含平凡类型，使得 thread_local 变量不需要动态初始化
+    struct thread_slot
+    {
+        epoch_record* record;
+        bool          registered;  // 是否已经注册线程退出时的清理
+        bool          dead;        // 线程正在退出，记录已经归还
+    };
+
+    // 线程退出时归还线程记录
+    struct record_releaser
+    {
+        ~record_releaser()
+        {
+            thread_slot& ts = local_slot();
+            if (ts.record != nullptr && ts.record->nesting == 0)
+            {
+                M_release(ts.record);
+                ts.record = nullptr;
+            }
+            ts.dead = true;
+        }
+    };
+
+    static std::atomic<uint64_t>      global_epoch;
+    static std::atomic<epoch_record*> records;
+
+public:
+    static void     enter();
+    static void     leave();
+    static uint64_t current() noexcept { return global_epoch.load(std::memory_order_seq_cst); }
+    static bool     try_advance() noexcept;
+
+    // 在纪元 retire_epoch 摘下的节点现在是否可以释放
+    static bool is_safe(uint64_t retire_epoch) noexcept
+    {
+        return retire_epoch + 2 <= global_epoch.load(std::memory_order_acquire);
+    }
+
+private:
+    static thread_slot&  local_slot();
+    static epoch_record* M_acquire();
+    static void          M_release(epoch_record* r) noexcept;
+};
+
+template <int Inst>
+std::atomic<uint64_t> epoch_domain_template<Inst>::global_epoch(0);
+
+template <int Inst>
+std::atomic<epoch_record*> epoch_domain_template<Inst>::records(nullptr);
+
+typedef epoch_domain_template<0> epoch_domain;
+
+template <int Inst>
+typename epoch_domain_template<Inst>::thread_slot&
+epoch_domain_template<Inst>::local_slot()
+{
+    static thread_local thread_slot ts;
+    return ts;
+}
+
+// 进入临界区，可以嵌套
+template <int Inst>
+void epoch_domain_template<Inst>::enter()
+{
+    thread_slot& ts = local_slot();
+    if (ts.record == nullptr)
+    {
+        if (!ts.registered && !ts.dead)
+        {   // 第一次进入时注册线程退出时的清理
+            ts.registered = true;
+            static thread_local record_releaser releaser;
+            (void)releaser;
+        }
+        ts.record = M_acquire();
+    }
+    epoch_record* r = ts.record;
+    if (r->nesting++ == 0)
+    {
+        const uint64_t e = global_epoch.load(std::memory_order_relaxed);
+        r->state.store((e << 1) | 1, std::memory_order_seq_cst);
+        // 之后对共享结构的读取不能提前到登记之前
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+    }
+}
+
+// 离开临界区
+template <int Inst>
+void epoch_domain_template<Inst>::leave()
+{
+    thread_slot& ts = local_slot();
+    epoch_record* r = ts.record;
+    if (--r->nesting == 0)
+    {
+        r->state.store(0, std::memory_order_release);
+        if (ts.dead)
+        {   // 线程退出之后才用到的记录，用完立即归还
+            M_release(r);
+            ts.record = nullptr;
+        }
+    }
+}
+
+// 所有处于临界区的线程都已登记当前纪元时，把全局纪元推进一步
+template <int Inst>
+bool epoch_domain_template<Inst>::try_advance() noexcept
+{
+    const uint64_t e = global_epoch.load(std::memory_order_acquire);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    for (epoch_record* r = records.load(std::memory_order_acquire); r != nullptr; r = r->next)
+    {
+        const uint64_t s = r->state.load(std::memory_order_acquire);
+        if ((s & 1) != 0 && (s >> 1) != e)
+            return false;
+    }
+    uint64_t expected = e;
+    return global_epoch.compare_exchange_strong(expected, e + 1, std::memory_order_acq_rel)
+        || expected > e;
+}
+
+// 复用一个空闲的线程记录，没有就新建一个
+template <int Inst>
+epoch_record* epoch_domain_template<Inst>::M_acquire()
+{
+    for (epoch_record* r = records.load(std::memory_order_acquire); r != nullptr; r = r->next)
+    {
+        bool expected = false;
+        if (!r->in_use.load(std::memory_order_relaxed) &&
+            r->in_use.compare_exchange_strong(expected, true, std::memory_order_acquire))
+            return r;
+    }
+    epoch_record* r = new epoch_record;
+    r->state.store(0, std::memory_order_relaxed);
+    r->in_use.store(true, std::memory_order_relaxed);
+    r->nesting = 0;
+    r->next = records.load(std::memory_order_relaxed);
+    while (!records.compare_exchange_weak(r->next, r, std::memory_order_release,
+                                          std::memory_order_relaxed))
+    {
+    }
+    return r;
+}
+
+template <int Inst>
+void epoch_domain_template<Inst>::M_release(epoch_record* r) noexcept
+{
+    r->state.store(0, std::memory_order_release);
+    r->in_use.store(false, std::memory_order_release);
+}
+
+// 类：epoch_guard
+// 构造时进入临界区，析构时离开，在它的生存期内读到的节点不会被释放
+class epoch_guard
+{
+public:
+    epoch_guard()  { epoch_domain::enter(); }
+    ~epoch_guard() { epoch_domain::leave(); }
+
+    epoch_guard(const epoch_guard&) = delete;
+    epoch_guard& operator=(const epoch_guard&) = delete;
+};
+
+} // namespace ctstl
+#endif // !CTSTL_EPOCH_H_
@@ -0,0 +1,220 @@
+#ifndef CTSTL_FLAT_HASH_SET_H_
+#define CTSTL_FLAT_HASH_SET_H_
+
+// 这个头文件包含一个模板类 flat_hash_set
+// flat_hash_set : 开放定址的哈希集合，键值不允许重复，底层为 flat_hash_table
+// 与 node 式的哈希表不同，插入、rehash 会使迭代器和元素的引用失效
+
+#include <initializer_list>
+
+#include "flat_hash_table.h"
+
+namespace ctstl
+{
+
+// 模板类 flat_hash_set
+// 参数一代表键值类型，参数二代表哈希函数，参数三代表键值比较方式，参数四代表空间配置器
+template <class Key, class Hash = ctstl::hash<Key>, class KeyEqual = ctstl::equal_to<Key>,
+          class Alloc = ctstl::allocator<Key>>
+class flat_hash_set
+{
+private:
+    typedef flat_hash_table<Key, Key, ctstl::identity<Key>, Hash, KeyEqual, Alloc> base_type;
+    base_type ht_;
+
+public:
+    // 使用 flat_hash_table 的型别
+    typedef typename base_type::allocator_type    allocator_type;
+    typedef typename base_type::key_type          key_type;
+    typedef typename base_type::value_type        value_type;
+    typedef typename base_type::hasher            hasher;
+    typedef typename base_type::key_equal         key_equal;
+
+    typedef typename base_type::size_type         size_type;
+    typedef typename base_type::difference_type   difference_type;
+    typedef typename base_type::pointer           pointer;
+    typedef typename base_type::const_pointer     const_pointer;
+    typedef typename base_type::reference         reference;
+    typedef typename base_type::const_reference   const_reference;
+
+    // 元素即键值，不允许通过迭代器修改
+    typedef typename base_type::const_iterator    iterator;
+    typedef typename base_type::const_iterator    const_iterator;
+
+    allocator_type get_allocator() const { return ht_.get_allocator(); }
+
+public:
+    // 构造、复制、移动函数
+
+    flat_hash_set()
+        : ht_(0) {}
+
+    explicit flat_hash_set(size_type bucket_count,
+                           const hasher& hash = hasher(),
+                           const key_equal& equal = key_equal(),
+                           const allocator_type& a = allocator_type())
+        : ht_(bucket_count, hash, equal, a) {}
+
+    template <class InputIterator>
+    flat_hash_set(InputIterator first, InputIterator last,
+                  const size_type bucket_count = 0,
+                  const hasher& hash = hasher(),
+                  const key_equal& equal = key_equal(),
+                  const allocator_type& a = allocator_type())
+        : ht_(bucket_count, hash, equal, a)
+    {
+        ht_.insert_unique(first, last);
+    }
+
+    flat_hash_set(std::initializer_list<value_type> ilist,
+                  const size_type bucket_count = 0,
+                  const hasher& hash = hasher(),
+                  const key_equal& equal = key_equal(),
+                  const allocator_type& a = allocator_type())
+        : ht_(bucket_count, hash, equal, a)
+    {
+        ht_.reserve(ilist.size());
+        ht_.insert_unique(ilist.begin(), ilist.end());
+    }
+
+    flat_hash_set(const flat_hash_set& rhs)
+        : ht_(rhs.ht_) {}
+    flat_hash_set(flat_hash_set&& rhs) noexcept
+        : ht_(ctstl::move(rhs.ht_)) {}
+
+    flat_hash_set& operator=(const flat_hash_set& rhs)
+    {
+        ht_ = rhs.ht_;
+        return *this;
+    }
+    flat_hash_set& operator=(flat_hash_set&& rhs) noexcept(std::is_empty<Alloc>::value)
+    {
+        ht_ = ctstl::move(rhs.ht_);
+        return *this;
+    }
+
+    flat_hash_set& operator=(std::initializer_list<value_type> ilist)
+    {
+        ht_.clear();
+        ht_.reserve(ilist.size());
+        ht_.insert_unique(ilist.begin(), ilist.end());
+        return *this;
+    }
+
+    ~flat_hash_set() = default;
+
+    // 迭代器相关
+    iterator       begin()  const noexcept { return ht_.begin(); }
+    iterator       end()    const noexcept { return ht_.end(); }
+    const_iterator cbegin() const noexcept { return ht_.cbegin(); }
+    const_iterator cend()   const noexcept { return ht_.cend(); }
+
+    // 容量相关
+    bool      empty()    const noexcept { return ht_.empty(); }
+    size_type size()     const noexcept { return ht_.size(); }
+    size_type max_size() const noexcept { return ht_.max_size(); }
+
+    // 修改容器操作
+
+    // emplace / emplace_hint
+    template <class ...Args>
+    ctstl::pair<iterator, bool> emplace(Args&& ...args)
+    {
+        ctstl::pair<typename base_type::iterator, bool> res = ht_.emplace_unique(ctstl::forward<Args>(args)...);
+        return ctstl::pair<iterator, bool>(res.first, res.second);
+    }
+
+    template <class ...Args>
+    iterator emplace_hint(const_iterator /*hint*/, Args&& ...args)
+    { return ht_.emplace_unique(ctstl::forward<Args>(args)...).first; }
+
+    // insert
+    ctstl::pair<iterator, bool> insert(const value_type& value)
+    {
+        ctstl::pair<typename base_type::iterator, bool> res = ht_.insert_unique(value);
+        return ctstl::pair<iterator, bool>(res.first, res.second);
+    }
+    ctstl::pair<iterator, bool> insert(value_type&& value)
+    {
+        ctstl::pair<typename base_type::iterator, bool> res = ht_.insert_unique(ctstl::move(value));
+        return ctstl::pair<iterator, bool>(res.first, res.second);
+    }
+
+    iterator insert(const_iterator /*hint*/, const value_type& value)
+    { return ht_.insert_unique(value).first; }
+    iterator insert(const_iterator /*hint*/, value_type&& value)
+    { return ht_.insert_unique(ctstl::move(value)).first; }
+
+    template <class InputIterator>
+    void insert(InputIterator first, InputIterator last)
+    { ht_.insert_unique(first, last); }
+
+    void insert(std::initializer_list<value_type> ilist)
+    { ht_.insert_unique(ilist.begin(), ilist.end()); }
+
+    // erase / clear
+    iterator  erase(const_iterator it)
+    { return ht_.erase(it); }
+    iterator  erase(const_iterator first, const_iterator last)
+    { return ht_.erase(first, last); }
+    size_type erase(const key_type& key)
+    { return ht_.erase_unique(key); }
+
+    void      clear() noexcept
+    { ht_.clear(); }
+
+    void      swap(flat_hash_set& other) noexcept
+    { ht_.swap(other.ht_); }
+
+    // 查找相关
+
+    size_type      count(const key_type& key) const
+    { return ht_.count(key); }
+
+    bool           contains(const key_type& key) const
+    { return ht_.count(key) != 0; }
+
+    const_iterator find(const key_type& key) const
+    { return ht_.find(key); }
+
+    // bucket interface
+
+    size_type bucket_count()     const noexcept
+    { return ht_.bucket_count(); }
+    size_type max_bucket_count() const noexcept
+    { return ht_.max_bucket_count(); }
+
+    // hash policy
+
+    float     load_factor()            const noexcept { return ht_.load_factor(); }
+
+    float     max_load_factor()        const noexcept { return ht_.max_load_factor(); }
+    void      max_load_factor(float ml)               { ht_.max_load_factor(ml); }
+
+    void      rehash(size_type count)                 { ht_.rehash(count); }
+    void      reserve(size_type count)                { ht_.reserve(count); }
+
+    hasher    hash_fcn()               const          { return ht_.hash_fcn(); }
+    key_equal key_eq()                 const          { return ht_.key_eq(); }
+
+public:
+    friend bool operator==(const flat_hash_set& lhs, const flat_hash_set& rhs)
+    {
+        return lhs.ht_.equal_to(rhs.ht_);
+    }
+    friend bool operator!=(const flat_hash_set& lhs, const flat_hash_set& rhs)
+    {
+        return !lhs.ht_.equal_to(rhs.ht_);
+    }
+};
+
+// 重载 ctstl 的 swap
+template <class Key, class Hash, class KeyEqual, class Alloc>
+void swap(flat_hash_set<Key, Hash, KeyEqual, Alloc>& lhs,
+          flat_hash_set<Key, Hash, KeyEqual, Alloc>& rhs) noexcept
+{
+    lhs.swap(rhs);
+}
+
+} // namespace ctstl
+#endif // !CTSTL_FLAT_HASH_SET_H_
@@ -0,0 +1,1035 @@
+#ifndef CTSTL_FLAT_HASH_TABLE_H_
+#define CTSTL_FLAT_HASH_TABLE_H_
+
+// 这个头文件包含一个模板类 flat_hash_table，作为 flat_hash_map / flat_hash_set 的底层
+//
+// 1. 结构
+// 开放定址：元素直接保存在 slots_ 数组中，另有一个与之对应的 1 字节控制数组 ctrl_，
+// 控制字节为 EFlatHashEmpty / EFlatHashDeleted / EFlatHashSentinel，或者是元素哈希值的低 7 位（H2）
+// 容量总是 2^k - 1，ctrl_[capacity] 是哨兵，之后的 EFlatHashGroupWidth - 1 个字节复制 ctrl_ 开头的字节，
+// 使得从任何位置开始都能一次读取一整组控制字节
+//
+// 2. 查找
+// 以哈希值的高位（H1）决定起点，每次比较一组（16 个）控制字节，支持 SSE2 时用一条比较指令完成，
+// 否则逐字节比较；只有 H2 相同的位置才真正比较 key，遇到空位即可停止
+//
+// 3. 删除
+// 如果删除位置所在的窗口中从来没有满过（前后都有空位），查找序列不可能越过这里，直接标记为空位；
+// 否则标记为墓碑（EFlatHashDeleted），墓碑过多时在原容量上重建
+//
+// 异常保证：插入单个元素时提供强异常安全保证
+
+#include <cstdint>
+#include <cstring>
+#include <initializer_list>
+#include <type_traits>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define CTSTL_HAS_SSE2 1
+#endif
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+#include "iterator.h"
+#include "memory.h"
+#include "functional.h"
+#include "util.h"
+#include "exceptdef.h"
+
+namespace ctstl
+{
+
+// 控制字节
+typedef signed char flat_hash_ctrl;
+
+enum { EFlatHashEmpty = -128 };    // 空位
+enum { EFlatHashDeleted = -2 };    // 墓碑
+enum { EFlatHashSentinel = -1 };   // 哨兵，位于 ctrl_[capacity]
+
+// 一次比较的控制字节个数
+enum { EFlatHashGroupWidth = 16 };
+
+// 最小的非零容量，保证一组控制字节不会越过复制的部分
+enum { EFlatHashMinCapacity = EFlatHashGroupWidth - 1 };
+
+// 空表共用的控制字节
+template <class Dummy = void>
+struct flat_hash_empty_group
+{
+    static const flat_hash_ctrl value[EFlatHashGroupWidth];
+};
+
+template <class Dummy>
+const flat_hash_ctrl flat_hash_empty_group<Dummy>::value[EFlatHashGroupWidth] = {
+    EFlatHashSentinel, EFlatHashEmpty, EFlatHashEmpty, EFlatHashEmpty,
+    EFlatHashEmpty,    EFlatHashEmpty, EFlatHashEmpty, EFlatHashEmpty,
+    EFlatHashEmpty,    EFlatHashEmpty, EFlatHashEmpty, EFlatHashEmpty,
+    EFlatHashEmpty,    EFlatHashEmpty, EFlatHashEmpty, EFlatHashEmpty
+};
+
+// 最低位的 1 的位置，x 不能为 0
+inline unsigned flat_hash_ctz(uint32_t x) noexcept
+{
+#if defined(__GNUC__) || defined(__clang__)
+    return static_cast<unsigned>(__builtin_ctz(x));
+#elif defined(_MSC_VER)
+    unsigned long index;
+    _BitScanForward(&index, x);
+    return static_cast<unsigned>(index);
+#else
+    unsigned n = 0;
+    for (; (x & 1) == 0; x >>= 1)
+        ++n;
+    return n;
+#endif
+}
+
+// 16 位掩码中，最高位的 1 之前的 0 的个数，x 不能为 0
+inline unsigned flat_hash_clz16(uint32_t x) noexcept
+{
+#if defined(__GNUC__) || defined(__clang__)
+    return static_cast<unsigned>(__builtin_clz(x)) - 16;
+#elif defined(_MSC_VER)
+    unsigned long index;
+    _BitScanReverse(&index, x);
+    return 15 - static_cast<unsigned>(index);
+#else
+    unsigned n = 0;
+    for (uint32_t bit = 0x8000; (x & bit) == 0; bit >>= 1)
+        ++n;
+    return n;
+#endif
+}
+
+// 把 hash 函数的结果充分混合，使 H1 与 H2 都依赖全部的位
+inline size_t flat_hash_mix(size_t h) noexcept
+{
+#if defined(__SIZEOF_INT128__) && __SIZEOF_POINTER__ == 8
+    const unsigned __int128 r = static_cast<unsigned __int128>(h) * 0x9E3779B97F4A7C15ull;
+    return static_cast<size_t>(r >> 64) ^ static_cast<size_t>(r);
+#else
+    h ^= h >> 16;
+    h *= static_cast<size_t>(0x85EBCA6Bu);
+    h ^= h >> 13;
+    h *= static_cast<size_t>(0xC2B2AE35u);
+    h ^= h >> 16;
+    return h;
+#endif
+}
+
+// 一组控制字节，match 系列函数返回一个位掩码，第 i 位表示第 i 个字节满足条件
+struct flat_hash_group
+{
+#if defined(CTSTL_HAS_SSE2)
+    __m128i ctrl;
+
+    explicit flat_hash_group(const flat_hash_ctrl* p) noexcept
+        : ctrl(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p))) {}
+
+    // H2 等于 h 的位置
+    uint32_t match(flat_hash_ctrl h) const noexcept
+    {
+        return static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_set1_epi8(h), ctrl)));
+    }
+
+    // 空位
+    uint32_t match_empty() const noexcept
+    {
+        return match(static_cast<flat_hash_ctrl>(EFlatHashEmpty));
+    }
+
+    // 空位或者墓碑
+    uint32_t match_empty_or_deleted() const noexcept
+    {
+        const __m128i sentinel = _mm_set1_epi8(static_cast<char>(EFlatHashSentinel));
+        return static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpgt_epi8(sentinel, ctrl)));
+    }
+#else
+    flat_hash_ctrl ctrl[EFlatHashGroupWidth];
+
+    explicit flat_hash_group(const flat_hash_ctrl* p) noexcept
+    {
+        std::memcpy(ctrl, p, EFlatHashGroupWidth);
+    }
+
+    uint32_t match(flat_hash_ctrl h) const noexcept
+    {
+        uint32_t mask = 0;
+        for (unsigned i = 0; i < EFlatHashGroupWidth; ++i)
+            mask |= static_cast<uint32_t>(ctrl[i] == h) << i;
+        return mask;
+    }
+
+    uint32_t match_empty() const noexcept
+    {
+        return match(static_cast<flat_hash_ctrl>(EFlatHashEmpty));
+    }
+
+    uint32_t match_empty_or_deleted() const noexcept
+    {
+        uint32_t mask = 0;
+        for (unsigned i = 0; i < EFlatHashGroupWidth; ++i)
+            mask |= static_cast<uint32_t>(ctrl[i] < EFlatHashSentinel) << i;
+        return mask;
+    }
+#endif
+
+    // 开头连续的空位或墓碑的个数
+    unsigned count_leading_empty_or_deleted() const noexcept
+    {
+        return flat_hash_ctz(match_empty_or_deleted() + 1);
+    }
+};
+
+// flat_hash_table 的迭代器，跳过空位与墓碑，停在哨兵上
+template <class T, class Ref, class Ptr>
+struct flat_hash_iterator : public iterator<forward_iterator_tag, T, ptrdiff_t, Ptr, Ref>
+{
+    typedef flat_hash_iterator<T, T&, T*>             iterator;
+    typedef flat_hash_iterator<T, const T&, const T*> const_iterator;
+    typedef flat_hash_iterator                        self;
+
+    typedef T            value_type;
+    typedef Ptr          pointer;
+    typedef Ref          reference;
+
+    const flat_hash_ctrl* ctrl;  // 当前位置的控制字节
+    T*                    slot;  // 当前位置的元素
+
+    flat_hash_iterator() noexcept : ctrl(nullptr), slot(nullptr) {}
+    flat_hash_iterator(const flat_hash_ctrl* c, T* s) noexcept : ctrl(c), slot(s) {}
+    flat_hash_iterator(const iterator& rhs) noexcept : ctrl(rhs.ctrl), slot(rhs.slot) {}
+
+    self& operator=(const iterator& rhs) noexcept
+    {
+        ctrl = rhs.ctrl;
+        slot = rhs.slot;
+        return *this;
+    }
+
+    reference operator*()  const { return *slot; }
+    pointer   operator->() const { return slot; }
+
+    self& operator++()
+    {
+        CTSTL_DEBUG(*ctrl >= 0);
+        ++ctrl;
+        ++slot;
+        skip_empty_or_deleted();
+        return *this;
+    }
+    self operator++(int)
+    {
+        self tmp = *this;
+        ++*this;
+        return tmp;
+    }
+
+    bool operator==(const self& rhs) const { return ctrl == rhs.ctrl; }
+    bool operator!=(const self& rhs) const { return ctrl != rhs.ctrl; }
+
+    void skip_empty_or_deleted() noexcept
+    {
+        while (*ctrl < EFlatHashSentinel)
+        {
+            const unsigned shift = flat_hash_group(ctrl).count_leading_empty_or_deleted();
+            ctrl += shift;
+            slot += shift;
+        }
+    }
+};
+
+// 模板类 flat_hash_table
+// Value 为元素类型，ExtractKey 从元素中取出 Key，Hash / KeyEqual 为哈希函数与判等函数
+template <class Value, class Key, class ExtractKey, class Hash, class KeyEqual, class Alloc>
+class flat_hash_table
+{
+public:
+    typedef Value                                          value_type;
+    typedef Key                                            key_type;
+    typedef Hash                                           hasher;
+    typedef KeyEqual                                       key_equal;
+    typedef Alloc                                          allocator_type;
+
+    typedef value_type*                                    pointer;
+    typedef const value_type*                              const_pointer;
+    typedef value_type&                                    reference;
+    typedef const value_type&                              const_reference;
+    typedef size_t                                         size_type;
+    typedef ptrdiff_t                                      difference_type;
+
+    typedef flat_hash_iterator<Value, Value&, Value*>             iterator;
+    typedef flat_hash_iterator<Value, const Value&, const Value*> const_iterator;
+
+    allocator_type get_allocator() const { return size_.first(); }
+
+private:
+    typedef typename Alloc::template rebind<value_type>::other     slot_allocator_type;
+    typedef typename Alloc::template rebind<flat_hash_ctrl>::other ctrl_allocator_type;
+
+    // 扩容时能不抛出异常地移动就移动，否则复制，使 rehash 失败时原来的表保持不变
+    typedef typename std::conditional<
+        !std::is_nothrow_move_constructible<value_type>::value &&
+        std::is_copy_constructible<value_type>::value,
+        const value_type&, value_type&&>::type transfer_ref;
+
+    // 哈希函数可能抛出异常时，扩容先算出全部元素的新位置再搬移，见 transfer_hashed_first
+    typedef std::integral_constant<bool, noexcept(
+        std::declval<const hasher&>()(std::declval<const key_type&>()))> nothrow_hash;
+
+    flat_hash_ctrl*                              ctrl_;         // 控制字节，capacity_ + EFlatHashGroupWidth 个
+    value_type*                                  slots_;        // 元素，capacity_ 个
+    size_type                                    capacity_;     // 0 或 2^k - 1
+    size_type                                    growth_left_;  // 不必 rehash 还能放入的元素个数
+    float                                        mlf_;          // 最大负载因子
+    compressed_pair<hasher, key_equal>           funcs_;        // 哈希函数与判等函数
+    compressed_pair<allocator_type, size_type>   size_;         // 配置器，以及元素个数
+
+public:
+    // 构造、复制、移动、析构函数
+    explicit flat_hash_table(size_type bucket_count,
+                             const hasher& hash = hasher(),
+                             const key_equal& equal = key_equal(),
+                             const allocator_type& a = allocator_type())
+        : ctrl_(empty_ctrl()), slots_(nullptr), capacity_(0), growth_left_(0),
+          mlf_(0.875f), funcs_(hash, equal), size_(a, 0)
+    {
+        if (bucket_count > 0)
+            resize(normalize_capacity(bucket_count));
+    }
+
+    flat_hash_table(const flat_hash_table& rhs)
+        : ctrl_(empty_ctrl()), slots_(nullptr), capacity_(0), growth_left_(0),
+          mlf_(rhs.mlf_), funcs_(rhs.funcs_.first(), rhs.funcs_.second()),
+          size_(rhs.size_.first(), 0)
+    {
+        copy_from(rhs);
+    }
+
+    flat_hash_table(flat_hash_table&& rhs) noexcept
+        : ctrl_(rhs.ctrl_), slots_(rhs.slots_), capacity_(rhs.capacity_),
+          growth_left_(rhs.growth_left_), mlf_(rhs.mlf_),
+          funcs_(ctstl::move(rhs.funcs_.first()), ctstl::move(rhs.funcs_.second())),
+          size_(ctstl::move(rhs.size_.first()), rhs.size_.second())
+    {
+        rhs.reset_empty();
+    }
+
+    // 赋值时配置器保持不变，临时的表使用自己的配置器
+    flat_hash_table& operator=(const flat_hash_table& rhs)
+    {
+        if (this != &rhs)
+        {
+            flat_hash_table tmp(0, rhs.funcs_.first(), rhs.funcs_.second(), get_allocator());
+            tmp.mlf_ = rhs.mlf_;
+            tmp.copy_from(rhs);
+            swap(tmp);
+        }
+        return *this;
+    }
+
+    // 与 rhs 的配置器相等时直接接管 rhs 的空间，否则逐个移动元素
+    flat_hash_table& operator=(flat_hash_table&& rhs) noexcept(std::is_empty<Alloc>::value)
+    {
+        if (this == &rhs)
+            return *this;
+        if (ctstl::allocator_equal(size_.first(), rhs.size_.first()))
+        {
+            flat_hash_table tmp(ctstl::move(rhs));
+            swap(tmp);
+        }
+        else
+        {
+            flat_hash_table tmp(0, rhs.funcs_.first(), rhs.funcs_.second(), get_allocator());
+            tmp.mlf_ = rhs.mlf_;
+            tmp.move_from(rhs);
+            swap(tmp);
+            rhs.clear();
+        }
+        return *this;
+    }
+
+    ~flat_hash_table()
+    {
+        release();
+    }
+
+    // 迭代器相关操作
+    iterator begin() noexcept
+    {
+        iterator it(ctrl_, slots_);
+        it.skip_empty_or_deleted();
+        return it;
+    }
+    const_iterator begin() const noexcept
+    {
+        const_iterator it(ctrl_, slots_);
+        it.skip_empty_or_deleted();
+        return it;
+    }
+    iterator       end()          noexcept { return iterator(ctrl_ + capacity_, slots_ + capacity_); }
+    const_iterator end()    const noexcept { return const_iterator(ctrl_ + capacity_, slots_ + capacity_); }
+
+    const_iterator cbegin() const noexcept { return begin(); }
+    const_iterator cend()   const noexcept { return end(); }
+
+    // 容量相关操作
+    bool      empty()    const noexcept { return size() == 0; }
+    size_type size()     const noexcept { return size_.second(); }
+    size_type max_size() const noexcept { return static_cast<size_type>(-1) / sizeof(value_type); }
+
+    // 修改容器相关操作
+
+    // 查找 key，找不到时为它预留一个位置（可能 rehash），返回位置以及是否已经存在
+    // 预留的位置需要紧接着用 emplace_at 构造元素
+    template <class K>
+    ctstl::pair<size_type, bool> find_or_prepare_insert(const K& key, size_type& hash);
+
+    // 在 find_or_prepare_insert 预留的位置上构造元素
+    template <class ...Args>
+    iterator emplace_at(size_type index, size_type hash, Args&& ...args);
+
+    iterator iterator_at(size_type index) noexcept
+    {
+        return iterator(ctrl_ + index, slots_ + index);
+    }
+
+    template <class ...Args>
+    ctstl::pair<iterator, bool> emplace_unique(Args&& ...args)
+    {
+        value_type tmp(ctstl::forward<Args>(args)...);
+        return insert_unique(ctstl::move(tmp));
+    }
+
+    ctstl::pair<iterator, bool> insert_unique(const value_type& value)
+    {
+        return insert_unique_impl(value);
+    }
+    ctstl::pair<iterator, bool> insert_unique(value_type&& value)
+    {
+        return insert_unique_impl(ctstl::move(value));
+    }
+
+    template <class IIter>
+    void insert_unique(IIter first, IIter last)
+    {
+        for (; first != last; ++first)
+            insert_unique(*first);
+    }
+
+    // erase / clear
+    iterator  erase(const_iterator pos);
+    iterator  erase(const_iterator first, const_iterator last);
+    template <class K>
+    size_type erase_unique(const K& key);
+    void      clear() noexcept;
+
+    void      swap(flat_hash_table& rhs) noexcept;
+
+    // 查找相关操作
+    template <class K>
+    iterator find(const K& key)
+    {
+        const size_type index = find_index(key, hash_of(key));
+        return index == npos() ? end() : iterator_at(index);
+    }
+    template <class K>
+    const_iterator find(const K& key) const
+    {
+        const size_type index = find_index(key, hash_of(key));
+        return index == npos() ? end() : const_iterator(ctrl_ + index, slots_ + index);
+    }
+
+    template <class K>
+    size_type count(const K& key) const
+    {
+        return find_index(key, hash_of(key)) == npos() ? 0 : 1;
+    }
+
+    // bucket 与 hash 策略相关操作
+    size_type bucket_count()     const noexcept { return capacity_; }
+    size_type max_bucket_count() const noexcept { return max_size(); }
+
+    float     load_factor() const noexcept
+    { return capacity_ != 0 ? static_cast<float>(size()) / static_cast<float>(capacity_) : 0.0f; }
+
+    float     max_load_factor() const noexcept { return mlf_; }
+    void      max_load_factor(float ml);
+
+    void      rehash(size_type count);
+    void      reserve(size_type count);
+
+    hasher    hash_fcn() const { return funcs_.first(); }
+    key_equal key_eq()   const { return funcs_.second(); }
+
+    bool      equal_to(const flat_hash_table& rhs) const;
+
+private:
+    // helper functions
+
+    static flat_hash_ctrl* empty_ctrl() noexcept
+    {
+        return const_cast<flat_hash_ctrl*>(flat_hash_empty_group<>::value);
+    }
+
+    slot_allocator_type slot_allocator() const
+    {
+        return ctstl::rebind_allocator<slot_allocator_type>(size_.first());
+    }
+
+    ctrl_allocator_type ctrl_allocator() const
+    {
+        return ctstl::rebind_allocator<ctrl_allocator_type>(size_.first());
+    }
+
+    static size_type npos() noexcept { return static_cast<size_type>(-1); }
+
+    static size_type      h1(size_type hash) noexcept { return hash >> 7; }
+    static flat_hash_ctrl h2(size_type hash) noexcept { return static_cast<flat_hash_ctrl>(hash & 0x7F); }
+
+    // 哈希函数的结果没有充分混合时（比如 identity_hash），先混合再使用
+    template <class K>
+    size_type hash_of(const K& key) const
+    {
+        const size_type h = funcs_.first()(key);
+        return hash_is_avalanching<hasher>::value ? h : flat_hash_mix(h);
+    }
+
+    const key_type& key_of(const value_type& value) const
+    {
+        return ExtractKey()(value);
+    }
+
+    // 容量为 capacity 时最多能放入的元素个数，至少保留一个空位使查找一定能够停止
+    size_type growth_of(size_type capacity) const noexcept
+    {
+        const size_type g = static_cast<size_type>(static_cast<double>(capacity) * mlf_);
+        return capacity == 0 ? 0 : (g < capacity ? g : capacity - 1);
+    }
+
+    static size_type normalize_capacity(size_type n) noexcept
+    {
+        size_type cap = EFlatHashMinCapacity;
+        while (cap < n)
+            cap = cap * 2 + 1;
+        return cap;
+    }
+
+    // 能放入 n 个元素的最小容量，负载因子很小时也至少能放入一个元素
+    size_type capacity_for(size_type n) const noexcept
+    {
+        size_type cap = EFlatHashMinCapacity;
+        while (growth_of(cap) < n || growth_of(cap) == 0)
+            cap = cap * 2 + 1;
+        return cap;
+    }
+
+    // 设置控制字节，同时更新 ctrl_ 末尾复制的部分
+    void set_ctrl(size_type index, flat_hash_ctrl h) noexcept
+    {
+        ctrl_[index] = h;
+        ctrl_[((index - (EFlatHashGroupWidth - 1)) & capacity_) + (EFlatHashGroupWidth - 1)] = h;
+    }
+
+    template <class K>
+    size_type find_index(const K& key, size_type hash) const;
+    size_type find_first_non_full(size_type hash) const noexcept;
+
+    template <class V>
+    ctstl::pair<iterator, bool> insert_unique_impl(V&& value);
+
+    void      erase_at(size_type index) noexcept;
+    void      rehash_and_grow_if_necessary();
+    void      resize(size_type new_capacity);
+    void      transfer_hashed_first(flat_hash_ctrl* old_ctrl, value_type* old_slots,
+                                    size_type old_capacity, size_type old_size);
+    void      reset_ctrl() noexcept;
+    void      copy_from(const flat_hash_table& rhs);
+    void      move_from(flat_hash_table& rhs);
+    void      destroy_slots() noexcept;
+    void      release() noexcept;
+    void      reset_empty() noexcept;
+};
+
+/*****************************************************************************************/
+
+template <class V, class K, class E, class H, class Eq, class A>
+template <class Key>
+ctstl::pair<typename flat_hash_table<V, K, E, H, Eq, A>::size_type, bool>
+flat_hash_table<V, K, E, H, Eq, A>::find_or_prepare_insert(const Key& key, size_type& hash)
+{
+    hash = hash_of(key);
+    const size_type index = find_index(key, hash);
+    if (index != npos())
+        return ctstl::pair<size_type, bool>(index, true);
+    THROW_LENGTH_ERROR_IF(size() >= max_size(), "flat_hash_table<T>'s size too big");
+    size_type target = find_first_non_full(hash);
+    if (growth_left_ == 0 && ctrl_[target] != EFlatHashDeleted)
+    {
+        rehash_and_grow_if_necessary();
+        target = find_first_non_full(hash);
+    }
+    return ctstl::pair<size_type, bool>(target, false);
+}
+
+// 先构造元素，成功后才修改控制字节，构造时抛出异常不会留下半个元素
+template <class V, class K, class E, class H, class Eq, class A>
+template <class ...Args>
+typename flat_hash_table<V, K, E, H, Eq, A>::iterator
+flat_hash_table<V, K, E, H, Eq, A>::emplace_at(size_type index, size_type hash, Args&& ...args)
+{
+    ctstl::construct(slots_ + index, ctstl::forward<Args>(args)...);
+    if (ctrl_[index] == EFlatHashEmpty)
+    {
+        CTSTL_DEBUG(growth_left_ > 0);
+        growth_left_ -= (growth_left_ > 0);
+    }
+    set_ctrl(index, h2(hash));
+    ++size_.second();
+    return iterator_at(index);
+}
+
+// 删除 pos 处的元素
+template <class V, class K, class E, class H, class Eq, class A>
+typename flat_hash_table<V, K, E, H, Eq, A>::iterator
+flat_hash_table<V, K, E, H, Eq, A>::erase(const_iterator pos)
+{
+    CTSTL_DEBUG(pos != cend());
+    const size_type index = static_cast<size_type>(pos.ctrl - ctrl_);
+    erase_at(index);
+    iterator next = iterator_at(index);
+    next.skip_empty_or_deleted();
+    return next;
+}
+
+// 删除[first, last)内的元素
+template <class V, class K, class E, class H, class Eq, class A>
+typename flat_hash_table<V, K, E, H, Eq, A>::iterator
+flat_hash_table<V, K, E, H, Eq, A>::erase(const_iterator first, const_iterator last)
+{
+    if (first == cbegin() && last == cend())
+    {
+        clear();
+        return end();
+    }
+    while (first != last)
+        first = erase(first);
+    return iterator_at(static_cast<size_type>(last.ctrl - ctrl_));
+}
+
+// 删除键值为 key 的元素
+template <class V, class K, class E, class H, class Eq, class A>
+template <class Key>
+typename flat_hash_table<V, K, E, H, Eq, A>::size_type
+flat_hash_table<V, K, E, H, Eq, A>::erase_unique(const Key& key)
+{
+    const size_type index = find_index(key, hash_of(key));
+    if (index == npos())
+        return 0;
+    erase_at(index);
+    return 1;
+}
+
+// 清空元素，保留容量
+template <class V, class K, class E, class H, class Eq, class A>
+void flat_hash_table<V, K, E, H, Eq, A>::clear() noexcept
+{
+    if (capacity_ == 0)
+        return;
+    destroy_slots();
+    reset_ctrl();
+    size_.second() = 0;
+    growth_left_ = growth_of(capacity_);
+}
+
+template <class V, class K, class E, class H, class Eq, class A>
+void flat_hash_table<V, K, E, H, Eq, A>::swap(flat_hash_table& rhs) noexcept
+{
+    if (this != &rhs)
+    {
+        CTSTL_DEBUG(ctstl::allocator_equal(size_.first(), rhs.size_.first()));
+        ctstl::swap(ctrl_, rhs.ctrl_);
+        ctstl::swap(slots_, rhs.slots_);
+        ctstl::swap(capacity_, rhs.capacity_);
+        ctstl::swap(growth_left_, rhs.growth_left_);
+        ctstl::swap(mlf_, rhs.mlf_);
+        ctstl::swap(funcs_.first(), rhs.funcs_.first());
+        ctstl::swap(funcs_.second(), rhs.funcs_.second());
+        ctstl::swap(size_.second(), rhs.size_.second());
+    }
+}
+
+// 设置最大负载因子，ml 的范围为 (0, 1]
+template <class V, class K, class E, class H, class Eq, class A>
+void flat_hash_table<V, K, E, H, Eq, A>::max_load_factor(float ml)
+{
+    THROW_OUT_RANGE_IF(!(ml > 0.0f && ml <= 1.0f), "flat_hash_table<T>::max_load_factor out of range");
+    // 已经占用的位置（元素与墓碑）
+    const size_type used = growth_of(capacity_) - growth_left_;
+    mlf_ = ml;
+    const size_type growth = growth_of(capacity_);
+    // 新的负载因子下放不下已占用的位置，或者一个元素也放不下，都要换成更大的表
+    if (growth < used || (capacity_ != 0 && growth == 0))
+        resize(capacity_for(size()));
+    else
+        growth_left_ = growth - used;
+}
+
+// 重新调整容量，count 为 0 时缩小到恰好能放下当前元素
+template <class V, class K, class E, class H, class Eq, class A>
+void flat_hash_table<V, K, E, H, Eq, A>::rehash(size_type count)
+{
+    if (count == 0 && size() == 0)
+    {
+        release();
+        reset_empty();
+        return;
+    }
+    const size_type by_size = capacity_for(size());
+    const size_type by_count = normalize_capacity(count);
+    resize(by_size > by_count ? by_size : by_count);
+}
+
+// 预留空间，之后插入 count 个元素之前不会 rehash
+template <class V, class K, class E, class H, class Eq, class A>
+void flat_hash_table<V, K, E, H, Eq, A>::reserve(size_type count)
+{
+    if (count > size() + growth_left_)
+        resize(capacity_for(count));
+}
+
+// 元素个数相同，并且每个元素都能在另一个表中找到相等的元素
+template <class V, class K, class E, class H, class Eq, class A>
+bool flat_hash_table<V, K, E, H, Eq, A>::equal_to(const flat_hash_table& rhs) const
+{
+    if (size() != rhs.size())
+        return false;
+    for (const_iterator it = begin(), e = end(); it != e; ++it)
+    {
+        const_iterator other = rhs.find(key_of(*it));
+        if (other == rhs.end() || !(*other == *it))
+            return false;
+    }
+    return true;
+}
+
+/*****************************************************************************************/
+// helper function
+
+// 查找 key 所在的位置，找不到时返回 npos()
+template <class V, class K, class E, class H, class Eq, class A>
+template <class Key>
+typename flat_hash_table<V, K, E, H, Eq, A>::size_type
+flat_hash_table<V, K, E, H, Eq, A>::find_index(const Key& key, size_type hash) const
+{
+    const flat_hash_ctrl tag = h2(hash);
+    size_type offset = h1(hash) & capacity_;
+    size_type step = 0;
+    while (true)
+    {
+        const flat_hash_group g(ctrl_ + offset);
+        for (uint32_t mask = g.match(tag); mask != 0; mask &= mask - 1)
+        {
+            const size_type index = (offset + flat_hash_ctz(mask)) & capacity_;
+            if (funcs_.second()(key_of(slots_[index]), key))
+                return index;
+        }
+        if (g.match_empty() != 0)
+            return npos();
+        // 以组为单位做二次探测，容量为 2 的幂减一时能够遍历所有的组
+        step += EFlatHashGroupWidth;
+        offset = (offset + step) & capacity_;
+    }
+}
+
+// 查找第一个空位或墓碑，表中至少有一个空位
+template <class V, class K, class E, class H, class Eq, class A>
+typename flat_hash_table<V, K, E, H, Eq, A>::size_type
+flat_hash_table<V, K, E, H, Eq, A>::find_first_non_full(size_type hash) const noexcept
+{
+    size_type offset = h1(hash) & capacity_;
+    size_type step = 0;
+    while (true)
+    {
+        const uint32_t mask = flat_hash_group(ctrl_ + offset).match_empty_or_deleted();
+        if (mask != 0)
+            return (offset + flat_hash_ctz(mask)) & capacity_;
+        step += EFlatHashGroupWidth;
+        offset = (offset + step) & capacity_;
+    }
+}
+
+template <class V, class K, class E, class H, class Eq, class A>
+template <class Value>
+ctstl::pair<typename flat_hash_table<V, K, E, H, Eq, A>::iterator, bool>
+flat_hash_table<V, K, E, H, Eq, A>::insert_unique_impl(Value&& value)
+{
+    size_type hash = 0;
+    const ctstl::pair<size_type, bool> res = find_or_prepare_insert(key_of(value), hash);
+    if (res.second)
+        return ctstl::pair<iterator, bool>(iterator_at(res.first), false);
+    return ctstl::pair<iterator, bool>(
+        emplace_at(res.first, hash, ctstl::forward<Value>(value)), true);
+}
+
+// 删除 index 处的元素，能不留墓碑时直接标记为空位
+template <class V, class K, class E, class H, class Eq, class A>
+void flat_hash_table<V, K, E, H, Eq, A>::erase_at(size_type index) noexcept
+{
+    ctstl::destroy(slots_ + index);
+    --size_.second();
+    const size_type before = (index - EFlatHashGroupWidth) & capacity_;
+    const uint32_t empty_after = flat_hash_group(ctrl_ + index).match_empty();
+    const uint32_t empty_before = flat_hash_group(ctrl_ + before).match_empty();
+    // 包含 index 的任何一个窗口中都有空位，说明没有查找序列越过这个位置
+    const bool was_never_full = empty_before != 0 && empty_after != 0 &&
+        flat_hash_ctz(empty_after) + flat_hash_clz16(empty_before) < EFlatHashGroupWidth;
+    if (was_never_full)
+    {
+        set_ctrl(index, static_cast<flat_hash_ctrl>(EFlatHashEmpty));
+        ++growth_left_;
+    }
+    else
+    {
+        set_ctrl(index, static_cast<flat_hash_ctrl>(EFlatHashDeleted));
+    }
+}
+
+// 空间用完时，墓碑较多就在原容量上重建，否则容量加倍
+// 只有重建后还能再放入元素（growth_of(capacity_) > size()）才在原容量上重建
+template <class V, class K, class E, class H, class Eq, class A>
+void flat_hash_table<V, K, E, H, Eq, A>::rehash_and_grow_if_necessary()
+{
+    const size_type growth = growth_of(capacity_);
+    if (capacity_ == 0)
+        resize(capacity_for(1));
+    else if (growth > size() && size() * 2 <= growth)
+        resize(capacity_);
+    else
+    {
+        // 负载因子很小时加倍一次可能还不够，至少要能再放入一个元素
+        const size_type doubled = capacity_ * 2 + 1;
+        const size_type needed = capacity_for(size() + 1);
+        resize(doubled > needed ? doubled : needed);
+    }
+}
+
+// 把所有元素搬到容量为 new_capacity 的新表中，失败时原来的表保持不变
+template <class V, class K, class E, class H, class Eq, class A>
+void flat_hash_table<V, K, E, H, Eq, A>::resize(size_type new_capacity)
+{
+    CTSTL_DEBUG(growth_of(new_capacity) >= size());
+    flat_hash_ctrl* old_ctrl = ctrl_;
+    value_type* old_slots = slots_;
+    const size_type old_capacity = capacity_;
+    const size_type old_growth_left = growth_left_;
+    const size_type old_size = size();
+
+    flat_hash_ctrl* new_ctrl = ctrl_allocator().allocate(new_capacity + EFlatHashGroupWidth);
+    value_type* new_slots = nullptr;
+    try
+    {
+        new_slots = slot_allocator().allocate(new_capacity);
+    }
+    catch (...)
+    {
+        ctrl_allocator().deallocate(new_ctrl, new_capacity + EFlatHashGroupWidth);
+        throw;
+    }
+    std::memset(new_ctrl, static_cast<unsigned char>(EFlatHashEmpty), new_capacity + EFlatHashGroupWidth);
+    new_ctrl[new_capacity] = EFlatHashSentinel;
+
+    ctrl_ = new_ctrl;
+    slots_ = new_slots;
+    capacity_ = new_capacity;
+    growth_left_ = growth_of(new_capacity);
+    size_.second() = 0;
+    try
+    {
+        if (!nothrow_hash::value && old_size != 0)
+        {
+            transfer_hashed_first(old_ctrl, old_slots, old_capacity, old_size);
+        }
+        else
+        {
+            for (size_type i = 0; i < old_capacity; ++i)
+            {
+                if (old_ctrl[i] >= 0)
+                {
+                    const size_type hash = hash_of(key_of(old_slots[i]));
+                    emplace_at(find_first_non_full(hash), hash, static_cast<transfer_ref>(old_slots[i]));
+                }
+            }
+        }
+    }
+    catch (...)
+    {
+        release();
+        ctrl_ = old_ctrl;
+        slots_ = old_slots;
+        capacity_ = old_capacity;
+        growth_left_ = old_growth_left;
+        size_.second() = old_size;
+        throw;
+    }
+
+    if (old_capacity != 0)
+    {
+        for (size_type i = 0; i < old_capacity; ++i)
+        {
+            if (old_ctrl[i] >= 0)
+                ctstl::destroy(old_slots + i);
+        }
+        slot_allocator().deallocate(old_slots, old_capacity);
+        ctrl_allocator().deallocate(old_ctrl, old_capacity + EFlatHashGroupWidth);
+    }
+}
+
+// 哈希函数可能抛出异常时的扩容：先为每个元素算出在新表中的位置，全部成功之后才开始搬移，
+// 否则哈希函数中途失败时，前面的元素已经被移走，原来的表里只剩下移动后的空壳
+// 失败时新表中不留下任何元素，由 resize 释放新表并恢复原来的表
+template <class V, class K, class E, class H, class Eq, class A>
+void flat_hash_table<V, K, E, H, Eq, A>::transfer_hashed_first(
+    flat_hash_ctrl* old_ctrl, value_type* old_slots, size_type old_capacity, size_type old_size)
+{
+    typedef typename A::template rebind<size_type>::other index_allocator_type;
+    index_allocator_type alloc = ctstl::rebind_allocator<index_allocator_type>(size_.first());
+    size_type* index = alloc.allocate(old_size);
+    size_type n = 0;
+    try
+    {
+        for (size_type i = 0; i < old_capacity; ++i)
+        {
+            if (old_ctrl[i] >= 0)
+            {
+                const size_type hash = hash_of(key_of(old_slots[i]));
+                const size_type pos = find_first_non_full(hash);
+                set_ctrl(pos, h2(hash));
+                index[n++] = pos;
+            }
+        }
+    }
+    catch (...)
+    {
+        alloc.deallocate(index, old_size);
+        reset_ctrl();
+        throw;
+    }
+
+    size_type k = 0;
+    try
+    {
+        for (size_type i = 0; i < old_capacity; ++i)
+        {
+            if (old_ctrl[i] >= 0)
+            {
+                ctstl::construct(slots_ + index[k], static_cast<transfer_ref>(old_slots[i]));
+                ++k;
+            }
+        }
+    }
+    catch (...)
+    {
+        for (size_type j = 0; j < k; ++j)
+            ctstl::destroy(slots_ + index[j]);
+        alloc.deallocate(index, old_size);
+        reset_ctrl();
+        throw;
+    }
+    alloc.deallocate(index, old_size);
+    growth_left_ -= old_size;
+    size_.second() = old_size;
+}
+
+// 把当前表的控制字节全部置为空，不析构元素
+template <class V, class K, class E, class H, class Eq, class A>
+void flat_hash_table<V, K, E, H, Eq, A>::reset_ctrl() noexcept
+{
+    std::memset(ctrl_, static_cast<unsigned char>(EFlatHashEmpty), capacity_ + EFlatHashGroupWidth);
+    ctrl_[capacity_] = EFlatHashSentinel;
+}
+
+// 复制 rhs 中的元素，当前表必须为空
+template <class V, class K, class E, class H, class Eq, class A>
+void flat_hash_table<V, K, E, H, Eq, A>::copy_from(const flat_hash_table& rhs)
+{
+    if (rhs.empty())
+        return;
+    resize(capacity_for(rhs.size()));
+    try
+    {
+        for (const_iterator it = rhs.begin(), e = rhs.end(); it != e; ++it)
+        {
+            const size_type hash = hash_of(key_of(*it));
+            emplace_at(find_first_non_full(hash), hash, *it);
+        }
+    }
+    catch (...)
+    {
+        release();
+        reset_empty();
+        throw;
+    }
+}
+
+// 与 copy_from 相同，但逐个移动 rhs 的元素，rhs 中的元素只剩下被移动后的状态
+template <class V, class K, class E, class H, class Eq, class A>
+void flat_hash_table<V, K, E, H, Eq, A>::move_from(flat_hash_table& rhs)
+{
+    if (rhs.empty())
+        return;
+    resize(capacity_for(rhs.size()));
+    try
+    {
+        for (iterator it = rhs.begin(), e = rhs.end(); it != e; ++it)
+        {
+            const size_type hash = hash_of(key_of(*it));
+            emplace_at(find_first_non_full(hash), hash, ctstl::move(*it));
+        }
+    }
+    catch (...)
+    {
+        release();
+        reset_empty();
+        throw;
+    }
+}
+
+template <class V, class K, class E, class H, class Eq, class A>
+void flat_hash_table<V, K, E, H, Eq, A>::destroy_slots() noexcept
+{
+    if (std::is_trivially_destructible<value_type>::value)
+        return;
+    for (size_type i = 0; i < capacity_; ++i)
+    {
+        if (ctrl_[i] >= 0)
+            ctstl::destroy(slots_ + i);
+    }
+}
+
+// 析构所有元素并释放内存，不重置成员
+template <class V, class K, class E, class H, class Eq, class A>
+void flat_hash_table<V, K, E, H, Eq, A>::release() noexcept
+{
+    if (capacity_ == 0)
+        return;
+    destroy_slots();
+    slot_allocator().deallocate(slots_, capacity_);
+    ctrl_allocator().deallocate(ctrl_, capacity_ + EFlatHashGroupWidth);
+}
+
+template <class V, class K, class E, class H, class Eq, class A>
+void flat_hash_table<V, K, E, H, Eq, A>::reset_empty() noexcept
+{
+    ctrl_ = empty_ctrl();
+    slots_ = nullptr;
+    capacity_ = 0;
+    growth_left_ = 0;
+    size_.second() = 0;
+}
+
+} // namespace ctstl
+#endif // !CTSTL_FLAT_HASH_TABLE_H_
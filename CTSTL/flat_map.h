@@ -0,0 +1,374 @@
+#ifndef CTSTL_FLAT_MAP_H_
+#define CTSTL_FLAT_MAP_H_
+
+// 这个头文件包含一个模板类 flat_map
+// flat_map : 有序映射，键值不允许重复，元素按键值顺序连续存放在 vector 中，底层为 flat_tree
+// 查找是在数组上二分，适合查找远多于修改、偶尔整体重建的查找表；
+// 单个插入、删除需要搬动其后的元素，批量修改请使用 insert_range
+// 插入、删除会使迭代器和元素的引用失效
+//
+// 1. 存放方式
+// 模板参数 Layout 为 flat_interleaved_layout（缺省）时以 vector<pair<Key, T>> 存放，迭代器是普通指针；
+// 为 flat_split_layout 时键值与实值分别存放在两个 vector 中，二分查找只访问键值数组，
+// 此时迭代器的 reference 是代理类型 pair<const Key&, T&>，可以用 keys() / values() 直接访问两个数组
+
+#include <initializer_list>
+
+#include "flat_tree.h"
+#include "algobase.h"
+
+namespace ctstl
+{
+
+// 根据 Layout 选择 flat_tree 的 storage
+template <class Key, class T, class Alloc, class Layout>
+struct flat_map_storage;
+
+template <class Key, class T, class Alloc>
+struct flat_map_storage<Key, T, Alloc, flat_interleaved_layout>
+{
+    typedef flat_interleaved_storage<Key, T, Alloc> type;
+};
+
+template <class Key, class T, class Alloc>
+struct flat_map_storage<Key, T, Alloc, flat_split_layout>
+{
+    typedef flat_split_storage<Key, T, Alloc> type;
+};
+
+// 模板类 flat_map
+// 参数一代表键值类型，参数二代表实值类型，参数三代表键值比较方式，缺省使用 ctstl::less，
+// 参数四代表空间配置器，参数五代表存放方式
+template <class Key, class T, class Compare = ctstl::less<Key>,
+          class Alloc = ctstl::allocator<ctstl::pair<const Key, T>>,
+          class Layout = flat_interleaved_layout>
+class flat_map
+{
+public:
+    // flat_map 的型别定义
+    typedef Key                        key_type;
+    typedef T                          mapped_type;
+    typedef ctstl::pair<const Key, T>  value_type;
+    typedef Compare                    key_compare;
+
+    // 定义一个 functor，用来进行元素比较
+    class value_compare : public binary_function<value_type, value_type, bool>
+    {
+        friend class flat_map<Key, T, Compare, Alloc, Layout>;
+    private:
+        Compare comp;
+        value_compare(Compare c) : comp(c) {}
+    public:
+        bool operator()(const value_type& lhs, const value_type& rhs) const
+        {
+            return comp(lhs.first, rhs.first);
+        }
+    };
+
+private:
+    typedef typename flat_map_storage<Key, T, Alloc, Layout>::type  storage_type;
+    typedef flat_tree<storage_type, key_compare>                     base_type;
+    base_type tree_;
+
+public:
+    // 使用 flat_tree 的型别
+    typedef typename base_type::allocator_type          allocator_type;
+    typedef typename base_type::size_type               size_type;
+    typedef typename base_type::difference_type         difference_type;
+    typedef typename base_type::pointer                 pointer;
+    typedef typename base_type::const_pointer           const_pointer;
+    typedef typename base_type::reference               reference;
+    typedef typename base_type::const_reference         const_reference;
+    typedef typename base_type::iterator                iterator;
+    typedef typename base_type::const_iterator          const_iterator;
+    typedef typename base_type::reverse_iterator        reverse_iterator;
+    typedef typename base_type::const_reverse_iterator  const_reverse_iterator;
+
+    allocator_type get_allocator() const { return tree_.get_allocator(); }
+    key_compare    key_comp()      const { return tree_.key_comp(); }
+    value_compare  value_comp()    const { return value_compare(tree_.key_comp()); }
+
+public:
+    // 构造、复制、移动函数
+
+    flat_map() = default;
+
+    explicit flat_map(const key_compare& comp, const allocator_type& a = allocator_type())
+        : tree_(comp, a) {}
+
+    template <class InputIterator>
+    flat_map(InputIterator first, InputIterator last,
+             const key_compare& comp = key_compare(),
+             const allocator_type& a = allocator_type())
+        : tree_(comp, a)
+    {
+        tree_.insert_range(first, last);
+    }
+
+    // 从严格递增的序列构造，O(n)
+    template <class InputIterator>
+    flat_map(sorted_unique_t, InputIterator first, InputIterator last,
+             const key_compare& comp = key_compare(),
+             const allocator_type& a = allocator_type())
+        : tree_(comp, a)
+    {
+        tree_.assign_sorted_unique(first, last);
+    }
+
+    flat_map(std::initializer_list<value_type> ilist,
+             const key_compare& comp = key_compare(),
+             const allocator_type& a = allocator_type())
+        : tree_(comp, a)
+    {
+        tree_.insert_range(ilist.begin(), ilist.end());
+    }
+
+    flat_map(const flat_map& rhs)
+        : tree_(rhs.tree_) {}
+    flat_map(flat_map&& rhs) noexcept
+        : tree_(ctstl::move(rhs.tree_)) {}
+
+    flat_map& operator=(const flat_map& rhs)
+    {
+        tree_ = rhs.tree_;
+        return *this;
+    }
+    flat_map& operator=(flat_map&& rhs) noexcept
+    {
+        tree_ = ctstl::move(rhs.tree_);
+        return *this;
+    }
+
+    flat_map& operator=(std::initializer_list<value_type> ilist)
+    {
+        tree_.clear();
+        tree_.insert_range(ilist.begin(), ilist.end());
+        return *this;
+    }
+
+    ~flat_map() = default;
+
+    // 迭代器相关
+    iterator               begin()         noexcept { return tree_.begin(); }
+    const_iterator         begin()   const noexcept { return tree_.begin(); }
+    iterator               end()           noexcept { return tree_.end(); }
+    const_iterator         end()     const noexcept { return tree_.end(); }
+
+    reverse_iterator       rbegin()        noexcept { return tree_.rbegin(); }
+    const_reverse_iterator rbegin()  const noexcept { return tree_.rbegin(); }
+    reverse_iterator       rend()          noexcept { return tree_.rend(); }
+    const_reverse_iterator rend()    const noexcept { return tree_.rend(); }
+
+    const_iterator         cbegin()  const noexcept { return tree_.cbegin(); }
+    const_iterator         cend()    const noexcept { return tree_.cend(); }
+    const_reverse_iterator crbegin() const noexcept { return tree_.crbegin(); }
+    const_reverse_iterator crend()   const noexcept { return tree_.crend(); }
+
+    // 容量相关
+    bool      empty()    const noexcept { return tree_.empty(); }
+    size_type size()     const noexcept { return tree_.size(); }
+    size_type max_size() const noexcept { return tree_.max_size(); }
+    size_type capacity() const noexcept { return tree_.capacity(); }
+    void      reserve(size_type n)      { tree_.reserve(n); }
+    void      shrink_to_fit()           { tree_.shrink_to_fit(); }
+
+    // 修改容器操作
+
+    // emplace / emplace_hint
+    template <class ...Args>
+    ctstl::pair<iterator, bool> emplace(Args&& ...args)
+    { return tree_.emplace_unique(ctstl::forward<Args>(args)...); }
+
+    template <class ...Args>
+    iterator emplace_hint(const_iterator hint, Args&& ...args)
+    { return tree_.emplace_unique_hint(hint, ctstl::forward<Args>(args)...); }
+
+    // try_emplace: key 已经存在时不构造实值
+    template <class ...Args>
+    ctstl::pair<iterator, bool> try_emplace(const key_type& key, Args&& ...args)
+    { return try_emplace_impl(key, key, ctstl::forward<Args>(args)...); }
+
+    template <class ...Args>
+    ctstl::pair<iterator, bool> try_emplace(key_type&& key, Args&& ...args)
+    { return try_emplace_impl(key, ctstl::move(key), ctstl::forward<Args>(args)...); }
+
+    // insert
+    ctstl::pair<iterator, bool> insert(const value_type& value)
+    { return tree_.insert_unique(value); }
+    ctstl::pair<iterator, bool> insert(value_type&& value)
+    { return tree_.insert_unique(ctstl::move(value)); }
+
+    iterator insert(const_iterator hint, const value_type& value)
+    { return tree_.insert_unique(hint, value); }
+    iterator insert(const_iterator hint, value_type&& value)
+    { return tree_.insert_unique(hint, ctstl::move(value)); }
+
+    template <class InputIterator>
+    void insert(InputIterator first, InputIterator last)
+    { tree_.insert_range(first, last); }
+
+    // [first, last) 已经严格递增，省去排序
+    template <class InputIterator>
+    void insert(sorted_unique_t, InputIterator first, InputIterator last)
+    { tree_.insert_sorted_unique(first, last); }
+
+    void insert(std::initializer_list<value_type> ilist)
+    { tree_.insert_range(ilist.begin(), ilist.end()); }
+
+    // insert_range: 一次排序、归并插入 [first, last)，代价为 O(m log m + size())
+    // 键值重复的元素中保留哪一个是未指定的，已经存在的键值不会被覆盖
+    template <class InputIterator>
+    void insert_range(InputIterator first, InputIterator last)
+    { tree_.insert_range(first, last); }
+
+    // insert_or_assign: key 已经存在时给实值赋值
+    template <class M>
+    ctstl::pair<iterator, bool> insert_or_assign(const key_type& key, M&& obj)
+    {
+        ctstl::pair<iterator, bool> res = try_emplace(key, ctstl::forward<M>(obj));
+        if (!res.second)
+            res.first->second = ctstl::forward<M>(obj);
+        return res;
+    }
+
+    template <class M>
+    ctstl::pair<iterator, bool> insert_or_assign(key_type&& key, M&& obj)
+    {
+        ctstl::pair<iterator, bool> res = try_emplace(ctstl::move(key), ctstl::forward<M>(obj));
+        if (!res.second)
+            res.first->second = ctstl::forward<M>(obj);
+        return res;
+    }
+
+    // erase / clear
+    iterator  erase(const_iterator it)
+    { return tree_.erase(it); }
+    iterator  erase(const_iterator first, const_iterator last)
+    { return tree_.erase(first, last); }
+    size_type erase(const key_type& key)
+    { return tree_.erase_unique(key); }
+
+    void      clear() noexcept
+    { tree_.clear(); }
+
+    void      swap(flat_map& other) noexcept
+    { tree_.swap(other.tree_); }
+
+    // 查找相关
+
+    mapped_type& at(const key_type& key)
+    {
+        iterator it = tree_.find(key);
+        THROW_OUT_RANGE_IF(it == end(), "flat_map<Key, T> no such element exists");
+        return it->second;
+    }
+    const mapped_type& at(const key_type& key) const
+    {
+        const_iterator it = tree_.find(key);
+        THROW_OUT_RANGE_IF(it == cend(), "flat_map<Key, T> no such element exists");
+        return it->second;
+    }
+
+    mapped_type& operator[](const key_type& key)
+    { return try_emplace(key).first->second; }
+    mapped_type& operator[](key_type&& key)
+    { return try_emplace(ctstl::move(key)).first->second; }
+
+    size_type      count(const key_type& key) const
+    { return tree_.count_unique(key); }
+
+    bool           contains(const key_type& key) const
+    { return tree_.count_unique(key) != 0; }
+
+    iterator       find(const key_type& key)
+    { return tree_.find(key); }
+    const_iterator find(const key_type& key) const
+    { return tree_.find(key); }
+
+    iterator       lower_bound(const key_type& key)
+    { return tree_.lower_bound(key); }
+    const_iterator lower_bound(const key_type& key) const
+    { return tree_.lower_bound(key); }
+
+    iterator       upper_bound(const key_type& key)
+    { return tree_.upper_bound(key); }
+    const_iterator upper_bound(const key_type& key) const
+    { return tree_.upper_bound(key); }
+
+    ctstl::pair<iterator, iterator>
+                   equal_range(const key_type& key)
+    { return tree_.equal_range_unique(key); }
+    ctstl::pair<const_iterator, const_iterator>
+                   equal_range(const key_type& key) const
+    { return tree_.equal_range_unique(key); }
+
+    // 键值数组、实值数组，只有 flat_split_layout 可用
+    template <class S = storage_type>
+    const typename S::key_container_type&    keys()   const noexcept
+    { return tree_.storage().keys(); }
+    template <class S = storage_type>
+    const typename S::mapped_container_type& values() const noexcept
+    { return tree_.storage().values(); }
+
+public:
+    friend bool operator==(const flat_map& lhs, const flat_map& rhs)
+    {
+        return lhs.size() == rhs.size() && ctstl::equal(lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
+    }
+    friend bool operator<(const flat_map& lhs, const flat_map& rhs)
+    {
+        return ctstl::lexicographical_compare(lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
+    }
+
+private:
+    // lookup 用来查找，k 用来构造键值，二者通常引用同一个对象
+    template <class K, class ...Args>
+    ctstl::pair<iterator, bool> try_emplace_impl(const key_type& lookup, K&& k, Args&& ...args)
+    {
+        const ctstl::pair<size_type, bool> res = tree_.find_or_prepare_insert(lookup);
+        if (res.second)
+            return ctstl::pair<iterator, bool>(begin() + res.first, false);
+        return ctstl::pair<iterator, bool>(
+            tree_.emplace_at(res.first, ctstl::forward<K>(k), ctstl::forward<Args>(args)...), true);
+    }
+};
+
+// 重载比较操作符
+template <class Key, class T, class Compare, class Alloc, class Layout>
+bool operator!=(const flat_map<Key, T, Compare, Alloc, Layout>& lhs,
+                const flat_map<Key, T, Compare, Alloc, Layout>& rhs)
+{
+    return !(lhs == rhs);
+}
+
+template <class Key, class T, class Compare, class Alloc, class Layout>
+bool operator>(const flat_map<Key, T, Compare, Alloc, Layout>& lhs,
+               const flat_map<Key, T, Compare, Alloc, Layout>& rhs)
+{
+    return rhs < lhs;
+}
+
+template <class Key, class T, class Compare, class Alloc, class Layout>
+bool operator<=(const flat_map<Key, T, Compare, Alloc, Layout>& lhs,
+                const flat_map<Key, T, Compare, Alloc, Layout>& rhs)
+{
+    return !(rhs < lhs);
+}
+
+template <class Key, class T, class Compare, class Alloc, class Layout>
+bool operator>=(const flat_map<Key, T, Compare, Alloc, Layout>& lhs,
+                const flat_map<Key, T, Compare, Alloc, Layout>& rhs)
+{
+    return !(lhs < rhs);
+}
+
+// 重载 ctstl 的 swap
+template <class Key, class T, class Compare, class Alloc, class Layout>
+void swap(flat_map<Key, T, Compare, Alloc, Layout>& lhs,
+          flat_map<Key, T, Compare, Alloc, Layout>& rhs) noexcept
+{
+    lhs.swap(rhs);
+}
+
+} // namespace ctstl
+#endif // !CTSTL_FLAT_MAP_H_
@@ -0,0 +1,261 @@
+#ifndef CTSTL_FLAT_SET_H_
+#define CTSTL_FLAT_SET_H_
+
+// 这个头文件包含一个模板类 flat_set
+// flat_set : 有序集合，键值不允许重复，元素按顺序连续存放在 vector 中，底层为 flat_tree
+// 查找是在数组上二分，适合查找远多于修改、偶尔整体重建的查找表；
+// 单个插入、删除需要搬动其后的元素，批量修改请使用 insert_range
+// 插入、删除会使迭代器和元素的引用失效
+
+#include <initializer_list>
+
+#include "flat_tree.h"
+#include "algobase.h"
+
+namespace ctstl
+{
+
+// 模板类 flat_set
+// 参数一代表键值类型，参数二代表键值比较方式，缺省使用 ctstl::less，参数三代表空间配置器
+template <class Key, class Compare = ctstl::less<Key>, class Alloc = ctstl::allocator<Key>>
+class flat_set
+{
+public:
+    // flat_set 的型别定义
+    typedef Key        key_type;
+    typedef Key        value_type;
+    typedef Compare    key_compare;
+    typedef Compare    value_compare;
+
+private:
+    typedef flat_tree<flat_set_storage<Key, Alloc>, key_compare> base_type;
+    base_type tree_;
+
+public:
+    // 使用 flat_tree 的型别
+    typedef typename base_type::allocator_type          allocator_type;
+    typedef typename base_type::size_type               size_type;
+    typedef typename base_type::difference_type         difference_type;
+    typedef typename base_type::pointer                 pointer;
+    typedef typename base_type::const_pointer           const_pointer;
+    typedef typename base_type::reference               reference;
+    typedef typename base_type::const_reference         const_reference;
+
+    // 元素即键值，不允许通过迭代器修改
+    typedef typename base_type::iterator                iterator;
+    typedef typename base_type::const_iterator          const_iterator;
+    typedef typename base_type::reverse_iterator        reverse_iterator;
+    typedef typename base_type::const_reverse_iterator  const_reverse_iterator;
+
+    allocator_type get_allocator() const { return tree_.get_allocator(); }
+    key_compare    key_comp()      const { return tree_.key_comp(); }
+    value_compare  value_comp()    const { return tree_.key_comp(); }
+
+public:
+    // 构造、复制、移动函数
+
+    flat_set() = default;
+
+    explicit flat_set(const key_compare& comp, const allocator_type& a = allocator_type())
+        : tree_(comp, a) {}
+
+    template <class InputIterator>
+    flat_set(InputIterator first, InputIterator last,
+             const key_compare& comp = key_compare(),
+             const allocator_type& a = allocator_type())
+        : tree_(comp, a)
+    {
+        tree_.insert_range(first, last);
+    }
+
+    // 从严格递增的序列构造，O(n)
+    template <class InputIterator>
+    flat_set(sorted_unique_t, InputIterator first, InputIterator last,
+             const key_compare& comp = key_compare(),
+             const allocator_type& a = allocator_type())
+        : tree_(comp, a)
+    {
+        tree_.assign_sorted_unique(first, last);
+    }
+
+    flat_set(std::initializer_list<value_type> ilist,
+             const key_compare& comp = key_compare(),
+             const allocator_type& a = allocator_type())
+        : tree_(comp, a)
+    {
+        tree_.insert_range(ilist.begin(), ilist.end());
+    }
+
+    flat_set(const flat_set& rhs)
+        : tree_(rhs.tree_) {}
+    flat_set(flat_set&& rhs) noexcept
+        : tree_(ctstl::move(rhs.tree_)) {}
+
+    flat_set& operator=(const flat_set& rhs)
+    {
+        tree_ = rhs.tree_;
+        return *this;
+    }
+    flat_set& operator=(flat_set&& rhs) noexcept
+    {
+        tree_ = ctstl::move(rhs.tree_);
+        return *this;
+    }
+
+    flat_set& operator=(std::initializer_list<value_type> ilist)
+    {
+        tree_.clear();
+        tree_.insert_range(ilist.begin(), ilist.end());
+        return *this;
+    }
+
+    ~flat_set() = default;
+
+    // 迭代器相关
+    iterator               begin()   const noexcept { return tree_.begin(); }
+    iterator               end()     const noexcept { return tree_.end(); }
+    reverse_iterator       rbegin()  const noexcept { return tree_.rbegin(); }
+    reverse_iterator       rend()    const noexcept { return tree_.rend(); }
+
+    const_iterator         cbegin()  const noexcept { return tree_.cbegin(); }
+    const_iterator         cend()    const noexcept { return tree_.cend(); }
+    const_reverse_iterator crbegin() const noexcept { return tree_.crbegin(); }
+    const_reverse_iterator crend()   const noexcept { return tree_.crend(); }
+
+    // 容量相关
+    bool      empty()    const noexcept { return tree_.empty(); }
+    size_type size()     const noexcept { return tree_.size(); }
+    size_type max_size() const noexcept { return tree_.max_size(); }
+    size_type capacity() const noexcept { return tree_.capacity(); }
+    void      reserve(size_type n)      { tree_.reserve(n); }
+    void      shrink_to_fit()           { tree_.shrink_to_fit(); }
+
+    // 修改容器操作
+
+    // emplace / emplace_hint
+    template <class ...Args>
+    ctstl::pair<iterator, bool> emplace(Args&& ...args)
+    { return tree_.emplace_unique(ctstl::forward<Args>(args)...); }
+
+    template <class ...Args>
+    iterator emplace_hint(const_iterator hint, Args&& ...args)
+    { return tree_.emplace_unique_hint(hint, ctstl::forward<Args>(args)...); }
+
+    // insert
+    ctstl::pair<iterator, bool> insert(const value_type& value)
+    { return tree_.insert_unique(value); }
+    ctstl::pair<iterator, bool> insert(value_type&& value)
+    { return tree_.insert_unique(ctstl::move(value)); }
+
+    iterator insert(const_iterator hint, const value_type& value)
+    { return tree_.insert_unique(hint, value); }
+    iterator insert(const_iterator hint, value_type&& value)
+    { return tree_.insert_unique(hint, ctstl::move(value)); }
+
+    template <class InputIterator>
+    void insert(InputIterator first, InputIterator last)
+    { tree_.insert_range(first, last); }
+
+    // [first, last) 已经严格递增，省去排序
+    template <class InputIterator>
+    void insert(sorted_unique_t, InputIterator first, InputIterator last)
+    { tree_.insert_sorted_unique(first, last); }
+
+    void insert(std::initializer_list<value_type> ilist)
+    { tree_.insert_range(ilist.begin(), ilist.end()); }
+
+    // insert_range: 一次排序、归并插入 [first, last)，代价为 O(m log m + size())
+    template <class InputIterator>
+    void insert_range(InputIterator first, InputIterator last)
+    { tree_.insert_range(first, last); }
+
+    // erase / clear
+    iterator  erase(const_iterator it)
+    { return tree_.erase(it); }
+    iterator  erase(const_iterator first, const_iterator last)
+    { return tree_.erase(first, last); }
+    size_type erase(const key_type& key)
+    { return tree_.erase_unique(key); }
+
+    void      clear() noexcept
+    { tree_.clear(); }
+
+    void      swap(flat_set& other) noexcept
+    { tree_.swap(other.tree_); }
+
+    // 查找相关
+
+    size_type      count(const key_type& key) const
+    { return tree_.count_unique(key); }
+
+    bool           contains(const key_type& key) const
+    { return tree_.count_unique(key) != 0; }
+
+    const_iterator find(const key_type& key) const
+    { return tree_.find(key); }
+
+    const_iterator lower_bound(const key_type& key) const
+    { return tree_.lower_bound(key); }
+
+    const_iterator upper_bound(const key_type& key) const
+    { return tree_.upper_bound(key); }
+
+    ctstl::pair<const_iterator, const_iterator>
+                   equal_range(const key_type& key) const
+    { return tree_.equal_range_unique(key); }
+
+    // 底层的有序数组
+    const ctstl::vector<Key, typename base_type::allocator_type>&
+                   keys() const noexcept
+    { return tree_.storage().keys(); }
+
+public:
+    friend bool operator==(const flat_set& lhs, const flat_set& rhs)
+    {
+        return lhs.size() == rhs.size() && ctstl::equal(lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
+    }
+    friend bool operator<(const flat_set& lhs, const flat_set& rhs)
+    {
+        return ctstl::lexicographical_compare(lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
+    }
+};
+
+// 重载比较操作符
+template <class Key, class Compare, class Alloc>
+bool operator!=(const flat_set<Key, Compare, Alloc>& lhs,
+                const flat_set<Key, Compare, Alloc>& rhs)
+{
+    return !(lhs == rhs);
+}
+
+template <class Key, class Compare, class Alloc>
+bool operator>(const flat_set<Key, Compare, Alloc>& lhs,
+               const flat_set<Key, Compare, Alloc>& rhs)
+{
+    return rhs < lhs;
+}
+
+template <class Key, class Compare, class Alloc>
+bool operator<=(const flat_set<Key, Compare, Alloc>& lhs,
+                const flat_set<Key, Compare, Alloc>& rhs)
+{
+    return !(rhs < lhs);
+}
+
+template <class Key, class Compare, class Alloc>
+bool operator>=(const flat_set<Key, Compare, Alloc>& lhs,
+                const flat_set<Key, Compare, Alloc>& rhs)
+{
+    return !(lhs < rhs);
+}
+
+// 重载 ctstl 的 swap
+template <class Key, class Compare, class Alloc>
+void swap(flat_set<Key, Compare, Alloc>& lhs,
+          flat_set<Key, Compare, Alloc>& rhs) noexcept
+{
+    lhs.swap(rhs);
+}
+
+} // namespace ctstl
+#endif // !CTSTL_FLAT_SET_H_
@@ -0,0 +1,814 @@
+#ifndef CTSTL_FLAT_TREE_H_
+#define CTSTL_FLAT_TREE_H_
+
+// 这个头文件包含一个模板类 flat_tree，作为 flat_map / flat_set 的底层
+//
+// 1. 结构
+// 元素按键值从小到大连续地保存在 ctstl::vector 中，查找是在数组上做二分，没有任何指针，
+// 适合查找远多于修改、偶尔整体重建的查找表
+// 存放方式由 storage 决定：
+//   flat_set_storage         : vector<Key>
+//   flat_interleaved_storage : vector<pair<Key, T>>，键值与实值交错存放（flat_map 的缺省方式）
+//   flat_split_storage       : vector<Key> 与 vector<T> 分开存放，二分只访问键值数组，
+//                              键值小而实值大时，查找路径上的缓存行全部是键值
+//
+// 2. 批量插入
+// 逐个插入 n 个元素需要搬动 O(n * size) 次，insert_range 先把新元素放进临时数组，
+// 排序、去重之后与原有元素做一次归并，总代价为 O(m log m + size)；
+// 新元素全部大于原有元素时（有序追加）直接接在末尾
+//
+// 插入、删除会使迭代器和元素的引用失效；元素的移动构造、移动赋值不应抛出异常
+
+#include <type_traits>
+
+#include "iterator.h"
+#include "memory.h"
+#include "functional.h"
+#include "heap_algo.h"
+#include "util.h"
+#include "exceptdef.h"
+#include "vector.h"
+
+namespace ctstl
+{
+
+// 排序时小于这个长度的区间改用插入排序
+enum { EFlatSortThreshold = 16 };
+
+// flat_map 的两种存放方式
+struct flat_interleaved_layout {};
+struct flat_split_layout {};
+
+/*****************************************************************************************/
+// flat_tree 使用的排序：introsort
+// 快速排序，三数取中选枢轴；递归过深时改用堆排序，小区间留给最后一趟插入排序
+/*****************************************************************************************/
+
+template <class RandomIter, class Compare>
+void flat_insertion_sort(RandomIter first, RandomIter last, Compare comp)
+{
+    if (first == last)
+        return;
+    for (RandomIter i = first + 1; i != last; ++i)
+    {
+        typename iterator_traits<RandomIter>::value_type value = ctstl::move(*i);
+        RandomIter j = i;
+        for (; j != first && comp(value, *(j - 1)); --j)
+            *j = ctstl::move(*(j - 1));
+        *j = ctstl::move(value);
+    }
+}
+
+// 把 *a, *b, *c 的中位数换到 result
+template <class RandomIter, class Compare>
+void flat_median_to_first(RandomIter result, RandomIter a, RandomIter b, RandomIter c,
+                          Compare comp)
+{
+    if (comp(*a, *b))
+    {
+        if (comp(*b, *c))      ctstl::swap(*result, *b);
+        else if (comp(*a, *c)) ctstl::swap(*result, *c);
+        else                   ctstl::swap(*result, *a);
+    }
+    else if (comp(*a, *c))     ctstl::swap(*result, *a);
+    else if (comp(*b, *c))     ctstl::swap(*result, *c);
+    else                       ctstl::swap(*result, *b);
+}
+
+template <class RandomIter, class Size, class Compare>
+void flat_intro_sort(RandomIter first, RandomIter last, Size depth, Compare comp)
+{
+    while (last - first > EFlatSortThreshold)
+    {
+        if (depth == 0)
+        {   // 递归过深，改用 heap_algo.h 中的堆排序
+            ctstl::make_heap(first, last, comp);
+            ctstl::sort_heap(first, last, comp);
+            return;
+        }
+        --depth;
+        ctstl::flat_median_to_first(first, first + 1, first + (last - first) / 2, last - 1, comp);
+        // 枢轴在 *first，两端各有一个不小于、不大于枢轴的元素作为哨兵，扫描不必检查边界
+        RandomIter lo = first + 1;
+        RandomIter hi = last;
+        while (true)
+        {
+            while (comp(*lo, *first))
+                ++lo;
+            --hi;
+            while (comp(*first, *hi))
+                --hi;
+            if (!(lo < hi))
+                break;
+            ctstl::swap(*lo, *hi);
+            ++lo;
+        }
+        ctstl::flat_intro_sort(lo, last, depth, comp);
+        last = lo;
+    }
+}
+
+template <class RandomIter, class Compare>
+void flat_sort(RandomIter first, RandomIter last, Compare comp)
+{
+    if (last - first < 2)
+        return;
+    size_t depth = 0;
+    for (size_t n = static_cast<size_t>(last - first); n > 1; n >>= 1)
+        depth += 2;
+    ctstl::flat_intro_sort(first, last, depth, comp);
+    ctstl::flat_insertion_sort(first, last, comp);
+}
+
+// 返回 [0, n) 中第一个使 pred(i) 为 false 的下标，pred 必须先为 true 后为 false
+// 每一步都把区间减半，用条件传送代替分支，比较结果难以预测时不会有分支预测失败
+template <class Pred>
+size_t flat_partition_point(size_t n, Pred pred)
+{
+    if (n == 0)
+        return 0;
+    size_t base = 0;
+    while (n > 1)
+    {
+        const size_t half = n / 2;
+        base = pred(base + half) ? base + half : base;
+        n -= half;
+    }
+    return base + (pred(base) ? 1 : 0);
+}
+
+/*****************************************************************************************/
+// storage
+// 向 flat_tree 提供统一的接口：按下标访问键值、在下标处插入、删除一段、从另一个 storage 搬入元素
+// slot_type 是批量插入时临时数组的元素类型，可以移动键值
+/*****************************************************************************************/
+
+// flat_set_storage : vector<Key>
+template <class Key, class Alloc>
+class flat_set_storage
+{
+public:
+    typedef Key                                              key_type;
+    typedef Key                                              value_type;
+    typedef Key                                              slot_type;
+    typedef typename Alloc::template rebind<Key>::other      allocator_type;
+    typedef ctstl::vector<Key, allocator_type>               container_type;
+
+    typedef const Key*                                       pointer;
+    typedef const Key*                                       const_pointer;
+    typedef const Key&                                       reference;
+    typedef const Key&                                       const_reference;
+    typedef const Key*                                       iterator;
+    typedef const Key*                                       const_iterator;
+    typedef size_t                                           size_type;
+    typedef ptrdiff_t                                        difference_type;
+
+private:
+    container_type keys_;
+
+public:
+    flat_set_storage() = default;
+    explicit flat_set_storage(const allocator_type& a) : keys_(a) {}
+
+    static const key_type& slot_key(const slot_type& s) noexcept { return s; }
+
+    allocator_type get_allocator() const { return keys_.get_allocator(); }
+
+    size_type size()     const noexcept { return keys_.size(); }
+    size_type max_size() const noexcept { return keys_.max_size(); }
+    size_type capacity() const noexcept { return keys_.capacity(); }
+    void      reserve(size_type n)      { keys_.reserve(n); }
+    void      shrink_to_fit()           { keys_.shrink_to_fit(); }
+    void      clear() noexcept          { keys_.clear(); }
+    void      swap(flat_set_storage& rhs) noexcept { keys_.swap(rhs.keys_); }
+
+    const key_type& key(size_type i) const noexcept { return keys_[i]; }
+
+    iterator  make_iterator(size_type i) const noexcept { return keys_.data() + i; }
+    size_type index_of(const_iterator it) const noexcept
+    { return static_cast<size_type>(it - keys_.data()); }
+
+    const container_type& keys() const noexcept { return keys_; }
+
+    void insert_slot(size_type i, slot_type&& s)
+    { keys_.emplace(keys_.begin() + i, ctstl::move(s)); }
+
+    template <class K>
+    void emplace_key(size_type i, K&& k)
+    { keys_.emplace(keys_.begin() + i, ctstl::forward<K>(k)); }
+
+    void append_slot(slot_type&& s)
+    { keys_.emplace_back(ctstl::move(s)); }
+
+    void append_from(flat_set_storage& rhs, size_type i)
+    { keys_.emplace_back(ctstl::move(rhs.keys_[i])); }
+
+    void erase(size_type first, size_type last)
+    { keys_.erase(keys_.begin() + first, keys_.begin() + last); }
+};
+
+// flat_interleaved_storage : vector<pair<Key, T>>，对外以 pair<const Key, T> 的形式出现
+template <class Key, class T, class Alloc>
+class flat_interleaved_storage
+{
+public:
+    typedef Key                                                key_type;
+    typedef T                                                  mapped_type;
+    typedef ctstl::pair<const Key, T>                          value_type;
+    typedef ctstl::pair<Key, T>                                slot_type;
+    typedef typename Alloc::template rebind<slot_type>::other  allocator_type;
+    typedef ctstl::vector<slot_type, allocator_type>           container_type;
+
+    typedef value_type*                                        pointer;
+    typedef const value_type*                                  const_pointer;
+    typedef value_type&                                        reference;
+    typedef const value_type&                                  const_reference;
+    typedef value_type*                                        iterator;
+    typedef const value_type*                                  const_iterator;
+    typedef size_t                                             size_type;
+    typedef ptrdiff_t                                          difference_type;
+
+private:
+    container_type slots_;
+
+public:
+    flat_interleaved_storage() = default;
+    explicit flat_interleaved_storage(const allocator_type& a) : slots_(a) {}
+
+    static const key_type& slot_key(const slot_type& s) noexcept { return s.first; }
+
+    allocator_type get_allocator() const { return slots_.get_allocator(); }
+
+    size_type size()     const noexcept { return slots_.size(); }
+    size_type max_size() const noexcept { return slots_.max_size(); }
+    size_type capacity() const noexcept { return slots_.capacity(); }
+    void      reserve(size_type n)      { slots_.reserve(n); }
+    void      shrink_to_fit()           { slots_.shrink_to_fit(); }
+    void      clear() noexcept          { slots_.clear(); }
+    void      swap(flat_interleaved_storage& rhs) noexcept { slots_.swap(rhs.slots_); }
+
+    const key_type& key(size_type i) const noexcept { return slots_[i].first; }
+
+    iterator make_iterator(size_type i) noexcept
+    { return reinterpret_cast<iterator>(slots_.data() + i); }
+    const_iterator make_iterator(size_type i) const noexcept
+    { return reinterpret_cast<const_iterator>(slots_.data() + i); }
+    size_type index_of(const_iterator it) const noexcept
+    { return static_cast<size_type>(it - make_iterator(0)); }
+
+    void insert_slot(size_type i, slot_type&& s)
+    { slots_.emplace(slots_.begin() + i, ctstl::move(s)); }
+
+    template <class K, class ...Args>
+    void emplace_key(size_type i, K&& k, Args&& ...args)
+    {
+        slots_.emplace(slots_.begin() + i, ctstl::piecewise_construct,
+                       std::forward_as_tuple(ctstl::forward<K>(k)),
+                       std::forward_as_tuple(ctstl::forward<Args>(args)...));
+    }
+
+    void append_slot(slot_type&& s)
+    { slots_.emplace_back(ctstl::move(s)); }
+
+    void append_from(flat_interleaved_storage& rhs, size_type i)
+    { slots_.emplace_back(ctstl::move(rhs.slots_[i])); }
+
+    void erase(size_type first, size_type last)
+    { slots_.erase(slots_.begin() + first, slots_.begin() + last); }
+};
+
+// flat_split_iterator 的 operator-> 返回的代理，保存一个 reference
+template <class Ref>
+struct flat_split_arrow
+{
+    Ref ref;
+    const Ref* operator->() const noexcept { return ctstl::address_of(ref); }
+};
+
+// 模板类: flat_split_iterator
+// 保存键值数组、实值数组的起始地址和元素下标，V 为实值类型（const 迭代器为 const T）
+// reference 是代理类型 pair<const Key&, V&>，可以通过 it->second 修改实值
+template <class Key, class V>
+class flat_split_iterator
+    : public ctstl::iterator<ctstl::random_access_iterator_tag,
+                             ctstl::pair<const Key, typename std::remove_const<V>::type>,
+                             ptrdiff_t,
+                             flat_split_arrow<ctstl::pair<const Key&, V&>>,
+                             ctstl::pair<const Key&, V&>>
+{
+    template <class K, class W> friend class flat_split_iterator;
+
+public:
+    typedef ctstl::pair<const Key&, V&>   reference;
+    typedef flat_split_arrow<reference>   pointer;
+    typedef ptrdiff_t                     difference_type;
+    typedef flat_split_iterator           self;
+
+private:
+    const Key*      keys_;
+    V*              values_;
+    difference_type i_;
+
+public:
+    flat_split_iterator() : keys_(nullptr), values_(nullptr), i_(0) {}
+    flat_split_iterator(const Key* keys, V* values, difference_type i)
+        : keys_(keys), values_(values), i_(i) {}
+
+    // 非 const 迭代器可以转换为 const 迭代器
+    template <class W, typename std::enable_if<
+        std::is_convertible<W*, V*>::value, int>::type = 0>
+    flat_split_iterator(const flat_split_iterator<Key, W>& rhs)
+        : keys_(rhs.keys_), values_(rhs.values_), i_(rhs.i_) {}
+
+    reference operator*()  const { return reference(keys_[i_], values_[i_]); }
+    pointer   operator->() const { return pointer{ **this }; }
+    reference operator[](difference_type n) const { return reference(keys_[i_ + n], values_[i_ + n]); }
+
+    // 元素下标
+    difference_type index() const noexcept { return i_; }
+
+    self& operator++()                   { ++i_; return *this; }
+    self  operator++(int)                { self tmp = *this; ++i_; return tmp; }
+    self& operator--()                   { --i_; return *this; }
+    self  operator--(int)                { self tmp = *this; --i_; return tmp; }
+    self& operator+=(difference_type n)  { i_ += n; return *this; }
+    self& operator-=(difference_type n)  { i_ -= n; return *this; }
+    self  operator+(difference_type n) const { return self(keys_, values_, i_ + n); }
+    self  operator-(difference_type n) const { return self(keys_, values_, i_ - n); }
+
+    difference_type operator-(const self& rhs) const { return i_ - rhs.i_; }
+
+    bool operator==(const self& rhs) const { return i_ == rhs.i_; }
+    bool operator!=(const self& rhs) const { return i_ != rhs.i_; }
+    bool operator< (const self& rhs) const { return i_ < rhs.i_; }
+    bool operator> (const self& rhs) const { return i_ > rhs.i_; }
+    bool operator<=(const self& rhs) const { return i_ <= rhs.i_; }
+    bool operator>=(const self& rhs) const { return i_ >= rhs.i_; }
+};
+
+template <class Key, class V>
+flat_split_iterator<Key, V> operator+(ptrdiff_t n, const flat_split_iterator<Key, V>& it)
+{
+    return it + n;
+}
+
+// flat_split_storage : vector<Key> 与 vector<T> 分开存放，两个数组的长度始终相同
+template <class Key, class T, class Alloc>
+class flat_split_storage
+{
+public:
+    typedef Key                                                key_type;
+    typedef T                                                  mapped_type;
+    typedef ctstl::pair<const Key, T>                          value_type;
+    typedef ctstl::pair<Key, T>                                slot_type;
+    typedef typename Alloc::template rebind<slot_type>::other  allocator_type;
+    typedef typename Alloc::template rebind<Key>::other        key_allocator_type;
+    typedef typename Alloc::template rebind<T>::other          mapped_allocator_type;
+    typedef ctstl::vector<Key, key_allocator_type>             key_container_type;
+    typedef ctstl::vector<T, mapped_allocator_type>            mapped_container_type;
+
+    typedef flat_split_iterator<Key, T>                        iterator;
+    typedef flat_split_iterator<Key, const T>                  const_iterator;
+    typedef typename iterator::pointer                         pointer;
+    typedef typename const_iterator::pointer                   const_pointer;
+    typedef typename iterator::reference                       reference;
+    typedef typename const_iterator::reference                 const_reference;
+    typedef size_t                                             size_type;
+    typedef ptrdiff_t                                          difference_type;
+
+private:
+    key_container_type    keys_;
+    mapped_container_type values_;
+
+public:
+    flat_split_storage() = default;
+    explicit flat_split_storage(const allocator_type& a)
+        : keys_(ctstl::rebind_allocator<key_allocator_type>(a)),
+          values_(ctstl::rebind_allocator<mapped_allocator_type>(a))
+    {
+    }
+
+    static const key_type& slot_key(const slot_type& s) noexcept { return s.first; }
+
+    allocator_type get_allocator() const
+    { return ctstl::rebind_allocator<allocator_type>(keys_.get_allocator()); }
+
+    size_type size()     const noexcept { return keys_.size(); }
+    size_type max_size() const noexcept { return ctstl::min(keys_.max_size(), values_.max_size()); }
+    size_type capacity() const noexcept { return ctstl::min(keys_.capacity(), values_.capacity()); }
+    void      reserve(size_type n)      { keys_.reserve(n); values_.reserve(n); }
+    void      shrink_to_fit()           { keys_.shrink_to_fit(); values_.shrink_to_fit(); }
+    void      clear() noexcept          { keys_.clear(); values_.clear(); }
+    void      swap(flat_split_storage& rhs) noexcept
+    {
+        keys_.swap(rhs.keys_);
+        values_.swap(rhs.values_);
+    }
+
+    const key_type& key(size_type i) const noexcept { return keys_[i]; }
+
+    iterator make_iterator(size_type i) noexcept
+    { return iterator(keys_.data(), values_.data(), static_cast<difference_type>(i)); }
+    const_iterator make_iterator(size_type i) const noexcept
+    { return const_iterator(keys_.data(), values_.data(), static_cast<difference_type>(i)); }
+    size_type index_of(const_iterator it) const noexcept
+    { return static_cast<size_type>(it.index()); }
+
+    const key_container_type&    keys()   const noexcept { return keys_; }
+    const mapped_container_type& values() const noexcept { return values_; }
+    mapped_container_type&       values()       noexcept { return values_; }
+
+    void insert_slot(size_type i, slot_type&& s)
+    { emplace_key(i, ctstl::move(s.first), ctstl::move(s.second)); }
+
+    // 先插入实值再插入键值，插入键值失败时删除刚插入的实值，两个数组的长度保持一致
+    template <class K, class ...Args>
+    void emplace_key(size_type i, K&& k, Args&& ...args)
+    {
+        values_.emplace(values_.begin() + i, ctstl::forward<Args>(args)...);
+        try
+        {
+            keys_.emplace(keys_.begin() + i, ctstl::forward<K>(k));
+        }
+        catch (...)
+        {
+            values_.erase(values_.begin() + i);
+            throw;
+        }
+    }
+
+    void append_slot(slot_type&& s)
+    {
+        keys_.emplace_back(ctstl::move(s.first));
+        try
+        {
+            values_.emplace_back(ctstl::move(s.second));
+        }
+        catch (...)
+        {
+            keys_.pop_back();
+            throw;
+        }
+    }
+
+    void append_from(flat_split_storage& rhs, size_type i)
+    {
+        keys_.emplace_back(ctstl::move(rhs.keys_[i]));
+        try
+        {
+            values_.emplace_back(ctstl::move(rhs.values_[i]));
+        }
+        catch (...)
+        {
+            keys_.pop_back();
+            throw;
+        }
+    }
+
+    void erase(size_type first, size_type last)
+    {
+        keys_.erase(keys_.begin() + first, keys_.begin() + last);
+        values_.erase(values_.begin() + first, values_.begin() + last);
+    }
+};
+
+/*****************************************************************************************/
+// flat_tree
+// 模板参数 Storage 代表存放方式，Compare 代表键值比较方式
+/*****************************************************************************************/
+
+template <class Storage, class Compare>
+class flat_tree
+{
+public:
+    typedef Storage                                    storage_type;
+    typedef typename Storage::key_type                 key_type;
+    typedef typename Storage::value_type               value_type;
+    typedef typename Storage::slot_type                slot_type;
+    typedef Compare                                    key_compare;
+    typedef typename Storage::allocator_type           allocator_type;
+
+    typedef typename Storage::pointer                  pointer;
+    typedef typename Storage::const_pointer            const_pointer;
+    typedef typename Storage::reference                reference;
+    typedef typename Storage::const_reference          const_reference;
+    typedef typename Storage::iterator                 iterator;
+    typedef typename Storage::const_iterator           const_iterator;
+    typedef ctstl::reverse_iterator<iterator>          reverse_iterator;
+    typedef ctstl::reverse_iterator<const_iterator>    const_reverse_iterator;
+    typedef typename Storage::size_type                size_type;
+    typedef typename Storage::difference_type          difference_type;
+
+private:
+    typedef ctstl::vector<slot_type, allocator_type>   batch_type;
+
+    storage_type storage_;
+    key_compare  comp_;
+
+public:
+    flat_tree() = default;
+
+    explicit flat_tree(const key_compare& comp, const allocator_type& a = allocator_type())
+        : storage_(a), comp_(comp) {}
+
+    flat_tree(const flat_tree& rhs) = default;
+    flat_tree(flat_tree&& rhs) noexcept
+        : storage_(ctstl::move(rhs.storage_)), comp_(rhs.comp_) {}
+
+    flat_tree& operator=(const flat_tree& rhs) = default;
+    flat_tree& operator=(flat_tree&& rhs) noexcept
+    {
+        storage_ = ctstl::move(rhs.storage_);
+        comp_ = rhs.comp_;
+        return *this;
+    }
+
+    ~flat_tree() = default;
+
+    allocator_type get_allocator() const { return storage_.get_allocator(); }
+    key_compare    key_comp()      const { return comp_; }
+
+    const storage_type& storage() const noexcept { return storage_; }
+    storage_type&       storage()       noexcept { return storage_; }
+
+public:
+    // 迭代器相关
+    iterator               begin()         noexcept { return storage_.make_iterator(0); }
+    const_iterator         begin()   const noexcept { return storage_.make_iterator(0); }
+    iterator               end()           noexcept { return storage_.make_iterator(size()); }
+    const_iterator         end()     const noexcept { return storage_.make_iterator(size()); }
+
+    reverse_iterator       rbegin()        noexcept { return reverse_iterator(end()); }
+    const_reverse_iterator rbegin()  const noexcept { return const_reverse_iterator(end()); }
+    reverse_iterator       rend()          noexcept { return reverse_iterator(begin()); }
+    const_reverse_iterator rend()    const noexcept { return const_reverse_iterator(begin()); }
+
+    const_iterator         cbegin()  const noexcept { return begin(); }
+    const_iterator         cend()    const noexcept { return end(); }
+    const_reverse_iterator crbegin() const noexcept { return rbegin(); }
+    const_reverse_iterator crend()   const noexcept { return rend(); }
+
+    // 容量相关
+    bool      empty()    const noexcept { return storage_.size() == 0; }
+    size_type size()     const noexcept { return storage_.size(); }
+    size_type max_size() const noexcept { return storage_.max_size(); }
+    size_type capacity() const noexcept { return storage_.capacity(); }
+    void      reserve(size_type n)      { storage_.reserve(n); }
+    void      shrink_to_fit()           { storage_.shrink_to_fit(); }
+
+    // 插入、删除
+
+    template <class ...Args>
+    ctstl::pair<iterator, bool> emplace_unique(Args&& ...args);
+
+    template <class ...Args>
+    iterator emplace_unique_hint(const_iterator hint, Args&& ...args);
+
+    ctstl::pair<iterator, bool> insert_unique(const value_type& value)
+    { return emplace_unique(value); }
+    ctstl::pair<iterator, bool> insert_unique(value_type&& value)
+    { return emplace_unique(ctstl::move(value)); }
+
+    iterator insert_unique(const_iterator hint, const value_type& value)
+    { return emplace_unique_hint(hint, value); }
+    iterator insert_unique(const_iterator hint, value_type&& value)
+    { return emplace_unique_hint(hint, ctstl::move(value)); }
+
+    // 批量插入：排序、去重后与原有元素归并，键值重复的元素中保留哪一个是未指定的
+    template <class InputIterator>
+    void insert_range(InputIterator first, InputIterator last)
+    {
+        batch_type batch(get_allocator());
+        for (; first != last; ++first)
+            batch.emplace_back(*first);
+        sort_unique(batch);
+        merge_unique(batch);
+    }
+
+    // [first, last) 已经严格递增，省去排序
+    template <class InputIterator>
+    void insert_sorted_unique(InputIterator first, InputIterator last)
+    {
+        batch_type batch(get_allocator());
+        for (; first != last; ++first)
+            batch.emplace_back(*first);
+        merge_unique(batch);
+    }
+
+    // 用严格递增的 [first, last) 替换原有元素，O(n)
+    template <class InputIterator>
+    void assign_sorted_unique(InputIterator first, InputIterator last)
+    {
+        clear();
+        for (; first != last; ++first)
+            storage_.append_slot(slot_type(*first));
+    }
+
+    // 查找 key，找到时返回 (下标, true)，否则返回应当插入的位置
+    ctstl::pair<size_type, bool> find_or_prepare_insert(const key_type& key) const
+    {
+        const size_type i = lower_index(key);
+        return ctstl::pair<size_type, bool>(i, i != size() && !comp_(key, storage_.key(i)));
+    }
+
+    // 在 find_or_prepare_insert 返回的位置上构造元素
+    template <class ...Args>
+    iterator emplace_at(size_type i, Args&& ...args)
+    {
+        storage_.emplace_key(i, ctstl::forward<Args>(args)...);
+        return storage_.make_iterator(i);
+    }
+
+    iterator  erase(const_iterator it)
+    {
+        const size_type i = storage_.index_of(it);
+        storage_.erase(i, i + 1);
+        return storage_.make_iterator(i);
+    }
+    iterator  erase(const_iterator first, const_iterator last)
+    {
+        const size_type i = storage_.index_of(first);
+        storage_.erase(i, storage_.index_of(last));
+        return storage_.make_iterator(i);
+    }
+    size_type erase_unique(const key_type& key)
+    {
+        const ctstl::pair<size_type, bool> res = find_or_prepare_insert(key);
+        if (!res.second)
+            return 0;
+        storage_.erase(res.first, res.first + 1);
+        return 1;
+    }
+
+    void      clear() noexcept { storage_.clear(); }
+
+    void      swap(flat_tree& rhs) noexcept
+    {
+        storage_.swap(rhs.storage_);
+        ctstl::swap(comp_, rhs.comp_);
+    }
+
+    // 查找相关
+
+    iterator       find(const key_type& key)
+    {
+        const ctstl::pair<size_type, bool> res = find_or_prepare_insert(key);
+        return storage_.make_iterator(res.second ? res.first : size());
+    }
+    const_iterator find(const key_type& key) const
+    {
+        const ctstl::pair<size_type, bool> res = find_or_prepare_insert(key);
+        return storage_.make_iterator(res.second ? res.first : size());
+    }
+
+    size_type      count_unique(const key_type& key) const
+    { return find_or_prepare_insert(key).second ? 1 : 0; }
+
+    iterator       lower_bound(const key_type& key)
+    { return storage_.make_iterator(lower_index(key)); }
+    const_iterator lower_bound(const key_type& key) const
+    { return storage_.make_iterator(lower_index(key)); }
+
+    iterator       upper_bound(const key_type& key)
+    { return storage_.make_iterator(upper_index(key)); }
+    const_iterator upper_bound(const key_type& key) const
+    { return storage_.make_iterator(upper_index(key)); }
+
+    ctstl::pair<iterator, iterator>
+                   equal_range_unique(const key_type& key)
+    {
+        const ctstl::pair<size_type, bool> res = find_or_prepare_insert(key);
+        return ctstl::pair<iterator, iterator>(storage_.make_iterator(res.first),
+            storage_.make_iterator(res.first + (res.second ? 1 : 0)));
+    }
+    ctstl::pair<const_iterator, const_iterator>
+                   equal_range_unique(const key_type& key) const
+    {
+        const ctstl::pair<size_type, bool> res = find_or_prepare_insert(key);
+        return ctstl::pair<const_iterator, const_iterator>(storage_.make_iterator(res.first),
+            storage_.make_iterator(res.first + (res.second ? 1 : 0)));
+    }
+
+private:
+    // 第一个不小于 key 的下标
+    size_type lower_index(const key_type& key) const
+    {
+        const storage_type& s = storage_;
+        const key_compare& comp = comp_;
+        return ctstl::flat_partition_point(s.size(),
+            [&](size_type i) { return comp(s.key(i), key); });
+    }
+
+    // 第一个大于 key 的下标
+    size_type upper_index(const key_type& key) const
+    {
+        const storage_type& s = storage_;
+        const key_compare& comp = comp_;
+        return ctstl::flat_partition_point(s.size(),
+            [&](size_type i) { return !comp(key, s.key(i)); });
+    }
+
+    void sort_unique(batch_type& batch);
+    void merge_unique(batch_type& batch);
+};
+
+/*****************************************************************************************/
+
+// 先构造元素得到键值，键值已经存在时丢弃
+template <class Storage, class Compare>
+template <class ...Args>
+ctstl::pair<typename flat_tree<Storage, Compare>::iterator, bool>
+flat_tree<Storage, Compare>::emplace_unique(Args&& ...args)
+{
+    slot_type tmp(ctstl::forward<Args>(args)...);
+    const ctstl::pair<size_type, bool> res = find_or_prepare_insert(Storage::slot_key(tmp));
+    if (res.second)
+        return ctstl::pair<iterator, bool>(storage_.make_iterator(res.first), false);
+    storage_.insert_slot(res.first, ctstl::move(tmp));
+    return ctstl::pair<iterator, bool>(storage_.make_iterator(res.first), true);
+}
+
+// hint 恰好是插入位置时省去二分查找，否则退化为 emplace_unique
+template <class Storage, class Compare>
+template <class ...Args>
+typename flat_tree<Storage, Compare>::iterator
+flat_tree<Storage, Compare>::emplace_unique_hint(const_iterator hint, Args&& ...args)
+{
+    slot_type tmp(ctstl::forward<Args>(args)...);
+    const key_type& key = Storage::slot_key(tmp);
+    size_type i = storage_.index_of(hint);
+    if ((i != 0 && !comp_(storage_.key(i - 1), key)) ||
+        (i != size() && !comp_(key, storage_.key(i))))
+    {
+        const ctstl::pair<size_type, bool> res = find_or_prepare_insert(key);
+        if (res.second)
+            return storage_.make_iterator(res.first);
+        i = res.first;
+    }
+    storage_.insert_slot(i, ctstl::move(tmp));
+    return storage_.make_iterator(i);
+}
+
+// 排序并删除键值重复的元素
+template <class Storage, class Compare>
+void flat_tree<Storage, Compare>::sort_unique(batch_type& batch)
+{
+    const key_compare& comp = comp_;
+    ctstl::flat_sort(batch.begin(), batch.end(), [&](const slot_type& a, const slot_type& b)
+    {
+        return comp(Storage::slot_key(a), Storage::slot_key(b));
+    });
+    if (batch.size() < 2)
+        return;
+    typename batch_type::iterator result = batch.begin();
+    for (typename batch_type::iterator it = result + 1; it != batch.end(); ++it)
+    {
+        if (comp(Storage::slot_key(*result), Storage::slot_key(*it)) && ++result != it)
+            *result = ctstl::move(*it);
+    }
+    batch.erase(result + 1, batch.end());
+}
+
+// 把严格递增的 batch 并入原有元素，键值已经存在的元素被丢弃
+template <class Storage, class Compare>
+void flat_tree<Storage, Compare>::merge_unique(batch_type& batch)
+{
+    if (batch.empty())
+        return;
+    const size_type n = size();
+    const size_type m = batch.size();
+    if (n == 0 || comp_(storage_.key(n - 1), Storage::slot_key(batch.front())))
+    {
+        // 有序追加
+        storage_.reserve(n + m);
+        for (size_type j = 0; j < m; ++j)
+            storage_.append_slot(ctstl::move(batch[j]));
+        return;
+    }
+    storage_type merged(get_allocator());
+    merged.reserve(n + m);
+    size_type i = 0, j = 0;
+    while (i < n && j < m)
+    {
+        const key_type& a = storage_.key(i);
+        const key_type& b = Storage::slot_key(batch[j]);
+        if (comp_(a, b))
+        {
+            merged.append_from(storage_, i++);
+        }
+        else
+        {
+            if (comp_(b, a))
+                merged.append_slot(ctstl::move(batch[j]));
+            ++j;
+        }
+    }
+    for (; i < n; ++i)
+        merged.append_from(storage_, i);
+    for (; j < m; ++j)
+        merged.append_slot(ctstl::move(batch[j]));
+    storage_.swap(merged);
+}
+
+} // namespace ctstl
+#endif // !CTSTL_FLAT_TREE_H_
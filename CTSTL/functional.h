@@ -4,6 +4,11 @@
 // 这个头文件包含了 ctstl 的函数对象与哈希函数
 
 #include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <string>
+#include <type_traits>
 
 namespace ctstl
 {
@@ -185,28 +190,190 @@ struct projectsecond :public binary_function<Arg1, Arg2, Arg1>
 
 
 // 哈希函数对象
+//
+// 哈希策略：
+// hash          : 对整数与指针使用 multiply-xorshift 混合，对字节序列与字符串逐字（8 字节）处理，
+//                 结果的每一位都依赖输入的每一位，可以直接用低位或高位作为 2 的幂大小的表的下标
+// identity_hash : 对整数与指针返回原值，供会自己混合哈希值的容器（比如 flat_hash_map）使用
+// 一个哈希函数对象定义了 is_avalanching 型别时，表示它的结果已经充分混合，容器不需要再混合一次
+
+template <class T>
+struct hash_void
+{
+  typedef void type;
+};
+
+// 判断哈希函数对象的结果是否已经充分混合
+template <class Hash, class = void>
+struct hash_is_avalanching : public std::false_type {};
+
+template <class Hash>
+struct hash_is_avalanching<Hash, typename hash_void<typename Hash::is_avalanching>::type>
+  : public std::true_type {};
+
+// 64 位乘法，a 与 b 分别得到 128 位结果的低 64 位与高 64 位
+inline void hash_mul128(uint64_t& a, uint64_t& b) noexcept
+{
+#if defined(__SIZEOF_INT128__)
+  const unsigned __int128 r = static_cast<unsigned __int128>(a) * b;
+  a = static_cast<uint64_t>(r);
+  b = static_cast<uint64_t>(r >> 64);
+#else
+  const uint64_t ha = a >> 32, la = a & 0xFFFFFFFFu;
+  const uint64_t hb = b >> 32, lb = b & 0xFFFFFFFFu;
+  const uint64_t rh = ha * hb, rm0 = ha * lb, rm1 = hb * la, rl = la * lb;
+  const uint64_t t = rl + (rm0 << 32);
+  const uint64_t lo = t + (rm1 << 32);
+  const uint64_t hi = rh + (rm0 >> 32) + (rm1 >> 32) + (t < rl) + (lo < t);
+  a = lo;
+  b = hi;
+#endif
+}
+
+// 64 位乘法，返回 128 位结果的高 64 位与低 64 位的异或
+inline uint64_t hash_mum(uint64_t a, uint64_t b) noexcept
+{
+  hash_mul128(a, b);
+  return a ^ b;
+}
+
+// 整数的混合函数（multiply-xorshift），是一个双射，不会引入新的冲突
+inline size_t hash_mix(size_t x) noexcept
+{
+#if (_MSC_VER && _WIN64) || ((__GNUC__ || __clang__) &&__SIZEOF_POINTER__ == 8)
+  uint64_t h = static_cast<uint64_t>(x);
+  h ^= h >> 32;
+  h *= 0xD6E8FEB86659FD93ull;
+  h ^= h >> 32;
+  h *= 0xD6E8FEB86659FD93ull;
+  h ^= h >> 32;
+  return static_cast<size_t>(h);
+#else
+  uint32_t h = static_cast<uint32_t>(x);
+  h ^= h >> 16;
+  h *= 0x85EBCA6Bu;
+  h ^= h >> 13;
+  h *= 0xC2B2AE35u;
+  h ^= h >> 16;
+  return static_cast<size_t>(h);
+#endif
+}
+
+// 读取未对齐的 8 / 4 字节
+inline uint64_t hash_read64(const unsigned char* p) noexcept
+{
+  uint64_t v;
+  std::memcpy(&v, p, sizeof(v));
+  return v;
+}
+
+inline uint64_t hash_read32(const unsigned char* p) noexcept
+{
+  uint32_t v;
+  std::memcpy(&v, p, sizeof(v));
+  return v;
+}
+
+/*
+计算字节序列的哈希值，参考 wyhash 的做法，每次处理 8 个字节：
+    长度不超过 16 的输入读取首尾（可能重叠）的几个字，不需要循环；
+    更长的输入每轮读取 48 个字节，分成三条互不依赖的乘法链，最后用一次 128 位乘法合并。
+相比逐字节的 FNV-1a，长输入的吞吐量高一个数量级，并且结果充分混合。
+*/
+inline size_t bitwise_hash(const unsigned char* first, size_t count, uint64_t seed = 0)
+{
+  const uint64_t s0 = 0x2D358DCCAA6C78A5ull;
+  const uint64_t s1 = 0x8BB84B93962EACC9ull;
+  const uint64_t s2 = 0x4B33A62ED433D4A3ull;
+  const uint64_t s3 = 0x4D5A2DA51DE1AA47ull;
+  const unsigned char* p = first;
+  seed ^= hash_mum(seed ^ s0, s1);
+  uint64_t a = 0;
+  uint64_t b = 0;
+  if (count <= 16)
+  {
+    if (count >= 4)
+    {
+      const size_t mid = (count >> 3) << 2;
+      a = (hash_read32(p) << 32) | hash_read32(p + mid);
+      b = (hash_read32(p + count - 4) << 32) | hash_read32(p + count - 4 - mid);
+    }
+    else if (count > 0)
+    {
+      a = (static_cast<uint64_t>(p[0]) << 16) | (static_cast<uint64_t>(p[count >> 1]) << 8) | p[count - 1];
+    }
+  }
+  else
+  {
+    size_t i = count;
+    if (i > 48)
+    {
+      uint64_t see1 = seed;
+      uint64_t see2 = seed;
+      do
+      {
+        seed = hash_mum(hash_read64(p) ^ s1, hash_read64(p + 8) ^ seed);
+        see1 = hash_mum(hash_read64(p + 16) ^ s2, hash_read64(p + 24) ^ see1);
+        see2 = hash_mum(hash_read64(p + 32) ^ s3, hash_read64(p + 40) ^ see2);
+        p += 48;
+        i -= 48;
+      } while (i > 48);
+      seed ^= see1 ^ see2;
+    }
+    while (i > 16)
+    {
+      seed = hash_mum(hash_read64(p) ^ s1, hash_read64(p + 8) ^ seed);
+      i -= 16;
+      p += 16;
+    }
+    a = hash_read64(p + i - 16);
+    b = hash_read64(p + i - 8);
+  }
+  a ^= s1;
+  b ^= seed;
+  hash_mul128(a, b);
+  return static_cast<size_t>(hash_mum(a ^ s0 ^ static_cast<uint64_t>(count), b ^ s1));
+}
 
 // 对于大部分类型，hash function 什么都不做
 template <class Key>
 struct hash {};
 
-// 针对指针的偏特化版本
+// 针对指针的偏特化版本，指针的低位通常因为对齐而全为 0，混合后再使用
 template <class T>
 struct hash<T*>
 {
+  typedef void is_avalanching;
   size_t operator()(T* p) const noexcept
-  { return reinterpret_cast<size_t>(p); }
+  { return hash_mix(reinterpret_cast<size_t>(p)); }
 };
 
 /*
-定义了一个名为 CTSTL_TRIVIAL_HASH_FCN 的宏，该宏用于为各种整型类型生成哈希函数。这些哈希函数都是 hash 结构的特化版本，其中 operator() 被重载以返回输入值的大小。对于这些类型，哈希函数只是返回原值。
+定义了一个名为 CTSTL_TRIVIAL_HASH_FCN 的宏，该宏用于为各种整型类型生成哈希函数。
+hash 的版本经过 hash_mix 混合，identity_hash 的版本只是返回原值。
 */
-// 对于整型类型，只是返回原值
-#define CTSTL_TRIVIAL_HASH_FCN(Type)         \
-template <> struct hash<Type>                \
-{                                            \
-  size_t operator()(Type val) const noexcept \
-  { return static_cast<size_t>(val); }       \
+#define CTSTL_TRIVIAL_HASH_FCN(Type)                         \
+template <> struct hash<Type>                                \
+{                                                            \
+  typedef void is_avalanching;                               \
+  size_t operator()(Type val) const noexcept                 \
+  { return hash_mix(static_cast<size_t>(val)); }             \
+};                                                           \
+template <> struct identity_hash<Type>                       \
+{                                                            \
+  size_t operator()(Type val) const noexcept                 \
+  { return static_cast<size_t>(val); }                       \
+};
+
+// 对于整型类型与指针，只是返回原值
+template <class Key>
+struct identity_hash {};
+
+template <class T>
+struct identity_hash<T*>
+{
+  size_t operator()(T* p) const noexcept
+  { return reinterpret_cast<size_t>(p); }
 };
 
 CTSTL_TRIVIAL_HASH_FCN(bool)
@@ -241,37 +408,12 @@ CTSTL_TRIVIAL_HASH_FCN(unsigned long long)
 
 #undef CTSTL_TRIVIAL_HASH_FCN
 
-/*
-该函数用于计算给定字节序列的哈希值。这个函数使用了一种名为 FNV-1a 的哈希算法，该算法以一种快速且简单的方式生成哈希值，适用于大多数用途。
-FNV-1a 算法的基本步骤：
-    初始化一个非零的哈希值，这个值通常被称为 offset_basis。
-    对于输入数据中的每一个字节：
-    先将哈希值与该字节进行异或运算。
-    然后将哈希值乘以一个特定的素数（称为 FNV_prime）
-*/
-// 对于浮点数，逐位哈希
-inline size_t bitwise_hash(const unsigned char* first, size_t count)
-{
-#if (_MSC_VER && _WIN64) || ((__GNUC__ || __clang__) &&__SIZEOF_POINTER__ == 8)
-  const size_t fnv_offset = 14695981039346656037ull;
-  const size_t fnv_prime = 1099511628211ull;
-#else
-  const size_t fnv_offset = 2166136261u;
-  const size_t fnv_prime = 16777619u;
-#endif
-  size_t result = fnv_offset;
-  for (size_t i = 0; i < count; ++i)
-  {
-    result ^= (size_t)first[i];
-    result *= fnv_prime;
-  }
-  return result;
-}
-
+// 对于浮点数，逐位哈希，+0.0 与 -0.0 相等，哈希值也相同
 template <>
 struct hash<float>
 {
-  size_t operator()(const float& val)
+  typedef void is_avalanching;
+  size_t operator()(const float& val) const noexcept
   { 
     return val == 0.0f ? 0 : bitwise_hash((const unsigned char*)&val, sizeof(float));
   }
@@ -280,19 +422,35 @@ struct hash<float>
 template <>
 struct hash<double>
 {
-  size_t operator()(const double& val)
+  typedef void is_avalanching;
+  size_t operator()(const double& val) const noexcept
   {
     return val == 0.0f ? 0 : bitwise_hash((const unsigned char*)&val, sizeof(double));
   }
 };
 
+// long double 只有前 10 个字节有意义，其余是填充
 template <>
 struct hash<long double>
 {
-  size_t operator()(const long double& val)
+  typedef void is_avalanching;
+  size_t operator()(const long double& val) const noexcept
   {
-    return val == 0.0f ? 0 : bitwise_hash((const unsigned char*)&val, sizeof(long double));
+    const size_t bytes = std::numeric_limits<long double>::digits == 64 ? 10 : sizeof(long double);
+    return val == 0.0f ? 0 : bitwise_hash((const unsigned char*)&val, bytes);
   }
 };
+
+// 对于字符串，按字节哈希
+template <class CharT, class Traits, class Alloc>
+struct hash<std::basic_string<CharT, Traits, Alloc>>
+{
+  typedef void is_avalanching;
+  size_t operator()(const std::basic_string<CharT, Traits, Alloc>& s) const noexcept
+  {
+    return bitwise_hash(reinterpret_cast<const unsigned char*>(s.data()), s.size() * sizeof(CharT));
+  }
+};
+
 } // namespace ctstl 
 #endif // CTSTL_FUNCTIONAL_H_
\ No newline at end of file
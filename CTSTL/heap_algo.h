@@ -2,11 +2,28 @@
 #define CTSTL_HEAP_ALGO_H_
 
 // 这个头文件包含 heap 的四个算法 : push_heap, pop_heap, sort_heap, make_heap
+//
+// 1. 什么是 d 叉堆？
+// 每个节点有 Arity 个孩子，节点 i 的孩子为 Arity * i + 1 ... Arity * i + Arity，父节点为 (i - 1) / Arity
+// 树高为 log(n) / log(Arity)，同一个节点的孩子在数组中相邻，下溯时每一层比较 Arity 个孩子，
+// 元素较小时它们通常位于同一条缓存行中；堆远大于缓存时每一层都是一次缓存未命中，
+// 4 叉、8 叉堆用更多的比较换取更少的层数，make_heap 和 push_heap 明显更快，
+// pop_heap 是否更快取决于比较的代价和元素的大小，应当按实际负载测量后选择
+//
+// 2. 如何使用？
+// 模板参数 Arity 放在最前面，缺省为 2（二叉堆），例如 ctstl::push_heap<4>(first, last, comp)
+// 同一个区间上的各个算法必须使用相同的 Arity
 
 #include "iterator.h"
+#include "functional.h"
+#include "util.h"
 
 namespace ctstl
 {
+
+// 缺省的分叉数
+enum { EHeapDefaultArity = 2 };
+
 /*****************************************************************************************/
 // push_heap
 // 该函数接受两个迭代器，表示一个 heap 容器的首尾，并且新元素已经插入到底部容器的最尾端，调整 heap
@@ -14,219 +31,171 @@ namespace ctstl
 // 实现一个最大堆
 // holeIndex：这是一个整数，表示新插入元素在堆中的位置。topIndex：表示堆的顶部位置。在大多数情况下，这个值为0。
 // push_heap_aux()相当于执行up(上溯)
-template <class RandomIter, class Distance, class T>
-void push_heap_aux(RandomIter first, Distance holeIndex, Distance topIndex, T value)
-{
-    auto parent =(holeIndex - 1) / 2;
-    while (holeIndex > topIndex && *(first + parent) < value)
-    {
-        // 使用 operator<，所以 heap 为 max-heap
-        *(first + holeIndex) = *(first + parent);
-        holeIndex = parent;
-        parent = (holeIndex - 1) / 2;
-    }
-    *(first + holeIndex) = value;
-}
-
-template <class RandomIter, class Distance>
-void push_heap_d(RandomIter first, RandomIter last, Distance*)
-{
-    ctstl::push_heap_aux(first, (last - first) - 1, static_cast<Distance>(0), *(last - 1));
-}
-
-template <class RandomIter>
-void push_heap(RandomIter first, RandomIter last)
-{   // 此函数被调用时，新元素应该已置于底部容器的最尾端
-    ctstl::push_heap_d(first, last, distance_type(first));
-}
-
-// 重载版本使用函数对象 comp 代替比较操作
-template <class RandomIter, class Distance, class T, class Compared>
+template <size_t Arity, class RandomIter, class Distance, class T, class Compared>
 void push_heap_aux(RandomIter first, Distance holeIndex, Distance topIndex, T value,
                    Compared comp)
 {
-    auto parent =(holeIndex - 1) / 2;
+    static_assert(Arity >= 2, "heap arity must be at least 2");
+    const Distance arity = static_cast<Distance>(Arity);
+    Distance parent = (holeIndex - 1) / arity;
     while (holeIndex > topIndex && comp(*(first + parent), value))
     {
-        // 使用 operator<，所以 heap 为 max-heap
-        *(first + holeIndex) = *(first + parent);
+        // 使用 comp 比较，comp 为 less 时 heap 为 max-heap
+        *(first + holeIndex) = ctstl::move(*(first + parent));
         holeIndex = parent;
-        parent = (holeIndex - 1) / 2;
+        parent = (holeIndex - 1) / arity;
     }
-    *(first + holeIndex) = value;
+    *(first + holeIndex) = ctstl::move(value);
 }
 
-template <class RandomIter, class Compared, class Distance>
+template <size_t Arity, class RandomIter, class Distance, class Compared>
 void push_heap_d(RandomIter first, RandomIter last, Distance*, Compared comp)
 {
-  ctstl::push_heap_aux(first, (last - first) - 1, static_cast<Distance>(0),
-                       *(last - 1), comp);
+    typename iterator_traits<RandomIter>::value_type value = ctstl::move(*(last - 1));
+    ctstl::push_heap_aux<Arity>(first, static_cast<Distance>((last - first) - 1),
+                                static_cast<Distance>(0), ctstl::move(value), comp);
 }
 
-template <class RandomIter, class Compared>
+template <size_t Arity = EHeapDefaultArity, class RandomIter, class Compared>
 void push_heap(RandomIter first, RandomIter last, Compared comp)
+{   // 此函数被调用时，新元素应该已置于底部容器的最尾端
+    ctstl::push_heap_d<Arity>(first, last, distance_type(first), comp);
+}
+
+// 使用 operator< 的版本
+template <size_t Arity = EHeapDefaultArity, class RandomIter>
+void push_heap(RandomIter first, RandomIter last)
 {
-  ctstl::push_heap_d(first, last, distance_type(first), comp);
+    ctstl::push_heap<Arity>(first, last,
+                            ctstl::less<typename iterator_traits<RandomIter>::value_type>());
 }
 
 /*****************************************************************************************/
 // pop_heap
 // 该函数接受两个迭代器，表示 heap 容器的首尾，将 heap 的根节点取出放到容器尾部，调整 heap
 /*****************************************************************************************/
-// 在堆中删除任意元素
-template <class RandomIter, class T, class Distance>
-void adjust_heap(RandomIter first, Distance holeIndex, Distance len, T value)
-{
-    // 先进行下溯过程
-    auto topIndex = holeIndex;
-    auto rchild = 2 * holeIndex + 2;
-    while (rchild < len)
-    {   
-        // 右孩子比左孩子小
-        if (*(first + rchild) < *(first + rchild - 1)) {
-            --rchild;
-        }
-        *(first + holeIndex) = *(first + rchild);
-        holeIndex = rchild;
-        rchild = 2 * (rchild + 1);
-    }
-    if (rchild == len)
-    {   // 如果没有右子节点
-        *(first + holeIndex) = *(first + (rchild - 1));
-        holeIndex = rchild - 1;
-    }
-    // 再执行一次上溯过程
-    ctstl::push_heap_aux(first, holeIndex, topIndex, value);
-}
-
-template <class RandomIter, class T, class Distance>
-void pop_heap_aux(RandomIter first, RandomIter last, RandomIter result, T value_type,
-                  Distance*)
-{   // 先将首值调至尾节点，然后调整[first, last - 1)使之重新成为一个 max-heap
-    *result = *first;
-    ctstl::adjust_heap(first, static_cast<Distance>(0), last - first, value);
-}
-
-template <class RandomIter>
-void pop_heap(RandomIter first, RandomIter last)
-{
-  ctstl::pop_heap_aux(first, last - 1, last - 1, *(last - 1), distance_type(first));
-}
-
-// 重载版本使用函数对象 comp 代替比较操作
-template <class RandomIter, class T, class Distance, class Compared>
+// 从 holeIndex 开始重新放入 value
+// 先一路把最大的孩子上移，直到叶节点（下溯，每一层比较 Arity 个孩子），再把 value 从叶节点上溯到合适的位置
+// 被弹出的末尾元素通常很小，最后的上溯几乎不会移动，比每一层都与 value 比较少一次比较
+template <size_t Arity, class RandomIter, class T, class Distance, class Compared>
 void adjust_heap(RandomIter first, Distance holeIndex, Distance len, T value,
                  Compared comp)
 {
-    // 先进行下溯(percolate down)过程
-    auto topIndex = holeIndex;
-    auto rchild = 2 * holeIndex + 2;
-    while (rchild < len)
+    const Distance arity = static_cast<Distance>(Arity);
+    const Distance topIndex = holeIndex;
+    Distance child = arity * holeIndex + 1;
+    // 孩子完整的节点，循环次数是编译期常量，可以被展开
+    while (child < len - (arity - 1))
     {
-        if (comp(*(first + rchild), *(first + rchild - 1)))  --rchild;
-        *(first + holeIndex) = *(first + rchild);
-        holeIndex = rchild;
-        rchild = 2 * (rchild + 1);
+        Distance largest = child;
+        for (Distance k = 1; k < arity; ++k)
+        {
+            // 孩子之间的大小关系是随机的，写成条件传送而不是分支
+            largest = comp(*(first + largest), *(first + (child + k))) ? child + k : largest;
+        }
+        *(first + holeIndex) = ctstl::move(*(first + largest));
+        holeIndex = largest;
+        child = arity * holeIndex + 1;
     }
-    if (rchild == len)
-    {
-        *(first + holeIndex) = *(first + (rchild - 1));
-        holeIndex = rchild - 1;
+    if (child < len)
+    {   // 最后一个内部节点的孩子不足 Arity 个
+        Distance largest = child;
+        for (Distance k = child + 1; k < len; ++k)
+        {
+            if (comp(*(first + largest), *(first + k)))
+                largest = k;
+        }
+        *(first + holeIndex) = ctstl::move(*(first + largest));
+        holeIndex = largest;
     }
     // 再执行一次上溯(percolate up)过程
-    ctstl::push_heap_aux(first, holeIndex, topIndex, value, comp);
+    ctstl::push_heap_aux<Arity>(first, holeIndex, topIndex, ctstl::move(value), comp);
 }
 
-template <class RandomIter, class T, class Distance, class Compared>
-void pop_heap_aux(RandomIter first, RandomIter last, RandomIter result, 
+template <size_t Arity, class RandomIter, class T, class Distance, class Compared>
+void pop_heap_aux(RandomIter first, RandomIter last, RandomIter result,
                   T value, Distance*, Compared comp)
-{
-    *result = *first;  // 先将尾指设置成首值，即尾指为欲求结果
-    ctstl::adjust_heap(first, static_cast<Distance>(0), last - first, value, comp);
+{   // 先将首值调至尾节点，然后调整[first, last)使之重新成为一个 heap
+    *result = ctstl::move(*first);
+    ctstl::adjust_heap<Arity>(first, static_cast<Distance>(0),
+                              static_cast<Distance>(last - first), ctstl::move(value), comp);
 }
 
-template <class RandomIter, class Compared>
+template <size_t Arity = EHeapDefaultArity, class RandomIter, class Compared>
 void pop_heap(RandomIter first, RandomIter last, Compared comp)
 {
-    ctstl::pop_heap_aux(first, last - 1, last - 1, *(last - 1),
-                        distance_type(first), comp);
+    typename iterator_traits<RandomIter>::value_type value = ctstl::move(*(last - 1));
+    ctstl::pop_heap_aux<Arity>(first, last - 1, last - 1, ctstl::move(value),
+                               distance_type(first), comp);
+}
+
+// 使用 operator< 的版本
+template <size_t Arity = EHeapDefaultArity, class RandomIter>
+void pop_heap(RandomIter first, RandomIter last)
+{
+    ctstl::pop_heap<Arity>(first, last,
+                           ctstl::less<typename iterator_traits<RandomIter>::value_type>());
 }
 
 /*****************************************************************************************/
 // sort_heap
 // 该函数接受两个迭代器，表示 heap 容器的首尾，不断执行 pop_heap 操作，直到首尾最多相差1
 /*****************************************************************************************/
-template <class RandomIter>
-void sort_heap(RandomIter first, RandomIter last)
+template <size_t Arity = EHeapDefaultArity, class RandomIter, class Compared>
+void sort_heap(RandomIter first, RandomIter last, Compared comp)
 {
     // 每执行一次 pop_heap，最大的元素都被放到尾部，直到容器最多只有一个元素，完成排序
-    while (last - first > 1) 
+    while (last - first > 1)
     {
-        ctstl::pop_heap(first, last--);
+        ctstl::pop_heap<Arity>(first, last--, comp);
     }
 }
 
-// 重载版本使用函数对象 comp 代替比较操作
-template <class RandomIter, class Compared>
-void sort_heap(RandomIter first, RandomIter last, Compared comp)
+// 使用 operator< 的版本
+template <size_t Arity = EHeapDefaultArity, class RandomIter>
+void sort_heap(RandomIter first, RandomIter last)
 {
-  while (last - first > 1)
-  {
-    mystl::pop_heap(first, last--, comp);
-  }
+    ctstl::sort_heap<Arity>(first, last,
+                            ctstl::less<typename iterator_traits<RandomIter>::value_type>());
 }
 
 /*****************************************************************************************/
 // make_heap
 // 该函数接受两个迭代器，表示 heap 容器的首尾，把容器内的数据变为一个 heap
 /*****************************************************************************************/
-template <class RandomIter, class Distance>
-void make_heap_aux(RandomIter first, RandomIter last, Distance*)
+template <size_t Arity, class RandomIter, class Distance, class Compared>
+void make_heap_aux(RandomIter first, RandomIter last, Distance*, Compared comp)
 {
-    if (last - first < 2) 
+    if (last - first < 2)
         return;
-    auto len = last - first;
-    auto holeIndex = (len - 2) / 2;
+    const Distance len = static_cast<Distance>(last - first);
+    // 最后一个元素的父节点，即最后一个内部节点
+    Distance holeIndex = (len - 2) / static_cast<Distance>(Arity);
     while (true)
     {
         // 重排以 holeIndex 为首的子树
-        ctstl::adjust_heap(first, holeIndex, len, *(first + holeIndex));
+        typename iterator_traits<RandomIter>::value_type value = ctstl::move(*(first + holeIndex));
+        ctstl::adjust_heap<Arity>(first, holeIndex, len, ctstl::move(value), comp);
         if (holeIndex == 0)
             return;
         holeIndex--;
     }
 }
 
-template <class RandomIter>
-void make_heap(RandomIter first, RandomIter last)
-{
-    ctstl::make_heap_aux(first, last, distance_type(first));;
-}
-
-// 重载版本使用函数对象 comp 代替比较操作
-template <class RandomIter, class Distance, class Compared>
-void make_heap_aux(RandomIter first, RandomIter last, Distance*, Compared comp)
+template <size_t Arity = EHeapDefaultArity, class RandomIter, class Compared>
+void make_heap(RandomIter first, RandomIter last, Compared comp)
 {
-  if (last - first < 2)
-    return;
-  auto len = last - first;
-  auto holeIndex = (len - 2) / 2;
-  while (true)
-  {
-    // 重排以 holeIndex 为首的子树
-    ctstl::adjust_heap(first, holeIndex, len, *(first + holeIndex), comp);
-    if (holeIndex == 0)
-      return;
-    holeIndex--;
-  }
+    ctstl::make_heap_aux<Arity>(first, last, distance_type(first), comp);
 }
 
-template <class RandomIter, class Compared>
-void make_heap(RandomIter first, RandomIter last, Compared comp)
+// 使用 operator< 的版本
+template <size_t Arity = EHeapDefaultArity, class RandomIter>
+void make_heap(RandomIter first, RandomIter last)
 {
-  ctstl::make_heap_aux(first, last, distance_type(first), comp);
+    ctstl::make_heap<Arity>(first, last,
+                            ctstl::less<typename iterator_traits<RandomIter>::value_type>());
 }
 
 } // namespace ctstl
 
-#endif // !CTSTL_HEAP_ALGO_H_
\ No newline at end of file
+#endif // !CTSTL_HEAP_ALGO_H_
@@ -222,6 +222,21 @@ void advance(InputIterator& i, Distance n)
   advance_dispatch(i, n, iterator_category(i));
 }
 
+// 模板类 : segmented_iterator_traits
+// 分段迭代器：像 deque 这样由若干连续块组成的容器，迭代器可以分解为“所在的块”和“块内的位置”两层，
+// algobase.h 中的 copy / move / fill / equal 对每一块分别调用块内（普通指针）的版本，从而用上 memmove / memset / memcmp
+// 容器通过特化这个模板声明自己的迭代器是分段迭代器，并提供：
+//   segment_iterator           : 在块之间移动的迭代器
+//   local_iterator             : 块内的迭代器（普通指针）
+//   segment(it) / local(it)    : 分解迭代器
+//   begin(seg) / end(seg)      : 块内元素的范围
+//   compose(seg, local)        : 重新组合成迭代器，local 等于 end(seg) 时得到下一块的开头
+template <class Iterator>
+struct segmented_iterator_traits
+{
+    typedef std::false_type is_segmented_iterator;
+};
+
 // 模板类 : reverse_iterator
 // 代表反向迭代器，使前进为后退，后退为前进
 template <class Iterator>
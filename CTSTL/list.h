@@ -0,0 +1,1057 @@
+#ifndef CTSTL_LIST_H_
+#define CTSTL_LIST_H_
+
+// 这个头文件包含了一个模板类 list
+// list : 双向链表
+//
+// 1. list 的结构
+// 哨兵节点 node_ 直接保存在 list 对象中，它的 next 指向第一个节点，prev 指向最后一个节点，
+// 因此在两端插入、删除都是 O(1)，空的 list 不需要分配任何内存
+// 节点默认由 slab_allocator 分配（见 slab_alloc.h），从整块的 slab 中切出，释放后在本线程内复用
+//
+// 2. 不分配内存的操作
+// splice / merge / sort / reverse 只修改节点之间的指针，不分配、不释放节点，也不移动元素
+//
+// 异常保证：
+// emplace_front / emplace_back / emplace / push_front / push_back / insert 插入单个元素时提供强异常安全保证，
+// sort / merge 在比较函数抛出异常时仍然保持 list 是一个合法的链表
+
+#include <initializer_list>
+#include <type_traits>
+
+#include "iterator.h"
+#include "memory.h"
+#include "functional.h"
+#include "util.h"
+#include "slab_alloc.h"
+#include "exceptdef.h"
+
+namespace ctstl
+{
+
+template <class T> struct list_node;
+
+// list 节点中与元素类型无关的部分，哨兵节点只有这一部分
+struct list_node_base
+{
+    list_node_base* prev;  // 前一节点
+    list_node_base* next;  // 下一节点
+
+    void unlink() noexcept
+    {
+        prev = next = this;
+    }
+};
+
+template <class T>
+struct list_node : public list_node_base
+{
+    T value;  // 数据域
+};
+
+// list 的迭代器设计
+template <class T, class Ref, class Ptr>
+struct list_iterator : public iterator<bidirectional_iterator_tag, T, ptrdiff_t, Ptr, Ref>
+{
+    typedef list_iterator<T, T&, T*>             iterator;
+    typedef list_iterator<T, const T&, const T*> const_iterator;
+    typedef list_iterator                        self;
+
+    typedef T                value_type;
+    typedef Ptr              pointer;
+    typedef Ref              reference;
+    typedef list_node_base*  base_ptr;
+    typedef list_node<T>*    node_ptr;
+
+    base_ptr node_;  // 指向当前节点
+
+    // 构造函数
+    list_iterator() noexcept : node_(nullptr) {}
+    explicit list_iterator(base_ptr x) noexcept : node_(x) {}
+    list_iterator(const iterator& rhs) noexcept : node_(rhs.node_) {}
+
+    self& operator=(const iterator& rhs) noexcept
+    {
+        node_ = rhs.node_;
+        return *this;
+    }
+
+    // 重载操作符
+    reference operator*()  const { return static_cast<node_ptr>(node_)->value; }
+    pointer   operator->() const { return &(operator*()); }
+
+    self& operator++()
+    {
+        CTSTL_DEBUG(node_ != nullptr);
+        node_ = node_->next;
+        return *this;
+    }
+    self operator++(int)
+    {
+        self tmp = *this;
+        ++*this;
+        return tmp;
+    }
+    self& operator--()
+    {
+        CTSTL_DEBUG(node_ != nullptr);
+        node_ = node_->prev;
+        return *this;
+    }
+    self operator--(int)
+    {
+        self tmp = *this;
+        --*this;
+        return tmp;
+    }
+
+    // 重载比较操作符
+    bool operator==(const self& rhs) const { return node_ == rhs.node_; }
+    bool operator!=(const self& rhs) const { return node_ != rhs.node_; }
+};
+
+// 模板类: list
+// 模板参数 T 代表数据类型，Alloc 代表空间配置器，节点由 Alloc::rebind<list_node<T>>::other 分配
+template <class T, class Alloc = ctstl::slab_allocator<T>>
+class list
+{
+public:
+    // list 的嵌套型别定义
+    typedef Alloc                                        allocator_type;
+
+    typedef T                                            value_type;
+    typedef T*                                           pointer;
+    typedef const T*                                     const_pointer;
+    typedef T&                                           reference;
+    typedef const T&                                     const_reference;
+    typedef size_t                                       size_type;
+    typedef ptrdiff_t                                    difference_type;
+
+    typedef list_iterator<T, T&, T*>                     iterator;
+    typedef list_iterator<T, const T&, const T*>         const_iterator;
+    typedef ctstl::reverse_iterator<iterator>            reverse_iterator;
+    typedef ctstl::reverse_iterator<const_iterator>      const_reverse_iterator;
+
+    allocator_type get_allocator() const { return size_.first(); }
+
+private:
+    typedef list_node_base*                                      base_ptr;
+    typedef list_node<T>*                                        node_ptr;
+    typedef typename Alloc::template rebind<list_node<T>>::other node_allocator_type;
+
+    list_node_base                               node_;  // 哨兵节点
+    compressed_pair<allocator_type, size_type>   size_;  // 配置器，以及元素个数
+
+public:
+    // 构造、复制、移动、析构函数
+    list()
+        : size_(allocator_type(), 0)
+    {
+        node_.unlink();
+    }
+
+    explicit list(const allocator_type& a)
+        : size_(a, 0)
+    {
+        node_.unlink();
+    }
+
+    explicit list(size_type n, const allocator_type& a = allocator_type())
+        : size_(a, 0)
+    {
+        node_.unlink();
+        fill_init(n);
+    }
+
+    list(size_type n, const T& value, const allocator_type& a = allocator_type())
+        : size_(a, 0)
+    {
+        node_.unlink();
+        fill_init(n, value);
+    }
+
+    template <class IIter, typename std::enable_if<
+        ctstl::is_input_iterator<IIter>::value, int>::type = 0>
+    list(IIter first, IIter last, const allocator_type& a = allocator_type())
+        : size_(a, 0)
+    {
+        node_.unlink();
+        copy_init(first, last);
+    }
+
+    list(std::initializer_list<T> ilist, const allocator_type& a = allocator_type())
+        : size_(a, 0)
+    {
+        node_.unlink();
+        copy_init(ilist.begin(), ilist.end());
+    }
+
+    list(const list& rhs)
+        : size_(rhs.size_.first(), 0)
+    {
+        node_.unlink();
+        copy_init(rhs.cbegin(), rhs.cend());
+    }
+
+    list(list&& rhs) noexcept
+        : size_(ctstl::move(rhs.size_.first()), 0)
+    {
+        node_.unlink();
+        take_nodes(rhs);
+    }
+
+    list& operator=(const list& rhs)
+    {
+        if (this != &rhs)
+            assign(rhs.begin(), rhs.end());
+        return *this;
+    }
+
+    // 配置器保持不变：与 rhs 的配置器相等时直接接管 rhs 的节点，否则逐个移动元素
+    list& operator=(list&& rhs) noexcept(std::is_empty<Alloc>::value)
+    {
+        if (this == &rhs)
+            return *this;
+        clear();
+        if (ctstl::allocator_equal(size_.first(), rhs.size_.first()))
+        {
+            take_nodes(rhs);
+        }
+        else
+        {
+            for (iterator it = rhs.begin(); it != rhs.end(); ++it)
+                emplace_back(ctstl::move(*it));
+            rhs.clear();
+        }
+        return *this;
+    }
+
+    list& operator=(std::initializer_list<T> ilist)
+    {
+        assign(ilist.begin(), ilist.end());
+        return *this;
+    }
+
+    ~list()
+    {
+        clear();
+    }
+
+public:
+    // 迭代器相关操作
+    iterator               begin()         noexcept { return iterator(node_.next); }
+    const_iterator         begin()   const noexcept { return const_iterator(node_.next); }
+    iterator               end()           noexcept { return iterator(&node_); }
+    const_iterator         end()     const noexcept { return const_iterator(const_cast<base_ptr>(&node_)); }
+
+    reverse_iterator       rbegin()        noexcept { return reverse_iterator(end()); }
+    const_reverse_iterator rbegin()  const noexcept { return const_reverse_iterator(end()); }
+    reverse_iterator       rend()          noexcept { return reverse_iterator(begin()); }
+    const_reverse_iterator rend()    const noexcept { return const_reverse_iterator(begin()); }
+
+    const_iterator         cbegin()  const noexcept { return begin(); }
+    const_iterator         cend()    const noexcept { return end(); }
+    const_reverse_iterator crbegin() const noexcept { return rbegin(); }
+    const_reverse_iterator crend()   const noexcept { return rend(); }
+
+    // 容量相关操作
+    bool      empty()    const noexcept { return node_.next == &node_; }
+    size_type size()     const noexcept { return size_.second(); }
+    size_type max_size() const noexcept { return static_cast<size_type>(-1) / sizeof(list_node<T>); }
+
+    // 访问元素相关操作
+    reference       front()
+    {
+        CTSTL_DEBUG(!empty());
+        return *begin();
+    }
+    const_reference front() const
+    {
+        CTSTL_DEBUG(!empty());
+        return *begin();
+    }
+    reference       back()
+    {
+        CTSTL_DEBUG(!empty());
+        return *(--end());
+    }
+    const_reference back()  const
+    {
+        CTSTL_DEBUG(!empty());
+        return *(--end());
+    }
+
+    // 调整容器相关操作
+
+    // assign
+    void assign(size_type n, const value_type& value)
+    {
+        fill_assign(n, value);
+    }
+
+    template <class IIter, typename std::enable_if<
+        ctstl::is_input_iterator<IIter>::value, int>::type = 0>
+    void assign(IIter first, IIter last)
+    {
+        copy_assign(first, last);
+    }
+
+    void assign(std::initializer_list<T> ilist)
+    {
+        copy_assign(ilist.begin(), ilist.end());
+    }
+
+    // emplace_front / emplace_back / emplace
+    template <class ...Args>
+    reference emplace_front(Args&& ...args)
+    {
+        THROW_LENGTH_ERROR_IF(size() > max_size() - 1, "list<T>'s size too big");
+        base_ptr p = create_node(ctstl::forward<Args>(args)...);
+        link_nodes(node_.next, p, p);
+        ++size_.second();
+        return static_cast<node_ptr>(p)->value;
+    }
+
+    template <class ...Args>
+    reference emplace_back(Args&& ...args)
+    {
+        THROW_LENGTH_ERROR_IF(size() > max_size() - 1, "list<T>'s size too big");
+        base_ptr p = create_node(ctstl::forward<Args>(args)...);
+        link_nodes(&node_, p, p);
+        ++size_.second();
+        return static_cast<node_ptr>(p)->value;
+    }
+
+    template <class ...Args>
+    iterator emplace(const_iterator pos, Args&& ...args)
+    {
+        THROW_LENGTH_ERROR_IF(size() > max_size() - 1, "list<T>'s size too big");
+        base_ptr p = create_node(ctstl::forward<Args>(args)...);
+        link_nodes(pos.node_, p, p);
+        ++size_.second();
+        return iterator(p);
+    }
+
+    // insert
+    iterator insert(const_iterator pos, const value_type& value)
+    {
+        return emplace(pos, value);
+    }
+
+    iterator insert(const_iterator pos, value_type&& value)
+    {
+        return emplace(pos, ctstl::move(value));
+    }
+
+    iterator insert(const_iterator pos, size_type n, const value_type& value)
+    {
+        THROW_LENGTH_ERROR_IF(size() > max_size() - n, "list<T>'s size too big");
+        return fill_insert(pos, n, value);
+    }
+
+    template <class IIter, typename std::enable_if<
+        ctstl::is_input_iterator<IIter>::value, int>::type = 0>
+    iterator insert(const_iterator pos, IIter first, IIter last)
+    {
+        return copy_insert(pos, first, last);
+    }
+
+    iterator insert(const_iterator pos, std::initializer_list<T> ilist)
+    {
+        return copy_insert(pos, ilist.begin(), ilist.end());
+    }
+
+    // push_front / push_back
+    void push_front(const value_type& value) { emplace_front(value); }
+    void push_front(value_type&& value)      { emplace_front(ctstl::move(value)); }
+    void push_back(const value_type& value)  { emplace_back(value); }
+    void push_back(value_type&& value)       { emplace_back(ctstl::move(value)); }
+
+    // pop_front / pop_back
+    void pop_front()
+    {
+        CTSTL_DEBUG(!empty());
+        base_ptr n = node_.next;
+        unlink_nodes(n, n);
+        destroy_node(n);
+        --size_.second();
+    }
+
+    void pop_back()
+    {
+        CTSTL_DEBUG(!empty());
+        base_ptr n = node_.prev;
+        unlink_nodes(n, n);
+        destroy_node(n);
+        --size_.second();
+    }
+
+    // erase / clear
+    iterator erase(const_iterator pos);
+    iterator erase(const_iterator first, const_iterator last);
+    void     clear() noexcept;
+
+    // resize
+    void resize(size_type new_size) { resize_impl(new_size); }
+    void resize(size_type new_size, const value_type& value) { resize_impl(new_size, value); }
+
+    void swap(list& rhs) noexcept;
+
+    // list 相关操作
+
+    void splice(const_iterator pos, list& x);
+    void splice(const_iterator pos, list& x, const_iterator it);
+    void splice(const_iterator pos, list& x, const_iterator first, const_iterator last);
+    void splice(const_iterator pos, list&& x)                { splice(pos, x); }
+    void splice(const_iterator pos, list&& x, const_iterator it) { splice(pos, x, it); }
+    void splice(const_iterator pos, list&& x, const_iterator first, const_iterator last)
+    { splice(pos, x, first, last); }
+
+    void remove(const value_type& value)
+    {
+        // value 可能引用 list 中的元素，先把要删除的节点转移到 deleted 中
+        list deleted(size_.first());
+        for (iterator f = begin(), l = end(); f != l; )
+        {
+            iterator next = f;
+            ++next;
+            if (*f == value)
+                deleted.splice(deleted.cend(), *this, f);
+            f = next;
+        }
+    }
+    template <class UnaryPredicate>
+    void remove_if(UnaryPredicate pred);
+
+    void unique()
+    { unique(ctstl::equal_to<T>()); }
+    template <class BinaryPredicate>
+    void unique(BinaryPredicate pred);
+
+    void merge(list& x)
+    { merge(x, ctstl::less<T>()); }
+    void merge(list&& x)
+    { merge(x, ctstl::less<T>()); }
+    template <class Compare>
+    void merge(list& x, Compare comp);
+    template <class Compare>
+    void merge(list&& x, Compare comp)
+    { merge(x, comp); }
+
+    void sort()
+    { list_sort(begin(), end(), size(), ctstl::less<T>()); }
+    template <class Compared>
+    void sort(Compared comp)
+    { list_sort(begin(), end(), size(), comp); }
+
+    void reverse() noexcept;
+
+private:
+    // helper functions
+
+    node_allocator_type node_allocator() const
+    {
+        return ctstl::rebind_allocator<node_allocator_type>(size_.first());
+    }
+
+    // create / destroy node
+    template <class ...Args>
+    base_ptr create_node(Args&& ...args);
+    void     destroy_node(base_ptr p) noexcept;
+
+    // link / unlink
+    static void link_nodes(base_ptr pos, base_ptr first, base_ptr last) noexcept;
+    static void unlink_nodes(base_ptr first, base_ptr last) noexcept;
+    void        take_nodes(list& rhs) noexcept;
+
+    // initialize
+    template <class... Value>
+    void      fill_init(size_type n, const Value&... value);
+    template <class IIter>
+    void      copy_init(IIter first, IIter last);
+
+    // assign
+    void      fill_assign(size_type n, const value_type& value);
+    template <class IIter>
+    void      copy_assign(IIter first, IIter last);
+
+    // insert
+    template <class... Value>
+    iterator  fill_insert(const_iterator pos, size_type n, const Value&... value);
+    template <class IIter>
+    iterator  copy_insert(const_iterator pos, IIter first, IIter last);
+
+    template <class... Value>
+    void      resize_impl(size_type new_size, const Value&... value);
+
+    // sort
+    template <class Compared>
+    iterator  list_sort(iterator first, iterator last, size_type n, Compared comp);
+};
+
+/*****************************************************************************************/
+
+// 删除 pos 处的元素
+template <class T, class Alloc>
+typename list<T, Alloc>::iterator
+list<T, Alloc>::erase(const_iterator pos)
+{
+    CTSTL_DEBUG(pos != cend());
+    base_ptr n = pos.node_;
+    base_ptr next = n->next;
+    unlink_nodes(n, n);
+    destroy_node(n);
+    --size_.second();
+    return iterator(next);
+}
+
+// 删除 [first, last) 内的元素
+template <class T, class Alloc>
+typename list<T, Alloc>::iterator
+list<T, Alloc>::erase(const_iterator first, const_iterator last)
+{
+    if (first != last)
+    {
+        unlink_nodes(first.node_, last.node_->prev);
+        while (first != last)
+        {
+            base_ptr cur = first.node_;
+            ++first;
+            destroy_node(cur);
+            --size_.second();
+        }
+    }
+    return iterator(last.node_);
+}
+
+// 清空 list
+template <class T, class Alloc>
+void list<T, Alloc>::clear() noexcept
+{
+    base_ptr cur = node_.next;
+    while (cur != &node_)
+    {
+        base_ptr next = cur->next;
+        destroy_node(cur);
+        cur = next;
+    }
+    node_.unlink();
+    size_.second() = 0;
+}
+
+// 交换两个 list，哨兵节点在对象内部，需要修正首尾节点的指向
+template <class T, class Alloc>
+void list<T, Alloc>::swap(list& rhs) noexcept
+{
+    if (this == &rhs)
+        return;
+    CTSTL_DEBUG(ctstl::allocator_equal(size_.first(), rhs.size_.first()));
+    list_node_base tmp;
+    tmp.unlink();
+    // this -> tmp, rhs -> this, tmp -> rhs
+    if (!empty())
+    {
+        tmp = node_;
+        tmp.next->prev = tmp.prev->next = &tmp;
+    }
+    if (!rhs.empty())
+    {
+        node_ = rhs.node_;
+        node_.next->prev = node_.prev->next = &node_;
+    }
+    else
+    {
+        node_.unlink();
+    }
+    if (tmp.next != &tmp)
+    {
+        rhs.node_ = tmp;
+        rhs.node_.next->prev = rhs.node_.prev->next = &rhs.node_;
+    }
+    else
+    {
+        rhs.node_.unlink();
+    }
+    ctstl::swap(size_.second(), rhs.size_.second());
+}
+
+// 将 list x 接合于 pos 之前
+template <class T, class Alloc>
+void list<T, Alloc>::splice(const_iterator pos, list& x)
+{
+    CTSTL_DEBUG(this != &x);
+    if (!x.empty())
+    {
+        THROW_LENGTH_ERROR_IF(size() > max_size() - x.size(), "list<T>'s size too big");
+
+        base_ptr f = x.node_.next;
+        base_ptr l = x.node_.prev;
+
+        x.unlink_nodes(f, l);
+        link_nodes(pos.node_, f, l);
+
+        size_.second() += x.size_.second();
+        x.size_.second() = 0;
+    }
+}
+
+// 将 it 所指的节点接合于 pos 之前
+template <class T, class Alloc>
+void list<T, Alloc>::splice(const_iterator pos, list& x, const_iterator it)
+{
+    if (pos.node_ != it.node_ && pos.node_ != it.node_->next)
+    {
+        THROW_LENGTH_ERROR_IF(this != &x && size() > max_size() - 1, "list<T>'s size too big");
+
+        base_ptr f = it.node_;
+
+        x.unlink_nodes(f, f);
+        link_nodes(pos.node_, f, f);
+
+        ++size_.second();
+        --x.size_.second();
+    }
+}
+
+// 将 list x 的 [first, last) 内的节点接合于 pos 之前
+template <class T, class Alloc>
+void list<T, Alloc>::splice(const_iterator pos, list& x, const_iterator first, const_iterator last)
+{
+    if (first != last && pos != last)
+    {
+        if (this != &x)
+        {
+            const size_type n = static_cast<size_type>(ctstl::distance(first, last));
+            THROW_LENGTH_ERROR_IF(size() > max_size() - n, "list<T>'s size too big");
+            size_.second() += n;
+            x.size_.second() -= n;
+        }
+        base_ptr f = first.node_;
+        base_ptr l = last.node_->prev;
+        x.unlink_nodes(f, l);
+        link_nodes(pos.node_, f, l);
+    }
+}
+
+// 将另一元操作 pred 为 true 的所有元素移除
+template <class T, class Alloc>
+template <class UnaryPredicate>
+void list<T, Alloc>::remove_if(UnaryPredicate pred)
+{
+    for (iterator f = begin(), l = end(); f != l; )
+    {
+        iterator next = f;
+        ++next;
+        if (pred(*f))
+            erase(f);
+        f = next;
+    }
+}
+
+// 移除 list 中满足 pred 为 true 重复元素
+template <class T, class Alloc>
+template <class BinaryPredicate>
+void list<T, Alloc>::unique(BinaryPredicate pred)
+{
+    iterator i = begin();
+    iterator e = end();
+    if (i == e)
+        return;
+    iterator j = i;
+    ++j;
+    while (j != e)
+    {
+        if (pred(*i, *j))
+        {
+            j = erase(j);
+        }
+        else
+        {
+            i = j;
+            ++j;
+        }
+    }
+}
+
+// 与另一个 list 合并，按照 comp 为 true 的顺序
+template <class T, class Alloc>
+template <class Compare>
+void list<T, Alloc>::merge(list& x, Compare comp)
+{
+    if (this == &x)
+        return;
+    THROW_LENGTH_ERROR_IF(size() > max_size() - x.size(), "list<T>'s size too big");
+
+    iterator f1 = begin();
+    iterator l1 = end();
+    iterator f2 = x.begin();
+    iterator l2 = x.end();
+
+    while (f1 != l1 && f2 != l2)
+    {
+        if (comp(*f2, *f1))
+        {
+            // 使 comp 为 true 的一段区间一次转移
+            iterator next = f2;
+            ++next;
+            for (; next != l2 && comp(*next, *f1); ++next)
+                ;
+            base_ptr f = f2.node_;
+            base_ptr l = next.node_->prev;
+            size_type n = 1;
+            for (base_ptr p = f; p != l; p = p->next)
+                ++n;
+            f2 = next;
+
+            // link node
+            x.unlink_nodes(f, l);
+            link_nodes(f1.node_, f, l);
+            size_.second() += n;
+            x.size_.second() -= n;
+            ++f1;
+        }
+        else
+        {
+            ++f1;
+        }
+    }
+    // 连接剩余部分
+    if (f2 != l2)
+    {
+        base_ptr f = f2.node_;
+        base_ptr l = l2.node_->prev;
+        x.unlink_nodes(f, l);
+        link_nodes(l1.node_, f, l);
+    }
+    size_.second() += x.size_.second();
+    x.size_.second() = 0;
+}
+
+// 将 list 反转
+template <class T, class Alloc>
+void list<T, Alloc>::reverse() noexcept
+{
+    base_ptr cur = &node_;
+    do
+    {
+        base_ptr next = cur->next;
+        cur->next = cur->prev;
+        cur->prev = next;
+        cur = next;
+    } while (cur != &node_);
+}
+
+/*****************************************************************************************/
+// helper function
+
+// 创建结点，构造元素时抛出异常则释放节点
+template <class T, class Alloc>
+template <class ...Args>
+typename list<T, Alloc>::base_ptr
+list<T, Alloc>::create_node(Args&& ...args)
+{
+    node_ptr p = node_allocator().allocate(1);
+    try
+    {
+        ctstl::construct(ctstl::address_of(p->value), ctstl::forward<Args>(args)...);
+    }
+    catch (...)
+    {
+        node_allocator().deallocate(p, 1);
+        throw;
+    }
+    p->prev = p->next = nullptr;
+    return p;
+}
+
+// 销毁结点
+template <class T, class Alloc>
+void list<T, Alloc>::destroy_node(base_ptr p) noexcept
+{
+    node_ptr n = static_cast<node_ptr>(p);
+    ctstl::destroy(ctstl::address_of(n->value));
+    node_allocator().deallocate(n, 1);
+}
+
+// 把 [first, last] 这一段节点链接到 pos 之前
+template <class T, class Alloc>
+void list<T, Alloc>::link_nodes(base_ptr pos, base_ptr first, base_ptr last) noexcept
+{
+    pos->prev->next = first;
+    first->prev = pos->prev;
+    pos->prev = last;
+    last->next = pos;
+}
+
+// 把 [first, last] 这一段节点从链表中断开
+template <class T, class Alloc>
+void list<T, Alloc>::unlink_nodes(base_ptr first, base_ptr last) noexcept
+{
+    first->prev->next = last->next;
+    last->next->prev = first->prev;
+}
+
+// 接管 rhs 的全部节点，当前 list 必须为空
+template <class T, class Alloc>
+void list<T, Alloc>::take_nodes(list& rhs) noexcept
+{
+    if (!rhs.empty())
+    {
+        node_ = rhs.node_;
+        node_.next->prev = node_.prev->next = &node_;
+        size_.second() = rhs.size_.second();
+        rhs.node_.unlink();
+        rhs.size_.second() = 0;
+    }
+}
+
+// 用 n 个元素初始化容器，value 为空时值初始化
+template <class T, class Alloc>
+template <class... Value>
+void list<T, Alloc>::fill_init(size_type n, const Value&... value)
+{
+    try
+    {
+        for (; n > 0; --n)
+            emplace_back(value...);
+    }
+    catch (...)
+    {
+        clear();
+        throw;
+    }
+}
+
+// 以 [first, last) 初始化容器
+template <class T, class Alloc>
+template <class IIter>
+void list<T, Alloc>::copy_init(IIter first, IIter last)
+{
+    try
+    {
+        for (; first != last; ++first)
+            emplace_back(*first);
+    }
+    catch (...)
+    {
+        clear();
+        throw;
+    }
+}
+
+// 用 n 个元素为容器赋值
+template <class T, class Alloc>
+void list<T, Alloc>::fill_assign(size_type n, const value_type& value)
+{
+    iterator i = begin();
+    iterator e = end();
+    for (; n > 0 && i != e; --n, ++i)
+        *i = value;
+    if (n > 0)
+        insert(e, n, value);
+    else
+        erase(i, e);
+}
+
+// 复制[f2, l2)为容器赋值
+template <class T, class Alloc>
+template <class IIter>
+void list<T, Alloc>::copy_assign(IIter f2, IIter l2)
+{
+    iterator f1 = begin();
+    iterator l1 = end();
+    for (; f1 != l1 && f2 != l2; ++f1, ++f2)
+        *f1 = *f2;
+    if (f2 == l2)
+        erase(f1, l1);
+    else
+        insert(l1, f2, l2);
+}
+
+// 在 pos 处插入 n 个元素，先在一条独立的链上构造好，再整段链接进来
+template <class T, class Alloc>
+template <class... Value>
+typename list<T, Alloc>::iterator
+list<T, Alloc>::fill_insert(const_iterator pos, size_type n, const Value&... value)
+{
+    list tmp(size_.first());
+    for (; n > 0; --n)
+        tmp.emplace_back(value...);
+    iterator result(pos.node_);
+    if (!tmp.empty())
+    {
+        result = tmp.begin();
+        splice(pos, tmp);
+    }
+    return result;
+}
+
+// 在 pos 处插入 [first, last) 的元素
+template <class T, class Alloc>
+template <class IIter>
+typename list<T, Alloc>::iterator
+list<T, Alloc>::copy_insert(const_iterator pos, IIter first, IIter last)
+{
+    list tmp(size_.first());
+    for (; first != last; ++first)
+        tmp.emplace_back(*first);
+    iterator result(pos.node_);
+    if (!tmp.empty())
+    {
+        result = tmp.begin();
+        splice(pos, tmp);
+    }
+    return result;
+}
+
+// 重置容器大小，value 为空时值初始化新的元素
+template <class T, class Alloc>
+template <class... Value>
+void list<T, Alloc>::resize_impl(size_type new_size, const Value&... value)
+{
+    if (new_size < size())
+    {
+        iterator i;
+        if (new_size <= size() / 2)
+        {
+            i = begin();
+            ctstl::advance(i, new_size);
+        }
+        else
+        {
+            i = end();
+            for (size_type n = size() - new_size; n > 0; --n)
+                --i;
+        }
+        erase(i, end());
+    }
+    else
+    {
+        fill_insert(end(), new_size - size(), value...);
+    }
+}
+
+// 对 [first, last) 的 n 个节点做归并排序，只修改节点的指针，返回排序后的第一个位置
+template <class T, class Alloc>
+template <class Compared>
+typename list<T, Alloc>::iterator
+list<T, Alloc>::list_sort(iterator f1, iterator l2, size_type n, Compared comp)
+{
+    if (n < 2)
+        return f1;
+
+    if (n == 2)
+    {
+        if (comp(*--l2, *f1))
+        {
+            base_ptr ln = l2.node_;
+            unlink_nodes(ln, ln);
+            link_nodes(f1.node_, ln, ln);
+            return l2;
+        }
+        return f1;
+    }
+
+    const size_type n2 = n / 2;
+    iterator l1 = f1;
+    ctstl::advance(l1, n2);
+    iterator result = f1 = list_sort(f1, l1, n2, comp);  // 前半段的最小位置
+    iterator f2 = l1 = list_sort(l1, l2, n - n2, comp);  // 后半段的最小位置
+
+    // 把较小的一段区间移到前面
+    if (comp(*f2, *f1))
+    {
+        iterator m = f2;
+        ++m;
+        for (; m != l2 && comp(*m, *f1); ++m)
+            ;
+        base_ptr f = f2.node_;
+        base_ptr l = m.node_->prev;
+        result = f2;
+        l1 = f2 = m;
+        unlink_nodes(f, l);
+        m = f1;
+        ++m;
+        link_nodes(f1.node_, f, l);
+        f1 = m;
+    }
+    else
+    {
+        ++f1;
+    }
+
+    // 合并两段有序区间
+    while (f1 != l1 && f2 != l2)
+    {
+        if (comp(*f2, *f1))
+        {
+            iterator m = f2;
+            ++m;
+            for (; m != l2 && comp(*m, *f1); ++m)
+                ;
+            base_ptr f = f2.node_;
+            base_ptr l = m.node_->prev;
+            if (l1 == f2)
+                l1 = m;
+            f2 = m;
+            unlink_nodes(f, l);
+            m = f1;
+            ++m;
+            link_nodes(f1.node_, f, l);
+            f1 = m;
+        }
+        else
+        {
+            ++f1;
+        }
+    }
+    return result;
+}
+
+// 重载比较操作符
+template <class T, class Alloc>
+bool operator==(const list<T, Alloc>& lhs, const list<T, Alloc>& rhs)
+{
+    return lhs.size() == rhs.size() &&
+        ctstl::equal(lhs.cbegin(), lhs.cend(), rhs.cbegin(), rhs.cend());
+}
+
+template <class T, class Alloc>
+bool operator<(const list<T, Alloc>& lhs, const list<T, Alloc>& rhs)
+{
+    return ctstl::lexicographical_compare(lhs.cbegin(), lhs.cend(), rhs.cbegin(), rhs.cend());
+}
+
+template <class T, class Alloc>
+bool operator!=(const list<T, Alloc>& lhs, const list<T, Alloc>& rhs)
+{
+    return !(lhs == rhs);
+}
+
+template <class T, class Alloc>
+bool operator>(const list<T, Alloc>& lhs, const list<T, Alloc>& rhs)
+{
+    return rhs < lhs;
+}
+
+template <class T, class Alloc>
+bool operator<=(const list<T, Alloc>& lhs, const list<T, Alloc>& rhs)
+{
+    return !(rhs < lhs);
+}
+
+template <class T, class Alloc>
+bool operator>=(const list<T, Alloc>& lhs, const list<T, Alloc>& rhs)
+{
+    return !(lhs < rhs);
+}
+
+// 重载 ctstl 的 swap
+template <class T, class Alloc>
+void swap(list<T, Alloc>& lhs, list<T, Alloc>& rhs) noexcept
+{
+    lhs.swap(rhs);
+}
+
+} // namespace ctstl
+#endif // !CTSTL_LIST_H_
@@ -2,7 +2,8 @@
 #define CTSTL_MEMORY_H
 
 // 这个头文件负责更高级的动态内存管理
-// 包含一些基本函数、空间配置器、未初始化的储存空间管理，以及一个模板类 auto_ptr
+// 包含一些基本函数、空间配置器、未初始化的储存空间管理，一个模板类 auto_ptr，
+// 以及 unique_ptr、shared_ptr、weak_ptr、atomic_shared_ptr、intrusive_ptr 等智能指针
 
 /*
 <cstddef>：这个头文件定义了一些用于对象大小的类型，如size_t和ptrdiff_t，以及空指针NULL。在动态内存管理中，size_t常用于表示对象的大小或者数组的长度。
@@ -12,8 +13,15 @@
 #include <cstddef>
 #include <cstdlib>
 #include <climits>
+#include <new>
+#include <atomic>
+#include <cstdint>
+#include <exception>
+#include <mutex>
+#include <type_traits>
 
 #include "algobase.h"
+#include "aligned_allocator.h"
 #include "allocator.h"
 #include "construct.h"
 #include "uninitialized.h"
@@ -24,9 +32,133 @@ namespace ctstl
 // 获取对象地址
 template  <class Tp>
 constexpr Tp* address_of(Tp& value) noexcept{
-    return &value
+    return &value;
 }
 
+// --------------------------------------------------------------------------------------
+// 类 : scratch_cache
+// 每个线程一块只增不减的临时缓冲区，get_temporary_buffer 与 temporary_buffer 优先从这里取得空间，
+// 使得连续调用的排序、归并等算法可以反复使用同一块已经载入的内存，而不是每次 malloc / free
+// 同一时刻只能被一个临时缓冲区占用，被占用（比如嵌套调用）或请求超过上限时退回 malloc
+// 每块空间前面有一个小的头部，记录它属于哪个线程的缓存（退回 malloc 的为空），
+// 因此可以在另一个线程上归还：缓存会回到所属线程，而不是被当作 malloc 的空间释放
+// 在其它线程上归还时，所属线程必须仍未退出，它退出时会释放自己的缓存
+class scratch_cache
+{
+private:
+    enum { EDefaultCapacityLimit = 16 * 1024 * 1024 };
+
+    struct state;
+
+    // 头部占用一个 max_align_t 的大小，不改变返回空间的对齐
+    union header
+    {
+        state*           owner;  // 所属的缓存，退回 malloc 时为 nullptr
+        std::max_align_t align;
+    };
+
+    struct state
+    {
+        header*           data;    // 缓存的内存（包括头部）
+        size_t            size;    // 缓存的大小（不包括头部）
+        std::atomic<bool> in_use;  // 是否已被某个临时缓冲区占用，可能由其它线程置为 false
+
+        state() : data(nullptr), size(0), in_use(false) {}
+        ~state() { free(data); }
+    };
+
+public:
+    // 取得至少 bytes 大小的空间，优先使用本线程的缓存，失败时返回 nullptr
+    static void* allocate(size_t bytes)
+    {
+        if (bytes > static_cast<size_t>(-1) - sizeof(header))
+            return nullptr;
+        void* cached = acquire(bytes);
+        if (cached)
+            return cached;
+        header* h = static_cast<header*>(malloc(sizeof(header) + bytes));
+        if (h == nullptr)
+            return nullptr;
+        h->owner = nullptr;
+        return h + 1;
+    }
+
+    // 归还 allocate 取得的空间，可以在任意线程上调用
+    static void deallocate(void* p) noexcept
+    {
+        if (p == nullptr)
+            return;
+        header* h = static_cast<header*>(p) - 1;
+        if (h->owner == nullptr)
+            free(h);
+        else
+            h->owner->in_use.store(false, std::memory_order_release);
+    }
+
+    // 释放本线程的缓存，缓存正被占用时什么都不做
+    static void trim() noexcept
+    {
+        state& st = local_state();
+        if (st.in_use.load(std::memory_order_acquire))
+            return;
+        free(st.data);
+        st.data = nullptr;
+        st.size = 0;
+    }
+
+    // 本线程缓存当前的大小
+    static size_t size() noexcept
+    {
+        return local_state().size;
+    }
+
+    // 所有线程共用的缓存大小上限，超过上限的请求不经过缓存，已有的缓存在 trim 之前保持不变
+    static size_t capacity_limit() noexcept
+    {
+        return limit().load(std::memory_order_relaxed);
+    }
+
+    static void set_capacity_limit(size_t bytes) noexcept
+    {
+        limit().store(bytes, std::memory_order_relaxed);
+    }
+
+private:
+    // 取得本线程的缓存，缓存被占用或 bytes 超过上限时返回 nullptr
+    static void* acquire(size_t bytes)
+    {
+        state& st = local_state();
+        if (st.in_use.load(std::memory_order_acquire) || bytes > capacity_limit())
+            return nullptr;
+        if (bytes > st.size)
+        {   // 缓存不够大，按两倍增长，但不超过上限
+            size_t new_size = st.size * 2 > bytes ? st.size * 2 : bytes;
+            if (new_size > capacity_limit())
+                new_size = bytes;
+            free(st.data);
+            st.data = static_cast<header*>(malloc(sizeof(header) + new_size));
+            st.size = st.data == nullptr ? 0 : new_size;
+            if (st.data == nullptr)
+                return nullptr;
+            st.data->owner = &st;
+        }
+        st.in_use.store(true, std::memory_order_relaxed);
+        return st.data + 1;
+    }
+
+    static state& local_state()
+    {
+        static thread_local state st;
+        return st;
+    }
+
+    static std::atomic<size_t>& limit() noexcept
+    {
+        static std::atomic<size_t> value(EDefaultCapacityLimit);
+        return value;
+    }
+};
+
 // 获取 / 释放 临时缓冲区
 
 template <class T>
@@ -35,8 +167,8 @@ pair<T*, ptrdiff_t> get_buffer_helper(ptrdiff_t len, T*)
     if (len > static_cast<ptrdiff_t>(INT_MAX / sizeof(T)))
         len = INT_MAX / sizeof(T); // 限制最大申请 len 的大小
     while (len > 0)
-    {
-        T* tmp = static_cast<T*>(malloc(static_cast<size_t>(len) * sizeof(T)));
+    {   // 优先使用本线程的缓存
+        T* tmp = static_cast<T*>(scratch_cache::allocate(static_cast<size_t>(len) * sizeof(T)));
         if (tmp)
             return pair<T*, ptrdiff_t>(tmp, len);
         len /= 2; // 申请失败时减少 len 的大小
@@ -56,16 +188,251 @@ pair<T*, ptrdiff_t> get_temporary_buffer(ptrdiff_t len, T*)
     return get_buffer_helper(len, static_cast<T*>(0));
 }
 
+// 可以在另一个线程上释放，见 scratch_cache
 template <class T>
 void release_temporary_buffer(T* ptr)
 {
-    free(ptr);
+    scratch_cache::deallocate(ptr);
+}
+
+// --------------------------------------------------------------------------------------
+// 模板类 : malloc_buffer_allocator
+// 直接使用 malloc / free 的内存来源，申请失败时返回 nullptr 而不是抛出异常
+template <class T>
+struct malloc_buffer_allocator
+{
+    static T* allocate(size_t n)
+    {
+        return static_cast<T*>(malloc(n * sizeof(T)));
+    }
+
+    static void deallocate(T* ptr, size_t /*n*/)
+    {
+        free(ptr);
+    }
+};
+
+// --------------------------------------------------------------------------------------
+// 类 : lazy_mmap_cache
+// 用 mmap 保留一段地址空间，物理页在第一次访问时才由内核提交，因此只用到一部分的大缓冲区不会触碰全部页面
+// 释放时先用 madvise(MADV_DONTNEED) 把物理页还给系统，再把这段地址空间留给本线程下一次使用，省去 mmap / munmap
+// 复用的地址空间可能比请求的大，借出时记下它的实际长度，归还时按实际长度处理，不会漏掉尾部
+// 没有 mmap 的平台上退化为 malloc / free
+class lazy_mmap_cache
+{
+private:
+    // 同时借出的复用地址空间最多记录这么多段，记录满时不再复用
+    enum { ELentSlots = 8 };
+
+    struct region
+    {
+        void*  data;
+        size_t size;  // 映射的实际长度
+    };
+
+    struct state
+    {
+        region cached;              // 保留下来的地址空间，物理页已经归还
+        region lent[ELentSlots];    // 从 cached 借出、尚未归还的地址空间
+
+        state() : cached(), lent() {}
+        ~state() { unmap(cached.data, cached.size); }
+    };
+
+public:
+    // 映射至少 bytes 大小的内存，失败时返回 nullptr
+    static void* map(size_t bytes) noexcept
+    {
+        const size_t size = round_up(bytes);
+        state& st = local_state();
+        if (st.cached.data != nullptr && st.cached.size >= size)
+        {   // 复用保留下来的地址空间，页面会在访问时重新提交（内容为零）
+            region* slot = find_lent(st, nullptr);
+            if (slot != nullptr)
+            {
+                *slot = st.cached;
+                st.cached = region();
+                return slot->data;
+            }
+        }
+#if defined(CTSTL_HAS_MMAP)
+        int flags = MAP_PRIVATE | MAP_ANONYMOUS;
+#if defined(MAP_NORESERVE)
+        flags |= MAP_NORESERVE;
+#endif
+        void* p = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, flags, -1, 0);
+        return p == MAP_FAILED ? nullptr : p;
+#else
+        return malloc(size);
+#endif
+    }
+
+    // 归还 map 得到的内存，bytes 必须与 map 时相同
+    static void unmap_lazy(void* p, size_t bytes) noexcept
+    {
+        if (p == nullptr)
+            return;
+        size_t size = round_up(bytes);
+        state& st = local_state();
+        region* slot = find_lent(st, p);
+        if (slot != nullptr)
+        {   // 借出的是复用的地址空间，按实际长度归还
+            size = slot->size;
+            *slot = region();
+        }
+#if defined(CTSTL_HAS_MMAP) && defined(MADV_DONTNEED)
+        // 每个线程只保留一段，留下较大的那一段
+        if (size > st.cached.size)
+        {
+            ::madvise(p, size, MADV_DONTNEED);
+            unmap(st.cached.data, st.cached.size);
+            st.cached.data = p;
+            st.cached.size = size;
+            return;
+        }
+#endif
+        unmap(p, size);
+    }
+
+    // 解除本线程保留的地址空间
+    static void trim() noexcept
+    {
+        state& st = local_state();
+        unmap(st.cached.data, st.cached.size);
+        st.cached = region();
+    }
+
+    // 64 位平台上不再受 INT_MAX 字节的限制
+    static size_t max_bytes() noexcept
+    {
+#if defined(CTSTL_HAS_MMAP)
+        if (sizeof(void*) >= 8)
+            return static_cast<size_t>(PTRDIFF_MAX);
+#endif
+        return static_cast<size_t>(INT_MAX);
+    }
+
+private:
+    static size_t page_size() noexcept
+    {
+        return mmap_page_size();
+    }
+
+    static size_t round_up(size_t bytes) noexcept
+    {
+        return (bytes + page_size() - 1) & ~(page_size() - 1);
+    }
+
+    static void unmap(void* p, size_t size) noexcept
+    {
+        if (p == nullptr)
+            return;
+#if defined(CTSTL_HAS_MMAP)
+        ::munmap(p, size);
+#else
+        (void)size;
+        free(p);
+#endif
+    }
+
+    static state& local_state()
+    {
+        static thread_local state st;
+        return st;
+    }
+
+    // 查找借出记录中起始地址为 p 的一项，p 为 nullptr 时查找空闲的一项
+    static region* find_lent(state& st, void* p) noexcept
+    {
+        for (size_t i = 0; i < ELentSlots; ++i)
+        {
+            if (st.lent[i].data == p)
+                return &st.lent[i];
+        }
+        return nullptr;
+    }
+};
+
+// --------------------------------------------------------------------------------------
+// 模板类 : lazy_mmap_buffer_allocator
+// 临时缓冲区的大缓冲区模式，内存来自 lazy_mmap_cache，申请失败时返回 nullptr
+template <class T>
+struct lazy_mmap_buffer_allocator
+{
+    static T* allocate(size_t n)
+    {
+        return static_cast<T*>(lazy_mmap_cache::map(n * sizeof(T)));
+    }
+
+    static void deallocate(T* ptr, size_t n)
+    {
+        lazy_mmap_cache::unmap_lazy(ptr, n * sizeof(T));
+    }
+
+    static size_t max_size() noexcept
+    {
+        return lazy_mmap_cache::max_bytes() / sizeof(T);
+    }
+};
+
+// 超过这个大小的临时缓冲区默认使用大缓冲区模式
+enum { ELargeBufferBytes = 64 * 1024 * 1024 };
+
+// --------------------------------------------------------------------------------------
+// 模板类 : scratch_buffer_allocator
+// temporary_buffer 默认的内存来源，优先使用本线程的 scratch_cache，不可用时退回 malloc
+// 不小于 ELargeBufferBytes 的请求使用 lazy_mmap_buffer_allocator
+template <class T>
+struct scratch_buffer_allocator
+{
+    static T* allocate(size_t n)
+    {
+        if (is_large(n))
+            return lazy_mmap_buffer_allocator<T>::allocate(n);
+        return static_cast<T*>(scratch_cache::allocate(n * sizeof(T)));
+    }
+
+    static void deallocate(T* ptr, size_t n)
+    {
+        if (is_large(n))
+            lazy_mmap_buffer_allocator<T>::deallocate(ptr, n);
+        else
+            scratch_cache::deallocate(ptr);
+    }
+
+    static size_t max_size() noexcept
+    {
+        return lazy_mmap_buffer_allocator<T>::max_size();
+    }
+
+private:
+    static bool is_large(size_t n) noexcept
+    {
+        return n * sizeof(T) >= static_cast<size_t>(ELargeBufferBytes);
+    }
+};
+
+// 缓冲区内存来源允许的最大长度：提供了静态 max_size() 的来源使用它，否则限制在 INT_MAX 字节以内
+template <class Alloc, class T>
+auto temporary_buffer_max_len(int) -> decltype(Alloc::max_size(), ptrdiff_t())
+{
+    const size_t n = Alloc::max_size();
+    return n > static_cast<size_t>(PTRDIFF_MAX) ? PTRDIFF_MAX : static_cast<ptrdiff_t>(n);
+}
+
+template <class Alloc, class T>
+ptrdiff_t temporary_buffer_max_len(long)
+{
+    return static_cast<ptrdiff_t>(INT_MAX / sizeof(T));
 }
 
 // --------------------------------------------------------------------------------------
 // 类模板 : temporary_buffer
 // 进行临时缓冲区的申请与释放
-template <class ForwardIterator, class T>
+// 第三个模板参数为缓冲区的内存来源，只需要提供静态的 allocate(n) 与 deallocate(ptr, n)，
+// 因此 allocator、aligned_allocator、huge_page_allocator 等都可以直接使用
+// allocate 返回 nullptr 或抛出 std::bad_alloc 时，缓冲区大小减半后重试
+template <class ForwardIterator, class T, class Alloc = scratch_buffer_allocator<T>>
 class temporary_buffer
 {
 private:
@@ -79,8 +446,9 @@ public:
 
     ~temporary_buffer()
     {
-        ctstl::destroy(buffer, buffer + n);
-        free(buffer);
+        ctstl::destroy(buffer, buffer + len);
+        if (buffer != nullptr)
+            Alloc::deallocate(buffer, static_cast<size_t>(len));
     }
 
 public:
@@ -91,10 +459,11 @@ public:
 
 private:
     void allocate_buffer();
+    T*   try_allocate(ptrdiff_t n);
     void initialize_buffer(const T&, std::true_type) {}
     void initialize_buffer(const T& value, std::false_type)
     {
-        ctstl::uninitialized_fill_n(first, len, value);
+        ctstl::uninitialized_fill_n(buffer, len, value);
     }
 
 private:
@@ -103,9 +472,10 @@ private:
 };
 
 // 构造函数
-template <class ForwardIterator, class T>
-temporary_buffer<ForwardIterator, T>::
+template <class ForwardIterator, class T, class Alloc>
+temporary_buffer<ForwardIterator, T, Alloc>::
 temporary_buffer(ForwardIterator first, ForwardIterator last)
+    : original_len(0), len(0), buffer(nullptr)
 {
     try
     {
@@ -118,7 +488,8 @@ temporary_buffer(ForwardIterator first, ForwardIterator last)
     }
     catch(...)
     {
-        free(buffer);
+        if (buffer != nullptr)
+            Alloc::deallocate(buffer, static_cast<size_t>(len));
         buffer = nullptr;
         len = 0;
     }
@@ -126,21 +497,36 @@ temporary_buffer(ForwardIterator first, ForwardIterator last)
 }
 
 // allocate_buffer 函数
-template <class ForwardIterator, class T>
-void temporary_buffer<ForwardIterator, T>::allocate_buffer()
+template <class ForwardIterator, class T, class Alloc>
+void temporary_buffer<ForwardIterator, T, Alloc>::allocate_buffer()
 {
     original_len = len;
-    if (len > static_cast<ptrdiff_t>(INT_MAX / sizeof(T)))
-        len = INT_MAX / sizeof(T);
+    const ptrdiff_t max_len = temporary_buffer_max_len<Alloc, T>(0);
+    if (len > max_len)
+        len = max_len;
     while (len > 0)
     {
-        buffer = static_cast<T*>(malloc(len * sizeof(T)));
+        buffer = try_allocate(len);
         if (buffer)
             break;
         len /= 2;
     }
 }
 
+// 把 Alloc 抛出的 std::bad_alloc 转换为 nullptr，以便 allocate_buffer 减半重试
+template <class ForwardIterator, class T, class Alloc>
+T* temporary_buffer<ForwardIterator, T, Alloc>::try_allocate(ptrdiff_t n)
+{
+    try
+    {
+        return Alloc::allocate(static_cast<size_t>(n));
+    }
+    catch (const std::bad_alloc&)
+    {
+        return nullptr;
+    }
+}
+
 // --------------------------------------------------------------------------------------
 // 模板类: auto_ptr
 // 一个具有严格对象所有权的小型智能指针
@@ -173,7 +559,7 @@ public:
     template <class U>
     auto_ptr& operator=(auto_ptr<U>& rhs)
     {
-        if (this->get() != RHS.GET())
+        if (this->get() != rhs.get())
         {
             delete m_ptr;
             m_ptr = rhs.release();
@@ -210,5 +596,1246 @@ public:
     }
 };
 
+// --------------------------------------------------------------------------------------
+// 模板类: default_delete
+// unique_ptr 与 shared_ptr 默认的删除器，无状态，因此在 unique_ptr 中不占空间
+template <class T>
+struct default_delete
+{
+    constexpr default_delete() noexcept = default;
+
+    template <class U, typename std::enable_if<
+        std::is_convertible<U*, T*>::value, int>::type = 0>
+    default_delete(const default_delete<U>&) noexcept {}
+
+    void operator()(T* ptr) const
+    {
+        static_assert(sizeof(T) > 0, "can't delete an incomplete type");
+        delete ptr;
+    }
+};
+
+template <class T>
+struct default_delete<T[]>
+{
+    constexpr default_delete() noexcept = default;
+
+    void operator()(T* ptr) const
+    {
+        static_assert(sizeof(T) > 0, "can't delete an incomplete type");
+        delete[] ptr;
+    }
+};
+
+// --------------------------------------------------------------------------------------
+// 模板类: unique_ptr
+// 独占所有权的智能指针，只能移动不能复制
+// 指针与删除器保存在 compressed_pair 中，删除器为空类时 sizeof(unique_ptr) == sizeof(T*)
+template <class T, class Deleter = default_delete<T>>
+class unique_ptr
+{
+public:
+    typedef T*          pointer;
+    typedef T           element_type;
+    typedef Deleter     deleter_type;
+
+private:
+    compressed_pair<Deleter, pointer> data_;
+
+public:
+    // 构造，复制，析构函数
+    constexpr unique_ptr() noexcept : data_() {}
+    constexpr unique_ptr(std::nullptr_t) noexcept : data_() {}
+    explicit unique_ptr(pointer p) noexcept : data_(Deleter(), p) {}
+    unique_ptr(pointer p, const Deleter& d) noexcept : data_(d, p) {}
+    unique_ptr(pointer p, Deleter&& d) noexcept : data_(ctstl::move(d), p) {}
+
+    unique_ptr(unique_ptr&& rhs) noexcept
+        : data_(ctstl::forward<Deleter>(rhs.get_deleter()), rhs.release())
+    {
+    }
+
+    template <class U, class E, typename std::enable_if<
+        std::is_convertible<U*, T*>::value && !std::is_array<U>::value, int>::type = 0>
+    unique_ptr(unique_ptr<U, E>&& rhs) noexcept
+        : data_(ctstl::forward<E>(rhs.get_deleter()), rhs.release())
+    {
+    }
+
+    unique_ptr(const unique_ptr&) = delete;
+    unique_ptr& operator=(const unique_ptr&) = delete;
+
+    unique_ptr& operator=(unique_ptr&& rhs) noexcept
+    {
+        reset(rhs.release());
+        get_deleter() = ctstl::forward<Deleter>(rhs.get_deleter());
+        return *this;
+    }
+
+    template <class U, class E>
+    unique_ptr& operator=(unique_ptr<U, E>&& rhs) noexcept
+    {
+        reset(rhs.release());
+        get_deleter() = ctstl::forward<E>(rhs.get_deleter());
+        return *this;
+    }
+
+    unique_ptr& operator=(std::nullptr_t) noexcept
+    {
+        reset();
+        return *this;
+    }
+
+    ~unique_ptr()
+    {
+        if (data_.second() != nullptr)
+            get_deleter()(data_.second());
+    }
+
+public:
+    T& operator*() const { return *data_.second(); }
+    pointer operator->() const noexcept { return data_.second(); }
+
+    pointer get() const noexcept { return data_.second(); }
+    deleter_type&       get_deleter()       noexcept { return data_.first(); }
+    const deleter_type& get_deleter() const noexcept { return data_.first(); }
+
+    explicit operator bool() const noexcept { return data_.second() != nullptr; }
+
+    // 放弃所有权，返回原来的指针
+    pointer release() noexcept
+    {
+        pointer tmp = data_.second();
+        data_.second() = nullptr;
+        return tmp;
+    }
+
+    // 重置指针，先替换再删除原来的对象，防止删除器中访问到自身
+    void reset(pointer p = pointer()) noexcept
+    {
+        pointer old = data_.second();
+        data_.second() = p;
+        if (old != nullptr)
+            get_deleter()(old);
+    }
+
+    void swap(unique_ptr& rhs) noexcept
+    {
+        ctstl::swap(data_.first(), rhs.data_.first());
+        ctstl::swap(data_.second(), rhs.data_.second());
+    }
+};
+
+// 数组版本
+template <class T, class Deleter>
+class unique_ptr<T[], Deleter>
+{
+public:
+    typedef T*          pointer;
+    typedef T           element_type;
+    typedef Deleter     deleter_type;
+
+private:
+    compressed_pair<Deleter, pointer> data_;
+
+public:
+    constexpr unique_ptr() noexcept : data_() {}
+    constexpr unique_ptr(std::nullptr_t) noexcept : data_() {}
+    explicit unique_ptr(pointer p) noexcept : data_(Deleter(), p) {}
+    unique_ptr(pointer p, const Deleter& d) noexcept : data_(d, p) {}
+    unique_ptr(pointer p, Deleter&& d) noexcept : data_(ctstl::move(d), p) {}
+
+    unique_ptr(unique_ptr&& rhs) noexcept
+        : data_(ctstl::forward<Deleter>(rhs.get_deleter()), rhs.release())
+    {
+    }
+
+    unique_ptr(const unique_ptr&) = delete;
+    unique_ptr& operator=(const unique_ptr&) = delete;
+
+    unique_ptr& operator=(unique_ptr&& rhs) noexcept
+    {
+        reset(rhs.release());
+        get_deleter() = ctstl::forward<Deleter>(rhs.get_deleter());
+        return *this;
+    }
+
+    unique_ptr& operator=(std::nullptr_t) noexcept
+    {
+        reset();
+        return *this;
+    }
+
+    ~unique_ptr()
+    {
+        if (data_.second() != nullptr)
+            get_deleter()(data_.second());
+    }
+
+public:
+    T& operator[](size_t i) const { return data_.second()[i]; }
+
+    pointer get() const noexcept { return data_.second(); }
+    deleter_type&       get_deleter()       noexcept { return data_.first(); }
+    const deleter_type& get_deleter() const noexcept { return data_.first(); }
+
+    explicit operator bool() const noexcept { return data_.second() != nullptr; }
+
+    pointer release() noexcept
+    {
+        pointer tmp = data_.second();
+        data_.second() = nullptr;
+        return tmp;
+    }
+
+    void reset(pointer p = pointer()) noexcept
+    {
+        pointer old = data_.second();
+        data_.second() = p;
+        if (old != nullptr)
+            get_deleter()(old);
+    }
+
+    void swap(unique_ptr& rhs) noexcept
+    {
+        ctstl::swap(data_.first(), rhs.data_.first());
+        ctstl::swap(data_.second(), rhs.data_.second());
+    }
+};
+
+template <class T, class D>
+void swap(unique_ptr<T, D>& lhs, unique_ptr<T, D>& rhs) noexcept
+{
+    lhs.swap(rhs);
+}
+
+// unique_ptr 只保存一个指针和删除器，删除器可以平凡重定位时，在容器中可以按位搬移
+template <class T, class D>
+struct is_trivially_relocatable<unique_ptr<T, D>> : is_trivially_relocatable<D> {};
+
+template <class T1, class D1, class T2, class D2>
+bool operator==(const unique_ptr<T1, D1>& lhs, const unique_ptr<T2, D2>& rhs)
+{
+    return lhs.get() == rhs.get();
+}
+
+template <class T1, class D1, class T2, class D2>
+bool operator!=(const unique_ptr<T1, D1>& lhs, const unique_ptr<T2, D2>& rhs)
+{
+    return lhs.get() != rhs.get();
+}
+
+template <class T, class D>
+bool operator==(const unique_ptr<T, D>& lhs, std::nullptr_t) noexcept
+{
+    return !lhs;
+}
+
+template <class T, class D>
+bool operator!=(const unique_ptr<T, D>& lhs, std::nullptr_t) noexcept
+{
+    return static_cast<bool>(lhs);
+}
+
+// make_unique，只支持非数组类型
+template <class T, class... Args>
+typename std::enable_if<!std::is_array<T>::value, unique_ptr<T>>::type
+make_unique(Args&&... args)
+{
+    return unique_ptr<T>(new T(ctstl::forward<Args>(args)...));
+}
+
+// --------------------------------------------------------------------------------------
+// 类: bad_weak_ptr
+// 从一个已经失效的 weak_ptr 构造 shared_ptr 时抛出
+class bad_weak_ptr : public std::exception
+{
+public:
+    const char* what() const noexcept override { return "bad_weak_ptr"; }
+};
+
+// --------------------------------------------------------------------------------------
+// 类: shared_count_base
+// shared_ptr 的控制块基类，记录强引用与弱引用计数
+// weak_count 中包含一个由所有强引用共同持有的计数，因此 use_count 归零时控制块还不会被释放
+class shared_count_base
+{
+private:
+    std::atomic<long> use_count_;
+    std::atomic<long> weak_count_;
+
+public:
+    shared_count_base() noexcept : use_count_(1), weak_count_(1) {}
+    virtual ~shared_count_base() {}
+
+    // 析构所管理的对象
+    virtual void dispose() noexcept = 0;
+    // 释放控制块本身
+    virtual void destroy() noexcept = 0;
+
+    void add_ref() noexcept
+    {
+        use_count_.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    // weak_ptr::lock 使用，只有对象还存活时才增加计数
+    bool add_ref_lock() noexcept
+    {
+        long count = use_count_.load(std::memory_order_relaxed);
+        while (count != 0)
+        {
+            if (use_count_.compare_exchange_weak(count, count + 1,
+                                                 std::memory_order_acq_rel,
+                                                 std::memory_order_relaxed))
+                return true;
+        }
+        return false;
+    }
+
+    void release() noexcept
+    {
+        if (use_count_.fetch_sub(1, std::memory_order_acq_rel) == 1)
+        {
+            dispose();
+            weak_release();
+        }
+    }
+
+    void weak_add_ref() noexcept
+    {
+        weak_count_.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    void weak_release() noexcept
+    {
+        if (weak_count_.fetch_sub(1, std::memory_order_acq_rel) == 1)
+            destroy();
+    }
+
+    long use_count() const noexcept
+    {
+        return use_count_.load(std::memory_order_relaxed);
+    }
+
+private:
+    shared_count_base(const shared_count_base&);
+    void operator=(const shared_count_base&);
+};
+
+// 控制块：保存指针与删除器，对象与控制块分开分配
+// 控制块本身的内存来自配置器 Alloc 的 rebind 版本
+template <class P, class Deleter, class Alloc>
+class shared_count_ptr : public shared_count_base
+{
+private:
+    typedef typename Alloc::template rebind<shared_count_ptr>::other block_allocator;
+
+    P ptr_;
+    compressed_pair<Deleter, Alloc> data_;  // 删除器与配置器通常都是空类
+
+public:
+    shared_count_ptr(P p, Deleter d, const Alloc& a)
+        : ptr_(p), data_(ctstl::move(d), a)
+    {
+    }
+
+    void dispose() noexcept override
+    {
+        data_.first()(ptr_);
+    }
+
+    void destroy() noexcept override
+    {
+        block_allocator a = ctstl::rebind_allocator<block_allocator>(data_.second());
+        this->~shared_count_ptr();
+        a.deallocate(this, 1);
+    }
+};
+
+// 控制块：对象直接存放在控制块中，make_shared / allocate_shared 只需要一次分配
+template <class T, class Alloc>
+class shared_count_inplace : public shared_count_base
+{
+private:
+    typedef typename Alloc::template rebind<shared_count_inplace>::other block_allocator;
+
+    // 未初始化的存储空间，对象的生命周期由 dispose 结束
+    typename std::aligned_storage<sizeof(T), alignof(T)>::type storage_;
+    compressed_pair<Alloc, char> alloc_;
+
+public:
+    explicit shared_count_inplace(const Alloc& a) : alloc_(a, char()) {}
+
+    T* object() noexcept
+    {
+        return reinterpret_cast<T*>(&storage_);
+    }
+
+    void dispose() noexcept override
+    {
+        ctstl::destroy(object());
+    }
+
+    void destroy() noexcept override
+    {
+        block_allocator a = ctstl::rebind_allocator<block_allocator>(alloc_.first());
+        this->~shared_count_inplace();
+        a.deallocate(this, 1);
+    }
+};
+
+template <class T> class weak_ptr;
+
+// --------------------------------------------------------------------------------------
+// 模板类: shared_ptr
+// 共享所有权的智能指针，最后一个 shared_ptr 析构时删除对象
+// 由两个指针组成：被管理的对象与控制块，引用计数为原子操作，可以在线程间传递
+template <class T>
+class shared_ptr
+{
+    template <class U> friend class shared_ptr;
+    template <class U> friend class weak_ptr;
+    template <class U, class Alloc, class... Args>
+    friend shared_ptr<U> allocate_shared(const Alloc& a, Args&&... args);
+
+public:
+    typedef T element_type;
+
+private:
+    T*                 ptr_;  // 被管理的对象
+    shared_count_base* cnt_;  // 控制块
+
+public:
+    // 构造，复制，析构函数
+    constexpr shared_ptr() noexcept : ptr_(nullptr), cnt_(nullptr) {}
+    constexpr shared_ptr(std::nullptr_t) noexcept : ptr_(nullptr), cnt_(nullptr) {}
+
+    template <class Y>
+    explicit shared_ptr(Y* p)
+        : ptr_(p), cnt_(nullptr)
+    {
+        cnt_ = make_count(p, default_delete<Y>(), ctstl::allocator<Y>());
+    }
+
+    template <class Y, class Deleter>
+    shared_ptr(Y* p, Deleter d)
+        : ptr_(p), cnt_(nullptr)
+    {
+        cnt_ = make_count(p, ctstl::move(d), ctstl::allocator<Y>());
+    }
+
+    // 控制块的内存来自配置器 a
+    template <class Y, class Deleter, class Alloc>
+    shared_ptr(Y* p, Deleter d, const Alloc& a)
+        : ptr_(p), cnt_(nullptr)
+    {
+        cnt_ = make_count(p, ctstl::move(d), a);
+    }
+
+    // 别名构造：与 rhs 共享所有权，但指向 p（通常是 rhs 所管理对象的某个成员）
+    template <class Y>
+    shared_ptr(const shared_ptr<Y>& rhs, T* p) noexcept
+        : ptr_(p), cnt_(rhs.cnt_)
+    {
+        if (cnt_ != nullptr)
+            cnt_->add_ref();
+    }
+
+    shared_ptr(const shared_ptr& rhs) noexcept
+        : ptr_(rhs.ptr_), cnt_(rhs.cnt_)
+    {
+        if (cnt_ != nullptr)
+            cnt_->add_ref();
+    }
+
+    template <class Y, typename std::enable_if<
+        std::is_convertible<Y*, T*>::value, int>::type = 0>
+    shared_ptr(const shared_ptr<Y>& rhs) noexcept
+        : ptr_(rhs.ptr_), cnt_(rhs.cnt_)
+    {
+        if (cnt_ != nullptr)
+            cnt_->add_ref();
+    }
+
+    shared_ptr(shared_ptr&& rhs) noexcept
+        : ptr_(rhs.ptr_), cnt_(rhs.cnt_)
+    {
+        rhs.ptr_ = nullptr;
+        rhs.cnt_ = nullptr;
+    }
+
+    template <class Y, typename std::enable_if<
+        std::is_convertible<Y*, T*>::value, int>::type = 0>
+    shared_ptr(shared_ptr<Y>&& rhs) noexcept
+        : ptr_(rhs.ptr_), cnt_(rhs.cnt_)
+    {
+        rhs.ptr_ = nullptr;
+        rhs.cnt_ = nullptr;
+    }
+
+    // 从 weak_ptr 构造，对象已经被删除时抛出 bad_weak_ptr
+    template <class Y>
+    explicit shared_ptr(const weak_ptr<Y>& rhs)
+        : ptr_(nullptr), cnt_(nullptr)
+    {
+        if (rhs.cnt_ == nullptr || !rhs.cnt_->add_ref_lock())
+            throw bad_weak_ptr();
+        ptr_ = rhs.ptr_;
+        cnt_ = rhs.cnt_;
+    }
+
+    template <class Y, class Deleter>
+    shared_ptr(unique_ptr<Y, Deleter>&& rhs)
+        : ptr_(rhs.get()), cnt_(nullptr)
+    {
+        if (ptr_ != nullptr)
+            cnt_ = make_count(rhs.get(), ctstl::move(rhs.get_deleter()), ctstl::allocator<Y>());
+        rhs.release();
+    }
+
+    ~shared_ptr()
+    {
+        if (cnt_ != nullptr)
+            cnt_->release();
+    }
+
+    shared_ptr& operator=(const shared_ptr& rhs) noexcept
+    {
+        shared_ptr(rhs).swap(*this);
+        return *this;
+    }
+
+    template <class Y>
+    shared_ptr& operator=(const shared_ptr<Y>& rhs) noexcept
+    {
+        shared_ptr(rhs).swap(*this);
+        return *this;
+    }
+
+    shared_ptr& operator=(shared_ptr&& rhs) noexcept
+    {
+        shared_ptr(ctstl::move(rhs)).swap(*this);
+        return *this;
+    }
+
+    template <class Y>
+    shared_ptr& operator=(shared_ptr<Y>&& rhs) noexcept
+    {
+        shared_ptr(ctstl::move(rhs)).swap(*this);
+        return *this;
+    }
+
+    template <class Y, class Deleter>
+    shared_ptr& operator=(unique_ptr<Y, Deleter>&& rhs)
+    {
+        shared_ptr(ctstl::move(rhs)).swap(*this);
+        return *this;
+    }
+
+public:
+    void reset() noexcept
+    {
+        shared_ptr().swap(*this);
+    }
+
+    template <class Y>
+    void reset(Y* p)
+    {
+        shared_ptr(p).swap(*this);
+    }
+
+    template <class Y, class Deleter>
+    void reset(Y* p, Deleter d)
+    {
+        shared_ptr(p, ctstl::move(d)).swap(*this);
+    }
+
+    template <class Y, class Deleter, class Alloc>
+    void reset(Y* p, Deleter d, const Alloc& a)
+    {
+        shared_ptr(p, ctstl::move(d), a).swap(*this);
+    }
+
+    void swap(shared_ptr& rhs) noexcept
+    {
+        ctstl::swap(ptr_, rhs.ptr_);
+        ctstl::swap(cnt_, rhs.cnt_);
+    }
+
+    T* get() const noexcept { return ptr_; }
+    T& operator*() const noexcept { return *ptr_; }
+    T* operator->() const noexcept { return ptr_; }
+
+    long use_count() const noexcept { return cnt_ == nullptr ? 0 : cnt_->use_count(); }
+    bool unique() const noexcept { return use_count() == 1; }
+    explicit operator bool() const noexcept { return ptr_ != nullptr; }
+
+    // 按控制块地址排序，使得指向同一个对象的不同别名被视为等价
+    template <class Y>
+    bool owner_before(const shared_ptr<Y>& rhs) const noexcept { return cnt_ < rhs.cnt_; }
+
+    template <class Y>
+    bool owner_before(const weak_ptr<Y>& rhs) const noexcept { return cnt_ < rhs.cnt_; }
+
+private:
+    // 分配控制块，失败时先用删除器删除 p，再把异常抛出去
+    template <class Y, class Deleter, class Alloc>
+    static shared_count_base* make_count(Y* p, Deleter d, const Alloc& a)
+    {
+        typedef typename Alloc::template rebind<Y>::other           value_allocator;
+        typedef shared_count_ptr<Y*, Deleter, value_allocator>       block_type;
+        typedef typename value_allocator::template rebind<block_type>::other block_allocator;
+        try
+        {
+            block_allocator ba = ctstl::rebind_allocator<block_allocator>(a);
+            block_type* block = ba.allocate(1);
+            ctstl::construct(block, p, d, ctstl::rebind_allocator<value_allocator>(a));
+            return block;
+        }
+        catch (...)
+        {
+            d(p);
+            throw;
+        }
+    }
+};
+
+template <class T>
+void swap(shared_ptr<T>& lhs, shared_ptr<T>& rhs) noexcept
+{
+    lhs.swap(rhs);
+}
+
+template <class T>
+struct is_trivially_relocatable<shared_ptr<T>> : std::true_type {};
+
+template <class T, class U>
+bool operator==(const shared_ptr<T>& lhs, const shared_ptr<U>& rhs) noexcept
+{
+    return lhs.get() == rhs.get();
+}
+
+template <class T, class U>
+bool operator!=(const shared_ptr<T>& lhs, const shared_ptr<U>& rhs) noexcept
+{
+    return lhs.get() != rhs.get();
+}
+
+template <class T, class U>
+bool operator<(const shared_ptr<T>& lhs, const shared_ptr<U>& rhs) noexcept
+{
+    return lhs.get() < rhs.get();
+}
+
+template <class T>
+bool operator==(const shared_ptr<T>& lhs, std::nullptr_t) noexcept
+{
+    return !lhs;
+}
+
+template <class T>
+bool operator!=(const shared_ptr<T>& lhs, std::nullptr_t) noexcept
+{
+    return static_cast<bool>(lhs);
+}
+
+// allocate_shared：控制块与对象在同一次分配中取得，内存来自配置器 a
+template <class T, class Alloc, class... Args>
+shared_ptr<T> allocate_shared(const Alloc& a, Args&&... args)
+{
+    typedef typename Alloc::template rebind<T>::other                  value_allocator;
+    typedef shared_count_inplace<T, value_allocator>                   block_type;
+    typedef typename value_allocator::template rebind<block_type>::other block_allocator;
+
+    block_allocator ba = ctstl::rebind_allocator<block_allocator>(a);
+    block_type* block = ba.allocate(1);
+    try
+    {
+        ctstl::construct(block, ctstl::rebind_allocator<value_allocator>(a));
+        ctstl::construct(block->object(), ctstl::forward<Args>(args)...);
+    }
+    catch (...)
+    {
+        ba.deallocate(block, 1);
+        throw;
+    }
+    shared_ptr<T> result;
+    result.ptr_ = block->object();
+    result.cnt_ = block;
+    return result;
+}
+
+// make_shared：使用默认的 allocator 的 allocate_shared
+template <class T, class... Args>
+shared_ptr<T> make_shared(Args&&... args)
+{
+    return ctstl::allocate_shared<T>(ctstl::allocator<T>(), ctstl::forward<Args>(args)...);
+}
+
+// --------------------------------------------------------------------------------------
+// 模板类: weak_ptr
+// 不拥有对象的观察者，只增加弱引用计数；通过 lock 得到一个 shared_ptr
+template <class T>
+class weak_ptr
+{
+    template <class U> friend class shared_ptr;
+    template <class U> friend class weak_ptr;
+
+public:
+    typedef T element_type;
+
+private:
+    T*                 ptr_;
+    shared_count_base* cnt_;
+
+public:
+    constexpr weak_ptr() noexcept : ptr_(nullptr), cnt_(nullptr) {}
+
+    weak_ptr(const weak_ptr& rhs) noexcept
+        : ptr_(rhs.ptr_), cnt_(rhs.cnt_)
+    {
+        if (cnt_ != nullptr)
+            cnt_->weak_add_ref();
+    }
+
+    template <class Y, typename std::enable_if<
+        std::is_convertible<Y*, T*>::value, int>::type = 0>
+    weak_ptr(const weak_ptr<Y>& rhs) noexcept
+        : ptr_(rhs.ptr_), cnt_(rhs.cnt_)
+    {
+        if (cnt_ != nullptr)
+            cnt_->weak_add_ref();
+    }
+
+    template <class Y, typename std::enable_if<
+        std::is_convertible<Y*, T*>::value, int>::type = 0>
+    weak_ptr(const shared_ptr<Y>& rhs) noexcept
+        : ptr_(rhs.ptr_), cnt_(rhs.cnt_)
+    {
+        if (cnt_ != nullptr)
+            cnt_->weak_add_ref();
+    }
+
+    weak_ptr(weak_ptr&& rhs) noexcept
+        : ptr_(rhs.ptr_), cnt_(rhs.cnt_)
+    {
+        rhs.ptr_ = nullptr;
+        rhs.cnt_ = nullptr;
+    }
+
+    ~weak_ptr()
+    {
+        if (cnt_ != nullptr)
+            cnt_->weak_release();
+    }
+
+    weak_ptr& operator=(const weak_ptr& rhs) noexcept
+    {
+        weak_ptr(rhs).swap(*this);
+        return *this;
+    }
+
+    template <class Y>
+    weak_ptr& operator=(const shared_ptr<Y>& rhs) noexcept
+    {
+        weak_ptr(rhs).swap(*this);
+        return *this;
+    }
+
+    weak_ptr& operator=(weak_ptr&& rhs) noexcept
+    {
+        weak_ptr(ctstl::move(rhs)).swap(*this);
+        return *this;
+    }
+
+public:
+    void reset() noexcept
+    {
+        weak_ptr().swap(*this);
+    }
+
+    void swap(weak_ptr& rhs) noexcept
+    {
+        ctstl::swap(ptr_, rhs.ptr_);
+        ctstl::swap(cnt_, rhs.cnt_);
+    }
+
+    long use_count() const noexcept { return cnt_ == nullptr ? 0 : cnt_->use_count(); }
+    bool expired() const noexcept { return use_count() == 0; }
+
+    // 对象还存活时返回共享它的 shared_ptr，否则返回空的 shared_ptr
+    shared_ptr<T> lock() const noexcept
+    {
+        shared_ptr<T> result;
+        if (cnt_ != nullptr && cnt_->add_ref_lock())
+        {
+            result.ptr_ = ptr_;
+            result.cnt_ = cnt_;
+        }
+        return result;
+    }
+
+    template <class Y>
+    bool owner_before(const shared_ptr<Y>& rhs) const noexcept { return cnt_ < rhs.cnt_; }
+
+    template <class Y>
+    bool owner_before(const weak_ptr<Y>& rhs) const noexcept { return cnt_ < rhs.cnt_; }
+};
+
+template <class T>
+void swap(weak_ptr<T>& lhs, weak_ptr<T>& rhs) noexcept
+{
+    lhs.swap(rhs);
+}
+
+template <class T>
+struct is_trivially_relocatable<weak_ptr<T>> : std::true_type {};
+
+// --------------------------------------------------------------------------------------
+// 危险指针（hazard pointer）的全局登记表，供 atomic_shared_ptr 延迟回收旧的快照节点
+// 每个线程占用一个独占 cache line 的槽位，读者只写自己的槽位，写者遍历所有槽位
+
+struct hazard_slot
+{
+    std::atomic<const void*> ptr;     // 当前线程正在访问的节点
+    std::atomic<bool>        in_use;  // 所属线程退出后为 false，可以被新线程复用
+    hazard_slot*             next;    // 槽位只增不减，串成单链表，只在持有登记锁时修改
+    char                     pad[64]; // 使得不同线程的槽位不会落在同一条 cache line 上
+
+    hazard_slot() : ptr(nullptr), in_use(true), next(nullptr) {}
+};
+
+class hazard_registry
+{
+private:
+    std::atomic<hazard_slot*> head_;
+    std::mutex                mutex_;  // 只在登记 / 复用槽位时使用
+
+public:
+    hazard_registry() : head_(nullptr) {}
+
+    static hazard_registry& instance()
+    {
+        static hazard_registry r;
+        return r;
+    }
+
+    // 为当前线程取得一个槽位：优先复用已经退出的线程留下的槽位
+    hazard_slot* acquire_slot()
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (hazard_slot* s = head_.load(std::memory_order_relaxed); s; s = s->next)
+        {
+            if (!s->in_use.load(std::memory_order_relaxed))
+            {
+                s->in_use.store(true, std::memory_order_relaxed);
+                return s;
+            }
+        }
+        hazard_slot* s = new hazard_slot();
+        s->next = head_.load(std::memory_order_relaxed);
+        head_.store(s, std::memory_order_release);
+        return s;
+    }
+
+    // 是否有线程正在访问 p
+    bool is_protected(const void* p) const noexcept
+    {
+        for (hazard_slot* s = head_.load(std::memory_order_acquire); s; s = s->next)
+        {
+            if (s->ptr.load(std::memory_order_seq_cst) == p)
+                return true;
+        }
+        return false;
+    }
+
+    // 当前线程的槽位
+    static hazard_slot* local_slot()
+    {
+        static thread_local slot_holder holder(instance().acquire_slot());
+        return holder.slot;
+    }
+
+private:
+    // 线程退出时归还槽位
+    struct slot_holder
+    {
+        hazard_slot* slot;
+        explicit slot_holder(hazard_slot* s) : slot(s) {}
+        ~slot_holder()
+        {
+            slot->ptr.store(nullptr, std::memory_order_relaxed);
+            slot->in_use.store(false, std::memory_order_release);
+        }
+    };
+
+    hazard_registry(const hazard_registry&);
+    void operator=(const hazard_registry&);
+};
+
+// 每个 atomic_shared_ptr 对象的编号，从不重复使用，避免对象地址复用时线程缓存命中错误的对象
+inline uint64_t atomic_shared_ptr_next_id() noexcept
+{
+    static std::atomic<uint64_t> id(0);
+    return id.fetch_add(1, std::memory_order_relaxed) + 1;
+}
+
+// --------------------------------------------------------------------------------------
+// 模板类: atomic_shared_ptr
+// 可以被多个线程同时读写的 shared_ptr，适合发布读多写少的快照（比如配置、路由表）
+// 写者把新值放入一个带版本号的节点并替换 current_，旧节点在没有读者的危险指针指向它时才释放；
+// 每个线程为每个对象缓存一份最近读到的版本，以及一个只属于本线程的控制块（它持有全局的那份 shared_ptr）。
+// 版本号没有变化时，load 只读取 version_ 并增加本线程控制块的计数，既不加锁，也不会让多个读者争用同一条 cache line；
+// 版本号变化后的第一次 load 通过危险指针取得新值，同样不加锁。
+// 注意：线程缓存会让旧的快照一直存活到该线程下一次 load 同一个对象或者线程退出，可以调用 release_local_cache 提前释放
+template <class T>
+class atomic_shared_ptr
+{
+private:
+    // 一个已发布的值
+    struct node
+    {
+        shared_ptr<T> value;
+        uint64_t      version;
+        node*         next_retired;  // 等待回收的节点串成链表，只在持有写者锁时访问
+    };
+
+    // 线程缓存中的一项，按对象编号直接映射
+    struct cache_entry
+    {
+        uint64_t      owner;    // 对象编号，0 表示空
+        uint64_t      version;
+        shared_ptr<T> local;    // 控制块只属于本线程
+    };
+
+    enum { ECacheEntries = 8 };
+
+    struct local_cache
+    {
+        cache_entry entries[ECacheEntries];
+        local_cache() : entries() {}
+    };
+
+    // 本线程控制块的删除器：持有全局的那份 shared_ptr，本线程不再引用这个版本时释放它
+    struct snapshot_holder
+    {
+        shared_ptr<T> owner;
+        void operator()(T*) noexcept { owner.reset(); }
+    };
+
+    const uint64_t        id_;
+    std::atomic<node*>    current_;
+    std::atomic<uint64_t> version_;  // 等于 current_ 的版本号，读者的快速路径只读取它
+    std::mutex            write_mutex_;
+    node*                 retired_;  // 已经被替换、但可能仍有读者在访问的节点
+
+public:
+    atomic_shared_ptr()
+        : id_(atomic_shared_ptr_next_id()), current_(nullptr), version_(0), retired_(nullptr)
+    {
+        current_.store(new node{shared_ptr<T>(), 0, nullptr}, std::memory_order_relaxed);
+    }
+
+    explicit atomic_shared_ptr(shared_ptr<T> value)
+        : id_(atomic_shared_ptr_next_id()), current_(nullptr), version_(0), retired_(nullptr)
+    {
+        current_.store(new node{ctstl::move(value), 0, nullptr}, std::memory_order_relaxed);
+    }
+
+    // 析构时不能有其它线程同时访问这个对象
+    ~atomic_shared_ptr()
+    {
+        delete current_.load(std::memory_order_relaxed);
+        while (retired_ != nullptr)
+        {
+            node* next = retired_->next_retired;
+            delete retired_;
+            retired_ = next;
+        }
+    }
+
+    atomic_shared_ptr(const atomic_shared_ptr&) = delete;
+    atomic_shared_ptr& operator=(const atomic_shared_ptr&) = delete;
+
+public:
+    // 只有 load 不加锁，store / exchange / compare_exchange_strong 要持有写者锁，所以整体不是无锁的
+    bool is_lock_free() const noexcept { return false; }
+
+    shared_ptr<T> load() const
+    {
+        cache_entry& e = thread_cache().entries[id_ % ECacheEntries];
+        const uint64_t version = version_.load(std::memory_order_acquire);
+        if (e.owner == id_ && e.version == version)
+            return e.local;
+        M_refresh(e);
+        return e.local;
+    }
+
+    operator shared_ptr<T>() const { return load(); }
+
+    void store(shared_ptr<T> value)
+    {
+        exchange(ctstl::move(value));
+    }
+
+    atomic_shared_ptr& operator=(shared_ptr<T> value)
+    {
+        exchange(ctstl::move(value));
+        return *this;
+    }
+
+    // 写者之间互斥，返回原来的值
+    shared_ptr<T> exchange(shared_ptr<T> value)
+    {
+        std::lock_guard<std::mutex> lock(write_mutex_);
+        return M_publish(ctstl::move(value));
+    }
+
+    // 当前值与 expected 指向同一个对象时替换为 desired，否则把当前值写入 expected
+    // load 得到的 shared_ptr 使用本线程的控制块，因此这里只比较指针，不比较控制块
+    bool compare_exchange_strong(shared_ptr<T>& expected, shared_ptr<T> desired)
+    {
+        std::lock_guard<std::mutex> lock(write_mutex_);
+        const shared_ptr<T>& cur = current_.load(std::memory_order_relaxed)->value;
+        if (cur.get() != expected.get())
+        {
+            expected = cur;
+            return false;
+        }
+        M_publish(ctstl::move(desired));
+        return true;
+    }
+
+    // 释放本线程为这个对象缓存的快照
+    void release_local_cache() const
+    {
+        cache_entry& e = thread_cache().entries[id_ % ECacheEntries];
+        if (e.owner == id_)
+        {
+            e.owner = 0;
+            e.local.reset();
+        }
+    }
+
+private:
+    static local_cache& thread_cache()
+    {
+        static thread_local local_cache cache;
+        return cache;
+    }
+
+    // 版本号变化后的慢路径：在危险指针的保护下复制全局的值，再为本线程建立一个新的控制块
+    void M_refresh(cache_entry& e) const
+    {
+        hazard_slot* slot = hazard_registry::local_slot();
+        node* n = current_.load(std::memory_order_seq_cst);
+        for (;;)
+        {
+            slot->ptr.store(n, std::memory_order_seq_cst);
+            node* again = current_.load(std::memory_order_seq_cst);
+            if (again == n)
+                break;
+            n = again;
+        }
+        shared_ptr<T> global = n->value;
+        const uint64_t version = n->version;
+        slot->ptr.store(nullptr, std::memory_order_release);
+
+        T* p = global.get();
+        shared_ptr<T> local;
+        if (global)
+            local = shared_ptr<T>(p, snapshot_holder{ctstl::move(global)});
+        e.local = ctstl::move(local);
+        e.version = version;
+        e.owner = id_;
+    }
+
+    // 发布新的值并回收旧节点，返回原来的值，调用者必须持有写者锁
+    shared_ptr<T> M_publish(shared_ptr<T> value)
+    {
+        node* old = current_.load(std::memory_order_relaxed);
+        node* n = new node{ctstl::move(value), old->version + 1, nullptr};
+        current_.store(n, std::memory_order_seq_cst);
+        version_.store(n->version, std::memory_order_release);
+        shared_ptr<T> result = old->value;
+        old->next_retired = retired_;
+        retired_ = old;
+        M_reclaim();
+        return result;
+    }
+
+    // 释放没有读者访问的旧节点，调用者必须持有写者锁
+    void M_reclaim()
+    {
+        hazard_registry& registry = hazard_registry::instance();
+        node** link = &retired_;
+        while (*link != nullptr)
+        {
+            node* n = *link;
+            if (registry.is_protected(n))
+            {
+                link = &n->next_retired;
+            }
+            else
+            {
+                *link = n->next_retired;
+                delete n;
+            }
+        }
+    }
+};
+
+// --------------------------------------------------------------------------------------
+// 模板类: intrusive_ptr
+// 引用计数保存在对象自身中的智能指针，大小与普通指针相同，不需要额外的控制块
+// 通过实参依赖查找调用 intrusive_ptr_add_ref(T*) 与 intrusive_ptr_release(T*)，
+// 对象可以自己提供这两个函数，也可以继承 intrusive_ref_counter
+template <class T>
+class intrusive_ptr
+{
+public:
+    typedef T element_type;
+
+private:
+    T* ptr_;
+
+public:
+    constexpr intrusive_ptr() noexcept : ptr_(nullptr) {}
+
+    // add_ref 为 false 时接管一个已经计过数的指针
+    intrusive_ptr(T* p, bool add_ref = true)
+        : ptr_(p)
+    {
+        if (ptr_ != nullptr && add_ref)
+            intrusive_ptr_add_ref(ptr_);
+    }
+
+    intrusive_ptr(const intrusive_ptr& rhs)
+        : ptr_(rhs.ptr_)
+    {
+        if (ptr_ != nullptr)
+            intrusive_ptr_add_ref(ptr_);
+    }
+
+    template <class U, typename std::enable_if<
+        std::is_convertible<U*, T*>::value, int>::type = 0>
+    intrusive_ptr(const intrusive_ptr<U>& rhs)
+        : ptr_(rhs.get())
+    {
+        if (ptr_ != nullptr)
+            intrusive_ptr_add_ref(ptr_);
+    }
+
+    intrusive_ptr(intrusive_ptr&& rhs) noexcept
+        : ptr_(rhs.ptr_)
+    {
+        rhs.ptr_ = nullptr;
+    }
+
+    ~intrusive_ptr()
+    {
+        if (ptr_ != nullptr)
+            intrusive_ptr_release(ptr_);
+    }
+
+    intrusive_ptr& operator=(const intrusive_ptr& rhs)
+    {
+        intrusive_ptr(rhs).swap(*this);
+        return *this;
+    }
+
+    intrusive_ptr& operator=(intrusive_ptr&& rhs) noexcept
+    {
+        intrusive_ptr(ctstl::move(rhs)).swap(*this);
+        return *this;
+    }
+
+    intrusive_ptr& operator=(T* p)
+    {
+        intrusive_ptr(p).swap(*this);
+        return *this;
+    }
+
+public:
+    void reset() noexcept
+    {
+        intrusive_ptr().swap(*this);
+    }
+
+    void reset(T* p, bool add_ref = true)
+    {
+        intrusive_ptr(p, add_ref).swap(*this);
+    }
+
+    // 放弃所有权但不减少计数，返回原来的指针
+    T* detach() noexcept
+    {
+        T* tmp = ptr_;
+        ptr_ = nullptr;
+        return tmp;
+    }
+
+    void swap(intrusive_ptr& rhs) noexcept
+    {
+        ctstl::swap(ptr_, rhs.ptr_);
+    }
+
+    T* get() const noexcept { return ptr_; }
+    T& operator*() const noexcept { return *ptr_; }
+    T* operator->() const noexcept { return ptr_; }
+    explicit operator bool() const noexcept { return ptr_ != nullptr; }
+};
+
+template <class T>
+void swap(intrusive_ptr<T>& lhs, intrusive_ptr<T>& rhs) noexcept
+{
+    lhs.swap(rhs);
+}
+
+template <class T>
+struct is_trivially_relocatable<intrusive_ptr<T>> : std::true_type {};
+
+template <class T, class U>
+bool operator==(const intrusive_ptr<T>& lhs, const intrusive_ptr<U>& rhs) noexcept
+{
+    return lhs.get() == rhs.get();
+}
+
+template <class T, class U>
+bool operator!=(const intrusive_ptr<T>& lhs, const intrusive_ptr<U>& rhs) noexcept
+{
+    return lhs.get() != rhs.get();
+}
+
+// 模板类: intrusive_ref_counter
+// 为派生类提供原子的引用计数，计数归零时 delete 派生类对象
+template <class Derived>
+class intrusive_ref_counter
+{
+private:
+    mutable std::atomic<long> ref_count_;
+
+protected:
+    intrusive_ref_counter() noexcept : ref_count_(0) {}
+    intrusive_ref_counter(const intrusive_ref_counter&) noexcept : ref_count_(0) {}
+    intrusive_ref_counter& operator=(const intrusive_ref_counter&) noexcept { return *this; }
+    ~intrusive_ref_counter() {}
+
+public:
+    long use_count() const noexcept { return ref_count_.load(std::memory_order_relaxed); }
+
+    friend void intrusive_ptr_add_ref(const Derived* p) noexcept
+    {
+        static_cast<const intrusive_ref_counter*>(p)->ref_count_.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    friend void intrusive_ptr_release(const Derived* p) noexcept
+    {
+        if (static_cast<const intrusive_ref_counter*>(p)->ref_count_.fetch_sub(
+                1, std::memory_order_acq_rel) == 1)
+            delete p;
+    }
+};
+
 } // namespace ctstl
 #endif
\ No newline at end of file
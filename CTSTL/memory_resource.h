@@ -0,0 +1,683 @@
+#ifndef CTSTL_MEMORY_RESOURCE_H_
+#define CTSTL_MEMORY_RESOURCE_H_
+
+// 这个头文件包含多态内存资源 memory_resource 的继承体系，以及模板类 polymorphic_allocator
+// memory_resource            : 抽象基类，定义 allocate / deallocate / is_equal 接口
+// monotonic_buffer_resource  : 只增不减的单调缓冲区，deallocate 什么都不做，release 时一次性归还全部内存
+// unsynchronized_pool_resource : 按 2 的幂划分区块大小的内存池，不加锁
+// synchronized_pool_resource   : 加锁的 unsynchronized_pool_resource，可被多个线程共用
+// polymorphic_allocator      : 接口与 allocator 相同，但把内存请求转交给一个 memory_resource
+
+#include <new>
+#include <cstddef>
+#include <atomic>
+#include <mutex>
+
+#include "construct.h"
+#include "util.h"
+
+namespace ctstl
+{
+
+// 默认的对齐大小
+#define CTSTL_MAX_ALIGN alignof(std::max_align_t)
+
+// 把 n 上调到 align 的倍数，align 必须为 2 的幂
+inline size_t align_up(size_t n, size_t align) noexcept
+{
+    return (n + align - 1) & ~(align - 1);
+}
+
+// --------------------------------------------------------------------------------------
+// 抽象类：memory_resource
+// 所有的内存资源都从这里派生，派生类只需要实现三个私有虚函数
+class memory_resource
+{
+public:
+    virtual ~memory_resource() {}
+
+    void* allocate(size_t bytes, size_t alignment = CTSTL_MAX_ALIGN)
+    {
+        return do_allocate(bytes, alignment);
+    }
+
+    void deallocate(void* p, size_t bytes, size_t alignment = CTSTL_MAX_ALIGN)
+    {
+        do_deallocate(p, bytes, alignment);
+    }
+
+    // 从一个资源分配的内存能否交给另一个资源释放
+    bool is_equal(const memory_resource& other) const noexcept
+    {
+        return do_is_equal(other);
+    }
+
+private:
+    virtual void* do_allocate(size_t bytes, size_t alignment) = 0;
+    virtual void  do_deallocate(void* p, size_t bytes, size_t alignment) = 0;
+    virtual bool  do_is_equal(const memory_resource& other) const noexcept = 0;
+};
+
+inline bool operator==(const memory_resource& lhs, const memory_resource& rhs) noexcept
+{
+    return &lhs == &rhs || lhs.is_equal(rhs);
+}
+
+inline bool operator!=(const memory_resource& lhs, const memory_resource& rhs) noexcept
+{
+    return !(lhs == rhs);
+}
+
+// new_delete_resource 使用的实现，超过默认对齐的请求多申请一部分空间，手动对齐
+class new_delete_memory_resource : public memory_resource
+{
+private:
+    void* do_allocate(size_t bytes, size_t alignment) override
+    {
+        if (alignment <= CTSTL_MAX_ALIGN)
+            return ::operator new(bytes);
+        // 在对齐后的地址前面记录原始地址
+        char* raw = static_cast<char*>(::operator new(bytes + alignment + sizeof(void*)));
+        char* aligned = reinterpret_cast<char*>(
+            align_up(reinterpret_cast<size_t>(raw + sizeof(void*)), alignment));
+        reinterpret_cast<void**>(aligned)[-1] = raw;
+        return aligned;
+    }
+
+    void do_deallocate(void* p, size_t, size_t alignment) override
+    {
+        if (alignment <= CTSTL_MAX_ALIGN)
+            ::operator delete(p);
+        else
+            ::operator delete(static_cast<void**>(p)[-1]);
+    }
+
+    bool do_is_equal(const memory_resource& other) const noexcept override
+    {
+        return this == &other;
+    }
+};
+
+// null_memory_resource 使用的实现，任何分配请求都抛出 std::bad_alloc
+class null_memory_resource_impl : public memory_resource
+{
+private:
+    void* do_allocate(size_t, size_t) override
+    {
+        throw std::bad_alloc();
+    }
+
+    void do_deallocate(void*, size_t, size_t) override {}
+
+    bool do_is_equal(const memory_resource& other) const noexcept override
+    {
+        return this == &other;
+    }
+};
+
+// 使用 ::operator new / ::operator delete 的全局资源
+inline memory_resource* new_delete_resource() noexcept
+{
+    static new_delete_memory_resource instance;
+    return &instance;
+}
+
+// 不允许分配的全局资源，可以作为 monotonic_buffer_resource 的上游，保证只使用调用者给出的缓冲区
+inline memory_resource* null_memory_resource() noexcept
+{
+    static null_memory_resource_impl instance;
+    return &instance;
+}
+
+inline std::atomic<memory_resource*>& default_resource_holder() noexcept
+{
+    static std::atomic<memory_resource*> holder(new_delete_resource());
+    return holder;
+}
+
+// 设置默认资源，传入 nullptr 时恢复为 new_delete_resource，返回原来的默认资源
+inline memory_resource* set_default_resource(memory_resource* r) noexcept
+{
+    if (r == nullptr)
+        r = new_delete_resource();
+    return default_resource_holder().exchange(r);
+}
+
+inline memory_resource* get_default_resource() noexcept
+{
+    return default_resource_holder().load();
+}
+
+// --------------------------------------------------------------------------------------
+// 类：monotonic_buffer_resource
+// 从当前缓冲区中依次切出内存，释放单个对象时什么都不做
+// 当前缓冲区用完后向上游申请一块更大的新缓冲区（每次增长一倍），调用 release 时一次性全部归还
+// 可以从调用者给出的缓冲区（比如一块栈上的数组）开始，用完后才向上游申请堆内存
+class monotonic_buffer_resource : public memory_resource
+{
+private:
+    // 从上游申请的每一块缓冲区的头部，串成单链表以便 release
+    struct chunk_header
+    {
+        chunk_header* next;
+        size_t        size;       // 包含头部在内的大小
+        size_t        alignment;  // 向上游申请时使用的对齐
+    };
+
+    enum { EDefaultChunkSize = 1024 };
+
+    memory_resource* upstream_;        // 上游资源
+    void*            initial_buffer_;  // 调用者给出的初始缓冲区
+    size_t           initial_size_;    // 初始缓冲区大小
+    char*            current_;         // 当前缓冲区中下一次分配的位置
+    size_t           space_;           // 当前缓冲区剩余的大小
+    size_t           next_size_;       // 下一次向上游申请的大小
+    chunk_header*    chunks_;          // 向上游申请的缓冲区链表
+
+public:
+    explicit monotonic_buffer_resource(memory_resource* upstream = get_default_resource())
+        : upstream_(upstream), initial_buffer_(nullptr), initial_size_(0),
+          current_(nullptr), space_(0), next_size_(EDefaultChunkSize), chunks_(nullptr)
+    {
+    }
+
+    monotonic_buffer_resource(size_t initial_size,
+                              memory_resource* upstream = get_default_resource())
+        : upstream_(upstream), initial_buffer_(nullptr), initial_size_(0),
+          current_(nullptr), space_(0),
+          next_size_(initial_size > sizeof(chunk_header) ? initial_size : static_cast<size_t>(EDefaultChunkSize)),
+          chunks_(nullptr)
+    {
+    }
+
+    monotonic_buffer_resource(void* buffer, size_t buffer_size,
+                              memory_resource* upstream = get_default_resource())
+        : upstream_(upstream), initial_buffer_(buffer), initial_size_(buffer_size),
+          current_(static_cast<char*>(buffer)), space_(buffer_size),
+          next_size_(buffer_size > EDefaultChunkSize / 2 ? buffer_size * 2 : static_cast<size_t>(EDefaultChunkSize)),
+          chunks_(nullptr)
+    {
+    }
+
+    ~monotonic_buffer_resource()
+    {
+        release();
+    }
+
+    // 把所有从上游申请的缓冲区归还给上游，并回到初始缓冲区的起点
+    // 之前从这个资源分配的所有对象都将失效，调用者需要保证它们已经不再使用
+    void release()
+    {
+        while (chunks_ != nullptr)
+        {
+            chunk_header* next = chunks_->next;
+            upstream_->deallocate(chunks_, chunks_->size, chunks_->alignment);
+            chunks_ = next;
+        }
+        current_ = static_cast<char*>(initial_buffer_);
+        space_ = initial_size_;
+    }
+
+    memory_resource* upstream_resource() const noexcept { return upstream_; }
+
+private:
+    monotonic_buffer_resource(const monotonic_buffer_resource&);
+    void operator=(const monotonic_buffer_resource&);
+
+    void* do_allocate(size_t bytes, size_t alignment) override
+    {
+        if (bytes == 0)
+            bytes = 1;
+        void* result = try_allocate(bytes, alignment);
+        if (result == nullptr)
+        {
+            new_chunk(bytes, alignment);
+            result = try_allocate(bytes, alignment);
+        }
+        return result;
+    }
+
+    void do_deallocate(void*, size_t, size_t) override {}
+
+    bool do_is_equal(const memory_resource& other) const noexcept override
+    {
+        return this == &other;
+    }
+
+    // 尝试在当前缓冲区中切出一块，空间不足时返回 nullptr
+    void* try_allocate(size_t bytes, size_t alignment) noexcept
+    {
+        if (current_ == nullptr)
+            return nullptr;
+        const size_t addr = reinterpret_cast<size_t>(current_);
+        const size_t padding = align_up(addr, alignment) - addr;
+        if (padding > space_ || bytes > space_ - padding)
+            return nullptr;
+        char* result = current_ + padding;
+        current_ = result + bytes;
+        space_ -= padding + bytes;
+        return result;
+    }
+
+    // 向上游申请一块足够容纳 bytes 的新缓冲区
+    void new_chunk(size_t bytes, size_t alignment)
+    {
+        const size_t chunk_align = alignment > alignof(chunk_header) ? alignment : alignof(chunk_header);
+        const size_t header_size = align_up(sizeof(chunk_header), chunk_align);
+        // 请求过大时直接失败，翻倍溢出时改为恰好够用的大小，不会回绕成很小的值或者死循环
+        const size_t max_size = static_cast<size_t>(-1);
+        if (bytes > max_size - header_size)
+            throw std::bad_alloc();
+        const size_t need = header_size + bytes;
+        size_t size = next_size_;
+        while (size < need)
+            size = size > max_size / 2 ? need : size * 2;
+        chunk_header* chunk = static_cast<chunk_header*>(upstream_->allocate(size, chunk_align));
+        chunk->next = chunks_;
+        chunk->size = size;
+        chunk->alignment = chunk_align;
+        chunks_ = chunk;
+        current_ = reinterpret_cast<char*>(chunk) + header_size;
+        space_ = size - header_size;
+        next_size_ = size > max_size / 2 ? size : size * 2;
+    }
+};
+
+// --------------------------------------------------------------------------------------
+// 结构体：pool_options
+// max_blocks_per_chunk        : 每次向上游申请时，一块缓冲区最多切出的区块个数
+// largest_required_pool_block : 由内存池管理的最大区块，更大的请求直接交给上游
+struct pool_options
+{
+    size_t max_blocks_per_chunk;
+    size_t largest_required_pool_block;
+
+    pool_options() : max_blocks_per_chunk(0), largest_required_pool_block(0) {}
+};
+
+// --------------------------------------------------------------------------------------
+// 类：unsynchronized_pool_resource
+// 区块大小为 8, 16, 32, ... 的一组内存池，每个池子维护自己的自由链表
+// 每个池子向上游申请缓冲区时，区块个数从 8 开始逐次翻倍，直到 max_blocks_per_chunk
+// 超过 largest_required_pool_block 或对齐大于默认对齐的请求直接交给上游，并记录下来以便 release
+class unsynchronized_pool_resource : public memory_resource
+{
+private:
+    enum { EMinBlockShift = 3 };                            // 最小区块 8 bytes
+    enum { EMaxBlockShift = 22 };                           // 最大区块 4 MB
+    enum { EPoolCount = EMaxBlockShift - EMinBlockShift + 1 };
+    enum { EDefaultLargestBlock = 4096 };
+    enum { EDefaultMaxBlocks = 1024 };
+    enum { EInitialBlocks = 8 };
+
+    union free_block
+    {
+        free_block* next;
+        char data[1];
+    };
+
+    struct chunk_header
+    {
+        chunk_header* next;
+        size_t        size;
+    };
+
+    // 直接从上游申请的大块内存的头部，双向链表使得单独释放时可以 O(1) 摘除
+    struct large_header
+    {
+        large_header* prev;
+        large_header* next;
+        size_t        size;       // 向上游申请的大小
+        size_t        alignment;  // 向上游申请时使用的对齐
+        size_t        offset;     // 原始地址到返回给用户的地址之间的距离
+    };
+
+    struct pool
+    {
+        free_block*   free_list;    // 空闲区块
+        chunk_header* chunks;       // 向上游申请的缓冲区
+        size_t        next_blocks;  // 下一次申请的区块个数
+    };
+
+    memory_resource* upstream_;
+    pool_options     options_;
+    size_t           pool_count_;
+    pool             pools_[EPoolCount];
+    large_header*    large_;
+
+public:
+    unsynchronized_pool_resource()
+        : upstream_(get_default_resource())
+    {
+        init(pool_options());
+    }
+
+    explicit unsynchronized_pool_resource(memory_resource* upstream)
+        : upstream_(upstream)
+    {
+        init(pool_options());
+    }
+
+    explicit unsynchronized_pool_resource(const pool_options& opts,
+                                          memory_resource* upstream = get_default_resource())
+        : upstream_(upstream)
+    {
+        init(opts);
+    }
+
+    ~unsynchronized_pool_resource()
+    {
+        release();
+    }
+
+    // 把所有内存归还给上游，即使其中的区块还没有被 deallocate
+    void release()
+    {
+        for (size_t i = 0; i < pool_count_; ++i)
+        {
+            chunk_header* c = pools_[i].chunks;
+            while (c != nullptr)
+            {
+                chunk_header* next = c->next;
+                upstream_->deallocate(c, c->size, CTSTL_MAX_ALIGN);
+                c = next;
+            }
+            pools_[i].free_list = nullptr;
+            pools_[i].chunks = nullptr;
+            pools_[i].next_blocks = EInitialBlocks;
+        }
+        while (large_ != nullptr)
+        {
+            large_header* next = large_->next;
+            free_large(large_);
+            large_ = next;
+        }
+    }
+
+    memory_resource* upstream_resource() const noexcept { return upstream_; }
+    pool_options     options() const noexcept { return options_; }
+
+private:
+    unsynchronized_pool_resource(const unsynchronized_pool_resource&);
+    void operator=(const unsynchronized_pool_resource&);
+
+    void init(const pool_options& opts)
+    {
+        options_ = opts;
+        if (options_.max_blocks_per_chunk == 0)
+            options_.max_blocks_per_chunk = EDefaultMaxBlocks;
+        if (options_.max_blocks_per_chunk < EInitialBlocks)
+            options_.max_blocks_per_chunk = EInitialBlocks;
+        if (options_.largest_required_pool_block == 0)
+            options_.largest_required_pool_block = EDefaultLargestBlock;
+        if (options_.largest_required_pool_block > (static_cast<size_t>(1) << EMaxBlockShift))
+            options_.largest_required_pool_block = static_cast<size_t>(1) << EMaxBlockShift;
+        pool_count_ = pool_index(options_.largest_required_pool_block) + 1;
+        options_.largest_required_pool_block = block_size(pool_count_ - 1);
+        for (size_t i = 0; i < EPoolCount; ++i)
+        {
+            pools_[i].free_list = nullptr;
+            pools_[i].chunks = nullptr;
+            pools_[i].next_blocks = EInitialBlocks;
+        }
+        large_ = nullptr;
+    }
+
+    static size_t block_size(size_t index) noexcept
+    {
+        return static_cast<size_t>(1) << (index + EMinBlockShift);
+    }
+
+    // 能容纳 bytes 的最小池子的下标
+    static size_t pool_index(size_t bytes) noexcept
+    {
+        size_t index = 0;
+        while (block_size(index) < bytes)
+            ++index;
+        return index;
+    }
+
+    void* do_allocate(size_t bytes, size_t alignment) override
+    {
+        const size_t need = bytes > alignment ? bytes : alignment;
+        if (need > options_.largest_required_pool_block || alignment > CTSTL_MAX_ALIGN)
+            return allocate_large(bytes, alignment);
+        pool& p = pools_[pool_index(need)];
+        if (p.free_list == nullptr)
+            refill(p, block_size(pool_index(need)));
+        free_block* result = p.free_list;
+        p.free_list = result->next;
+        return result;
+    }
+
+    void do_deallocate(void* ptr, size_t bytes, size_t alignment) override
+    {
+        const size_t need = bytes > alignment ? bytes : alignment;
+        if (need > options_.largest_required_pool_block || alignment > CTSTL_MAX_ALIGN)
+        {
+            deallocate_large(ptr);
+            return;
+        }
+        pool& p = pools_[pool_index(need)];
+        free_block* block = static_cast<free_block*>(ptr);
+        block->next = p.free_list;
+        p.free_list = block;
+    }
+
+    bool do_is_equal(const memory_resource& other) const noexcept override
+    {
+        return this == &other;
+    }
+
+    // 为池子申请一块新的缓冲区，并把它切成区块挂到自由链表上
+    void refill(pool& p, size_t size)
+    {
+        const size_t header_size = align_up(sizeof(chunk_header), CTSTL_MAX_ALIGN);
+        const size_t nblocks = p.next_blocks;
+        const size_t chunk_size = header_size + size * nblocks;
+        chunk_header* chunk = static_cast<chunk_header*>(
+            upstream_->allocate(chunk_size, CTSTL_MAX_ALIGN));
+        chunk->next = p.chunks;
+        chunk->size = chunk_size;
+        p.chunks = chunk;
+        char* first = reinterpret_cast<char*>(chunk) + header_size;
+        for (size_t i = nblocks; i > 0; --i)
+        {
+            free_block* block = reinterpret_cast<free_block*>(first + (i - 1) * size);
+            block->next = p.free_list;
+            p.free_list = block;
+        }
+        if (p.next_blocks < options_.max_blocks_per_chunk)
+        {
+            p.next_blocks *= 2;
+            if (p.next_blocks > options_.max_blocks_per_chunk)
+                p.next_blocks = options_.max_blocks_per_chunk;
+        }
+    }
+
+    // 头部紧贴在返回给用户的地址之前，原始地址为 ptr - offset
+    void* allocate_large(size_t bytes, size_t alignment)
+    {
+        const size_t align = alignment > alignof(large_header) ? alignment : alignof(large_header);
+        const size_t offset = align_up(sizeof(large_header), align);
+        const size_t size = offset + bytes;
+        char* raw = static_cast<char*>(upstream_->allocate(size, align));
+        large_header* h = reinterpret_cast<large_header*>(raw + offset) - 1;
+        h->prev = nullptr;
+        h->next = large_;
+        h->size = size;
+        h->alignment = align;
+        h->offset = offset;
+        if (large_ != nullptr)
+            large_->prev = h;
+        large_ = h;
+        return raw + offset;
+    }
+
+    void deallocate_large(void* ptr)
+    {
+        large_header* h = static_cast<large_header*>(ptr) - 1;
+        if (h->prev != nullptr)
+            h->prev->next = h->next;
+        else
+            large_ = h->next;
+        if (h->next != nullptr)
+            h->next->prev = h->prev;
+        free_large(h);
+    }
+
+    void free_large(large_header* h)
+    {
+        char* raw = reinterpret_cast<char*>(h + 1) - h->offset;
+        upstream_->deallocate(raw, h->size, h->alignment);
+    }
+};
+
+// --------------------------------------------------------------------------------------
+// 类：synchronized_pool_resource
+// 用一把互斥锁保护的 unsynchronized_pool_resource，可以被多个线程同时使用
+class synchronized_pool_resource : public memory_resource
+{
+private:
+    unsynchronized_pool_resource pool_;
+    std::mutex                   mutex_;
+
+public:
+    synchronized_pool_resource()
+    {
+    }
+
+    explicit synchronized_pool_resource(memory_resource* upstream)
+        : pool_(upstream)
+    {
+    }
+
+    explicit synchronized_pool_resource(const pool_options& opts,
+                                        memory_resource* upstream = get_default_resource())
+        : pool_(opts, upstream)
+    {
+    }
+
+    void release()
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        pool_.release();
+    }
+
+    memory_resource* upstream_resource() const noexcept { return pool_.upstream_resource(); }
+    pool_options     options() const noexcept { return pool_.options(); }
+
+private:
+    void* do_allocate(size_t bytes, size_t alignment) override
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return pool_.allocate(bytes, alignment);
+    }
+
+    void do_deallocate(void* p, size_t bytes, size_t alignment) override
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        pool_.deallocate(p, bytes, alignment);
+    }
+
+    bool do_is_equal(const memory_resource& other) const noexcept override
+    {
+        return this == &other;
+    }
+};
+
+// --------------------------------------------------------------------------------------
+// 模板类：polymorphic_allocator
+// 接口与 allocator 相同，区别在于它持有一个 memory_resource 指针，所有内存请求都交给这个资源
+// 同一个容器图中的所有容器使用同一个 monotonic_buffer_resource 时，可以通过一次 release 全部释放
+template <class T>
+class polymorphic_allocator
+{
+public:
+    typedef T           value_type;
+    typedef T*          pointer;
+    typedef const T*    const_pointer;
+    typedef T&          reference;
+    typedef const T&    const_reference;
+    typedef size_t      size_type;
+    typedef ptrdiff_t   difference_type;
+
+    template <class U>
+    struct rebind
+    {
+        typedef polymorphic_allocator<U> other;
+    };
+
+private:
+    memory_resource* resource_;
+
+public:
+    polymorphic_allocator() noexcept : resource_(get_default_resource()) {}
+    polymorphic_allocator(memory_resource* r) noexcept : resource_(r) {}
+    polymorphic_allocator(const polymorphic_allocator& rhs) = default;
+
+    template <class U>
+    polymorphic_allocator(const polymorphic_allocator<U>& rhs) noexcept
+        : resource_(rhs.resource())
+    {
+    }
+
+    polymorphic_allocator& operator=(const polymorphic_allocator&) = delete;
+
+public:
+    T* allocate()
+    {
+        return static_cast<T*>(resource_->allocate(sizeof(T), alignof(T)));
+    }
+
+    T* allocate(size_type n)
+    {
+        if (n == 0)
+            return nullptr;
+        return static_cast<T*>(resource_->allocate(n * sizeof(T), alignof(T)));
+    }
+
+    void deallocate(T* ptr)
+    {
+        if (ptr == nullptr)
+            return;
+        resource_->deallocate(ptr, sizeof(T), alignof(T));
+    }
+
+    void deallocate(T* ptr, size_type n)
+    {
+        if (ptr == nullptr)
+            return;
+        resource_->deallocate(ptr, n * sizeof(T), alignof(T));
+    }
+
+    void construct(T* ptr)                  { ctstl::construct(ptr); }
+    void construct(T* ptr, const T& value)  { ctstl::construct(ptr, value); }
+    void construct(T* ptr, T&& value)       { ctstl::construct(ptr, ctstl::move(value)); }
+
+    template <class... Args>
+    void construct(T* ptr, Args&& ...args)
+    {
+        ctstl::construct(ptr, ctstl::forward<Args>(args)...);
+    }
+
+    void destroy(T* ptr)                    { ctstl::destroy(ptr); }
+    void destroy(T* first, T* last)         { ctstl::destroy(first, last); }
+
+    memory_resource* resource() const noexcept { return resource_; }
+};
+
+template <class T1, class T2>
+bool operator==(const polymorphic_allocator<T1>& lhs, const polymorphic_allocator<T2>& rhs) noexcept
+{
+    return *lhs.resource() == *rhs.resource();
+}
+
+template <class T1, class T2>
+bool operator!=(const polymorphic_allocator<T1>& lhs, const polymorphic_allocator<T2>& rhs) noexcept
+{
+    return !(lhs == rhs);
+}
+
+} // namespace ctstl
+#endif // !CTSTL_MEMORY_RESOURCE_H_
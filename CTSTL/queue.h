@@ -0,0 +1,550 @@
+#ifndef CTSTL_QUEUE_H_
+#define CTSTL_QUEUE_H_
+
+// 这个头文件包含两个模板类 priority_queue 和 indexed_priority_queue
+// priority_queue         : 优先队列，底层为 vector 上的堆，使用 heap_algo.h 中的算法
+// indexed_priority_queue : 可修改优先级的优先队列，push 返回一个 handle，
+//                          可以通过 handle 在 O(log n) 时间内修改元素的优先级或删除元素
+//
+// 1. 为什么需要 indexed_priority_queue？
+// 普通的优先队列不能修改已经入队的元素，只能再插入一份新的、在弹出时丢弃过期的那一份（惰性删除），
+// 频繁修改优先级时堆会越来越大；indexed_priority_queue 记录每个 handle 在堆中的下标，
+// 直接从那个位置上溯或下溯，堆中只有有效的元素
+//
+// 2. increase_key / decrease_key 的方向
+// 与 priority_queue 一样，top() 是按 Compare 排序最“大”的元素，缺省的 ctstl::less 为最大堆
+// increase_key 表示新值按 Compare 不小于旧值（离堆顶更近），decrease_key 表示新值不大于旧值；
+// 使用 ctstl::greater 的最小堆（例如最短路中的距离）中，把距离改小应当调用 increase_key，
+// 不确定方向时调用 update
+
+#include <initializer_list>
+#include <type_traits>
+
+#include "heap_algo.h"
+#include "iterator.h"
+#include "functional.h"
+#include "util.h"
+#include "exceptdef.h"
+#include "vector.h"
+
+namespace ctstl
+{
+
+// 模板类 priority_queue
+// 参数一代表数据类型，参数二代表容器类型，缺省使用 ctstl::vector 作为底层容器
+// 参数三代表比较权值的方式，缺省使用 ctstl::less 作为比较方式，参数四代表堆的分叉数
+template <class T, class Container = ctstl::vector<T>,
+          class Compare = ctstl::less<typename Container::value_type>,
+          size_t Arity = EHeapDefaultArity>
+class priority_queue
+{
+public:
+    typedef Container                                container_type;
+    typedef Compare                                  value_compare;
+    // 使用底层容器的型别
+    typedef typename Container::value_type           value_type;
+    typedef typename Container::size_type            size_type;
+    typedef typename Container::reference            reference;
+    typedef typename Container::const_reference      const_reference;
+
+    static_assert(std::is_same<T, value_type>::value,
+                  "the value_type of Container should be same with T");
+
+private:
+    container_type c_;     // 用底层容器来表现 priority_queue
+    value_compare  comp_;  // 权值比较的标准
+
+public:
+    // 构造、复制、移动函数
+    priority_queue() = default;
+
+    explicit priority_queue(const Compare& c)
+        : c_(), comp_(c)
+    {
+    }
+
+    template <class IIter, typename std::enable_if<
+        ctstl::is_input_iterator<IIter>::value, int>::type = 0>
+    priority_queue(IIter first, IIter last, const Compare& c = Compare())
+        : c_(first, last), comp_(c)
+    {
+        ctstl::make_heap<Arity>(c_.begin(), c_.end(), comp_);
+    }
+
+    priority_queue(std::initializer_list<T> ilist, const Compare& c = Compare())
+        : c_(ilist), comp_(c)
+    {
+        ctstl::make_heap<Arity>(c_.begin(), c_.end(), comp_);
+    }
+
+    explicit priority_queue(const Container& s, const Compare& c = Compare())
+        : c_(s), comp_(c)
+    {
+        ctstl::make_heap<Arity>(c_.begin(), c_.end(), comp_);
+    }
+    explicit priority_queue(Container&& s, const Compare& c = Compare())
+        : c_(ctstl::move(s)), comp_(c)
+    {
+        ctstl::make_heap<Arity>(c_.begin(), c_.end(), comp_);
+    }
+
+    priority_queue(const priority_queue& rhs) = default;
+    priority_queue(priority_queue&& rhs) = default;
+
+    priority_queue& operator=(const priority_queue& rhs) = default;
+    priority_queue& operator=(priority_queue&& rhs) = default;
+
+    priority_queue& operator=(std::initializer_list<T> ilist)
+    {
+        c_ = ilist;
+        ctstl::make_heap<Arity>(c_.begin(), c_.end(), comp_);
+        return *this;
+    }
+
+    ~priority_queue() = default;
+
+public:
+    // 访问元素相关操作
+    const_reference top() const
+    {
+        CTSTL_DEBUG(!empty());
+        return c_.front();
+    }
+
+    // 容量相关操作
+    bool      empty() const noexcept { return c_.empty(); }
+    size_type size()  const noexcept { return c_.size(); }
+
+    // 修改容器相关操作
+    template <class... Args>
+    void emplace(Args&& ...args)
+    {
+        c_.emplace_back(ctstl::forward<Args>(args)...);
+        ctstl::push_heap<Arity>(c_.begin(), c_.end(), comp_);
+    }
+
+    void push(const value_type& value)
+    {
+        c_.push_back(value);
+        ctstl::push_heap<Arity>(c_.begin(), c_.end(), comp_);
+    }
+    void push(value_type&& value)
+    {
+        c_.push_back(ctstl::move(value));
+        ctstl::push_heap<Arity>(c_.begin(), c_.end(), comp_);
+    }
+
+    void pop()
+    {
+        CTSTL_DEBUG(!empty());
+        ctstl::pop_heap<Arity>(c_.begin(), c_.end(), comp_);
+        c_.pop_back();
+    }
+
+    void clear() noexcept { c_.clear(); }
+
+    void swap(priority_queue& rhs) noexcept
+    {
+        ctstl::swap(c_, rhs.c_);
+        ctstl::swap(comp_, rhs.comp_);
+    }
+
+public:
+    friend bool operator==(const priority_queue& lhs, const priority_queue& rhs)
+    {
+        return lhs.c_ == rhs.c_;
+    }
+    friend bool operator!=(const priority_queue& lhs, const priority_queue& rhs)
+    {
+        return lhs.c_ != rhs.c_;
+    }
+};
+
+// 重载 ctstl 的 swap
+template <class T, class Container, class Compare, size_t Arity>
+void swap(priority_queue<T, Container, Compare, Arity>& lhs,
+          priority_queue<T, Container, Compare, Arity>& rhs) noexcept
+{
+    lhs.swap(rhs);
+}
+
+/*****************************************************************************************/
+// indexed_priority_queue
+// 堆中的元素是 (handle, value)，pos 数组记录每个 handle 在堆中的下标；
+// 通过 indexed_heap_iterator 调用 heap_algo.h 中的算法，每次写入堆中的一个位置都同时更新 pos，
+// 因此上溯、下溯可以直接复用 push_heap_aux / adjust_heap
+/*****************************************************************************************/
+
+template <class T>
+struct indexed_heap_entry
+{
+    size_t handle;
+    T      value;
+
+    indexed_heap_entry() = default;
+
+    template <class... Args>
+    indexed_heap_entry(size_t h, Args&& ...args)
+        : handle(h), value(ctstl::forward<Args>(args)...)
+    {
+    }
+};
+
+// 堆中一个位置的代理引用
+// 赋值时移动元素并把 pos[handle] 设为这个位置；从右值代理转换为元素时把元素移出
+template <class T>
+class indexed_heap_reference
+{
+public:
+    typedef indexed_heap_entry<T> entry;
+
+private:
+    entry*    heap_;
+    size_t*   pos_;
+    ptrdiff_t i_;
+
+public:
+    indexed_heap_reference(entry* heap, size_t* pos, ptrdiff_t i) noexcept
+        : heap_(heap), pos_(pos), i_(i) {}
+
+    indexed_heap_reference(const indexed_heap_reference&) = default;
+
+    const entry& get() const noexcept { return heap_[i_]; }
+
+    operator entry() && { return ctstl::move(heap_[i_]); }
+
+    indexed_heap_reference& operator=(entry&& e)
+    {
+        heap_[i_] = ctstl::move(e);
+        pos_[heap_[i_].handle] = static_cast<size_t>(i_);
+        return *this;
+    }
+
+    indexed_heap_reference& operator=(const indexed_heap_reference& rhs)
+    {
+        return *this = ctstl::move(rhs.heap_[rhs.i_]);
+    }
+};
+
+// 模板类: indexed_heap_iterator
+// 堆数组上的随机访问迭代器，reference 为 indexed_heap_reference
+template <class T>
+class indexed_heap_iterator
+    : public ctstl::iterator<ctstl::random_access_iterator_tag, indexed_heap_entry<T>,
+                             ptrdiff_t, void, indexed_heap_reference<T>>
+{
+public:
+    typedef indexed_heap_entry<T>      entry;
+    typedef indexed_heap_reference<T>  reference;
+    typedef ptrdiff_t                  difference_type;
+    typedef indexed_heap_iterator      self;
+
+private:
+    entry*          heap_;
+    size_t*         pos_;
+    difference_type i_;
+
+public:
+    indexed_heap_iterator(entry* heap, size_t* pos, difference_type i) noexcept
+        : heap_(heap), pos_(pos), i_(i) {}
+
+    reference operator*() const { return reference(heap_, pos_, i_); }
+    reference operator[](difference_type n) const { return reference(heap_, pos_, i_ + n); }
+
+    self& operator++()                   { ++i_; return *this; }
+    self  operator++(int)                { self tmp = *this; ++i_; return tmp; }
+    self& operator--()                   { --i_; return *this; }
+    self  operator--(int)                { self tmp = *this; --i_; return tmp; }
+    self& operator+=(difference_type n)  { i_ += n; return *this; }
+    self& operator-=(difference_type n)  { i_ -= n; return *this; }
+    self  operator+(difference_type n) const { return self(heap_, pos_, i_ + n); }
+    self  operator-(difference_type n) const { return self(heap_, pos_, i_ - n); }
+
+    difference_type operator-(const self& rhs) const { return i_ - rhs.i_; }
+
+    bool operator==(const self& rhs) const { return i_ == rhs.i_; }
+    bool operator!=(const self& rhs) const { return i_ != rhs.i_; }
+    bool operator< (const self& rhs) const { return i_ < rhs.i_; }
+    bool operator> (const self& rhs) const { return i_ > rhs.i_; }
+    bool operator<=(const self& rhs) const { return i_ <= rhs.i_; }
+    bool operator>=(const self& rhs) const { return i_ >= rhs.i_; }
+};
+
+// 比较堆中元素（或它的代理引用）的 value
+template <class T, class Compare>
+struct indexed_heap_compare
+{
+    Compare comp;
+
+    indexed_heap_compare() = default;
+    explicit indexed_heap_compare(const Compare& c) : comp(c) {}
+
+    static const T& value_of(const indexed_heap_entry<T>& e) noexcept { return e.value; }
+    static const T& value_of(const indexed_heap_reference<T>& r) noexcept { return r.get().value; }
+
+    template <class A, class B>
+    bool operator()(const A& a, const B& b) const
+    {
+        return comp(value_of(a), value_of(b));
+    }
+};
+
+// 模板类 indexed_priority_queue
+// 参数一代表数据类型，参数二代表比较权值的方式，缺省使用 ctstl::less，参数三代表堆的分叉数
+// handle 是小整数，元素出队或被删除后它的 handle 会被之后的 push 复用
+template <class T, class Compare = ctstl::less<T>, size_t Arity = EHeapDefaultArity>
+class indexed_priority_queue
+{
+public:
+    typedef T                                   value_type;
+    typedef Compare                             value_compare;
+    typedef const T&                            const_reference;
+    typedef size_t                              size_type;
+    typedef size_t                              handle_type;
+
+private:
+    typedef indexed_heap_entry<T>               entry;
+    typedef indexed_heap_iterator<T>            heap_iterator;
+    typedef indexed_heap_compare<T, Compare>    heap_compare;
+
+    ctstl::vector<entry>     heap_;   // 按 Arity 叉堆排列的元素
+    ctstl::vector<size_type> pos_;    // handle 在 heap_ 中的下标，不在队列中时为 npos()
+    ctstl::vector<size_type> free_;   // 可以复用的 handle，容量不小于 pos_.size()，归还时不会分配内存
+    heap_compare             comp_;
+
+public:
+    // 构造、复制、移动函数
+    indexed_priority_queue() = default;
+
+    explicit indexed_priority_queue(const Compare& c)
+        : comp_(c)
+    {
+    }
+
+    // vector 的复制只按元素个数分配容量，这里要重新保证 free_ 的容量不小于 pos_.size()
+    indexed_priority_queue(const indexed_priority_queue& rhs)
+        : heap_(rhs.heap_), pos_(rhs.pos_), free_(rhs.free_), comp_(rhs.comp_)
+    {
+        free_.reserve(pos_.size());
+    }
+
+    indexed_priority_queue(indexed_priority_queue&& rhs) = default;
+
+    indexed_priority_queue& operator=(const indexed_priority_queue& rhs)
+    {
+        if (this != &rhs)
+        {
+            indexed_priority_queue tmp(rhs);
+            swap(tmp);
+        }
+        return *this;
+    }
+
+    indexed_priority_queue& operator=(indexed_priority_queue&& rhs) = default;
+
+    ~indexed_priority_queue() = default;
+
+    value_compare value_comp() const { return comp_.comp; }
+
+public:
+    // 访问元素相关操作
+    const_reference top() const
+    {
+        CTSTL_DEBUG(!empty());
+        return heap_.front().value;
+    }
+    handle_type     top_handle() const
+    {
+        CTSTL_DEBUG(!empty());
+        return heap_.front().handle;
+    }
+
+    bool            contains(handle_type h) const noexcept
+    { return h < pos_.size() && pos_[h] != npos(); }
+
+    const_reference value(handle_type h) const
+    {
+        CTSTL_DEBUG(contains(h));
+        return heap_[pos_[h]].value;
+    }
+
+    // 容量相关操作
+    bool      empty() const noexcept { return heap_.empty(); }
+    size_type size()  const noexcept { return heap_.size(); }
+
+    void      reserve(size_type n)
+    {
+        heap_.reserve(n);
+        pos_.reserve(n);
+        free_.reserve(n);
+    }
+
+    // 修改容器相关操作
+
+    // 入队，返回元素的 handle
+    template <class... Args>
+    handle_type emplace(Args&& ...args)
+    {
+        const handle_type h = acquire_handle();
+        try
+        {
+            heap_.emplace_back(h, ctstl::forward<Args>(args)...);
+        }
+        catch (...)
+        {
+            release_handle(h);
+            throw;
+        }
+        pos_[h] = heap_.size() - 1;
+        sift_up(heap_.size() - 1);
+        return h;
+    }
+
+    handle_type push(const value_type& value) { return emplace(value); }
+    handle_type push(value_type&& value)      { return emplace(ctstl::move(value)); }
+
+    void pop()
+    {
+        CTSTL_DEBUG(!empty());
+        ctstl::pop_heap<Arity>(heap_begin(), heap_end(), comp_);
+        const handle_type h = heap_.back().handle;
+        heap_.pop_back();
+        release_handle(h);
+    }
+
+    // 新值按 Compare 不小于旧值，元素向堆顶移动
+    template <class V>
+    void increase_key(handle_type h, V&& v)
+    {
+        CTSTL_DEBUG(contains(h));
+        const size_type i = pos_[h];
+        CTSTL_DEBUG(!comp_.comp(v, heap_[i].value));
+        heap_[i].value = ctstl::forward<V>(v);
+        sift_up(i);
+    }
+
+    // 新值按 Compare 不大于旧值，元素向叶节点移动
+    template <class V>
+    void decrease_key(handle_type h, V&& v)
+    {
+        CTSTL_DEBUG(contains(h));
+        const size_type i = pos_[h];
+        CTSTL_DEBUG(!comp_.comp(heap_[i].value, v));
+        heap_[i].value = ctstl::forward<V>(v);
+        sift_down(i);
+    }
+
+    // 任意修改元素的值
+    template <class V>
+    void update(handle_type h, V&& v)
+    {
+        CTSTL_DEBUG(contains(h));
+        const size_type i = pos_[h];
+        const bool up = comp_.comp(heap_[i].value, v);
+        heap_[i].value = ctstl::forward<V>(v);
+        if (up)
+            sift_up(i);
+        else
+            sift_down(i);
+    }
+
+    // 删除 handle 对应的元素，末尾的元素移到它的位置后再上溯或下溯
+    void erase(handle_type h)
+    {
+        CTSTL_DEBUG(contains(h));
+        const size_type i = pos_[h];
+        const size_type last = heap_.size() - 1;
+        if (i != last)
+        {
+            heap_[i] = ctstl::move(heap_[last]);
+            pos_[heap_[i].handle] = i;
+        }
+        heap_.pop_back();
+        release_handle(h);
+        if (i < heap_.size())
+        {
+            if (i > 0 && comp_(heap_[(i - 1) / Arity], heap_[i]))
+                sift_up(i);
+            else
+                sift_down(i);
+        }
+    }
+
+    // 清空队列，之前的所有 handle 失效
+    void clear() noexcept
+    {
+        heap_.clear();
+        pos_.clear();
+        free_.clear();
+    }
+
+    void swap(indexed_priority_queue& rhs) noexcept
+    {
+        heap_.swap(rhs.heap_);
+        pos_.swap(rhs.pos_);
+        free_.swap(rhs.free_);
+        ctstl::swap(comp_, rhs.comp_);
+    }
+
+private:
+    static size_type npos() noexcept { return static_cast<size_type>(-1); }
+
+    heap_iterator heap_begin() noexcept
+    { return heap_iterator(heap_.data(), pos_.data(), 0); }
+    heap_iterator heap_end() noexcept
+    { return heap_iterator(heap_.data(), pos_.data(), static_cast<ptrdiff_t>(heap_.size())); }
+
+    // 从下标 i 上溯
+    void sift_up(size_type i)
+    {
+        entry value = ctstl::move(heap_[i]);
+        ctstl::push_heap_aux<Arity>(heap_begin(), static_cast<ptrdiff_t>(i),
+                                    static_cast<ptrdiff_t>(0), ctstl::move(value), comp_);
+    }
+
+    // 从下标 i 下溯
+    void sift_down(size_type i)
+    {
+        entry value = ctstl::move(heap_[i]);
+        ctstl::adjust_heap<Arity>(heap_begin(), static_cast<ptrdiff_t>(i),
+                                  static_cast<ptrdiff_t>(heap_.size()), ctstl::move(value), comp_);
+    }
+
+    handle_type acquire_handle()
+    {
+        if (!free_.empty())
+        {
+            const handle_type h = free_.back();
+            free_.pop_back();
+            return h;
+        }
+        pos_.push_back(npos());
+        try
+        {
+            free_.reserve(pos_.size());
+        }
+        catch (...)
+        {
+            pos_.pop_back();
+            throw;
+        }
+        return pos_.size() - 1;
+    }
+
+    void release_handle(handle_type h) noexcept
+    {
+        pos_[h] = npos();
+        free_.push_back(h);
+    }
+};
+
+// 重载 ctstl 的 swap
+template <class T, class Compare, size_t Arity>
+void swap(indexed_priority_queue<T, Compare, Arity>& lhs,
+          indexed_priority_queue<T, Compare, Arity>& rhs) noexcept
+{
+    lhs.swap(rhs);
+}
+
+} // namespace ctstl
+#endif // !CTSTL_QUEUE_H_
@@ -0,0 +1,253 @@
+#ifndef CTSTL_RADIX_HEAP_H_
+#define CTSTL_RADIX_HEAP_H_
+
+// 这个头文件包含一个模板类 radix_heap
+// radix_heap : 键值为无符号整数、取出的键值单调不减的最小优先队列，适合定时器、Dijkstra 这类负载
+//
+// 1. 原理
+// 记 last 为最近一次取出（top / pop）的最小键值，键值 k 放在第 bit_width(k ^ last) 号桶中，
+// 0 号桶中的键值都等于 last；k 越接近 last，桶号越小，i 号桶中的键值都小于 i + 1 号桶中的键值
+// 0 号桶为空时，找到第一个非空的桶，以其中最小的键值为新的 last，把这个桶中的元素重新分配到更小的桶中
+// 每个元素每次重新分配桶号至少减一，总代价为均摊 O(log C)（C 为键值的位数范围），push 为 O(1)，
+// 不需要任何键值比较之外的比较函数
+//
+// 2. 单调性要求
+// push 的键值不能小于最近一次 top() / pop() 看到的键值（Dijkstra 中新的距离总是不小于刚取出的距离），
+// 违反时在调试模式下由 CTSTL_DEBUG 断言
+//
+// 3. 接口
+// 与 priority_queue<pair<Key, Value>, vector<...>, greater<...>> 相同的 push / emplace / top / pop / empty / size，
+// 二者可以互相替换
+// 重新分配桶在第一次需要最小元素时进行，所以 top() 会修改内部状态（相关成员是 mutable 的），
+// 元素的移动构造不应抛出异常
+
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+#include "util.h"
+#include "exceptdef.h"
+#include "vector.h"
+
+namespace ctstl
+{
+
+// 表示 x 需要的位数，x 为 0 时返回 0
+inline unsigned radix_heap_bit_width(uint64_t x) noexcept
+{
+#if defined(__GNUC__) || defined(__clang__)
+    return x == 0 ? 0 : 64 - static_cast<unsigned>(__builtin_clzll(x));
+#elif defined(_MSC_VER) && defined(_M_X64)
+    unsigned long index;
+    return _BitScanReverse64(&index, x) ? static_cast<unsigned>(index) + 1 : 0;
+#else
+    unsigned n = 0;
+    for (; x != 0; x >>= 1)
+        ++n;
+    return n;
+#endif
+}
+
+// 最低位的 1 的位置，x 不能为 0
+inline unsigned radix_heap_ctz(uint64_t x) noexcept
+{
+#if defined(__GNUC__) || defined(__clang__)
+    return static_cast<unsigned>(__builtin_ctzll(x));
+#elif defined(_MSC_VER) && defined(_M_X64)
+    unsigned long index;
+    _BitScanForward64(&index, x);
+    return static_cast<unsigned>(index);
+#else
+    unsigned n = 0;
+    for (; (x & 1) == 0; x >>= 1)
+        ++n;
+    return n;
+#endif
+}
+
+// 模板类 radix_heap
+// 参数一代表键值类型，必须是不超过 64 位的无符号整数，参数二代表实值类型
+template <class Key, class Value>
+class radix_heap
+{
+    static_assert(std::is_integral<Key>::value && std::is_unsigned<Key>::value,
+                  "radix_heap requires an unsigned integer key");
+    static_assert(std::numeric_limits<Key>::digits <= 64, "radix_heap key is wider than 64 bits");
+
+public:
+    typedef Key                         key_type;
+    typedef Value                       mapped_type;
+    typedef ctstl::pair<Key, Value>     value_type;
+    typedef value_type&                 reference;
+    typedef const value_type&           const_reference;
+    typedef size_t                      size_type;
+
+private:
+    typedef ctstl::vector<value_type>   bucket_type;
+
+    // 0 号桶加上每一位一个桶
+    static constexpr size_t bucket_count = std::numeric_limits<Key>::digits + 1;
+
+    mutable bucket_type buckets_[bucket_count];
+    mutable uint64_t    nonempty_;  // 第 i - 1 位表示 i 号桶（i >= 1）是否非空
+    mutable key_type    last_;      // 最近一次取出的最小键值
+    size_type           size_;
+
+public:
+    // 构造、复制、移动函数
+    radix_heap() noexcept
+        : nonempty_(0), last_(0), size_(0)
+    {
+    }
+
+    radix_heap(const radix_heap& rhs) = default;
+    radix_heap& operator=(const radix_heap& rhs) = default;
+
+    radix_heap(radix_heap&& rhs) noexcept
+        : nonempty_(rhs.nonempty_), last_(rhs.last_), size_(rhs.size_)
+    {
+        for (size_t i = 0; i < bucket_count; ++i)
+            buckets_[i].swap(rhs.buckets_[i]);
+        rhs.nonempty_ = 0;
+        rhs.last_ = 0;
+        rhs.size_ = 0;
+    }
+
+    radix_heap& operator=(radix_heap&& rhs) noexcept
+    {
+        if (this != &rhs)
+        {
+            clear();
+            swap(rhs);
+        }
+        return *this;
+    }
+
+    ~radix_heap() = default;
+
+public:
+    // 访问元素相关操作，返回键值最小的元素
+    const_reference top() const
+    {
+        CTSTL_DEBUG(!empty());
+        pull();
+        return buckets_[0].back();
+    }
+
+    // 键值的下界：之后 push 的键值不能小于它
+    key_type last_key() const noexcept { return last_; }
+
+    // 容量相关操作
+    bool      empty() const noexcept { return size_ == 0; }
+    size_type size()  const noexcept { return size_; }
+
+    // 修改容器相关操作
+    template <class... Args>
+    void emplace(Args&& ...args)
+    {
+        place(value_type(ctstl::forward<Args>(args)...));
+    }
+
+    void push(const value_type& value) { place(value_type(value)); }
+    void push(value_type&& value)      { place(ctstl::move(value)); }
+
+    void pop()
+    {
+        CTSTL_DEBUG(!empty());
+        pull();
+        buckets_[0].pop_back();
+        --size_;
+    }
+
+    // 清空队列，键值的下界回到 0
+    void clear() noexcept
+    {
+        for (size_t i = 0; i < bucket_count; ++i)
+            buckets_[i].clear();
+        nonempty_ = 0;
+        last_ = 0;
+        size_ = 0;
+    }
+
+    void swap(radix_heap& rhs) noexcept
+    {
+        for (size_t i = 0; i < bucket_count; ++i)
+            buckets_[i].swap(rhs.buckets_[i]);
+        ctstl::swap(nonempty_, rhs.nonempty_);
+        ctstl::swap(last_, rhs.last_);
+        ctstl::swap(size_, rhs.size_);
+    }
+
+private:
+    size_t bucket_index(key_type key) const noexcept
+    {
+        return radix_heap_bit_width(static_cast<uint64_t>(key ^ last_));
+    }
+
+    static uint64_t bucket_bit(size_t i) noexcept
+    {
+        return static_cast<uint64_t>(1) << (i - 1);
+    }
+
+    void place(value_type&& value)
+    {
+        CTSTL_DEBUG(!(value.first < last_));
+        const size_t i = bucket_index(value.first);
+        buckets_[i].push_back(ctstl::move(value));
+        if (i != 0)
+            nonempty_ |= bucket_bit(i);
+        ++size_;
+    }
+
+    void pull() const;
+};
+
+// 0 号桶为空时，把第一个非空的桶重新分配到更小的桶中
+// 先数出每个目标桶需要的空间并预留，之后的移动不会分配内存，失败时容器保持不变
+template <class Key, class Value>
+void radix_heap<Key, Value>::pull() const
+{
+    if (!buckets_[0].empty())
+        return;
+    CTSTL_DEBUG(nonempty_ != 0);
+    const size_t i = radix_heap_ctz(nonempty_) + 1;
+    bucket_type& bucket = buckets_[i];
+
+    key_type new_last = bucket[0].first;
+    for (size_t k = 1; k < bucket.size(); ++k)
+        new_last = bucket[k].first < new_last ? bucket[k].first : new_last;
+
+    size_t count[bucket_count] = {};
+    for (size_t k = 0; k < bucket.size(); ++k)
+        ++count[radix_heap_bit_width(static_cast<uint64_t>(bucket[k].first ^ new_last))];
+    for (size_t j = 0; j < i; ++j)
+    {
+        if (count[j] != 0)
+            buckets_[j].reserve(buckets_[j].size() + count[j]);
+    }
+
+    last_ = new_last;
+    for (size_t k = 0; k < bucket.size(); ++k)
+    {
+        const size_t j = bucket_index(bucket[k].first);
+        buckets_[j].push_back(ctstl::move(bucket[k]));
+        if (j != 0)
+            nonempty_ |= bucket_bit(j);
+    }
+    bucket.clear();
+    nonempty_ &= ~bucket_bit(i);
+}
+
+// 重载 ctstl 的 swap
+template <class Key, class Value>
+void swap(radix_heap<Key, Value>& lhs, radix_heap<Key, Value>& rhs) noexcept
+{
+    lhs.swap(rhs);
+}
+
+} // namespace ctstl
+#endif // !CTSTL_RADIX_HEAP_H_
@@ -0,0 +1,383 @@
+#ifndef CTSTL_SLAB_ALLOC_H_
+#define CTSTL_SLAB_ALLOC_H_
+
+// 这个头文件包含节点配置器 slab_alloc_template，以及以它为后端的 slab_allocator
+// 每个 slab_alloc_template 只管理一种大小的区块（比如某种链表节点），区块从一整块 slab 中按顺序切出，
+// 释放的区块进入本线程的自由链表，下一次分配直接复用，分配与释放都不需要加锁
+// 本线程的自由链表有长度上限，超过时把一批区块归还给全局的自由链表（生产者 / 消费者这类一边分配、
+// 另一边释放的负载不会让消费者的链表无限增长），线程退出时，它缓存的全部区块也归还给全局的自由链表
+// 与 pool_alloc 一样，slab 在程序结束前不会归还给系统
+
+#include <new>
+#include <cstddef>
+#include <mutex>
+
+#include "alloc.h"
+#include "construct.h"
+#include "util.h"
+
+namespace ctstl
+{
+
+// 每个 slab 的大小，至少能切出 ESlabMinObjects 个区块
+enum { ESlabBytes = 16 * 1024 };
+enum { ESlabMinObjects = 32 };
+
+// 线程缓存与全局链表之间一次交换的区块个数，线程缓存最多保存 8 批
+enum { ESlabTransferBatch = 32 };
+
+// 模板类：slab_alloc_template
+// 模板参数 Bytes 为区块大小，Align 为区块的对齐，大小、对齐相同的类型共用同一个实例
+template <size_t Bytes, size_t Align>
+class slab_alloc_template
+{
+    static_assert(Align <= alignof(std::max_align_t), "slab_alloc does not support over-aligned types");
+
+public:
+    // 区块大小至少能放下一个 FreeList，并且是 Align 的倍数
+    static constexpr size_t object_bytes =
+        ((Bytes < sizeof(FreeList) ? sizeof(FreeList) : Bytes) + Align - 1) / Align * Align;
+
+    // slab 开头保存下一个 slab 的地址，之后才是区块
+    static constexpr size_t header_bytes =
+        (sizeof(void*) + Align - 1) / Align * Align;
+
+    static constexpr size_t slab_bytes =
+        header_bytes + object_bytes * ESlabMinObjects > static_cast<size_t>(ESlabBytes)
+        ? header_bytes + object_bytes * ESlabMinObjects
+        : static_cast<size_t>(ESlabBytes);
+
+private:
+    // 全局部分：线程退出时归还的区块，以及所有 slab 组成的链表
+    struct central_list
+    {
+        std::mutex mutex;
+        FreeList*  list;
+        void*      slabs;
+    };
+
+    // 线程缓存，只包含平凡类型，使得 thread_local 变量不需要动态初始化
+    struct thread_cache
+    {
+        FreeList* list;        // 已释放的区块
+        size_t    length;      // list 的长度
+        size_t    max_length;  // 超过这个长度时归还一批给全局链表
+        char*     slab_cur;    // 当前 slab 中尚未切分的部分
+        char*     slab_end;
+        bool      registered;  // 是否已经注册线程退出时的清理
+        bool      dead;        // 线程正在退出，缓存已经归还
+    };
+
+    // 线程退出时把线程缓存中的全部区块归还全局链表
+    struct cache_cleaner
+    {
+        ~cache_cleaner()
+        {
+            thread_cache& tc = local_cache();
+            M_flush(tc);
+            tc.dead = true;
+        }
+    };
+
+    static central_list central;
+
+public:
+    static void* allocate();
+    static void  deallocate(void* p);
+
+private:
+    static thread_cache& local_cache();
+    static void  M_register(thread_cache& tc);
+    static void* M_refill(thread_cache& tc);
+    static void  M_release(thread_cache& tc);
+    static void  M_flush(thread_cache& tc);
+    static void  M_central_insert(FreeList* head, FreeList* tail);
+};
+
+template <size_t Bytes, size_t Align>
+constexpr size_t slab_alloc_template<Bytes, Align>::object_bytes;
+
+template <size_t Bytes, size_t Align>
+constexpr size_t slab_alloc_template<Bytes, Align>::header_bytes;
+
+template <size_t Bytes, size_t Align>
+constexpr size_t slab_alloc_template<Bytes, Align>::slab_bytes;
+
+template <size_t Bytes, size_t Align>
+typename slab_alloc_template<Bytes, Align>::central_list
+slab_alloc_template<Bytes, Align>::central;
+
+template <size_t Bytes, size_t Align>
+typename slab_alloc_template<Bytes, Align>::thread_cache&
+slab_alloc_template<Bytes, Align>::local_cache()
+{
+    static thread_local thread_cache tc;
+    return tc;
+}
+
+template <size_t Bytes, size_t Align>
+void* slab_alloc_template<Bytes, Align>::allocate()
+{
+    thread_cache& tc = local_cache();
+    FreeList* result = tc.list;
+    if (result != nullptr)
+    {
+        tc.list = result->next;
+        --tc.length;
+        return result;
+    }
+    if (tc.slab_cur != tc.slab_end)
+    {
+        void* p = tc.slab_cur;
+        tc.slab_cur += object_bytes;
+        return p;
+    }
+    return M_refill(tc);
+}
+
+template <size_t Bytes, size_t Align>
+void slab_alloc_template<Bytes, Align>::deallocate(void* p)
+{
+    if (p == nullptr)
+        return;
+    thread_cache& tc = local_cache();
+    FreeList* q = static_cast<FreeList*>(p);
+    if (tc.dead)
+    {   // 线程正在退出，直接还给全局链表
+        M_central_insert(q, q);
+        return;
+    }
+    q->next = tc.list;
+    tc.list = q;
+    if (++tc.length > tc.max_length)
+        M_release(tc);
+}
+
+// 第一次走到慢路径时注册线程退出时的清理
+template <size_t Bytes, size_t Align>
+void slab_alloc_template<Bytes, Align>::M_register(thread_cache& tc)
+{
+    if (!tc.registered && !tc.dead)
+    {
+        tc.registered = true;
+        static thread_local cache_cleaner cleaner;
+        (void)cleaner;
+    }
+}
+
+// 线程缓存为空，先从全局链表取一批区块，没有就申请一个新的 slab
+template <size_t Bytes, size_t Align>
+void* slab_alloc_template<Bytes, Align>::M_refill(thread_cache& tc)
+{
+    M_register(tc);
+    std::lock_guard<std::mutex> guard(central.mutex);
+    if (central.list != nullptr)
+    {
+        FreeList* result = central.list;
+        if (tc.dead)
+        {
+            central.list = result->next;
+            return result;
+        }
+        FreeList* tail = result;
+        size_t n = 1;
+        for (; n < ESlabTransferBatch && tail->next != nullptr; ++n)
+            tail = tail->next;
+        central.list = tail->next;
+        tail->next = nullptr;
+        tc.list = result->next;
+        tc.length = n - 1;
+        // 慢启动：频繁走到慢路径时，允许缓存更多的区块
+        if (tc.max_length < ESlabTransferBatch)
+            tc.max_length = ESlabTransferBatch;
+        else if (tc.max_length < 8 * ESlabTransferBatch)
+            tc.max_length += ESlabTransferBatch;
+        return result;
+    }
+    char* slab = static_cast<char*>(::operator new(slab_bytes));
+    *reinterpret_cast<void**>(slab) = central.slabs;
+    central.slabs = slab;
+    char* first = slab + header_bytes;
+    char* end = first + (slab_bytes - header_bytes) / object_bytes * object_bytes;
+    if (tc.dead)
+    {   // 线程正在退出，整个 slab 放入全局链表
+        FreeList* head = reinterpret_cast<FreeList*>(first + object_bytes);
+        FreeList* cur = head;
+        for (char* p = first + 2 * object_bytes; p != end; p += object_bytes)
+        {
+            cur->next = reinterpret_cast<FreeList*>(p);
+            cur = cur->next;
+        }
+        cur->next = central.list;
+        central.list = head;
+        return first;
+    }
+    tc.slab_cur = first + object_bytes;
+    tc.slab_end = end;
+    return first;
+}
+
+// 线程缓存过长，把一批归还全局链表
+template <size_t Bytes, size_t Align>
+void slab_alloc_template<Bytes, Align>::M_release(thread_cache& tc)
+{
+    M_register(tc);
+    if (tc.max_length < ESlabTransferBatch)
+    {   // 只释放、从不分配的线程（比如消费者）第一次走到这里
+        tc.max_length = ESlabTransferBatch;
+        return;
+    }
+    FreeList* head = tc.list;
+    FreeList* tail = head;
+    for (size_t i = 1; i < ESlabTransferBatch; ++i)
+        tail = tail->next;
+    tc.list = tail->next;
+    tc.length -= ESlabTransferBatch;
+    M_central_insert(head, tail);
+}
+
+// 把线程缓存中的区块（包括 slab 中尚未切分的部分）归还全局链表
+template <size_t Bytes, size_t Align>
+void slab_alloc_template<Bytes, Align>::M_flush(thread_cache& tc)
+{
+    for (; tc.slab_cur != tc.slab_end; tc.slab_cur += object_bytes)
+    {
+        FreeList* q = reinterpret_cast<FreeList*>(tc.slab_cur);
+        q->next = tc.list;
+        tc.list = q;
+    }
+    if (tc.list == nullptr)
+        return;
+    FreeList* tail = tc.list;
+    while (tail->next != nullptr)
+        tail = tail->next;
+    M_central_insert(tc.list, tail);
+    tc.list = nullptr;
+    tc.length = 0;
+}
+
+// 把 [head, tail] 这条链表放入全局链表
+template <size_t Bytes, size_t Align>
+void slab_alloc_template<Bytes, Align>::M_central_insert(FreeList* head, FreeList* tail)
+{
+    std::lock_guard<std::mutex> guard(central.mutex);
+    tail->next = central.list;
+    central.list = head;
+}
+
+// 模板类：slab_allocator
+// 与 allocator 的接口相同，单个对象从 slab 中分配，适合作为链表、树等节点式容器的配置器
+// 一次分配多个对象时退化为 ::operator new
+template <class T>
+class slab_allocator
+{
+public:
+    typedef T           value_type;
+    typedef T*          pointer;
+    typedef const T*    const_pointer;
+    typedef T&          reference;
+    typedef const T&    const_reference;
+    typedef size_t      size_type;
+    typedef ptrdiff_t   difference_type;
+
+    template <class U>
+    struct rebind
+    {
+        typedef slab_allocator<U> other;
+    };
+
+private:
+    typedef slab_alloc_template<sizeof(T), alignof(T)> slab_alloc;
+
+public:
+    static T* allocate();
+    static T* allocate(size_type n);
+
+    static void deallocate(T* ptr);
+    static void deallocate(T* ptr, size_type n);
+
+    static void construct(T* ptr);
+    static void construct(T* ptr, const T& value);
+    static void construct(T* ptr, T&& value);
+
+    template <class... Args>
+    static void construct(T* ptr, Args&& ...args);
+
+    static void destroy(T* ptr);
+    static void destroy(T* first, T* last);
+};
+
+template <class T>
+T* slab_allocator<T>::allocate()
+{
+    return static_cast<T*>(slab_alloc::allocate());
+}
+
+template <class T>
+T* slab_allocator<T>::allocate(size_type n)
+{
+    if (n == 0)
+        return nullptr;
+    if (n == 1)
+        return allocate();
+    return static_cast<T*>(::operator new(n * sizeof(T)));
+}
+
+// 不带大小的版本只能用来释放 allocate() 得到的单个对象
+template <class T>
+void slab_allocator<T>::deallocate(T* ptr)
+{
+    slab_alloc::deallocate(ptr);
+}
+
+// n 必须与 allocate(n) 时相同
+template <class T>
+void slab_allocator<T>::deallocate(T* ptr, size_type n)
+{
+    if (ptr == nullptr)
+        return;
+    if (n == 1)
+        slab_alloc::deallocate(ptr);
+    else
+        ::operator delete(ptr);
+}
+
+template <class T>
+void slab_allocator<T>::construct(T* ptr)
+{
+    ctstl::construct(ptr);
+}
+
+template <class T>
+void slab_allocator<T>::construct(T* ptr, const T& value)
+{
+    ctstl::construct(ptr, value);
+}
+
+template <class T>
+void slab_allocator<T>::construct(T* ptr, T&& value)
+{
+    ctstl::construct(ptr, ctstl::move(value));
+}
+
+template <class T>
+template <class ...Args>
+void slab_allocator<T>::construct(T* ptr, Args&& ...args)
+{
+    ctstl::construct(ptr, ctstl::forward<Args>(args)...);
+}
+
+template <class T>
+void slab_allocator<T>::destroy(T* ptr)
+{
+    ctstl::destroy(ptr);
+}
+
+template <class T>
+void slab_allocator<T>::destroy(T* first, T* last)
+{
+    ctstl::destroy(first, last);
+}
+
+} // namespace ctstl
+#endif // !CTSTL_SLAB_ALLOC_H_
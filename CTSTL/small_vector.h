@@ -0,0 +1,734 @@
+#ifndef CTSTL_SMALL_VECTOR_H_
+#define CTSTL_SMALL_VECTOR_H_
+
+// 这个头文件包含一个模板类 small_vector
+// small_vector : 带内联存储的向量，元素个数不超过 N 时存放在对象内部，不需要分配堆内存
+// 超过 N 个元素时转移到由 Alloc 分配的堆空间，增长与搬移元素的方式与 vector 相同（共用 vector.h 中的辅助函数）
+
+#include <initializer_list>
+#include <type_traits>
+
+#include "iterator.h"
+#include "memory.h"
+#include "util.h"
+#include "exceptdef.h"
+#include "vector.h"
+
+namespace ctstl
+{
+
+// 模板类: small_vector
+// 模板参数 T 代表类型，N 代表内联存储的元素个数，Alloc 代表堆空间使用的配置器
+// 紧凑的布局：元素个数与“是否在堆上”的标志合用一个 size_t（最低位为标志），
+// 堆指针、堆容量与内联存储共用同一块空间，因此 sizeof(small_vector) == sizeof(size_t) + max(N * sizeof(T), 2 * sizeof(void*))
+// 由于不保存指向自身的指针，元素与配置器可以平凡重定位时 small_vector 也可以
+template <class T, size_t N, class Alloc = ctstl::allocator<T>>
+class small_vector
+{
+    static_assert(N > 0, "small_vector needs at least one inline element");
+
+public:
+    // small_vector 的嵌套型别定义
+    typedef Alloc                                    allocator_type;
+
+    typedef T                                        value_type;
+    typedef value_type*                              pointer;
+    typedef const value_type*                        const_pointer;
+    typedef value_type&                              reference;
+    typedef const value_type&                        const_reference;
+    typedef size_t                                   size_type;
+    typedef ptrdiff_t                                difference_type;
+
+    typedef value_type*                              iterator;
+    typedef const value_type*                        const_iterator;
+    typedef ctstl::reverse_iterator<iterator>        reverse_iterator;
+    typedef ctstl::reverse_iterator<const_iterator>  const_reverse_iterator;
+
+    allocator_type get_allocator() const { return size_.first(); }
+
+private:
+    struct heap_storage
+    {
+        pointer   data;
+        size_type cap;
+    };
+
+    union storage
+    {
+        heap_storage heap;
+        typename std::aligned_storage<sizeof(T) * N, alignof(T)>::type buf;
+    };
+
+    compressed_pair<allocator_type, size_type> size_;  // 配置器，以及 (元素个数 << 1) | 是否在堆上
+    storage                                    storage_;
+
+public:
+    // 构造、复制、移动、析构函数
+    small_vector() noexcept
+        : size_(allocator_type(), 0)
+    {
+    }
+
+    explicit small_vector(const allocator_type& a) noexcept
+        : size_(a, 0)
+    {
+    }
+
+    explicit small_vector(size_type n, const allocator_type& a = allocator_type())
+        : size_(a, 0)
+    {
+        resize(n);
+    }
+
+    small_vector(size_type n, const value_type& value, const allocator_type& a = allocator_type())
+        : size_(a, 0)
+    {
+        insert(end(), n, value);
+    }
+
+    template <class Iter, typename std::enable_if<
+        ctstl::is_input_iterator<Iter>::value, int>::type = 0>
+    small_vector(Iter first, Iter last, const allocator_type& a = allocator_type())
+        : size_(a, 0)
+    {
+        init_from(first, last);
+    }
+
+    small_vector(const small_vector& rhs)
+        : size_(rhs.size_.first(), 0)
+    {
+        init_from(rhs.begin(), rhs.end());
+    }
+
+    small_vector(small_vector&& rhs) noexcept(std::is_nothrow_move_constructible<T>::value)
+        : size_(ctstl::move(rhs.size_.first()), 0)
+    {
+        steal(rhs);
+    }
+
+    small_vector(std::initializer_list<value_type> ilist, const allocator_type& a = allocator_type())
+        : size_(a, 0)
+    {
+        init_from(ilist.begin(), ilist.end());
+    }
+
+    small_vector& operator=(const small_vector& rhs)
+    {
+        if (this != &rhs)
+            assign(rhs.begin(), rhs.end());
+        return *this;
+    }
+
+    // 配置器保持不变：与 rhs 的配置器相等时接管 rhs 的元素，否则在自己的空间中逐个移动元素
+    small_vector& operator=(small_vector&& rhs)
+        noexcept(std::is_nothrow_move_constructible<T>::value && std::is_empty<Alloc>::value)
+    {
+        if (this == &rhs)
+            return *this;
+        if (ctstl::allocator_equal(size_.first(), rhs.size_.first()))
+        {
+            release();
+            steal(rhs);
+        }
+        else
+        {
+            clear();
+            reserve(rhs.size());
+            ctstl::uninitialized_move(rhs.begin(), rhs.end(), data());
+            set_size(rhs.size());
+            rhs.clear();
+        }
+        return *this;
+    }
+
+    small_vector& operator=(std::initializer_list<value_type> ilist)
+    {
+        assign(ilist.begin(), ilist.end());
+        return *this;
+    }
+
+    ~small_vector()
+    {
+        release();
+    }
+
+public:
+    // 迭代器相关操作
+    iterator               begin()         noexcept { return data(); }
+    const_iterator         begin()   const noexcept { return data(); }
+    iterator               end()           noexcept { return data() + size(); }
+    const_iterator         end()     const noexcept { return data() + size(); }
+
+    reverse_iterator       rbegin()        noexcept { return reverse_iterator(end()); }
+    const_reverse_iterator rbegin()  const noexcept { return const_reverse_iterator(end()); }
+    reverse_iterator       rend()          noexcept { return reverse_iterator(begin()); }
+    const_reverse_iterator rend()    const noexcept { return const_reverse_iterator(begin()); }
+
+    const_iterator         cbegin()  const noexcept { return begin(); }
+    const_iterator         cend()    const noexcept { return end(); }
+    const_reverse_iterator crbegin() const noexcept { return rbegin(); }
+    const_reverse_iterator crend()   const noexcept { return rend(); }
+
+    // 容量相关操作
+    bool      empty()    const noexcept { return size() == 0; }
+    size_type size()     const noexcept { return size_.second() >> 1; }
+    size_type max_size() const noexcept { return (static_cast<size_type>(-1) >> 1) / sizeof(T); }
+    size_type capacity() const noexcept { return is_inline() ? N : storage_.heap.cap; }
+
+    // 元素是否存放在内联存储中
+    bool      is_inline() const noexcept { return (size_.second() & 1) == 0; }
+
+    void      reserve(size_type n);
+    void      shrink_to_fit();
+
+    // 访问元素相关操作
+    reference operator[](size_type n)
+    {
+        CTSTL_DEBUG(n < size());
+        return data()[n];
+    }
+    const_reference operator[](size_type n) const
+    {
+        CTSTL_DEBUG(n < size());
+        return data()[n];
+    }
+    reference at(size_type n)
+    {
+        THROW_OUT_RANGE_IF(!(n < size()), "small_vector<T, N>::at() subscript out of range");
+        return (*this)[n];
+    }
+    const_reference at(size_type n) const
+    {
+        THROW_OUT_RANGE_IF(!(n < size()), "small_vector<T, N>::at() subscript out of range");
+        return (*this)[n];
+    }
+
+    reference front()
+    {
+        CTSTL_DEBUG(!empty());
+        return *begin();
+    }
+    const_reference front() const
+    {
+        CTSTL_DEBUG(!empty());
+        return *begin();
+    }
+    reference back()
+    {
+        CTSTL_DEBUG(!empty());
+        return *(end() - 1);
+    }
+    const_reference back() const
+    {
+        CTSTL_DEBUG(!empty());
+        return *(end() - 1);
+    }
+
+    pointer data() noexcept
+    {
+        return is_inline() ? reinterpret_cast<pointer>(&storage_.buf) : storage_.heap.data;
+    }
+    const_pointer data() const noexcept
+    {
+        return is_inline() ? reinterpret_cast<const_pointer>(&storage_.buf) : storage_.heap.data;
+    }
+
+    // 修改容器相关操作
+
+    // assign
+    void assign(size_type n, const value_type& value)
+    {
+        clear();
+        insert(end(), n, value);
+    }
+
+    template <class Iter, typename std::enable_if<
+        ctstl::is_input_iterator<Iter>::value, int>::type = 0>
+    void assign(Iter first, Iter last)
+    {
+        clear();
+        insert(end(), first, last);
+    }
+
+    void assign(std::initializer_list<value_type> ilist)
+    {
+        assign(ilist.begin(), ilist.end());
+    }
+
+    // emplace / emplace_back
+    template <class... Args>
+    iterator emplace(const_iterator pos, Args&& ...args);
+
+    template <class... Args>
+    reference emplace_back(Args&& ...args);
+
+    // push_back / pop_back
+    void push_back(const value_type& value) { emplace_back(value); }
+    void push_back(value_type&& value)      { emplace_back(ctstl::move(value)); }
+
+    void pop_back()
+    {
+        CTSTL_DEBUG(!empty());
+        ctstl::destroy(end() - 1);
+        set_size(size() - 1);
+    }
+
+    // insert
+    iterator insert(const_iterator pos, const value_type& value)
+    {
+        return emplace(pos, value);
+    }
+    iterator insert(const_iterator pos, value_type&& value)
+    {
+        return emplace(pos, ctstl::move(value));
+    }
+
+    iterator insert(const_iterator pos, size_type n, const value_type& value);
+
+    template <class Iter, typename std::enable_if<
+        ctstl::is_input_iterator<Iter>::value, int>::type = 0>
+    iterator insert(const_iterator pos, Iter first, Iter last)
+    {
+        CTSTL_DEBUG(pos >= begin() && pos <= end());
+        return range_insert(const_cast<iterator>(pos), first, last, iterator_category(first));
+    }
+
+    iterator insert(const_iterator pos, std::initializer_list<value_type> ilist)
+    {
+        return insert(pos, ilist.begin(), ilist.end());
+    }
+
+    // erase / clear
+    iterator erase(const_iterator pos);
+    iterator erase(const_iterator first, const_iterator last);
+    void     clear() noexcept
+    {
+        ctstl::destroy(begin(), end());
+        set_size(0);
+    }
+
+    // resize
+    void resize(size_type new_size) { resize_impl(new_size); }
+    void resize(size_type new_size, const value_type& value) { resize_impl(new_size, value); }
+
+    void swap(small_vector& rhs);
+
+private:
+    // helper functions
+
+    void set_size(size_type n) noexcept
+    {
+        size_.second() = (n << 1) | (size_.second() & 1);
+    }
+
+    // 改为使用堆空间 [data, data + cap)
+    void set_heap(pointer data, size_type cap, size_type n) noexcept
+    {
+        storage_.heap.data = data;
+        storage_.heap.cap = cap;
+        size_.second() = (n << 1) | 1;
+    }
+
+    // 析构所有元素并释放堆空间，之后回到空的内联状态
+    void release() noexcept
+    {
+        ctstl::destroy(begin(), end());
+        if (!is_inline())
+            size_.first().deallocate(storage_.heap.data, storage_.heap.cap);
+        size_.second() = 0;
+    }
+
+    // 从空的 *this 接管 rhs 的元素：堆空间直接接管指针，内联存储逐个搬移
+    void steal(small_vector& rhs);
+
+    template <class Iter>
+    void init_from(Iter first, Iter last)
+    {
+        try
+        {
+            insert(end(), first, last);
+        }
+        catch (...)
+        {
+            release();
+            throw;
+        }
+    }
+
+    // 把元素搬到容量为 new_cap 的堆空间
+    void reallocate(size_type new_cap);
+
+    // 在 pos 处插入 n 个由 construct_gap 构造的元素，容量不足时转移到更大的堆空间
+    template <class ConstructGap>
+    iterator insert_n(iterator pos, size_type n, ConstructGap construct_gap);
+
+    template <class IIter>
+    iterator range_insert(iterator pos, IIter first, IIter last, ctstl::input_iterator_tag);
+    template <class FIter>
+    iterator range_insert(iterator pos, FIter first, FIter last, ctstl::forward_iterator_tag);
+
+    template <class... Value>
+    void resize_impl(size_type new_size, const Value&... value);
+};
+
+/*****************************************************************************************/
+
+// 预留空间大小，超过内联容量时转移到堆空间
+template <class T, size_t N, class Alloc>
+void small_vector<T, N, Alloc>::reserve(size_type n)
+{
+    if (capacity() < n)
+    {
+        THROW_LENGTH_ERROR_IF(n > max_size(),
+                              "n can not larger than max_size() in small_vector<T, N>::reserve(n)");
+        reallocate(n);
+    }
+}
+
+// 放弃多余的容量，元素个数不超过 N 时回到内联存储
+template <class T, size_t N, class Alloc>
+void small_vector<T, N, Alloc>::shrink_to_fit()
+{
+    if (is_inline() || size() == capacity())
+        return;
+    if (size() > N)
+    {
+        reallocate(size());
+        return;
+    }
+    // 内联存储与堆指针共用空间，先保存堆空间的信息，搬移失败时再恢复，容器保持不变
+    const heap_storage heap = storage_.heap;
+    const size_type n = size();
+    pointer buf = reinterpret_cast<pointer>(&storage_.buf);
+    try
+    {
+        ctstl::vector_transfer(heap.data, heap.data + n, buf);
+    }
+    catch (...)
+    {
+        storage_.heap = heap;
+        throw;
+    }
+    ctstl::vector_destroy_transferred(heap.data, heap.data + n);
+    size_.first().deallocate(heap.data, heap.cap);
+    size_.second() = n << 1;
+}
+
+// 在 pos 位置就地构造元素
+template <class T, size_t N, class Alloc>
+template <class... Args>
+typename small_vector<T, N, Alloc>::iterator
+small_vector<T, N, Alloc>::emplace(const_iterator pos, Args&& ...args)
+{
+    CTSTL_DEBUG(pos >= begin() && pos <= end());
+    iterator xpos = const_cast<iterator>(pos);
+    if (xpos == end())
+        return &emplace_back(ctstl::forward<Args>(args)...);
+    if (size() < capacity())
+    {
+        // 参数可能引用容器中的元素，先构造出来再移动到位
+        value_type tmp(ctstl::forward<Args>(args)...);
+        return insert_n(xpos, 1, [&](iterator p)
+        {
+            ctstl::construct(p, ctstl::move(tmp));
+        });
+    }
+    return insert_n(xpos, 1, [&](iterator p)
+    {
+        ctstl::construct(p, ctstl::forward<Args>(args)...);
+    });
+}
+
+// 在尾部就地构造元素
+template <class T, size_t N, class Alloc>
+template <class... Args>
+typename small_vector<T, N, Alloc>::reference
+small_vector<T, N, Alloc>::emplace_back(Args&& ...args)
+{
+    const size_type n = size();
+    if (n < capacity())
+    {
+        pointer p = data() + n;
+        ctstl::construct(p, ctstl::forward<Args>(args)...);
+        set_size(n + 1);
+        return *p;
+    }
+    return *insert_n(end(), 1, [&](iterator p)
+    {
+        ctstl::construct(p, ctstl::forward<Args>(args)...);
+    });
+}
+
+// 在 pos 处插入 n 个元素
+template <class T, size_t N, class Alloc>
+typename small_vector<T, N, Alloc>::iterator
+small_vector<T, N, Alloc>::insert(const_iterator pos, size_type n, const value_type& value)
+{
+    CTSTL_DEBUG(pos >= begin() && pos <= end());
+    iterator xpos = const_cast<iterator>(pos);
+    if (size() + n <= capacity())
+    {
+        const value_type value_copy = value;  // value 可能引用容器中的元素
+        return insert_n(xpos, n, [&](iterator p)
+        {
+            ctstl::uninitialized_fill_n(p, n, value_copy);
+        });
+    }
+    return insert_n(xpos, n, [&](iterator p)
+    {
+        ctstl::uninitialized_fill_n(p, n, value);
+    });
+}
+
+// 删除 pos 位置上的元素
+template <class T, size_t N, class Alloc>
+typename small_vector<T, N, Alloc>::iterator
+small_vector<T, N, Alloc>::erase(const_iterator pos)
+{
+    CTSTL_DEBUG(pos >= begin() && pos < end());
+    return erase(pos, pos + 1);
+}
+
+// 删除[first, last)上的元素
+template <class T, size_t N, class Alloc>
+typename small_vector<T, N, Alloc>::iterator
+small_vector<T, N, Alloc>::erase(const_iterator first, const_iterator last)
+{
+    CTSTL_DEBUG(first >= begin() && last <= end() && !(last < first));
+    iterator xfirst = const_cast<iterator>(first);
+    iterator xlast = const_cast<iterator>(last);
+    if (xfirst == xlast)
+        return xfirst;
+    iterator old_end = end();
+    if (is_trivially_relocatable<T>::value)
+    {
+        // 先析构被删除的元素，再把后面的元素按位前移
+        ctstl::destroy(xfirst, xlast);
+        ctstl::uninitialized_relocate(xlast, old_end, xfirst);
+    }
+    else
+    {
+        iterator new_end = ctstl::move(xlast, old_end, xfirst);
+        ctstl::destroy(new_end, old_end);
+    }
+    set_size(size() - static_cast<size_type>(xlast - xfirst));
+    return xfirst;
+}
+
+// 与另一个 small_vector 交换
+// 两边都在堆上时只交换指针，否则需要搬移内联存储中的元素
+// 不交换配置器，两个 small_vector 的配置器必须相等
+template <class T, size_t N, class Alloc>
+void small_vector<T, N, Alloc>::swap(small_vector& rhs)
+{
+    if (this == &rhs)
+        return;
+    CTSTL_DEBUG(ctstl::allocator_equal(size_.first(), rhs.size_.first()));
+    if (!is_inline() && !rhs.is_inline())
+    {
+        ctstl::swap(size_.second(), rhs.size_.second());
+        ctstl::swap(storage_.heap, rhs.storage_.heap);
+        return;
+    }
+    small_vector tmp(ctstl::move(rhs));
+    rhs = ctstl::move(*this);
+    *this = ctstl::move(tmp);
+}
+
+/*****************************************************************************************/
+// helper function
+
+// steal 函数
+template <class T, size_t N, class Alloc>
+void small_vector<T, N, Alloc>::steal(small_vector& rhs)
+{
+    if (!rhs.is_inline())
+    {
+        storage_.heap = rhs.storage_.heap;
+        size_.second() = rhs.size_.second();
+        rhs.size_.second() = 0;
+        return;
+    }
+    const size_type n = rhs.size();
+    pointer src = rhs.data();
+    ctstl::uninitialized_relocate(src, src + n, reinterpret_cast<pointer>(&storage_.buf));
+    size_.second() = n << 1;
+    rhs.size_.second() = 0;
+}
+
+// reallocate 函数
+template <class T, size_t N, class Alloc>
+void small_vector<T, N, Alloc>::reallocate(size_type new_cap)
+{
+    pointer new_data = size_.first().allocate(new_cap);
+    const size_type n = size();
+    pointer old_data = data();
+    try
+    {
+        ctstl::vector_transfer(old_data, old_data + n, new_data);
+    }
+    catch (...)
+    {
+        size_.first().deallocate(new_data, new_cap);
+        throw;
+    }
+    ctstl::vector_destroy_transferred(old_data, old_data + n);
+    if (!is_inline())
+        size_.first().deallocate(old_data, storage_.heap.cap);
+    set_heap(new_data, new_cap, n);
+}
+
+// insert_n 函数
+template <class T, size_t N, class Alloc>
+template <class ConstructGap>
+typename small_vector<T, N, Alloc>::iterator
+small_vector<T, N, Alloc>::insert_n(iterator pos, size_type n, ConstructGap construct_gap)
+{
+    if (n == 0)
+        return pos;
+    const size_type old_size = size();
+    if (capacity() - old_size >= n)
+    {
+        iterator last = end();
+        try
+        {
+            ctstl::vector_insert_in_place(pos, last, n, construct_gap);
+        }
+        catch (...)
+        {
+            set_size(static_cast<size_type>(last - data()));
+            throw;
+        }
+        set_size(old_size + n);
+        return pos;
+    }
+    // 容量不足，转移到更大的堆空间，全部成功之后才析构、释放旧空间
+    const size_type new_cap = ctstl::vector_grow_capacity(capacity(), n, max_size());
+    pointer new_data = size_.first().allocate(new_cap);
+    pointer old_data = data();
+    iterator gap;
+    try
+    {
+        gap = ctstl::vector_transfer_insert(old_data, pos, old_data + old_size, new_data, n,
+                                            construct_gap);
+    }
+    catch (...)
+    {
+        size_.first().deallocate(new_data, new_cap);
+        throw;
+    }
+    ctstl::vector_destroy_transferred(old_data, old_data + old_size);
+    if (!is_inline())
+        size_.first().deallocate(old_data, storage_.heap.cap);
+    set_heap(new_data, new_cap, old_size + n);
+    return gap;
+}
+
+// range_insert 函数
+template <class T, size_t N, class Alloc>
+template <class IIter>
+typename small_vector<T, N, Alloc>::iterator
+small_vector<T, N, Alloc>::range_insert(iterator pos, IIter first, IIter last, ctstl::input_iterator_tag)
+{
+    const difference_type offset = pos - begin();
+    for (; first != last; ++first, ++pos)
+        pos = emplace(pos, *first);
+    return begin() + offset;
+}
+
+template <class T, size_t N, class Alloc>
+template <class FIter>
+typename small_vector<T, N, Alloc>::iterator
+small_vector<T, N, Alloc>::range_insert(iterator pos, FIter first, FIter last, ctstl::forward_iterator_tag)
+{
+    const size_type n = static_cast<size_type>(ctstl::distance(first, last));
+    return insert_n(pos, n, [&](iterator p)
+    {
+        ctstl::uninitialized_copy(first, last, p);
+    });
+}
+
+// resize_impl 函数，value 为空时值初始化新的元素
+template <class T, size_t N, class Alloc>
+template <class... Value>
+void small_vector<T, N, Alloc>::resize_impl(size_type new_size, const Value&... value)
+{
+    const size_type old_size = size();
+    if (new_size < old_size)
+    {
+        erase(begin() + new_size, end());
+    }
+    else if (new_size > old_size)
+    {
+        const size_type n = new_size - old_size;
+        insert_n(end(), n, [&](iterator p)
+        {
+            iterator cur = p;
+            try
+            {
+                for (size_type i = 0; i < n; ++i, ++cur)
+                    ctstl::construct(cur, value...);
+            }
+            catch (...)
+            {
+                ctstl::destroy(p, cur);
+                throw;
+            }
+        });
+    }
+}
+
+/*****************************************************************************************/
+// 重载比较操作符
+
+template <class T, size_t N, class Alloc>
+bool operator==(const small_vector<T, N, Alloc>& lhs, const small_vector<T, N, Alloc>& rhs)
+{
+    return lhs.size() == rhs.size() &&
+        ctstl::equal(lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
+}
+
+template <class T, size_t N, class Alloc>
+bool operator<(const small_vector<T, N, Alloc>& lhs, const small_vector<T, N, Alloc>& rhs)
+{
+    return ctstl::lexicographical_compare(lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
+}
+
+template <class T, size_t N, class Alloc>
+bool operator!=(const small_vector<T, N, Alloc>& lhs, const small_vector<T, N, Alloc>& rhs)
+{
+    return !(lhs == rhs);
+}
+
+template <class T, size_t N, class Alloc>
+bool operator>(const small_vector<T, N, Alloc>& lhs, const small_vector<T, N, Alloc>& rhs)
+{
+    return rhs < lhs;
+}
+
+template <class T, size_t N, class Alloc>
+bool operator<=(const small_vector<T, N, Alloc>& lhs, const small_vector<T, N, Alloc>& rhs)
+{
+    return !(rhs < lhs);
+}
+
+template <class T, size_t N, class Alloc>
+bool operator>=(const small_vector<T, N, Alloc>& lhs, const small_vector<T, N, Alloc>& rhs)
+{
+    return !(lhs < rhs);
+}
+
+// 重载 ctstl 的 swap
+template <class T, size_t N, class Alloc>
+void swap(small_vector<T, N, Alloc>& lhs, small_vector<T, N, Alloc>& rhs)
+{
+    lhs.swap(rhs);
+}
+
+template <class T, size_t N, class Alloc>
+struct is_trivially_relocatable<small_vector<T, N, Alloc>>
+    : std::integral_constant<bool, is_trivially_relocatable<T>::value &&
+                                   is_trivially_relocatable<Alloc>::value> {};
+
+} // namespace ctstl
+#endif // !CTSTL_SMALL_VECTOR_H_
@@ -0,0 +1,710 @@
+#ifndef CTSTL_SOA_VECTOR_H_
+#define CTSTL_SOA_VECTOR_H_
+
+// 这个头文件包含一个模板类 soa_vector
+// soa_vector : 按列存放的向量（structure of arrays），每个字段保存在各自连续、按 cache line 对齐的数组中，
+//              只读取一两个字段的扫描只会把这些列读进 cache
+//
+// 1. 迭代器的 reference 是什么？
+// 一个元素分散在各列中，迭代器的 reference 是代理类型 std::tuple<Ts&...>，value_type 是 std::tuple<Ts...>；
+// 迭代器满足 random_access_iterator_tag，可以用于 copy、fill、equal 等只通过 *it 读写元素的算法，
+// 但不能取得元素的地址（operator-> / iter_swap）。
+//
+// 2. 如何对一列使用 algobase.h 中的快速路径？
+// column<I>() 返回第 I 列的 soa_span，begin() / end() 是普通指针，
+// 可平凡复制的列传给 ctstl::copy / fill 等算法时会走 memmove / memset 的路径，循环也可以被编译器向量化。
+
+#include <initializer_list>
+#include <tuple>
+#include <type_traits>
+
+#include "aligned_allocator.h"
+#include "iterator.h"
+#include "util.h"
+#include "exceptdef.h"
+#include "vector.h"
+
+namespace ctstl
+{
+
+// 每一列的起始地址至少按这个大小对齐
+enum { ESoaColumnAlign = 64 };
+
+// 模板类: soa_span
+// 连续数组的一段，[data, data + size)
+template <class T>
+class soa_span
+{
+public:
+    typedef T         value_type;
+    typedef T*        pointer;
+    typedef T&        reference;
+    typedef T*        iterator;
+    typedef size_t    size_type;
+
+private:
+    T*     data_;
+    size_t size_;
+
+public:
+    soa_span() noexcept : data_(nullptr), size_(0) {}
+    soa_span(T* data, size_t size) noexcept : data_(data), size_(size) {}
+
+    iterator  begin() const noexcept { return data_; }
+    iterator  end()   const noexcept { return data_ + size_; }
+    pointer   data()  const noexcept { return data_; }
+    size_type size()  const noexcept { return size_; }
+    bool      empty() const noexcept { return size_ == 0; }
+
+    reference operator[](size_type n) const
+    {
+        CTSTL_DEBUG(n < size_);
+        return data_[n];
+    }
+};
+
+// 模板类: soa_iterator
+// 保存每一列的起始地址和元素下标，Ps 为各列的元素类型（const 迭代器为 const Ts）
+template <class... Ps>
+class soa_iterator : public ctstl::iterator<ctstl::random_access_iterator_tag,
+                                            std::tuple<typename std::remove_const<Ps>::type...>,
+                                            ptrdiff_t, void, std::tuple<Ps&...>>
+{
+    template <class... Qs> friend class soa_iterator;
+
+public:
+    typedef std::tuple<Ps&...>  reference;
+    typedef ptrdiff_t           difference_type;
+    typedef soa_iterator        self;
+
+private:
+    std::tuple<Ps*...> cols_;
+    difference_type    i_;
+
+public:
+    soa_iterator() : cols_(), i_(0) {}
+    soa_iterator(const std::tuple<Ps*...>& cols, difference_type i) : cols_(cols), i_(i) {}
+
+    // 非 const 迭代器可以转换为 const 迭代器
+    template <class... Qs, typename std::enable_if<
+        std::is_convertible<std::tuple<Qs*...>, std::tuple<Ps*...>>::value, int>::type = 0>
+    soa_iterator(const soa_iterator<Qs...>& rhs) : cols_(rhs.cols_), i_(rhs.i_) {}
+
+    reference operator*() const { return deref(i_, ctstl::make_index_sequence<sizeof...(Ps)>()); }
+    reference operator[](difference_type n) const
+    {
+        return deref(i_ + n, ctstl::make_index_sequence<sizeof...(Ps)>());
+    }
+
+    // 元素下标
+    difference_type index() const noexcept { return i_; }
+
+    self& operator++()                   { ++i_; return *this; }
+    self  operator++(int)                { self tmp = *this; ++i_; return tmp; }
+    self& operator--()                   { --i_; return *this; }
+    self  operator--(int)                { self tmp = *this; --i_; return tmp; }
+    self& operator+=(difference_type n)  { i_ += n; return *this; }
+    self& operator-=(difference_type n)  { i_ -= n; return *this; }
+    self  operator+(difference_type n) const { return self(cols_, i_ + n); }
+    self  operator-(difference_type n) const { return self(cols_, i_ - n); }
+
+    difference_type operator-(const self& rhs) const { return i_ - rhs.i_; }
+
+    bool operator==(const self& rhs) const { return i_ == rhs.i_; }
+    bool operator!=(const self& rhs) const { return i_ != rhs.i_; }
+    bool operator< (const self& rhs) const { return i_ < rhs.i_; }
+    bool operator> (const self& rhs) const { return i_ > rhs.i_; }
+    bool operator<=(const self& rhs) const { return i_ <= rhs.i_; }
+    bool operator>=(const self& rhs) const { return i_ >= rhs.i_; }
+
+private:
+    template <size_t... I>
+    reference deref(difference_type i, ctstl::index_sequence<I...>) const
+    {
+        return reference(std::get<I>(cols_)[i]...);
+    }
+};
+
+template <class... Ps>
+soa_iterator<Ps...> operator+(ptrdiff_t n, const soa_iterator<Ps...>& it)
+{
+    return it + n;
+}
+
+// 搬移一列时不会抛出异常：按位重定位，或者使用 noexcept 的移动构造（只能移动的类型也归为这一类，只提供基本保证）
+template <class T>
+struct soa_nothrow_transfer
+    : std::integral_constant<bool, is_trivially_relocatable<T>::value ||
+                                   std::is_nothrow_move_constructible<T>::value ||
+                                   !std::is_copy_constructible<T>::value> {};
+
+// 模板类: soa_vector
+// 模板参数 Ts 代表各列的类型
+// 所有列放在同一块按 ESoaColumnAlign 对齐的内存中，每一列的起始地址也按 ESoaColumnAlign 对齐
+template <class... Ts>
+class soa_vector
+{
+    static_assert(sizeof...(Ts) > 0, "soa_vector needs at least one column");
+
+public:
+    // soa_vector 的嵌套型别定义
+    typedef std::tuple<Ts...>                        value_type;
+    typedef std::tuple<Ts&...>                       reference;
+    typedef std::tuple<const Ts&...>                 const_reference;
+    typedef size_t                                   size_type;
+    typedef ptrdiff_t                                difference_type;
+
+    typedef soa_iterator<Ts...>                      iterator;
+    typedef soa_iterator<const Ts...>                const_iterator;
+    typedef ctstl::reverse_iterator<iterator>        reverse_iterator;
+    typedef ctstl::reverse_iterator<const_iterator>  const_reverse_iterator;
+
+    // 第 I 列的元素类型
+    template <size_t I>
+    using column_type = typename std::tuple_element<I, value_type>::type;
+
+    enum { ColumnCount = sizeof...(Ts) };
+
+private:
+    typedef ctstl::make_index_sequence<sizeof...(Ts)> indices;
+
+    std::tuple<Ts*...> cols_;  // 各列的起始地址，第 0 列的地址也是整块内存的地址
+    size_type          size_;
+    size_type          cap_;
+
+public:
+    // 构造、复制、移动、析构函数
+    soa_vector() noexcept
+        : cols_(), size_(0), cap_(0)
+    {
+    }
+
+    explicit soa_vector(size_type n)
+        : cols_(), size_(0), cap_(0)
+    {
+        resize(n);
+    }
+
+    soa_vector(std::initializer_list<value_type> ilist)
+        : cols_(), size_(0), cap_(0)
+    {
+        reserve(ilist.size());
+        for (const value_type& value : ilist)
+            push_back(value);
+    }
+
+    soa_vector(const soa_vector& rhs)
+        : cols_(), size_(0), cap_(0)
+    {
+        reserve(rhs.size_);
+        copy_columns(rhs, indices());
+    }
+
+    soa_vector(soa_vector&& rhs) noexcept
+        : cols_(rhs.cols_), size_(rhs.size_), cap_(rhs.cap_)
+    {
+        rhs.cols_ = std::tuple<Ts*...>();
+        rhs.size_ = rhs.cap_ = 0;
+    }
+
+    soa_vector& operator=(const soa_vector& rhs)
+    {
+        if (this != &rhs)
+        {
+            soa_vector tmp(rhs);
+            swap(tmp);
+        }
+        return *this;
+    }
+
+    soa_vector& operator=(soa_vector&& rhs) noexcept
+    {
+        if (this != &rhs)
+        {
+            soa_vector tmp(ctstl::move(rhs));
+            swap(tmp);
+        }
+        return *this;
+    }
+
+    ~soa_vector()
+    {
+        clear();
+        deallocate_block(std::get<0>(cols_), cap_);
+    }
+
+public:
+    // 迭代器相关操作
+    iterator               begin()         noexcept { return iterator(cols_, 0); }
+    const_iterator         begin()   const noexcept { return const_iterator(const_cols(), 0); }
+    iterator               end()           noexcept { return iterator(cols_, size_); }
+    const_iterator         end()     const noexcept { return const_iterator(const_cols(), size_); }
+
+    reverse_iterator       rbegin()        noexcept { return reverse_iterator(end()); }
+    const_reverse_iterator rbegin()  const noexcept { return const_reverse_iterator(end()); }
+    reverse_iterator       rend()          noexcept { return reverse_iterator(begin()); }
+    const_reverse_iterator rend()    const noexcept { return const_reverse_iterator(begin()); }
+
+    const_iterator         cbegin()  const noexcept { return begin(); }
+    const_iterator         cend()    const noexcept { return end(); }
+
+    // 容量相关操作
+    bool      empty()    const noexcept { return size_ == 0; }
+    size_type size()     const noexcept { return size_; }
+    size_type capacity() const noexcept { return cap_; }
+    size_type max_size() const noexcept
+    {
+        return static_cast<size_type>(-1) / (row_bytes() + ESoaColumnAlign);
+    }
+
+    void reserve(size_type n)
+    {
+        if (cap_ < n)
+        {
+            THROW_LENGTH_ERROR_IF(n > max_size(),
+                                  "n can not larger than max_size() in soa_vector<Ts...>::reserve(n)");
+            reallocate(n);
+        }
+    }
+
+    void shrink_to_fit()
+    {
+        if (size_ < cap_)
+            reallocate(size_);
+    }
+
+    // 访问元素相关操作
+    reference operator[](size_type n)
+    {
+        CTSTL_DEBUG(n < size_);
+        return begin()[n];
+    }
+    const_reference operator[](size_type n) const
+    {
+        CTSTL_DEBUG(n < size_);
+        return begin()[n];
+    }
+    reference at(size_type n)
+    {
+        THROW_OUT_RANGE_IF(!(n < size_), "soa_vector<Ts...>::at() subscript out of range");
+        return (*this)[n];
+    }
+    const_reference at(size_type n) const
+    {
+        THROW_OUT_RANGE_IF(!(n < size_), "soa_vector<Ts...>::at() subscript out of range");
+        return (*this)[n];
+    }
+
+    reference       front()       { CTSTL_DEBUG(!empty()); return (*this)[0]; }
+    const_reference front() const { CTSTL_DEBUG(!empty()); return (*this)[0]; }
+    reference       back()        { CTSTL_DEBUG(!empty()); return (*this)[size_ - 1]; }
+    const_reference back()  const { CTSTL_DEBUG(!empty()); return (*this)[size_ - 1]; }
+
+    // 按列访问
+    template <size_t I>
+    soa_span<column_type<I>> column() noexcept
+    {
+        return soa_span<column_type<I>>(std::get<I>(cols_), size_);
+    }
+    template <size_t I>
+    soa_span<const column_type<I>> column() const noexcept
+    {
+        return soa_span<const column_type<I>>(std::get<I>(cols_), size_);
+    }
+
+    template <size_t I>
+    column_type<I>*       data()       noexcept { return std::get<I>(cols_); }
+    template <size_t I>
+    const column_type<I>* data() const noexcept { return std::get<I>(cols_); }
+
+    // 修改容器相关操作
+
+    // emplace_back / push_back，每一列由一个参数构造
+    template <class... Args>
+    void emplace_back(Args&& ...args)
+    {
+        static_assert(sizeof...(Args) == sizeof...(Ts), "soa_vector::emplace_back needs one argument per column");
+        if (size_ == cap_)
+            grow_for_append(ctstl::forward<Args>(args)...);
+        else
+            construct_row(size_, indices(), ctstl::forward<Args>(args)...);
+        ++size_;
+    }
+
+    void push_back(const Ts&... values) { emplace_back(values...); }
+    void push_back(const value_type& value) { push_back_tuple(value, indices()); }
+    void push_back(value_type&& value)      { push_back_tuple(ctstl::move(value), indices()); }
+
+    void pop_back()
+    {
+        CTSTL_DEBUG(!empty());
+        --size_;
+        destroy_rows(size_, size_ + 1, indices());
+    }
+
+    // erase / clear
+    iterator erase(const_iterator pos)
+    {
+        CTSTL_DEBUG(pos >= cbegin() && pos < cend());
+        return erase(pos, pos + 1);
+    }
+    iterator erase(const_iterator first, const_iterator last);
+
+    void clear() noexcept
+    {
+        destroy_rows(0, size_, indices());
+        size_ = 0;
+    }
+
+    // resize，新的元素值初始化
+    void resize(size_type new_size);
+
+    void swap(soa_vector& rhs) noexcept
+    {
+        ctstl::swap(cols_, rhs.cols_);
+        ctstl::swap(size_, rhs.size_);
+        ctstl::swap(cap_, rhs.cap_);
+    }
+
+private:
+    // helper functions
+
+    std::tuple<const Ts*...> const_cols() const
+    {
+        return std::tuple<const Ts*...>(cols_);
+    }
+
+    static size_t row_bytes() noexcept
+    {
+        const size_t sizes[] = { sizeof(Ts)... };
+        size_t bytes = 0;
+        for (size_t s : sizes)
+            bytes += s;
+        return bytes;
+    }
+
+    static size_t block_align() noexcept
+    {
+        const size_t aligns[] = { alignof(Ts)... };
+        size_t align = ESoaColumnAlign;
+        for (size_t a : aligns)
+            align = a > align ? a : align;
+        return align;
+    }
+
+    // 容量为 cap 时整块内存的大小，offsets 得到每一列的偏移
+    static size_t block_bytes(size_type cap, size_t* offsets) noexcept
+    {
+        const size_t sizes[] = { sizeof(Ts)... };
+        const size_t align = block_align();
+        size_t bytes = 0;
+        for (size_t k = 0; k < sizeof...(Ts); ++k)
+        {
+            offsets[k] = bytes;
+            bytes += (sizes[k] * cap + align - 1) & ~(align - 1);
+        }
+        return bytes;
+    }
+
+    template <size_t... I>
+    static std::tuple<Ts*...> allocate_block(size_type cap, ctstl::index_sequence<I...>)
+    {
+        if (cap == 0)
+            return std::tuple<Ts*...>();
+        size_t offsets[sizeof...(Ts)];
+        const size_t bytes = block_bytes(cap, offsets);
+        char* block = static_cast<char*>(ctstl::aligned_operator_new(bytes, block_align()));
+        return std::tuple<Ts*...>(reinterpret_cast<Ts*>(block + offsets[I])...);
+    }
+
+    static void deallocate_block(void* block, size_type cap) noexcept
+    {
+        if (block != nullptr && cap != 0)
+            ctstl::aligned_operator_delete(block, block_align());
+    }
+
+    // 在第 row 行构造一个元素，某一列构造失败时析构已经构造的列
+    template <size_t... I, class... Args>
+    void construct_row(size_type row, ctstl::index_sequence<I...>, Args&& ...args)
+    {
+        size_t built = 0;
+        try
+        {
+            int unused[] = { 0, (ctstl::construct(std::get<I>(cols_) + row,
+                                                  ctstl::forward<Args>(args)), ++built, 0)... };
+            (void)unused;
+        }
+        catch (...)
+        {
+            int unused[] = { 0, (I < built ? ctstl::destroy(std::get<I>(cols_) + row) : void(), 0)... };
+            (void)unused;
+            throw;
+        }
+    }
+
+    // 值初始化第 row 行
+    template <size_t... I>
+    void value_init_row(size_type row, ctstl::index_sequence<I...>)
+    {
+        size_t built = 0;
+        try
+        {
+            int unused[] = { 0, (ctstl::construct(std::get<I>(cols_) + row), ++built, 0)... };
+            (void)unused;
+        }
+        catch (...)
+        {
+            int unused[] = { 0, (I < built ? ctstl::destroy(std::get<I>(cols_) + row) : void(), 0)... };
+            (void)unused;
+            throw;
+        }
+    }
+
+    template <size_t... I>
+    void destroy_rows(size_type first, size_type last, ctstl::index_sequence<I...>) noexcept
+    {
+        int unused[] = { 0, (ctstl::destroy(std::get<I>(cols_) + first, std::get<I>(cols_) + last), 0)... };
+        (void)unused;
+    }
+
+    template <class Tuple, size_t... I>
+    void push_back_tuple(Tuple&& value, ctstl::index_sequence<I...>)
+    {
+        emplace_back(std::get<I>(ctstl::forward<Tuple>(value))...);
+    }
+
+    // 容量已满时在尾部添加元素：参数可能引用容器中的元素，先在新空间中构造新元素，再搬移旧元素
+    template <class... Args>
+    void grow_for_append(Args&& ...args);
+
+    // 把元素搬到容量为 new_cap 的新空间
+    void reallocate(size_type new_cap);
+
+    // 把各列搬到 to 中，先搬可能抛出异常的列（复制），再搬不会抛出异常的列，失败时旧空间保持不变
+    template <size_t... I>
+    void transfer_columns(const std::tuple<Ts*...>& to, ctstl::index_sequence<I...>);
+
+    template <size_t I>
+    bool transfer_column(const std::tuple<Ts*...>& to, bool throwing_pass)
+    {
+        typedef column_type<I> T;
+        if (soa_nothrow_transfer<T>::value == throwing_pass)
+            return false;
+        ctstl::vector_transfer(std::get<I>(cols_), std::get<I>(cols_) + size_, std::get<I>(to));
+        return true;
+    }
+
+    template <size_t... I>
+    void destroy_transferred(ctstl::index_sequence<I...>) noexcept
+    {
+        int unused[] = { 0, (ctstl::vector_destroy_transferred(std::get<I>(cols_),
+                                                               std::get<I>(cols_) + size_), 0)... };
+        (void)unused;
+    }
+
+    template <size_t... I>
+    void copy_columns(const soa_vector& rhs, ctstl::index_sequence<I...>);
+
+    template <size_t... I>
+    void erase_rows(size_type first, size_type last, ctstl::index_sequence<I...>);
+
+    void construct_rows(size_type first, size_type last);
+};
+
+/*****************************************************************************************/
+
+// 删除[first, last)上的元素，每一列分别前移
+template <class... Ts>
+typename soa_vector<Ts...>::iterator
+soa_vector<Ts...>::erase(const_iterator first, const_iterator last)
+{
+    CTSTL_DEBUG(first >= cbegin() && last <= cend() && !(last < first));
+    const size_type f = static_cast<size_type>(first.index());
+    const size_type l = static_cast<size_type>(last.index());
+    if (f != l)
+    {
+        erase_rows(f, l, indices());
+        size_ -= l - f;
+    }
+    return begin() + f;
+}
+
+// resize
+template <class... Ts>
+void soa_vector<Ts...>::resize(size_type new_size)
+{
+    if (new_size < size_)
+    {
+        destroy_rows(new_size, size_, indices());
+        size_ = new_size;
+    }
+    else if (new_size > size_)
+    {
+        reserve(new_size);
+        construct_rows(size_, new_size);
+        size_ = new_size;
+    }
+}
+
+/*****************************************************************************************/
+// helper function
+
+// grow_for_append 函数
+template <class... Ts>
+template <class... Args>
+void soa_vector<Ts...>::grow_for_append(Args&& ...args)
+{
+    const size_type new_cap = ctstl::vector_grow_capacity(cap_, 1, max_size());
+    std::tuple<Ts*...> new_cols = allocate_block(new_cap, indices());
+    std::tuple<Ts*...> old_cols = cols_;
+    try
+    {
+        cols_ = new_cols;
+        construct_row(size_, indices(), ctstl::forward<Args>(args)...);
+    }
+    catch (...)
+    {
+        cols_ = old_cols;
+        deallocate_block(std::get<0>(new_cols), new_cap);
+        throw;
+    }
+    cols_ = old_cols;
+    try
+    {
+        transfer_columns(new_cols, indices());
+    }
+    catch (...)
+    {
+        ctstl::swap(cols_, new_cols);
+        destroy_rows(size_, size_ + 1, indices());
+        ctstl::swap(cols_, new_cols);
+        deallocate_block(std::get<0>(new_cols), new_cap);
+        throw;
+    }
+    destroy_transferred(indices());
+    deallocate_block(std::get<0>(cols_), cap_);
+    cols_ = new_cols;
+    cap_ = new_cap;
+}
+
+// reallocate 函数
+template <class... Ts>
+void soa_vector<Ts...>::reallocate(size_type new_cap)
+{
+    std::tuple<Ts*...> new_cols = allocate_block(new_cap, indices());
+    try
+    {
+        transfer_columns(new_cols, indices());
+    }
+    catch (...)
+    {
+        deallocate_block(std::get<0>(new_cols), new_cap);
+        throw;
+    }
+    destroy_transferred(indices());
+    deallocate_block(std::get<0>(cols_), cap_);
+    cols_ = new_cols;
+    cap_ = new_cap;
+}
+
+// transfer_columns 函数
+template <class... Ts>
+template <size_t... I>
+void soa_vector<Ts...>::transfer_columns(const std::tuple<Ts*...>& to, ctstl::index_sequence<I...>)
+{
+    bool copied[sizeof...(Ts)] = {};
+    try
+    {
+        int unused[] = { 0, (copied[I] = transfer_column<I>(to, true), 0)... };
+        (void)unused;
+    }
+    catch (...)
+    {
+        int unused[] = { 0, (copied[I] ? ctstl::destroy(std::get<I>(to), std::get<I>(to) + size_)
+                                       : void(), 0)... };
+        (void)unused;
+        throw;
+    }
+    int unused[] = { 0, (transfer_column<I>(to, false), 0)... };
+    (void)unused;
+}
+
+// copy_columns 函数，*this 为空并且容量足够
+template <class... Ts>
+template <size_t... I>
+void soa_vector<Ts...>::copy_columns(const soa_vector& rhs, ctstl::index_sequence<I...>)
+{
+    bool copied[sizeof...(Ts)] = {};
+    try
+    {
+        int unused[] = { 0, (ctstl::uninitialized_copy(std::get<I>(rhs.cols_),
+                                                       std::get<I>(rhs.cols_) + rhs.size_,
+                                                       std::get<I>(cols_)),
+                             copied[I] = true, 0)... };
+        (void)unused;
+    }
+    catch (...)
+    {
+        int unused[] = { 0, (copied[I] ? ctstl::destroy(std::get<I>(cols_), std::get<I>(cols_) + rhs.size_)
+                                       : void(), 0)... };
+        (void)unused;
+        throw;
+    }
+    size_ = rhs.size_;
+}
+
+// erase_rows 函数
+template <class... Ts>
+template <size_t... I>
+void soa_vector<Ts...>::erase_rows(size_type first, size_type last, ctstl::index_sequence<I...>)
+{
+    int unused[] = { 0, (ctstl::destroy(ctstl::move(std::get<I>(cols_) + last,
+                                                    std::get<I>(cols_) + size_,
+                                                    std::get<I>(cols_) + first),
+                                        std::get<I>(cols_) + size_),
+                         0)... };
+    (void)unused;
+}
+
+// construct_rows 函数，值初始化 [first, last) 行，失败时析构本次构造的元素
+template <class... Ts>
+void soa_vector<Ts...>::construct_rows(size_type first, size_type last)
+{
+    size_type row = first;
+    try
+    {
+        for (; row < last; ++row)
+            value_init_row(row, indices());
+    }
+    catch (...)
+    {
+        destroy_rows(first, row, indices());
+        throw;
+    }
+}
+
+/*****************************************************************************************/
+// 重载比较操作符
+
+template <class... Ts>
+bool operator==(const soa_vector<Ts...>& lhs, const soa_vector<Ts...>& rhs)
+{
+    return lhs.size() == rhs.size() &&
+        ctstl::equal(lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
+}
+
+template <class... Ts>
+bool operator!=(const soa_vector<Ts...>& lhs, const soa_vector<Ts...>& rhs)
+{
+    return !(lhs == rhs);
+}
+
+// 重载 ctstl 的 swap
+template <class... Ts>
+void swap(soa_vector<Ts...>& lhs, soa_vector<Ts...>& rhs) noexcept
+{
+    lhs.swap(rhs);
+}
+
+} // namespace ctstl
+#endif // !CTSTL_SOA_VECTOR_H_
@@ -0,0 +1,554 @@
+#ifndef CTSTL_STATIC_VECTOR_H_
+#define CTSTL_STATIC_VECTOR_H_
+
+// 这个头文件包含一个模板类 static_vector
+// static_vector : 容量固定为 N 的向量，元素存放在对象内部未初始化的存储中，从不分配堆内存，也没有退回堆内存的分支
+//
+// 1. 超出容量时怎么办？
+// 默认情况下超出容量是调用者的错误，只在调试模式下由 CTSTL_DEBUG 断言；
+// 定义了宏 CTSTL_STATIC_VECTOR_CHECKED 时，超出容量的插入抛出 std::length_error（THROW_LENGTH_ERROR_IF）
+//
+// 2. 哪些操作是 constexpr 的？
+// 元素通过 placement new 构造在原始字节中，C++20 之前常量求值不允许这样做，因此只有 capacity / max_size 是 constexpr 的
+
+#include <initializer_list>
+#include <type_traits>
+
+#include "construct.h"
+#include "iterator.h"
+#include "util.h"
+#include "exceptdef.h"
+#include "vector.h"
+
+#ifdef CTSTL_STATIC_VECTOR_CHECKED
+#define CTSTL_STATIC_VECTOR_CHECK(expr, what) THROW_LENGTH_ERROR_IF(!(expr), what)
+#else
+#define CTSTL_STATIC_VECTOR_CHECK(expr, what) CTSTL_DEBUG(expr)
+#endif // CTSTL_STATIC_VECTOR_CHECKED
+
+namespace ctstl
+{
+
+// 模板类: static_vector_storage
+// static_vector 的元素存储，T 可平凡复制时复制、移动与析构都是平凡的，static_vector 因此也是可平凡复制的
+template <class T, size_t N, bool = std::is_trivially_copyable<T>::value>
+class static_vector_storage
+{
+protected:
+    size_t                                                          size_;
+    typename std::aligned_storage<sizeof(T) * N, alignof(T)>::type buf_;
+
+    static_vector_storage() noexcept : size_(0) {}
+
+    T*       M_data()       noexcept { return reinterpret_cast<T*>(&buf_); }
+    const T* M_data() const noexcept { return reinterpret_cast<const T*>(&buf_); }
+};
+
+// T 不可平凡复制时，逐个复制、移动、析构元素
+template <class T, size_t N>
+class static_vector_storage<T, N, false>
+{
+protected:
+    size_t                                                          size_;
+    typename std::aligned_storage<sizeof(T) * N, alignof(T)>::type buf_;
+
+    static_vector_storage() noexcept : size_(0) {}
+
+    static_vector_storage(const static_vector_storage& rhs)
+        : size_(0)
+    {
+        for (; size_ < rhs.size_; ++size_)
+            ctstl::construct(M_data() + size_, rhs.M_data()[size_]);
+    }
+
+    static_vector_storage(static_vector_storage&& rhs)
+        noexcept(std::is_nothrow_move_constructible<T>::value)
+        : size_(0)
+    {
+        for (; size_ < rhs.size_; ++size_)
+            ctstl::construct(M_data() + size_, ctstl::move(rhs.M_data()[size_]));
+    }
+
+    static_vector_storage& operator=(const static_vector_storage& rhs)
+    {
+        if (this != &rhs)
+            M_assign<const T&>(rhs.M_data(), rhs.size_);
+        return *this;
+    }
+
+    static_vector_storage& operator=(static_vector_storage&& rhs)
+        noexcept(std::is_nothrow_move_constructible<T>::value &&
+                 std::is_nothrow_move_assignable<T>::value)
+    {
+        if (this != &rhs)
+            M_assign<T&&>(rhs.M_data(), rhs.size_);
+        return *this;
+    }
+
+    ~static_vector_storage()
+    {
+        ctstl::destroy(M_data(), M_data() + size_);
+    }
+
+    T*       M_data()       noexcept { return reinterpret_cast<T*>(&buf_); }
+    const T* M_data() const noexcept { return reinterpret_cast<const T*>(&buf_); }
+
+private:
+    // 前面的部分赋值，多出的部分构造或析构，Ref 为 const T& 时复制，为 T&& 时移动
+    template <class Ref, class U>
+    void M_assign(U* src, size_t n)
+    {
+        T* data = M_data();
+        size_t i = 0;
+        for (; i < n && i < size_; ++i)
+            data[i] = static_cast<Ref>(src[i]);
+        if (i < size_)
+        {
+            ctstl::destroy(data + i, data + size_);
+            size_ = i;
+        }
+        for (; size_ < n; ++size_)
+            ctstl::construct(data + size_, static_cast<Ref>(src[size_]));
+    }
+};
+
+// 模板类: static_vector
+// 模板参数 T 代表类型，N 代表容量
+// 迭代器是普通指针，与 vector 一样在中间插入、删除时使用 vector.h 中共用的元素搬移函数
+template <class T, size_t N>
+class static_vector : private static_vector_storage<T, N>
+{
+    static_assert(N > 0, "static_vector needs a non-zero capacity");
+
+    typedef static_vector_storage<T, N> base_type;
+    using base_type::size_;
+    using base_type::M_data;
+
+public:
+    // static_vector 的嵌套型别定义
+    typedef T                                        value_type;
+    typedef value_type*                              pointer;
+    typedef const value_type*                        const_pointer;
+    typedef value_type&                              reference;
+    typedef const value_type&                        const_reference;
+    typedef size_t                                   size_type;
+    typedef ptrdiff_t                                difference_type;
+
+    typedef value_type*                              iterator;
+    typedef const value_type*                        const_iterator;
+    typedef ctstl::reverse_iterator<iterator>        reverse_iterator;
+    typedef ctstl::reverse_iterator<const_iterator>  const_reverse_iterator;
+
+public:
+    // 构造函数，复制、移动、析构由 static_vector_storage 决定
+    static_vector() noexcept = default;
+
+    explicit static_vector(size_type n)
+    {
+        resize(n);
+    }
+
+    static_vector(size_type n, const value_type& value)
+    {
+        insert(end(), n, value);
+    }
+
+    template <class Iter, typename std::enable_if<
+        ctstl::is_input_iterator<Iter>::value, int>::type = 0>
+    static_vector(Iter first, Iter last)
+    {
+        insert(end(), first, last);
+    }
+
+    static_vector(std::initializer_list<value_type> ilist)
+    {
+        insert(end(), ilist.begin(), ilist.end());
+    }
+
+    static_vector& operator=(std::initializer_list<value_type> ilist)
+    {
+        assign(ilist.begin(), ilist.end());
+        return *this;
+    }
+
+public:
+    // 迭代器相关操作
+    iterator               begin()         noexcept { return M_data(); }
+    const_iterator         begin()   const noexcept { return M_data(); }
+    iterator               end()           noexcept { return M_data() + size_; }
+    const_iterator         end()     const noexcept { return M_data() + size_; }
+
+    reverse_iterator       rbegin()        noexcept { return reverse_iterator(end()); }
+    const_reverse_iterator rbegin()  const noexcept { return const_reverse_iterator(end()); }
+    reverse_iterator       rend()          noexcept { return reverse_iterator(begin()); }
+    const_reverse_iterator rend()    const noexcept { return const_reverse_iterator(begin()); }
+
+    const_iterator         cbegin()  const noexcept { return begin(); }
+    const_iterator         cend()    const noexcept { return end(); }
+    const_reverse_iterator crbegin() const noexcept { return rbegin(); }
+    const_reverse_iterator crend()   const noexcept { return rend(); }
+
+    // 容量相关操作
+    bool      empty()    const noexcept { return size_ == 0; }
+    bool      full()     const noexcept { return size_ == N; }
+    size_type size()     const noexcept { return size_; }
+
+    static constexpr size_type capacity() noexcept { return N; }
+    static constexpr size_type max_size() noexcept { return N; }
+
+    // 访问元素相关操作
+    reference operator[](size_type n)
+    {
+        CTSTL_DEBUG(n < size());
+        return M_data()[n];
+    }
+    const_reference operator[](size_type n) const
+    {
+        CTSTL_DEBUG(n < size());
+        return M_data()[n];
+    }
+    reference at(size_type n)
+    {
+        THROW_OUT_RANGE_IF(!(n < size()), "static_vector<T, N>::at() subscript out of range");
+        return (*this)[n];
+    }
+    const_reference at(size_type n) const
+    {
+        THROW_OUT_RANGE_IF(!(n < size()), "static_vector<T, N>::at() subscript out of range");
+        return (*this)[n];
+    }
+
+    reference front()
+    {
+        CTSTL_DEBUG(!empty());
+        return *begin();
+    }
+    const_reference front() const
+    {
+        CTSTL_DEBUG(!empty());
+        return *begin();
+    }
+    reference back()
+    {
+        CTSTL_DEBUG(!empty());
+        return *(end() - 1);
+    }
+    const_reference back() const
+    {
+        CTSTL_DEBUG(!empty());
+        return *(end() - 1);
+    }
+
+    pointer       data()       noexcept { return M_data(); }
+    const_pointer data() const noexcept { return M_data(); }
+
+    // 修改容器相关操作
+
+    // assign
+    void assign(size_type n, const value_type& value)
+    {
+        clear();
+        insert(end(), n, value);
+    }
+
+    template <class Iter, typename std::enable_if<
+        ctstl::is_input_iterator<Iter>::value, int>::type = 0>
+    void assign(Iter first, Iter last)
+    {
+        clear();
+        insert(end(), first, last);
+    }
+
+    void assign(std::initializer_list<value_type> ilist)
+    {
+        assign(ilist.begin(), ilist.end());
+    }
+
+    // emplace / emplace_back
+    template <class... Args>
+    iterator emplace(const_iterator pos, Args&& ...args);
+
+    template <class... Args>
+    reference emplace_back(Args&& ...args)
+    {
+        CTSTL_STATIC_VECTOR_CHECK(size_ < N, "static_vector<T, N>'s size too big");
+        pointer p = M_data() + size_;
+        ctstl::construct(p, ctstl::forward<Args>(args)...);
+        ++size_;
+        return *p;
+    }
+
+    // 容量已满时不插入并返回 nullptr，否则返回新元素的地址
+    template <class... Args>
+    pointer try_emplace_back(Args&& ...args)
+    {
+        if (size_ == N)
+            return nullptr;
+        return &emplace_back(ctstl::forward<Args>(args)...);
+    }
+
+    // push_back / pop_back
+    void push_back(const value_type& value) { emplace_back(value); }
+    void push_back(value_type&& value)      { emplace_back(ctstl::move(value)); }
+
+    void pop_back()
+    {
+        CTSTL_DEBUG(!empty());
+        --size_;
+        ctstl::destroy(M_data() + size_);
+    }
+
+    // insert
+    iterator insert(const_iterator pos, const value_type& value)
+    {
+        return emplace(pos, value);
+    }
+    iterator insert(const_iterator pos, value_type&& value)
+    {
+        return emplace(pos, ctstl::move(value));
+    }
+
+    iterator insert(const_iterator pos, size_type n, const value_type& value);
+
+    template <class Iter, typename std::enable_if<
+        ctstl::is_input_iterator<Iter>::value, int>::type = 0>
+    iterator insert(const_iterator pos, Iter first, Iter last)
+    {
+        CTSTL_DEBUG(pos >= begin() && pos <= end());
+        return range_insert(const_cast<iterator>(pos), first, last, iterator_category(first));
+    }
+
+    iterator insert(const_iterator pos, std::initializer_list<value_type> ilist)
+    {
+        return insert(pos, ilist.begin(), ilist.end());
+    }
+
+    // erase / clear
+    iterator erase(const_iterator pos)
+    {
+        CTSTL_DEBUG(pos >= begin() && pos < end());
+        return erase(pos, pos + 1);
+    }
+    iterator erase(const_iterator first, const_iterator last);
+    void     clear() noexcept
+    {
+        ctstl::destroy(begin(), end());
+        size_ = 0;
+    }
+
+    // resize
+    void resize(size_type new_size) { resize_impl(new_size); }
+    void resize(size_type new_size, const value_type& value) { resize_impl(new_size, value); }
+
+    void swap(static_vector& rhs);
+
+private:
+    // helper functions
+
+    // 在 pos 处插入 n 个由 construct_gap 构造的元素
+    template <class ConstructGap>
+    iterator insert_n(iterator pos, size_type n, ConstructGap construct_gap);
+
+    template <class IIter>
+    iterator range_insert(iterator pos, IIter first, IIter last, ctstl::input_iterator_tag);
+    template <class FIter>
+    iterator range_insert(iterator pos, FIter first, FIter last, ctstl::forward_iterator_tag);
+
+    template <class... Value>
+    void resize_impl(size_type new_size, const Value&... value);
+};
+
+/*****************************************************************************************/
+
+// 在 pos 位置就地构造元素
+template <class T, size_t N>
+template <class... Args>
+typename static_vector<T, N>::iterator
+static_vector<T, N>::emplace(const_iterator pos, Args&& ...args)
+{
+    CTSTL_DEBUG(pos >= begin() && pos <= end());
+    iterator xpos = const_cast<iterator>(pos);
+    if (xpos == end())
+        return &emplace_back(ctstl::forward<Args>(args)...);
+    CTSTL_STATIC_VECTOR_CHECK(size_ < N, "static_vector<T, N>'s size too big");
+    // 参数可能引用容器中的元素，先构造出来再移动到位
+    value_type tmp(ctstl::forward<Args>(args)...);
+    return insert_n(xpos, 1, [&](iterator p)
+    {
+        ctstl::construct(p, ctstl::move(tmp));
+    });
+}
+
+// 在 pos 处插入 n 个元素
+template <class T, size_t N>
+typename static_vector<T, N>::iterator
+static_vector<T, N>::insert(const_iterator pos, size_type n, const value_type& value)
+{
+    CTSTL_DEBUG(pos >= begin() && pos <= end());
+    CTSTL_STATIC_VECTOR_CHECK(n <= N - size_, "static_vector<T, N>'s size too big");
+    const value_type value_copy = value;  // value 可能引用容器中的元素
+    return insert_n(const_cast<iterator>(pos), n, [&](iterator p)
+    {
+        ctstl::uninitialized_fill_n(p, n, value_copy);
+    });
+}
+
+// 删除[first, last)上的元素
+template <class T, size_t N>
+typename static_vector<T, N>::iterator
+static_vector<T, N>::erase(const_iterator first, const_iterator last)
+{
+    CTSTL_DEBUG(first >= begin() && last <= end() && !(last < first));
+    iterator xfirst = const_cast<iterator>(first);
+    iterator xlast = const_cast<iterator>(last);
+    if (xfirst == xlast)
+        return xfirst;
+    iterator old_end = end();
+    if (is_trivially_relocatable<T>::value)
+    {
+        // 先析构被删除的元素，再把后面的元素按位前移
+        ctstl::destroy(xfirst, xlast);
+        ctstl::uninitialized_relocate(xlast, old_end, xfirst);
+    }
+    else
+    {
+        iterator new_end = ctstl::move(xlast, old_end, xfirst);
+        ctstl::destroy(new_end, old_end);
+    }
+    size_ -= static_cast<size_type>(xlast - xfirst);
+    return xfirst;
+}
+
+// 与另一个 static_vector 交换，公共部分逐个交换，多出的部分移动过去
+template <class T, size_t N>
+void static_vector<T, N>::swap(static_vector& rhs)
+{
+    if (this == &rhs)
+        return;
+    static_vector& longer = size_ < rhs.size_ ? rhs : *this;
+    static_vector& shorter = size_ < rhs.size_ ? *this : rhs;
+    const size_type common = shorter.size_;
+    for (size_type i = 0; i < common; ++i)
+        ctstl::swap(longer[i], shorter[i]);
+    for (size_type i = common; i < longer.size_; ++i)
+        shorter.emplace_back(ctstl::move(longer[i]));
+    longer.erase(longer.begin() + common, longer.end());
+}
+
+/*****************************************************************************************/
+// helper function
+
+// insert_n 函数
+template <class T, size_t N>
+template <class ConstructGap>
+typename static_vector<T, N>::iterator
+static_vector<T, N>::insert_n(iterator pos, size_type n, ConstructGap construct_gap)
+{
+    if (n == 0)
+        return pos;
+    CTSTL_STATIC_VECTOR_CHECK(n <= N - size_, "static_vector<T, N>'s size too big");
+    iterator last = end();
+    try
+    {
+        ctstl::vector_insert_in_place(pos, last, n, construct_gap);
+    }
+    catch (...)
+    {
+        size_ = static_cast<size_type>(last - M_data());
+        throw;
+    }
+    size_ += n;
+    return pos;
+}
+
+// range_insert 函数
+template <class T, size_t N>
+template <class IIter>
+typename static_vector<T, N>::iterator
+static_vector<T, N>::range_insert(iterator pos, IIter first, IIter last, ctstl::input_iterator_tag)
+{
+    const difference_type offset = pos - begin();
+    for (; first != last; ++first, ++pos)
+        pos = emplace(pos, *first);
+    return begin() + offset;
+}
+
+template <class T, size_t N>
+template <class FIter>
+typename static_vector<T, N>::iterator
+static_vector<T, N>::range_insert(iterator pos, FIter first, FIter last, ctstl::forward_iterator_tag)
+{
+    const size_type n = static_cast<size_type>(ctstl::distance(first, last));
+    return insert_n(pos, n, [&](iterator p)
+    {
+        ctstl::uninitialized_copy(first, last, p);
+    });
+}
+
+// resize_impl 函数，value 为空时值初始化新的元素
+template <class T, size_t N>
+template <class... Value>
+void static_vector<T, N>::resize_impl(size_type new_size, const Value&... value)
+{
+    if (new_size < size_)
+    {
+        erase(begin() + new_size, end());
+        return;
+    }
+    CTSTL_STATIC_VECTOR_CHECK(new_size <= N, "static_vector<T, N>'s size too big");
+    while (size_ < new_size)
+        emplace_back(value...);
+}
+
+/*****************************************************************************************/
+// 重载比较操作符
+
+template <class T, size_t N>
+bool operator==(const static_vector<T, N>& lhs, const static_vector<T, N>& rhs)
+{
+    return lhs.size() == rhs.size() &&
+        ctstl::equal(lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
+}
+
+template <class T, size_t N>
+bool operator<(const static_vector<T, N>& lhs, const static_vector<T, N>& rhs)
+{
+    return ctstl::lexicographical_compare(lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
+}
+
+template <class T, size_t N>
+bool operator!=(const static_vector<T, N>& lhs, const static_vector<T, N>& rhs)
+{
+    return !(lhs == rhs);
+}
+
+template <class T, size_t N>
+bool operator>(const static_vector<T, N>& lhs, const static_vector<T, N>& rhs)
+{
+    return rhs < lhs;
+}
+
+template <class T, size_t N>
+bool operator<=(const static_vector<T, N>& lhs, const static_vector<T, N>& rhs)
+{
+    return !(rhs < lhs);
+}
+
+template <class T, size_t N>
+bool operator>=(const static_vector<T, N>& lhs, const static_vector<T, N>& rhs)
+{
+    return !(lhs < rhs);
+}
+
+// 重载 ctstl 的 swap
+template <class T, size_t N>
+void swap(static_vector<T, N>& lhs, static_vector<T, N>& rhs)
+{
+    lhs.swap(rhs);
+}
+
+template <class T, size_t N>
+struct is_trivially_relocatable<static_vector<T, N>> : is_trivially_relocatable<T> {};
+
+} // namespace ctstl
+#endif // !CTSTL_STATIC_VECTOR_H_
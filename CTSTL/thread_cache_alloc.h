@@ -0,0 +1,317 @@
+#ifndef CTSTL_THREAD_CACHE_ALLOC_H_
+#define CTSTL_THREAD_CACHE_ALLOC_H_
+
+// 这个头文件包含带线程缓存的空间配置器 thread_cache_alloc_template，以及以它为后端的 thread_cache_allocator
+// 每个线程为每个 size class 持有一个私有的空闲区块链表（magazine），分配与释放在本线程内完成，不需要加锁
+// 线程缓存为空或过长时，以 ETransferBatch 个区块为一批，与中心缓存（central cache）交换
+// 一个线程释放另一个线程分配的区块（remote free）时，区块直接进入释放方的线程缓存，
+// 缓存过长时成批归还中心缓存，再被分配方取回，因此生产者 / 消费者模式下区块可以安全地在线程间流动
+
+#include <new>
+#include <cstddef>
+#include <mutex>
+
+#include "alloc.h"
+
+namespace ctstl
+{
+
+// 线程缓存与中心缓存之间一次交换的区块个数
+enum { ETransferBatch = 32 };
+
+// 中心缓存中每个 size class 最多保存的整批个数，超出的部分退化为一条普通链表
+enum { ETransferSlots = 64 };
+
+// 中心缓存每次向系统申请的大小
+enum { ECentralChunkBytes = 64 * 1024 };
+
+// 模板类：thread_cache_alloc_template
+// 接口与 pool_alloc 相同，可以作为 pool_allocator 的第二个模板参数
+// 模板参数 Inst 只用于区分互不相干的多个实例
+template <int Inst>
+class thread_cache_alloc_template
+{
+private:
+    // 中心缓存中的一个 size class
+    struct central_list
+    {
+        std::mutex mutex;
+        FreeList*  slots[ETransferSlots];  // 每个元素是一条长度恰好为 ETransferBatch 的链表
+        size_t     nslots;
+        FreeList*  overflow;               // 不成整批的区块
+        size_t     noverflow;
+        char*      chunk_cur;              // 当前切分中的 chunk
+        char*      chunk_end;
+    };
+
+    // 线程缓存中的一个 size class
+    struct cache_list
+    {
+        FreeList* list;
+        size_t    length;
+        size_t    max_length;  // 超过这个长度时归还一批给中心缓存
+    };
+
+    // 线程缓存，只包含平凡类型，使得 thread_local 变量不需要动态初始化
+    struct thread_cache
+    {
+        cache_list lists[EFreeListsNumber];
+        bool       registered;  // 是否已经注册线程退出时的清理
+        bool       dead;        // 线程正在退出，缓存已经归还
+    };
+
+    // 线程退出时把线程缓存中的全部区块归还中心缓存
+    struct cache_cleaner
+    {
+        ~cache_cleaner()
+        {
+            flush_thread_cache();
+            local_cache().dead = true;
+        }
+    };
+
+    static central_list central[EFreeListsNumber];
+
+public:
+    static void* allocate(size_t n);
+    static void  deallocate(void* p, size_t n);
+
+    // 把本线程缓存中的区块全部归还中心缓存，供需要尽快让其它线程复用内存的场合使用
+    static void  flush_thread_cache();
+
+private:
+    static thread_cache& local_cache();
+    static size_t M_round_up(size_t bytes);
+    static size_t M_freelist_index(size_t bytes);
+    static void   M_register(thread_cache& tc);
+    static void*  M_fetch(thread_cache& tc, size_t index);
+    static void   M_release(thread_cache& tc, size_t index);
+    static void   M_central_insert(size_t index, FreeList* list, size_t n);
+    static size_t M_central_remove(size_t index, FreeList*& list);
+};
+
+template <int Inst>
+typename thread_cache_alloc_template<Inst>::central_list
+thread_cache_alloc_template<Inst>::central[EFreeListsNumber];
+
+template <int Inst>
+typename thread_cache_alloc_template<Inst>::thread_cache&
+thread_cache_alloc_template<Inst>::local_cache()
+{
+    static thread_local thread_cache tc;
+    return tc;
+}
+
+template <int Inst>
+void* thread_cache_alloc_template<Inst>::allocate(size_t n)
+{
+    if (n > static_cast<size_t>(ESmallObjectBytes))
+        return ::operator new(n);
+    const size_t index = M_freelist_index(n);
+    thread_cache& tc = local_cache();
+    cache_list& cl = tc.lists[index];
+    FreeList* result = cl.list;
+    if (result == nullptr)
+        return M_fetch(tc, index);
+    cl.list = result->next;
+    --cl.length;
+    return result;
+}
+
+template <int Inst>
+void thread_cache_alloc_template<Inst>::deallocate(void* p, size_t n)
+{
+    if (n > static_cast<size_t>(ESmallObjectBytes))
+    {
+        ::operator delete(p);
+        return;
+    }
+    const size_t index = M_freelist_index(n);
+    thread_cache& tc = local_cache();
+    FreeList* q = static_cast<FreeList*>(p);
+    if (tc.dead)
+    {   // 线程正在退出，直接还给中心缓存
+        q->next = nullptr;
+        M_central_insert(index, q, 1);
+        return;
+    }
+    cache_list& cl = tc.lists[index];
+    q->next = cl.list;
+    cl.list = q;
+    if (++cl.length > cl.max_length)
+        M_release(tc, index);
+}
+
+template <int Inst>
+void thread_cache_alloc_template<Inst>::flush_thread_cache()
+{
+    thread_cache& tc = local_cache();
+    for (size_t i = 0; i < EFreeListsNumber; ++i)
+    {
+        cache_list& cl = tc.lists[i];
+        if (cl.list != nullptr)
+            M_central_insert(i, cl.list, cl.length);
+        cl.list = nullptr;
+        cl.length = 0;
+    }
+}
+
+template <int Inst>
+size_t thread_cache_alloc_template<Inst>::M_round_up(size_t bytes)
+{
+    return ((bytes + EAlign - 1) & ~(static_cast<size_t>(EAlign) - 1));
+}
+
+template <int Inst>
+size_t thread_cache_alloc_template<Inst>::M_freelist_index(size_t bytes)
+{
+    return bytes == 0 ? 0 : (bytes + EAlign - 1) / EAlign - 1;
+}
+
+// 第一次走到慢路径时注册线程退出时的清理
+template <int Inst>
+void thread_cache_alloc_template<Inst>::M_register(thread_cache& tc)
+{
+    if (!tc.registered && !tc.dead)
+    {
+        tc.registered = true;
+        static thread_local cache_cleaner cleaner;
+        (void)cleaner;
+    }
+}
+
+// 线程缓存为空，从中心缓存取一批
+template <int Inst>
+void* thread_cache_alloc_template<Inst>::M_fetch(thread_cache& tc, size_t index)
+{
+    M_register(tc);
+    FreeList* list = nullptr;
+    const size_t n = M_central_remove(index, list);
+    FreeList* result = list;
+    if (tc.dead)
+    {   // 线程正在退出，多出来的区块不再缓存
+        if (n > 1)
+            M_central_insert(index, result->next, n - 1);
+        return result;
+    }
+    cache_list& cl = tc.lists[index];
+    cl.list = result->next;
+    cl.length = n - 1;
+    // 慢启动：同一个 size class 频繁走到慢路径时，允许缓存更多的区块
+    if (cl.max_length < ETransferBatch)
+        cl.max_length = ETransferBatch;
+    else if (cl.max_length < 8 * ETransferBatch)
+        cl.max_length += ETransferBatch;
+    return result;
+}
+
+// 线程缓存过长，把一批归还中心缓存
+template <int Inst>
+void thread_cache_alloc_template<Inst>::M_release(thread_cache& tc, size_t index)
+{
+    M_register(tc);
+    cache_list& cl = tc.lists[index];
+    if (cl.max_length < ETransferBatch)
+    {   // 只释放、从不分配的线程（比如消费者）第一次走到这里
+        cl.max_length = ETransferBatch;
+        return;
+    }
+    FreeList* head = cl.list;
+    FreeList* tail = head;
+    for (size_t i = 1; i < ETransferBatch; ++i)
+        tail = tail->next;
+    cl.list = tail->next;
+    cl.length -= ETransferBatch;
+    tail->next = nullptr;
+    M_central_insert(index, head, ETransferBatch);
+}
+
+// 把一条以 nullptr 结尾的、长度为 n 的链表放入中心缓存
+template <int Inst>
+void thread_cache_alloc_template<Inst>::M_central_insert(size_t index, FreeList* list, size_t n)
+{
+    central_list& c = central[index];
+    std::lock_guard<std::mutex> guard(c.mutex);
+    if (n == ETransferBatch && c.nslots < ETransferSlots)
+    {   // 整批放入，O(1)
+        c.slots[c.nslots++] = list;
+        return;
+    }
+    FreeList* tail = list;
+    while (tail->next != nullptr)
+        tail = tail->next;
+    tail->next = c.overflow;
+    c.overflow = list;
+    c.noverflow += n;
+}
+
+// 从中心缓存中取出至多 ETransferBatch 个区块，返回取到的个数（至少为 1）
+template <int Inst>
+size_t thread_cache_alloc_template<Inst>::M_central_remove(size_t index, FreeList*& list)
+{
+    central_list& c = central[index];
+    std::lock_guard<std::mutex> guard(c.mutex);
+    if (c.nslots > 0)
+    {
+        list = c.slots[--c.nslots];
+        return ETransferBatch;
+    }
+    if (c.overflow != nullptr)
+    {
+        size_t n = 1;
+        FreeList* tail = c.overflow;
+        while (n < ETransferBatch && tail->next != nullptr)
+        {
+            tail = tail->next;
+            ++n;
+        }
+        list = c.overflow;
+        c.overflow = tail->next;
+        c.noverflow -= n;
+        tail->next = nullptr;
+        return n;
+    }
+    // 中心缓存也为空，从 chunk 中切出一批
+    const size_t size = M_round_up(index * EAlign + 1);
+    if (static_cast<size_t>(c.chunk_end - c.chunk_cur) < size)
+    {   // chunk 剩余的零头不足一个区块，直接丢弃
+        c.chunk_cur = static_cast<char*>(::operator new(ECentralChunkBytes));
+        c.chunk_end = c.chunk_cur + ECentralChunkBytes;
+    }
+    size_t n = static_cast<size_t>(c.chunk_end - c.chunk_cur) / size;
+    if (n > ETransferBatch)
+        n = ETransferBatch;
+    list = reinterpret_cast<FreeList*>(c.chunk_cur);
+    FreeList* cur = list;
+    for (size_t i = 1; i < n; ++i)
+    {
+        FreeList* next = reinterpret_cast<FreeList*>(reinterpret_cast<char*>(cur) + size);
+        cur->next = next;
+        cur = next;
+    }
+    cur->next = nullptr;
+    c.chunk_cur += n * size;
+    return n;
+}
+
+// 默认使用的线程缓存配置器
+typedef thread_cache_alloc_template<0> thread_cache_alloc;
+
+// 模板类：thread_cache_allocator
+// 接口与 allocator 相同，小对象的分配与释放通常只访问本线程的缓存
+template <class T>
+class thread_cache_allocator : public pool_allocator<T, thread_cache_alloc>
+{
+    // 线程缓存与中心缓存中的区块只按 EAlign 对齐
+    static_assert(alignof(T) <= EAlign, "thread_cache_allocator does not support types aligned beyond EAlign");
+
+public:
+    template <class U>
+    struct rebind
+    {
+        typedef thread_cache_allocator<U> other;
+    };
+};
+
+} // namespace ctstl
+#endif // !CTSTL_THREAD_CACHE_ALLOC_H_
@@ -30,5 +30,19 @@ struct is_pair : ctstl::m_false_type { };
 
 template <class T1, class T2>
 struct is_pair<ctstl::pair<T1, T2>> : ctstl::m_true_type {};
+
+// is_trivially_relocatable
+// 可平凡重定位：把对象按位复制到新的地址，并且不再调用原对象的析构函数，效果等同于移动构造之后析构原对象
+// 可平凡复制的类型都满足；只持有指针的句柄类（比如智能指针、容器）虽然不可平凡复制，通常也满足，
+// 这样的类型可以特化这个模板来声明自己满足，容器搬移元素时就能用一次 memmove 代替逐个移动构造、析构
+// 注意：保存了指向自身（或自身成员）的指针的类型不满足，不能特化
+template <class T>
+struct is_trivially_relocatable
+    : std::integral_constant<bool, std::is_trivially_copyable<T>::value> {};
+
+template <class T1, class T2>
+struct is_trivially_relocatable<ctstl::pair<T1, T2>>
+    : std::integral_constant<bool, is_trivially_relocatable<T1>::value &&
+                                   is_trivially_relocatable<T2>::value> {};
 }
 #endif
\ No newline at end of file
@@ -3,6 +3,8 @@
 
 // 这个头文件用于对未初始化空间构造元素
 
+#include <cstring>
+
 #include "algobase.h"
 #include "construct.h"
 #include "iterator.h"
@@ -37,10 +39,8 @@ unchecked_uninit_copy(InputIter first, InputIter last, ForwardIter result, std::
     }
     catch(...)
     {
-        for (; result != cur; --cur)
-        {
-            ctstl::destroy(&*cur);
-        }
+        ctstl::destroy(result, cur);
+        throw;
     }
     return cur;
 }
@@ -79,10 +79,8 @@ uninitialized_copy_n(InputIter first, Size n, ForwardIter result, std::false_typ
     }
     catch(...)
     {
-        for (; cur != result; --cur)
-        {
-            ctstl::destroy(&*cur);
-        }
+        ctstl::destroy(result, cur);
+        throw;
     }
     return cur;
 }
@@ -105,7 +103,7 @@ template <class ForwardIter, class T>
 void 
 unchecked_uninit_fill(ForwardIter first, ForwardIter last, const T& value, std::true_type)
 {
-  mystl::fill(first, last, value);
+  ctstl::fill(first, last, value);
 }
 
 template <class ForwardIter, class T>
@@ -117,20 +115,21 @@ unchecked_uninit_fill(ForwardIter first, ForwardIter last, const T& value, std::
   {
     for (; cur != last; ++cur)
     {
-      mystl::construct(&*cur, value);
+      ctstl::construct(&*cur, value);
     }
   }
   catch (...)
   {
     for (;first != cur; ++first)
-      mystl::destroy(&*first);
+      ctstl::destroy(&*first);
+    throw;
   }
 }
 
 template <class ForwardIter, class T>
 void  uninitialized_fill(ForwardIter first, ForwardIter last, const T& value)
 {
-  mystl::unchecked_uninit_fill(first, last, value, 
+  ctstl::unchecked_uninit_fill(first, last, value, 
                                std::is_trivially_copy_assignable<
                                typename iterator_traits<ForwardIter>::
                                value_type>{});
@@ -163,6 +162,7 @@ unchecked_uninit_fill_n(ForwardIter first, Size n, const T& value, std::false_ty
     {
         for (; first != cur; ++first)
             ctstl::destroy(&*first);
+        throw;
     }
     return cur;
 }
@@ -170,7 +170,7 @@ unchecked_uninit_fill_n(ForwardIter first, Size n, const T& value, std::false_ty
 template <class ForwardIter, class Size, class T>
 ForwardIter uninitialized_fill_n(ForwardIter first, Size n, const T& value)
 {
-    return ctstl::unchecked_uninit_fill_n(first, n, vlaue,
+    return ctstl::unchecked_uninit_fill_n(first, n, value,
                                           std::is_trivially_copy_assignable<
                                           typename iterator_traits<ForwardIter>::
                                           value_type>{});
@@ -184,7 +184,7 @@ template <class InputIter, class ForwardIter>
 ForwardIter 
 unchecked_uninit_move(InputIter first, InputIter last, ForwardIter result, std::true_type)
 {
-  return mystl::move(first, last, result);
+  return ctstl::move(first, last, result);
 }
 
 template <class InputIter, class ForwardIter>
@@ -196,12 +196,13 @@ unchecked_uninit_move(InputIter first, InputIter last, ForwardIter result, std::
   {
     for (; first != last; ++first, ++cur)
     {
-      mystl::construct(&*cur, mystl::move(*first));
+      ctstl::construct(&*cur, ctstl::move(*first));
     }
   }
   catch (...)
   {
-    mystl::destroy(result, cur);
+    ctstl::destroy(result, cur);
+    throw;
   }
   return cur;
 }
@@ -209,7 +210,7 @@ unchecked_uninit_move(InputIter first, InputIter last, ForwardIter result, std::
 template <class InputIter, class ForwardIter>
 ForwardIter uninitialized_move(InputIter first, InputIter last, ForwardIter result)
 {
-  return mystl::unchecked_uninit_move(first, last, result,
+  return ctstl::unchecked_uninit_move(first, last, result,
                                       std::is_trivially_move_assignable<
                                       typename iterator_traits<InputIter>::
                                       value_type>{});
@@ -223,7 +224,7 @@ template <class InputIter, class Size, class ForwardIter>
 ForwardIter 
 unchecked_uninit_move_n(InputIter first, Size n, ForwardIter result, std::true_type)
 {
-  return mystl::move(first, first + n, result);
+  return ctstl::move(first, first + n, result);
 }
 
 template <class InputIter, class Size, class ForwardIter>
@@ -235,13 +236,13 @@ unchecked_uninit_move_n(InputIter first, Size n, ForwardIter result, std::false_
   {
     for (; n > 0; --n, ++first, ++cur)
     {
-      mystl::construct(&*cur, mystl::move(*first));
+      ctstl::construct(&*cur, ctstl::move(*first));
     }
   }
   catch (...)
   {
     for (; result != cur; ++result)
-      mystl::destroy(&*result);
+      ctstl::destroy(&*result);
     throw;
   }
   return cur;
@@ -250,11 +251,66 @@ unchecked_uninit_move_n(InputIter first, Size n, ForwardIter result, std::false_
 template <class InputIter, class Size, class ForwardIter>
 ForwardIter uninitialized_move_n(InputIter first, Size n, ForwardIter result)
 {
-  return mystl::unchecked_uninit_move_n(first, n, result,
+  return ctstl::unchecked_uninit_move_n(first, n, result,
                                         std::is_trivially_move_assignable<
                                         typename iterator_traits<InputIter>::
                                         value_type>{});
 }
 
+/*****************************************************************************************/
+// uninitialized_relocate
+// 把 [first, last) 上的对象搬到以 result 为起始处的未初始化空间，返回搬运结束的位置
+// 搬运之后原来的对象已经结束生命周期（被析构或者被按位搬走），调用者不能再析构它们
+// 对可平凡重定位的类型，指针区间上只做一次 memmove，两个区间可以重叠
+/*****************************************************************************************/
+template <class InputIter, class ForwardIter>
+ForwardIter
+unchecked_uninit_relocate(InputIter first, InputIter last, ForwardIter result, std::false_type)
+{
+    ForwardIter cur = ctstl::uninitialized_move(first, last, result);
+    ctstl::destroy(first, last);
+    return cur;
+}
+
+template <class T>
+T* unchecked_uninit_relocate(T* first, T* last, T* result, std::true_type)
+{
+    const size_t n = static_cast<size_t>(last - first);
+    if (n != 0)
+        std::memmove(static_cast<void*>(result), static_cast<const void*>(first), n * sizeof(T));
+    return result + n;
+}
+
+template <class InputIter, class ForwardIter>
+ForwardIter uninitialized_relocate(InputIter first, InputIter last, ForwardIter result)
+{
+    return ctstl::unchecked_uninit_relocate(first, last, result, std::false_type{});
+}
+
+template <class T>
+T* uninitialized_relocate(T* first, T* last, T* result)
+{
+    return ctstl::unchecked_uninit_relocate(first, last, result, is_trivially_relocatable<T>{});
+}
+
+/*****************************************************************************************/
+// uninitialized_relocate_n
+// 把 [first, first + n) 上的对象搬到以 result 为起始处的未初始化空间，返回搬运结束的位置
+/*****************************************************************************************/
+template <class InputIter, class Size, class ForwardIter>
+ForwardIter uninitialized_relocate_n(InputIter first, Size n, ForwardIter result)
+{
+    ForwardIter cur = ctstl::uninitialized_move_n(first, n, result);
+    for (; n > 0; --n, ++first)
+        ctstl::destroy(&*first);
+    return cur;
+}
+
+template <class T, class Size>
+T* uninitialized_relocate_n(T* first, Size n, T* result)
+{
+    return ctstl::unchecked_uninit_relocate(first, first + n, result, is_trivially_relocatable<T>{});
+}
+
 } // namespace ctstl
 #endif // !CTSTL_UNINITIALIZED_H_
\ No newline at end of file
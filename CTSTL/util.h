@@ -3,6 +3,8 @@
 
 // 这个文件包含一些通用工具，包括 move, forward, swap 等函数，以及 pair 等 
 #include <cstddef>
+#include <tuple>
+#include <type_traits>
 
 #include "iterator"
 
@@ -27,7 +29,7 @@ typename std::remove_reference<T>::type&& move(T&& arg) noexcept
 template <class T>
 T&& forward(typename std::remove_reference<T>::type& arg) noexcept
 {
-    return static_cast<&&>(arg);
+    return static_cast<T&&>(arg);
 }
 
 /*
@@ -38,16 +40,16 @@ template <class T>
 T&& forward(typename std::remove_reference<T>::type&& arg) noexcept
 {
     static_assert(!std::is_lvalue_reference<T>::value, "bad forward");
-    return static_cast<&&>(arg);
+    return static_cast<T&&>(arg);
 }
 
 //swap
 template <class Tp>
 void swap(Tp& lhs, Tp& rhs)
 {
-    auto tmp(ctstl::moce(lhs));
+    auto tmp(ctstl::move(lhs));
     lhs = ctstl::move(rhs);
-    rhs = ctstl::moce(tmp);
+    rhs = ctstl::move(tmp);
 }
 
 template <class ForwardIter1, class Forwarditer2>
@@ -65,6 +67,27 @@ void swap(Tp(&a)[N], Tp(&b)[N])
     ctstl::swap_range(a, a + N, b);
 }
 
+// index_sequence / make_index_sequence
+// std::index_sequence 从 C++14 开始才有，用来把 0, 1, ..., N - 1 展开成参数包，逐个处理 tuple 或参数包中的元素
+template <size_t... I>
+struct index_sequence {};
+
+template <size_t N, size_t... I>
+struct make_index_sequence_impl : make_index_sequence_impl<N - 1, N - 1, I...> {};
+
+template <size_t... I>
+struct make_index_sequence_impl<0, I...>
+{
+    typedef index_sequence<I...> type;
+};
+
+template <size_t N>
+using make_index_sequence = typename make_index_sequence_impl<N>::type;
+
+// 标签：pair 的两个成员分别用两个 tuple 中的参数原地构造
+struct piecewise_construct_t { explicit piecewise_construct_t() = default; };
+constexpr piecewise_construct_t piecewise_construct{};
+
 //pair
 // 结构体模板 : pair
 // 两个模板参数分别表示两个数据的类型
@@ -127,8 +150,8 @@ struct pair
         std::is_convertible<Other1&&, Ty1>::value &&
         std::is_convertible<Other2&&, Ty2>::value, int>::type = 0>
         constexpr pair(Other1&& a, Other2&& b)
-        : first(mystl::forward<Other1>(a)),
-        second(mystl::forward<Other2>(b))
+        : first(ctstl::forward<Other1>(a)),
+        second(ctstl::forward<Other2>(b))
     {
     }
 
@@ -140,8 +163,8 @@ struct pair
         (!std::is_convertible<Other1, Ty1>::value ||
         !std::is_convertible<Other2, Ty2>::value), int>::type = 0>
         explicit constexpr pair(Other1&& a, Other2&& b)
-        : first(mystl::forward<Other1>(a)),
-        second(mystl::forward<Other2>(b))
+        : first(ctstl::forward<Other1>(a)),
+        second(ctstl::forward<Other2>(b))
     {
     }
 
@@ -179,8 +202,8 @@ struct pair
         std::is_convertible<Other1, Ty1>::value &&
         std::is_convertible<Other2, Ty2>::value, int>::type = 0>
         constexpr pair(pair<Other1, Other2>&& other)
-        : first(mystl::forward<Other1>(other.first)),
-        second(mystl::forward<Other2>(other.second))
+        : first(ctstl::forward<Other1>(other.first)),
+        second(ctstl::forward<Other2>(other.second))
     {
     }
 
@@ -192,15 +215,15 @@ struct pair
         (!std::is_convertible<Other1, Ty1>::value ||
         !std::is_convertible<Other2, Ty2>::value), int>::type = 0>
         explicit constexpr pair(pair<Other1, Other2>&& other)
-        : first(mystl::forward<Other1>(other.first)),
-        second(mystl::forward<Other2>(other.second))
+        : first(ctstl::forward<Other1>(other.first)),
+        second(ctstl::forward<Other2>(other.second))
     {
     }
 
     // copy assign for this pair
     pair& operator=(const pair& rhs)
     {
-        if (this != &ths)
+        if (this != &rhs)
         {
             first = rhs.first;
             second = rhs.second;
@@ -225,28 +248,43 @@ struct pair
     {
         first = other.first;
         second = other.second;
-        return this;
+        return *this;
     }
 
     // move assign for other pair
-    tmeplate <class Other1, class Other2>
-    pair& operator=(const Pair<Other1, Other2>&& other)
+    template <class Other1, class Other2>
+    pair& operator=(pair<Other1, Other2>&& other)
     {
-        fisrt = ctstl::forward<Other1>(other.first);
-        second = ctstl::forward<Other2>(Other.second);
+        first = ctstl::forward<Other1>(other.first);
+        second = ctstl::forward<Other2>(other.second);
         return *this;
     }
 
+    // piecewise constructiable：first 与 second 分别用 a、b 中的参数原地构造，不产生临时对象
+    template <class... Args1, class... Args2>
+    pair(piecewise_construct_t, std::tuple<Args1...> a, std::tuple<Args2...> b)
+        : pair(a, b, make_index_sequence<sizeof...(Args1)>(), make_index_sequence<sizeof...(Args2)>())
+    {
+    }
+
     ~pair() = default;
 
     void swap(pair& other)
     {
-        if (this != other)
+        if (this != &other)
         {
             ctstl::swap(first, other.first);
             ctstl::swap(second, other.second);
         }
     }
+
+private:
+    template <class Tuple1, class Tuple2, size_t... I1, size_t... I2>
+    pair(Tuple1& a, Tuple2& b, index_sequence<I1...>, index_sequence<I2...>)
+        : first(std::get<I1>(ctstl::move(a))...),
+          second(std::get<I2>(ctstl::move(b))...)
+    {
+    }
 };
 
 // 重载比较操作符
@@ -263,7 +301,7 @@ bool operator<(const pair<Ty1, Ty2>& lhs, const pair<Ty1, Ty2>& rhs)
 }
 
 template <class Ty1, class Ty2>
-bool operator==(const pair<Ty1, Ty2>& lhs, const pair<Ty1, Ty2>& rhs)
+bool operator!=(const pair<Ty1, Ty2>& lhs, const pair<Ty1, Ty2>& rhs)
 {
     return !(lhs == rhs);
 }
@@ -300,5 +338,64 @@ pair<Ty1, Ty2> make_pair(Ty1&& first, Ty2&& second)
     return pair<Ty1, Ty2>(ctstl::forward<Ty1>(first), ctstl::forward<Ty2>(second));
 }
 
+// 标签：调用者保证输入序列已经按比较函数严格递增（有序且无重复），容器可以跳过查找直接构造
+struct sorted_unique_t { explicit sorted_unique_t() = default; };
+constexpr sorted_unique_t sorted_unique{};
+
+// std::is_final 从 C++14 开始才有，之前的标准使用编译器内建的 __is_final
+#if __cplusplus >= 201402L
+template <class T>
+struct is_final_class : std::is_final<T> {};
+#else
+template <class T>
+struct is_final_class : std::integral_constant<bool, __is_final(T)> {};
+#endif
+
+// 模板类：compressed_pair
+// 保存两个数据，当第一个类型是空类（比如无状态的删除器或配置器）时利用空基类优化（EBO），使它不占用空间
+template <class T1, class T2,
+          bool = std::is_empty<T1>::value && !is_final_class<T1>::value>
+class compressed_pair : private T1
+{
+private:
+    T2 second_;
+
+public:
+    constexpr compressed_pair() : T1(), second_() {}
+
+    template <class U1, class U2>
+    constexpr compressed_pair(U1&& a, U2&& b)
+        : T1(ctstl::forward<U1>(a)), second_(ctstl::forward<U2>(b))
+    {
+    }
+
+    T1&       first()        noexcept { return *this; }
+    const T1& first()  const noexcept { return *this; }
+    T2&       second()       noexcept { return second_; }
+    const T2& second() const noexcept { return second_; }
+};
+
+template <class T1, class T2>
+class compressed_pair<T1, T2, false>
+{
+private:
+    T1 first_;
+    T2 second_;
+
+public:
+    constexpr compressed_pair() : first_(), second_() {}
+
+    template <class U1, class U2>
+    constexpr compressed_pair(U1&& a, U2&& b)
+        : first_(ctstl::forward<U1>(a)), second_(ctstl::forward<U2>(b))
+    {
+    }
+
+    T1&       first()        noexcept { return first_; }
+    const T1& first()  const noexcept { return first_; }
+    T2&       second()       noexcept { return second_; }
+    const T2& second() const noexcept { return second_; }
+};
+
 }
 #endif // !CTSTL_UTIL_H
\ No newline at end of file
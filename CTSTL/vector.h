@@ -2,12 +2,1060 @@
 #ifndef CTSTL_VECTOR_H_
 #define CTSTL_VECTOR_H_
 
+// 这个头文件包含一个模板类 vector
+// vector : 向量
+
 // 1. 什么是强异常安全保证？
+// 操作要么完全成功，要么抛出异常并且容器保持调用前的状态，就像这个操作从来没有发生过一样。
+// vector 在重新分配空间时，先在新空间中构造好所有元素，全部成功之后才释放旧空间；
+// 元素的移动构造可能抛出异常时改用复制构造，这样失败时旧空间中的元素完好无损。
+// push_back / emplace_back / reserve / shrink_to_fit 提供强异常安全保证，
+// 在中间插入、删除元素只提供基本保证（不泄漏资源，容器仍然可用）
 
 // 模板initializer_list可以列表初始化容器
 #include <initializer_list>
+#include <type_traits>
 
 #include "iterator.h"
 #include "memory.h"
+#include "util.h"
+#include "exceptdef.h"
+
+namespace ctstl
+{
+
+#ifdef max
+#pragma message("#undefing marco max")
+#undef max
+#endif // max
+
+#ifdef min
+#pragma message("#undefing marco min")
+#undef min
+#endif // min
+
+/*****************************************************************************************/
+// vector 与 small_vector 共用的辅助函数
+/*****************************************************************************************/
+
+// 几何增长：新的容量为旧容量的 1.5 倍，并且至少能再放下 add_size 个元素
+// 1.5 倍使得释放掉的旧空间之和有机会被后面的请求复用，2 倍则永远不可能
+inline size_t vector_grow_capacity(size_t old_cap, size_t add_size, size_t max_size)
+{
+    THROW_LENGTH_ERROR_IF(add_size > max_size - old_cap, "vector<T>'s size too big");
+    if (old_cap > max_size - old_cap / 2)
+    {
+        return old_cap + add_size > max_size - 16
+            ? old_cap + add_size : old_cap + add_size + 16;
+    }
+    return old_cap == 0
+        ? ctstl::max(add_size, static_cast<size_t>(16))
+        : ctstl::max(old_cap + old_cap / 2, old_cap + add_size);
+}
+
+// vector_transfer
+// 把 [first, last) 搬到 result 开始的未初始化空间，调用者在全部成功后再用 vector_destroy_transferred 处理原来的元素
+// 可平凡重定位的类型（包括可平凡复制的类型）直接 memmove 整块内存，原来的元素随之失效、不再析构；
+// 其它类型在移动构造不会抛出异常（或者不能复制）时移动，否则复制，以便失败时原来的元素保持不变
+template <class T>
+T* vector_transfer_cat(T* first, T* last, T* result, std::true_type)
+{
+    return ctstl::uninitialized_move(first, last, result);
+}
+
+template <class T>
+T* vector_transfer_cat(T* first, T* last, T* result, std::false_type)
+{
+    return ctstl::uninitialized_copy(first, last, result);
+}
+
+template <class T>
+T* vector_transfer(T* first, T* last, T* result, std::true_type)
+{
+    return ctstl::uninitialized_relocate(first, last, result);
+}
+
+template <class T>
+T* vector_transfer(T* first, T* last, T* result, std::false_type)
+{
+    return ctstl::vector_transfer_cat(first, last, result, std::integral_constant<bool,
+                                      std::is_nothrow_move_constructible<T>::value ||
+                                      !std::is_copy_constructible<T>::value>{});
+}
+
+template <class T>
+T* vector_transfer(T* first, T* last, T* result)
+{
+    return ctstl::vector_transfer(first, last, result, is_trivially_relocatable<T>{});
+}
+
+template <class T>
+void vector_destroy_transferred(T* first, T* last)
+{
+    if (!is_trivially_relocatable<T>::value)
+        ctstl::destroy(first, last);
+}
+
+// vector_can_reallocate
+// 配置器提供 reallocate(ptr, old_n, new_n)（比如 aligned_allocator.h 中的 realloc_allocator）并且元素可以平凡重定位时，
+// vector 扩容直接调整原来的内存块（realloc / mremap），不需要分配新空间再搬移元素
+template <class T, class Alloc, class = void>
+struct vector_can_reallocate : std::false_type {};
+
+template <class T, class Alloc>
+struct vector_can_reallocate<T, Alloc, decltype(void(std::declval<Alloc&>().reallocate(
+    std::declval<T*>(), size_t(), size_t())))>
+    : std::integral_constant<bool, is_trivially_relocatable<T>::value> {};
+
+// vector_transfer_insert
+// 把 [first, last) 搬到新空间 new_first 中，并在 pos 对应的位置留出 n 个位置交给 construct_gap 构造，返回新空间中这个位置
+// 先构造新元素（参数可能引用旧空间中的元素），再搬前后两段；
+// 失败时新空间中已经构造的元素被析构，旧空间不变；成功时调用者析构旧元素（vector_destroy_transferred）并释放旧空间
+template <class T, class ConstructGap>
+T* vector_transfer_insert(T* first, T* pos, T* last, T* new_first, size_t n,
+                          ConstructGap construct_gap)
+{
+    T* gap = new_first + (pos - first);
+    construct_gap(gap);
+    try
+    {
+        T* new_end = ctstl::vector_transfer(first, pos, new_first);
+        try
+        {
+            ctstl::vector_transfer(pos, last, gap + n);
+        }
+        catch (...)
+        {
+            ctstl::destroy(new_first, new_end);
+            throw;
+        }
+    }
+    catch (...)
+    {
+        ctstl::destroy(gap, gap + n);
+        throw;
+    }
+    return gap;
+}
+
+// vector_insert_in_place
+// [pos, last) 之后至少还有 n 个未初始化的位置时，在 pos 处插入 n 个由 construct_gap 构造的元素，last 随之更新
+// 可平凡重定位的类型把 [pos, last) 整体按位后移，构造失败时再移回原处，容器保持不变；
+// 其它类型把 [pos, last) 逐个向后移动，再析构留在间隙中的旧元素，构造失败时丢弃 pos 之后的元素（基本保证）
+template <class T, class ConstructGap>
+void vector_insert_in_place(T* pos, T*& last, size_t n, ConstructGap construct_gap, std::true_type)
+{
+    ctstl::uninitialized_relocate(pos, last, pos + n);
+    try
+    {
+        construct_gap(pos);
+    }
+    catch (...)
+    {
+        ctstl::uninitialized_relocate(pos + n, last + n, pos);
+        throw;
+    }
+    last += n;
+}
+
+template <class T, class ConstructGap>
+void vector_insert_in_place(T* pos, T*& last, size_t n, ConstructGap construct_gap, std::false_type)
+{
+    T* old_last = last;
+    const size_t after = static_cast<size_t>(last - pos);
+    if (after > n)
+    {
+        last = ctstl::uninitialized_move(old_last - n, old_last, old_last);
+        ctstl::move_backward(pos, old_last - n, old_last);
+        ctstl::destroy(pos, pos + n);
+    }
+    else
+    {
+        ctstl::uninitialized_move(pos, old_last, pos + n);
+        last = old_last + n;
+        ctstl::destroy(pos, old_last);
+    }
+    try
+    {
+        construct_gap(pos);
+    }
+    catch (...)
+    {
+        ctstl::destroy(pos + n, last);
+        last = pos;
+        throw;
+    }
+}
+
+template <class T, class ConstructGap>
+void vector_insert_in_place(T* pos, T*& last, size_t n, ConstructGap construct_gap)
+{
+    ctstl::vector_insert_in_place(pos, last, n, construct_gap, is_trivially_relocatable<T>{});
+}
+
+// 模板类: vector
+// 模板参数 T 代表类型，Alloc 代表空间配置器
+// 配置器保存在 compressed_pair 中，无状态的配置器不占空间；有状态的配置器（比如 polymorphic_allocator）随容器保存
+template <class T, class Alloc = ctstl::allocator<T>>
+class vector
+{
+    static_assert(!std::is_same<bool, T>::value, "vector<bool> is abandoned in ctstl");
+
+public:
+    // vector 的嵌套型别定义
+    typedef Alloc                                    allocator_type;
+
+    typedef T                                        value_type;
+    typedef value_type*                              pointer;
+    typedef const value_type*                        const_pointer;
+    typedef value_type&                              reference;
+    typedef const value_type&                        const_reference;
+    typedef size_t                                   size_type;
+    typedef ptrdiff_t                                difference_type;
+
+    typedef value_type*                              iterator;
+    typedef const value_type*                        const_iterator;
+    typedef ctstl::reverse_iterator<iterator>        reverse_iterator;
+    typedef ctstl::reverse_iterator<const_iterator>  const_reverse_iterator;
+
+    allocator_type get_allocator() const { return cap_.first(); }
+
+private:
+    iterator begin_;  // 表示目前使用空间的头部
+    iterator end_;    // 表示目前使用空间的尾部
+    compressed_pair<allocator_type, iterator> cap_;  // 配置器，以及目前储存空间的尾部
+
+public:
+    // 构造、复制、移动、析构函数
+    vector() noexcept
+        : begin_(nullptr), end_(nullptr), cap_(allocator_type(), nullptr)
+    {
+    }
+
+    explicit vector(const allocator_type& a) noexcept
+        : begin_(nullptr), end_(nullptr), cap_(a, nullptr)
+    {
+    }
+
+    explicit vector(size_type n, const allocator_type& a = allocator_type())
+        : begin_(nullptr), end_(nullptr), cap_(a, nullptr)
+    {
+        fill_init(n);
+    }
+
+    vector(size_type n, const value_type& value, const allocator_type& a = allocator_type())
+        : begin_(nullptr), end_(nullptr), cap_(a, nullptr)
+    {
+        fill_init(n, value);
+    }
+
+    template <class Iter, typename std::enable_if<
+        ctstl::is_input_iterator<Iter>::value, int>::type = 0>
+    vector(Iter first, Iter last, const allocator_type& a = allocator_type())
+        : begin_(nullptr), end_(nullptr), cap_(a, nullptr)
+    {
+        range_init(first, last, iterator_category(first));
+    }
+
+    vector(const vector& rhs)
+        : begin_(nullptr), end_(nullptr), cap_(rhs.cap_.first(), nullptr)
+    {
+        range_init(rhs.begin_, rhs.end_, ctstl::random_access_iterator_tag());
+    }
+
+    vector(vector&& rhs) noexcept
+        : begin_(rhs.begin_), end_(rhs.end_), cap_(ctstl::move(rhs.cap_.first()), rhs.cap_.second())
+    {
+        rhs.begin_ = nullptr;
+        rhs.end_ = nullptr;
+        rhs.cap_.second() = nullptr;
+    }
+
+    vector(std::initializer_list<value_type> ilist, const allocator_type& a = allocator_type())
+        : begin_(nullptr), end_(nullptr), cap_(a, nullptr)
+    {
+        range_init(ilist.begin(), ilist.end(), ctstl::random_access_iterator_tag());
+    }
+
+    vector& operator=(const vector& rhs);
+    vector& operator=(vector&& rhs) noexcept(std::is_empty<Alloc>::value);
+
+    vector& operator=(std::initializer_list<value_type> ilist)
+    {
+        assign(ilist.begin(), ilist.end());
+        return *this;
+    }
+
+    ~vector()
+    {
+        destroy_and_deallocate(begin_, end_, cap_.second() - begin_);
+        begin_ = end_ = cap_.second() = nullptr;
+    }
+
+public:
+    // 迭代器相关操作
+    iterator               begin()         noexcept { return begin_; }
+    const_iterator         begin()   const noexcept { return begin_; }
+    iterator               end()           noexcept { return end_; }
+    const_iterator         end()     const noexcept { return end_; }
+
+    reverse_iterator       rbegin()        noexcept { return reverse_iterator(end()); }
+    const_reverse_iterator rbegin()  const noexcept { return const_reverse_iterator(end()); }
+    reverse_iterator       rend()          noexcept { return reverse_iterator(begin()); }
+    const_reverse_iterator rend()    const noexcept { return const_reverse_iterator(begin()); }
+
+    const_iterator         cbegin()  const noexcept { return begin(); }
+    const_iterator         cend()    const noexcept { return end(); }
+    const_reverse_iterator crbegin() const noexcept { return rbegin(); }
+    const_reverse_iterator crend()   const noexcept { return rend(); }
+
+    // 容量相关操作
+    bool      empty()    const noexcept { return begin_ == end_; }
+    size_type size()     const noexcept { return static_cast<size_type>(end_ - begin_); }
+    size_type max_size() const noexcept { return static_cast<size_type>(-1) / sizeof(T); }
+    size_type capacity() const noexcept { return static_cast<size_type>(cap_.second() - begin_); }
+    void      reserve(size_type n);
+    void      shrink_to_fit();
+
+    // 访问元素相关操作
+    reference operator[](size_type n)
+    {
+        CTSTL_DEBUG(n < size());
+        return *(begin_ + n);
+    }
+    const_reference operator[](size_type n) const
+    {
+        CTSTL_DEBUG(n < size());
+        return *(begin_ + n);
+    }
+    reference at(size_type n)
+    {
+        THROW_OUT_RANGE_IF(!(n < size()), "vector<T>::at() subscript out of range");
+        return (*this)[n];
+    }
+    const_reference at(size_type n) const
+    {
+        THROW_OUT_RANGE_IF(!(n < size()), "vector<T>::at() subscript out of range");
+        return (*this)[n];
+    }
+
+    reference front()
+    {
+        CTSTL_DEBUG(!empty());
+        return *begin_;
+    }
+    const_reference front() const
+    {
+        CTSTL_DEBUG(!empty());
+        return *begin_;
+    }
+    reference back()
+    {
+        CTSTL_DEBUG(!empty());
+        return *(end_ - 1);
+    }
+    const_reference back() const
+    {
+        CTSTL_DEBUG(!empty());
+        return *(end_ - 1);
+    }
+
+    pointer       data()       noexcept { return begin_; }
+    const_pointer data() const noexcept { return begin_; }
+
+    // 修改容器相关操作
+
+    // assign
+    void assign(size_type n, const value_type& value)
+    {
+        fill_assign(n, value);
+    }
+
+    template <class Iter, typename std::enable_if<
+        ctstl::is_input_iterator<Iter>::value, int>::type = 0>
+    void assign(Iter first, Iter last)
+    {
+        copy_assign(first, last, iterator_category(first));
+    }
+
+    void assign(std::initializer_list<value_type> il)
+    {
+        copy_assign(il.begin(), il.end(), ctstl::forward_iterator_tag{});
+    }
+
+    // emplace / emplace_back
+    template <class... Args>
+    iterator emplace(const_iterator pos, Args&& ...args);
+
+    template <class... Args>
+    reference emplace_back(Args&& ...args);
+
+    // push_back / pop_back
+    void push_back(const value_type& value) { emplace_back(value); }
+    void push_back(value_type&& value)      { emplace_back(ctstl::move(value)); }
+
+    void pop_back()
+    {
+        CTSTL_DEBUG(!empty());
+        ctstl::destroy(end_ - 1);
+        --end_;
+    }
+
+    // insert
+    iterator insert(const_iterator pos, const value_type& value)
+    {
+        return emplace(pos, value);
+    }
+    iterator insert(const_iterator pos, value_type&& value)
+    {
+        return emplace(pos, ctstl::move(value));
+    }
+
+    iterator insert(const_iterator pos, size_type n, const value_type& value)
+    {
+        CTSTL_DEBUG(pos >= begin() && pos <= end());
+        return fill_insert(const_cast<iterator>(pos), n, value);
+    }
+
+    template <class Iter, typename std::enable_if<
+        ctstl::is_input_iterator<Iter>::value, int>::type = 0>
+    iterator insert(const_iterator pos, Iter first, Iter last)
+    {
+        CTSTL_DEBUG(pos >= begin() && pos <= end());
+        return range_insert(const_cast<iterator>(pos), first, last, iterator_category(first));
+    }
+
+    iterator insert(const_iterator pos, std::initializer_list<value_type> ilist)
+    {
+        return range_insert(const_cast<iterator>(pos), ilist.begin(), ilist.end(),
+                            ctstl::random_access_iterator_tag());
+    }
+
+    // erase / clear
+    iterator erase(const_iterator pos);
+    iterator erase(const_iterator first, const_iterator last);
+    void     clear() noexcept { erase(begin(), end()); }
+
+    // resize
+    void resize(size_type new_size) { resize_impl(new_size); }
+    void resize(size_type new_size, const value_type& value) { resize_impl(new_size, value); }
+
+    void swap(vector& rhs) noexcept;
+
+private:
+    // helper functions
+
+    // 分配、释放
+    iterator allocate_n(size_type n)
+    {
+        return n == 0 ? nullptr : cap_.first().allocate(n);
+    }
+    void deallocate_n(iterator p, size_type n)
+    {
+        if (p != nullptr)
+            cap_.first().deallocate(p, n);
+    }
+    void destroy_and_deallocate(iterator first, iterator last, size_type n)
+    {
+        ctstl::destroy(first, last);
+        deallocate_n(first, n);
+    }
+
+    // initialize
+    // value 为空时值初始化 n 个元素，否则复制 n 个 value
+    template <class... Value>
+    void fill_init(size_type n, const Value&... value);
+
+    // 在 first 开始的未初始化空间中构造 n 个元素，值初始化的版本不要求元素可以复制
+    static iterator construct_n(iterator first, size_type n);
+    static iterator construct_n(iterator first, size_type n, const value_type& value);
+
+    template <class Iter>
+    void range_init(Iter first, Iter last, ctstl::input_iterator_tag);
+    template <class Iter>
+    void range_init(Iter first, Iter last, ctstl::forward_iterator_tag);
+
+    // 把元素搬到容量为 new_cap 的空间，配置器支持时原地调整内存块
+    void reallocate(size_type new_cap)
+    {
+        reallocate(new_cap, vector_can_reallocate<T, Alloc>{});
+    }
+    void reallocate(size_type new_cap, std::true_type);
+    void reallocate(size_type new_cap, std::false_type);
+
+    // 用新的空间替换旧空间，new_begin 中已经有 [new_begin, new_end) 个元素
+    void replace_storage(iterator new_begin, iterator new_end, size_type new_cap)
+    {
+        deallocate_n(begin_, capacity());
+        begin_ = new_begin;
+        end_ = new_end;
+        cap_.second() = new_begin + new_cap;
+    }
+
+    // 重新分配空间，并在 pos 处构造 n 个新元素，返回新空间中这个位置
+    template <class ConstructGap>
+    iterator realloc_insert(iterator pos, size_type n, ConstructGap construct_gap);
+
+    // 备用空间用完时在尾部构造元素
+    template <class... Args>
+    reference realloc_emplace_back(std::true_type, Args&& ...args);
+    template <class... Args>
+    reference realloc_emplace_back(std::false_type, Args&& ...args);
+
+    // assign
+    void fill_assign(size_type n, const value_type& value);
+
+    template <class IIter>
+    void copy_assign(IIter first, IIter last, ctstl::input_iterator_tag);
+    template <class FIter>
+    void copy_assign(FIter first, FIter last, ctstl::forward_iterator_tag);
+
+    // insert
+    iterator fill_insert(iterator pos, size_type n, const value_type& value);
+
+    template <class IIter>
+    iterator range_insert(iterator pos, IIter first, IIter last, ctstl::input_iterator_tag);
+    template <class FIter>
+    iterator range_insert(iterator pos, FIter first, FIter last, ctstl::forward_iterator_tag);
+
+    // 在 pos 处插入 n 个由 construct_gap 构造的元素，备用空间不足时重新分配
+    template <class ConstructGap>
+    iterator insert_n(iterator pos, size_type n, ConstructGap construct_gap);
+
+    template <class... Value>
+    void resize_impl(size_type new_size, const Value&... value);
+};
+
+/*****************************************************************************************/
+
+// 复制赋值操作符
+template <class T, class Alloc>
+vector<T, Alloc>& vector<T, Alloc>::operator=(const vector& rhs)
+{
+    if (this != &rhs)
+        copy_assign(rhs.begin_, rhs.end_, ctstl::forward_iterator_tag());
+    return *this;
+}
+
+// 移动赋值操作符
+// 配置器保持不变：与 rhs 的配置器相等时直接接管 rhs 的空间，否则在自己的空间中逐个移动元素
+template <class T, class Alloc>
+vector<T, Alloc>& vector<T, Alloc>::operator=(vector&& rhs) noexcept(std::is_empty<Alloc>::value)
+{
+    if (this == &rhs)
+        return *this;
+    if (ctstl::allocator_equal(cap_.first(), rhs.cap_.first()))
+    {
+        destroy_and_deallocate(begin_, end_, capacity());
+        begin_ = rhs.begin_;
+        end_ = rhs.end_;
+        cap_.second() = rhs.cap_.second();
+        rhs.begin_ = nullptr;
+        rhs.end_ = nullptr;
+        rhs.cap_.second() = nullptr;
+    }
+    else
+    {
+        clear();
+        reserve(rhs.size());
+        end_ = ctstl::uninitialized_move(rhs.begin_, rhs.end_, begin_);
+        rhs.clear();
+    }
+    return *this;
+}
+
+// 预留空间大小，当原容量小于要求大小时，才会重新分配
+template <class T, class Alloc>
+void vector<T, Alloc>::reserve(size_type n)
+{
+    if (capacity() < n)
+    {
+        THROW_LENGTH_ERROR_IF(n > max_size(),
+                              "n can not larger than max_size() in vector<T>::reserve(n)");
+        reallocate(n);
+    }
+}
+
+// 放弃多余的容量
+template <class T, class Alloc>
+void vector<T, Alloc>::shrink_to_fit()
+{
+    if (end_ < cap_.second())
+        reallocate(size());
+}
+
+// 在 pos 位置就地构造元素，避免额外的复制或移动开销
+template <class T, class Alloc>
+template <class... Args>
+typename vector<T, Alloc>::iterator
+vector<T, Alloc>::emplace(const_iterator pos, Args&& ...args)
+{
+    CTSTL_DEBUG(pos >= begin() && pos <= end());
+    iterator xpos = const_cast<iterator>(pos);
+    if (end_ != cap_.second() && xpos == end_)
+    {
+        ctstl::construct(end_, ctstl::forward<Args>(args)...);
+        ++end_;
+        return xpos;
+    }
+    if (end_ != cap_.second())
+    {
+        // 参数可能引用容器中的元素，先构造出来再移动到位
+        value_type tmp(ctstl::forward<Args>(args)...);
+        return insert_n(xpos, 1, [&](iterator p)
+        {
+            ctstl::construct(p, ctstl::move(tmp));
+        });
+    }
+    return realloc_insert(xpos, 1, [&](iterator p)
+    {
+        ctstl::construct(p, ctstl::forward<Args>(args)...);
+    });
+}
+
+// 在尾部就地构造元素，避免额外的复制或移动开销
+template <class T, class Alloc>
+template <class... Args>
+typename vector<T, Alloc>::reference
+vector<T, Alloc>::emplace_back(Args&& ...args)
+{
+    if (end_ < cap_.second())
+    {
+        ctstl::construct(end_, ctstl::forward<Args>(args)...);
+        ++end_;
+        return *(end_ - 1);
+    }
+    return realloc_emplace_back(vector_can_reallocate<T, Alloc>{}, ctstl::forward<Args>(args)...);
+}
+
+// 删除 pos 位置上的元素
+template <class T, class Alloc>
+typename vector<T, Alloc>::iterator
+vector<T, Alloc>::erase(const_iterator pos)
+{
+    CTSTL_DEBUG(pos >= begin() && pos < end());
+    return erase(pos, pos + 1);
+}
+
+// 删除[first, last)上的元素
+template <class T, class Alloc>
+typename vector<T, Alloc>::iterator
+vector<T, Alloc>::erase(const_iterator first, const_iterator last)
+{
+    CTSTL_DEBUG(first >= begin() && last <= end() && !(last < first));
+    iterator xfirst = const_cast<iterator>(first);
+    iterator xlast = const_cast<iterator>(last);
+    if (xfirst != xlast && is_trivially_relocatable<T>::value)
+    {
+        // 先析构被删除的元素，再把后面的元素按位前移
+        ctstl::destroy(xfirst, xlast);
+        end_ = ctstl::uninitialized_relocate(xlast, end_, xfirst);
+    }
+    else if (xfirst != xlast)
+    {
+        iterator new_end = ctstl::move(xlast, end_, xfirst);
+        ctstl::destroy(new_end, end_);
+        end_ = new_end;
+    }
+    return xfirst;
+}
+
+// 与另一个 vector 交换
+// 只交换空间，不交换配置器，两个 vector 的配置器必须相等
+template <class T, class Alloc>
+void vector<T, Alloc>::swap(vector<T, Alloc>& rhs) noexcept
+{
+    if (this != &rhs)
+    {
+        CTSTL_DEBUG(ctstl::allocator_equal(cap_.first(), rhs.cap_.first()));
+        ctstl::swap(begin_, rhs.begin_);
+        ctstl::swap(end_, rhs.end_);
+        ctstl::swap(cap_.second(), rhs.cap_.second());
+    }
+}
+
+/*****************************************************************************************/
+// helper function
+
+// fill_init 函数
+template <class T, class Alloc>
+template <class... Value>
+void vector<T, Alloc>::fill_init(size_type n, const Value&... value)
+{
+    THROW_LENGTH_ERROR_IF(n > max_size(), "vector<T>'s size too big");
+    begin_ = allocate_n(n);
+    try
+    {
+        end_ = construct_n(begin_, n, value...);
+    }
+    catch (...)
+    {
+        deallocate_n(begin_, n);
+        begin_ = nullptr;
+        throw;
+    }
+    cap_.second() = begin_ + n;
+}
+
+// construct_n 函数
+template <class T, class Alloc>
+typename vector<T, Alloc>::iterator
+vector<T, Alloc>::construct_n(iterator first, size_type n, const value_type& value)
+{
+    return ctstl::uninitialized_fill_n(first, n, value);
+}
+
+template <class T, class Alloc>
+typename vector<T, Alloc>::iterator
+vector<T, Alloc>::construct_n(iterator first, size_type n)
+{
+    iterator cur = first;
+    try
+    {
+        for (; n > 0; --n, ++cur)
+            ctstl::construct(cur);
+    }
+    catch (...)
+    {
+        ctstl::destroy(first, cur);
+        throw;
+    }
+    return cur;
+}
+
+// range_init 函数
+template <class T, class Alloc>
+template <class Iter>
+void vector<T, Alloc>::range_init(Iter first, Iter last, ctstl::input_iterator_tag)
+{
+    try
+    {
+        for (; first != last; ++first)
+            emplace_back(*first);
+    }
+    catch (...)
+    {
+        destroy_and_deallocate(begin_, end_, capacity());
+        begin_ = end_ = cap_.second() = nullptr;
+        throw;
+    }
+}
+
+template <class T, class Alloc>
+template <class Iter>
+void vector<T, Alloc>::range_init(Iter first, Iter last, ctstl::forward_iterator_tag)
+{
+    const size_type n = static_cast<size_type>(ctstl::distance(first, last));
+    THROW_LENGTH_ERROR_IF(n > max_size(), "vector<T>'s size too big");
+    begin_ = allocate_n(n);
+    try
+    {
+        end_ = ctstl::uninitialized_copy(first, last, begin_);
+    }
+    catch (...)
+    {
+        deallocate_n(begin_, n);
+        begin_ = nullptr;
+        throw;
+    }
+    cap_.second() = begin_ + n;
+}
+
+// 调整原来的内存块，元素按字节随之搬移，失败时容器不变
+template <class T, class Alloc>
+void vector<T, Alloc>::reallocate(size_type new_cap, std::true_type)
+{
+    if (begin_ == nullptr)
+    {
+        reallocate(new_cap, std::false_type());
+        return;
+    }
+    const size_type n = size();
+    realloc_result<T> result = cap_.first().reallocate(begin_, capacity(), new_cap);
+    begin_ = result.ptr;
+    end_ = begin_ + n;
+    cap_.second() = begin_ + new_cap;
+}
+
+// 把元素搬到容量为 new_cap 的新空间，成功后释放旧空间
+template <class T, class Alloc>
+void vector<T, Alloc>::reallocate(size_type new_cap, std::false_type)
+{
+    iterator new_begin = allocate_n(new_cap);
+    iterator new_end;
+    try
+    {
+        new_end = ctstl::vector_transfer(begin_, end_, new_begin);
+    }
+    catch (...)
+    {
+        deallocate_n(new_begin, new_cap);
+        throw;
+    }
+    ctstl::vector_destroy_transferred(begin_, end_);
+    replace_storage(new_begin, new_end, new_cap);
+}
+
+// 重新分配空间，并在 pos 处构造 n 个新元素，全部成功之后才析构、释放旧空间
+template <class T, class Alloc>
+template <class ConstructGap>
+typename vector<T, Alloc>::iterator
+vector<T, Alloc>::realloc_insert(iterator pos, size_type n, ConstructGap construct_gap)
+{
+    const size_type new_cap = ctstl::vector_grow_capacity(capacity(), n, max_size());
+    iterator new_begin = allocate_n(new_cap);
+    iterator gap;
+    try
+    {
+        gap = ctstl::vector_transfer_insert(begin_, pos, end_, new_begin, n, construct_gap);
+    }
+    catch (...)
+    {
+        deallocate_n(new_begin, new_cap);
+        throw;
+    }
+    iterator new_end = gap + n + (end_ - pos);
+    ctstl::vector_destroy_transferred(begin_, end_);
+    replace_storage(new_begin, new_end, new_cap);
+    return gap;
+}
+
+// realloc_emplace_back 函数
+// 原地扩展时内存块可能整体移动，参数可能引用容器中的元素，所以先构造出来再移动到位
+template <class T, class Alloc>
+template <class... Args>
+typename vector<T, Alloc>::reference
+vector<T, Alloc>::realloc_emplace_back(std::true_type, Args&& ...args)
+{
+    value_type tmp(ctstl::forward<Args>(args)...);
+    reallocate(ctstl::vector_grow_capacity(capacity(), 1, max_size()));
+    ctstl::construct(end_, ctstl::move(tmp));
+    ++end_;
+    return *(end_ - 1);
+}
+
+template <class T, class Alloc>
+template <class... Args>
+typename vector<T, Alloc>::reference
+vector<T, Alloc>::realloc_emplace_back(std::false_type, Args&& ...args)
+{
+    return *realloc_insert(end_, 1, [&](iterator p)
+    {
+        ctstl::construct(p, ctstl::forward<Args>(args)...);
+    });
+}
+
+// insert_n 函数
+template <class T, class Alloc>
+template <class ConstructGap>
+typename vector<T, Alloc>::iterator
+vector<T, Alloc>::insert_n(iterator pos, size_type n, ConstructGap construct_gap)
+{
+    if (n == 0)
+        return pos;
+    if (static_cast<size_type>(cap_.second() - end_) >= n)
+    {
+        ctstl::vector_insert_in_place(pos, end_, n, construct_gap);
+        return pos;
+    }
+    return realloc_insert(pos, n, construct_gap);
+}
+
+// fill_assign 函数
+template <class T, class Alloc>
+void vector<T, Alloc>::fill_assign(size_type n, const value_type& value)
+{
+    if (n > capacity())
+    {
+        vector tmp(n, value, cap_.first());
+        swap(tmp);
+    }
+    else if (n > size())
+    {
+        ctstl::fill(begin(), end(), value);
+        end_ = ctstl::uninitialized_fill_n(end_, n - size(), value);
+    }
+    else
+    {
+        erase(ctstl::fill_n(begin_, n, value), end_);
+    }
+}
+
+// copy_assign 函数
+template <class T, class Alloc>
+template <class IIter>
+void vector<T, Alloc>::copy_assign(IIter first, IIter last, ctstl::input_iterator_tag)
+{
+    iterator cur = begin_;
+    for (; first != last && cur != end_; ++first, ++cur)
+        *cur = *first;
+    if (first == last)
+    {
+        erase(cur, end_);
+    }
+    else
+    {
+        for (; first != last; ++first)
+            emplace_back(*first);
+    }
+}
+
+// 用 [first, last) 为容器赋值
+template <class T, class Alloc>
+template <class FIter>
+void vector<T, Alloc>::copy_assign(FIter first, FIter last, ctstl::forward_iterator_tag)
+{
+    const size_type len = static_cast<size_type>(ctstl::distance(first, last));
+    if (len > capacity())
+    {
+        vector tmp(first, last, cap_.first());
+        swap(tmp);
+    }
+    else if (size() >= len)
+    {
+        iterator new_end = ctstl::copy(first, last, begin_);
+        ctstl::destroy(new_end, end_);
+        end_ = new_end;
+    }
+    else
+    {
+        FIter mid = first;
+        ctstl::advance(mid, size());
+        ctstl::copy(first, mid, begin_);
+        end_ = ctstl::uninitialized_copy(mid, last, end_);
+    }
+}
+
+// fill_insert 函数
+template <class T, class Alloc>
+typename vector<T, Alloc>::iterator
+vector<T, Alloc>::fill_insert(iterator pos, size_type n, const value_type& value)
+{
+    if (n == 0)
+        return pos;
+    if (static_cast<size_type>(cap_.second() - end_) >= n)
+    {
+        const value_type value_copy = value;  // value 可能引用容器中的元素
+        return insert_n(pos, n, [&](iterator p)
+        {
+            ctstl::uninitialized_fill_n(p, n, value_copy);
+        });
+    }
+    // 重新分配时新元素先于旧元素的搬移构造，value 引用容器中的元素也没有问题
+    return realloc_insert(pos, n, [&](iterator p)
+    {
+        ctstl::uninitialized_fill_n(p, n, value);
+    });
+}
+
+// range_insert 函数
+template <class T, class Alloc>
+template <class IIter>
+typename vector<T, Alloc>::iterator
+vector<T, Alloc>::range_insert(iterator pos, IIter first, IIter last, ctstl::input_iterator_tag)
+{
+    const difference_type offset = pos - begin_;
+    for (; first != last; ++first, ++pos)
+        pos = emplace(pos, *first);
+    return begin_ + offset;
+}
+
+template <class T, class Alloc>
+template <class FIter>
+typename vector<T, Alloc>::iterator
+vector<T, Alloc>::range_insert(iterator pos, FIter first, FIter last, ctstl::forward_iterator_tag)
+{
+    const size_type n = static_cast<size_type>(ctstl::distance(first, last));
+    return insert_n(pos, n, [&](iterator p)
+    {
+        ctstl::uninitialized_copy(first, last, p);
+    });
+}
+
+// resize_impl 函数，value 为空时值初始化新的元素
+template <class T, class Alloc>
+template <class... Value>
+void vector<T, Alloc>::resize_impl(size_type new_size, const Value&... value)
+{
+    if (new_size < size())
+    {
+        erase(begin() + new_size, end());
+    }
+    else if (new_size > size())
+    {
+        const size_type n = new_size - size();
+        if (static_cast<size_type>(cap_.second() - end_) < n &&
+            vector_can_reallocate<T, Alloc>::value && sizeof...(Value) == 0)
+        {
+            // 值初始化的新元素不引用容器中的元素，可以先原地扩展再构造
+            reallocate(ctstl::vector_grow_capacity(capacity(), n, max_size()));
+            end_ = construct_n(end_, n, value...);
+        }
+        else if (static_cast<size_type>(cap_.second() - end_) < n)
+        {
+            // 新元素在新空间中构造，失败时容器不变
+            realloc_insert(end_, n, [&](iterator p)
+            {
+                construct_n(p, n, value...);
+            });
+        }
+        else
+        {
+            end_ = construct_n(end_, n, value...);
+        }
+    }
+}
+
+/*****************************************************************************************/
+// 重载比较操作符
+
+template <class T, class Alloc>
+bool operator==(const vector<T, Alloc>& lhs, const vector<T, Alloc>& rhs)
+{
+    return lhs.size() == rhs.size() &&
+        ctstl::equal(lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
+}
+
+template <class T, class Alloc>
+bool operator<(const vector<T, Alloc>& lhs, const vector<T, Alloc>& rhs)
+{
+    return ctstl::lexicographical_compare(lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
+}
+
+template <class T, class Alloc>
+bool operator!=(const vector<T, Alloc>& lhs, const vector<T, Alloc>& rhs)
+{
+    return !(lhs == rhs);
+}
+
+template <class T, class Alloc>
+bool operator>(const vector<T, Alloc>& lhs, const vector<T, Alloc>& rhs)
+{
+    return rhs < lhs;
+}
+
+template <class T, class Alloc>
+bool operator<=(const vector<T, Alloc>& lhs, const vector<T, Alloc>& rhs)
+{
+    return !(rhs < lhs);
+}
+
+template <class T, class Alloc>
+bool operator>=(const vector<T, Alloc>& lhs, const vector<T, Alloc>& rhs)
+{
+    return !(lhs < rhs);
+}
+
+// 重载 ctstl 的 swap
+template <class T, class Alloc>
+void swap(vector<T, Alloc>& lhs, vector<T, Alloc>& rhs) noexcept
+{
+    lhs.swap(rhs);
+}
+
+// vector 只保存三个指针和配置器，配置器可以平凡重定位时 vector 也可以
+template <class T, class Alloc>
+struct is_trivially_relocatable<vector<T, Alloc>> : is_trivially_relocatable<Alloc> {};
 
-#endif
\ No newline at end of file
+} // namespace ctstl
+#endif // !CTSTL_VECTOR_H_
@@ -1,10 +1,41 @@
 #include <iostream>
 #include <vector>
 #include <deque>
-
+#include <chrono>
+#include <algorithm>
+#include "../../CTSTL/deque.h"
 using namespace std;
 
+// 对比 std::deque 与 ctstl::deque：对象大小，以及分段迭代器上 copy / fill 的耗时
+// ctstl 的 copy / fill 识别分段迭代器，对每个连续的块调用 memmove / memset，std 版本逐个元素处理
+// 编译：g++ -std=c++11 -O2 test.cpp
+
+template <class F>
+double time_ms(F f)
+{
+    auto start = chrono::steady_clock::now();
+    f();
+    return chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+}
+
 int main()
 { 
-    cout << sizeof(deque<int>) << endl;
-}
\ No newline at end of file
+    cout << "sizeof(std::deque<int>)   = " << sizeof(deque<int>) << endl;
+    cout << "sizeof(ctstl::deque<int>) = " << sizeof(ctstl::deque<int>) << endl;
+
+    const size_t n = 10000000;
+    const int rounds = 10;
+    deque<int> sa(n, 1), sb(n);
+    ctstl::deque<int> ca(n, 1), cb(n);
+
+    double t1 = time_ms([&] { for (int i = 0; i < rounds; ++i) std::copy(sa.begin(), sa.end(), sb.begin()); });
+    double t2 = time_ms([&] { for (int i = 0; i < rounds; ++i) ctstl::copy(ca.begin(), ca.end(), cb.begin()); });
+    cout << "copy " << n << " ints x " << rounds << ": std " << t1 << " ms, ctstl " << t2 << " ms" << endl;
+
+    t1 = time_ms([&] { for (int i = 0; i < rounds; ++i) std::fill(sb.begin(), sb.end(), i); });
+    t2 = time_ms([&] { for (int i = 0; i < rounds; ++i) ctstl::fill(cb.begin(), cb.end(), i); });
+    cout << "fill " << n << " ints x " << rounds << ": std " << t1 << " ms, ctstl " << t2 << " ms" << endl;
+
+    // 防止结果被优化掉
+    cout << sb[n / 2] + cb[n / 2] << endl;
+}
@@ -0,0 +1,114 @@
+// 读多写少的快照发布：atomic_shared_ptr 与“互斥锁保护的 shared_ptr”对比
+// 若干读者线程不停地取出当前快照并读取其中的数据，一个写者线程每隔一段时间发布新的快照
+// 每种线程数运行固定的时间，输出所有读者合计的吞吐量
+//
+// 编译：g++ -std=c++11 -O2 -pthread atomic_shared_ptr_bench.cpp -o atomic_shared_ptr_bench
+// 运行：./atomic_shared_ptr_bench [每轮毫秒数，缺省 200] [最多读者线程数，缺省 64]
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "../CTSTL/memory.h"
+#include "bench_util.h"
+
+namespace
+{
+
+struct config
+{
+    long version;
+    long values[15];
+};
+
+// 互斥锁保护的 shared_ptr
+class locked_ptr
+{
+public:
+    explicit locked_ptr(ctstl::shared_ptr<config> p) : ptr_(ctstl::move(p)) {}
+
+    ctstl::shared_ptr<config> load() const
+    {
+        std::lock_guard<std::mutex> guard(mutex_);
+        return ptr_;
+    }
+
+    void store(ctstl::shared_ptr<config> p)
+    {
+        std::lock_guard<std::mutex> guard(mutex_);
+        ptr_.swap(p);
+    }
+
+private:
+    mutable std::mutex        mutex_;
+    ctstl::shared_ptr<config> ptr_;
+};
+
+ctstl::shared_ptr<config> make_config(long version)
+{
+    ctstl::shared_ptr<config> p = ctstl::make_shared<config>();
+    p->version = version;
+    for (long& v : p->values)
+        v = version;
+    return p;
+}
+
+// 返回读者每秒合计读取的次数（百万次）
+template <class Holder>
+double run(size_t readers, size_t duration_ms)
+{
+    Holder holder(make_config(0));
+    std::atomic<bool> stop(false);
+    std::vector<unsigned long long> counts(readers * 8);  // 每个计数占一条 cache line
+    std::vector<std::thread> threads;
+    for (size_t i = 0; i < readers; ++i)
+    {
+        threads.emplace_back([&, i]
+        {
+            unsigned long long n = 0;
+            long sum = 0;
+            while (!stop.load(std::memory_order_relaxed))
+            {
+                ctstl::shared_ptr<config> p = holder.load();
+                sum += p->values[n % 15];
+                ++n;
+            }
+            bench::do_not_optimize(sum);
+            counts[i * 8] = n;
+        });
+    }
+    threads.emplace_back([&]
+    {
+        for (long version = 1; !stop.load(std::memory_order_relaxed); ++version)
+        {
+            holder.store(make_config(version));
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    });
+    std::this_thread::sleep_for(std::chrono::milliseconds(duration_ms));
+    stop.store(true);
+    for (auto& t : threads)
+        t.join();
+    unsigned long long total = 0;
+    for (size_t i = 0; i < readers; ++i)
+        total += counts[i * 8];
+    return static_cast<double>(total) / static_cast<double>(duration_ms) / 1000.0;
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    const size_t duration_ms = bench::arg_or(argc, argv, 1, 200);
+    const size_t max_readers = bench::arg_or(argc, argv, 2, 64);
+    std::printf("%8s %22s %22s\n", "readers", "atomic_shared_ptr", "mutex + shared_ptr");
+    for (size_t readers = 1; readers <= max_readers; readers *= 2)
+    {
+        const double a = run<ctstl::atomic_shared_ptr<config>>(readers, duration_ms);
+        const double m = run<locked_ptr>(readers, duration_ms);
+        std::printf("%8zu %15.1f Mops/s %15.1f Mops/s\n", readers, a, m);
+    }
+}
@@ -0,0 +1,59 @@
+#ifndef CTSTL_BENCH_UTIL_H_
+#define CTSTL_BENCH_UTIL_H_
+
+// bench 目录下各个基准测试共用的小工具：计时、防止结果被优化掉、读取命令行参数
+// 每个基准测试都是单独的源文件，编译方式写在各自的开头
+
+#include <chrono>
+#include <cstddef>
+#include <cstdlib>
+
+namespace bench
+{
+
+// 执行一次 f，返回耗时（毫秒）
+template <class F>
+double time_ms(F f)
+{
+    const auto start = std::chrono::steady_clock::now();
+    f();
+    const auto stop = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::milli>(stop - start).count();
+}
+
+// 让编译器认为 value 被读取过，计算它的代码不会被删除
+template <class T>
+inline void do_not_optimize(const T& value)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    asm volatile("" : : "g"(&value) : "memory");
+#else
+    static const volatile void* sink;
+    sink = &value;
+#endif
+}
+
+// 第 index 个命令行参数（从 1 开始），不存在时返回 def
+inline size_t arg_or(int argc, char** argv, int index, size_t def)
+{
+    return index < argc ? static_cast<size_t>(std::strtoull(argv[index], nullptr, 10)) : def;
+}
+
+// 简单快速的伪随机数，所有基准测试使用相同的序列
+struct xorshift64
+{
+    unsigned long long state;
+
+    explicit xorshift64(unsigned long long seed = 88172645463325252ull) : state(seed) {}
+
+    unsigned long long operator()()
+    {
+        state ^= state << 13;
+        state ^= state >> 7;
+        state ^= state << 17;
+        return state;
+    }
+};
+
+} // namespace bench
+#endif // !CTSTL_BENCH_UTIL_H_
@@ -0,0 +1,118 @@
+// btree_map 与 std::map 对比：随机插入、随机查找、中序遍历，以及从有序序列批量构造
+// （btree_map 用 sorted_unique 构造，std::map 逐个在 end() 处带提示插入，两者都是 O(n)）
+// 键为随机的 64 位整数，每种规模先测 btree_map 再测 std::map，测完即释放，峰值内存只有一个容器
+// std::map 每个节点约 48 字节，1 亿个元素需要约 5 GB 内存
+//
+// 编译：g++ -std=c++11 -O2 btree_bench.cpp -o btree_bench
+// 运行：./btree_bench [元素个数...，缺省 1000000 10000000 100000000]
+
+#include <algorithm>
+#include <cstdio>
+#include <map>
+#include <vector>
+
+#include "../CTSTL/btree_map.h"
+#include "bench_util.h"
+
+namespace
+{
+
+typedef unsigned long long key_type;
+
+struct result
+{
+    double insert_ms;
+    double find_ms;
+    double scan_ms;
+    double bulk_ms;
+};
+
+double ns_per(double ms, size_t n)
+{
+    return ms * 1e6 / static_cast<double>(n);
+}
+
+template <class Map, class Insert, class Bulk>
+result run(const std::vector<key_type>& keys, const std::vector<ctstl::pair<key_type, key_type>>& sorted,
+           Insert insert, Bulk bulk)
+{
+    result r;
+    key_type sum = 0;
+    {
+        Map m;
+        r.insert_ms = bench::time_ms([&]
+        {
+            for (key_type k : keys)
+                insert(m, k);
+        });
+        r.find_ms = bench::time_ms([&]
+        {
+            for (key_type k : keys)
+                sum += m.find(k)->second;
+        });
+        r.scan_ms = bench::time_ms([&]
+        {
+            for (typename Map::const_iterator it = m.begin(); it != m.end(); ++it)
+                sum += it->second;
+        });
+    }
+    r.bulk_ms = bench::time_ms([&]
+    {
+        Map m = bulk(sorted);
+        sum += m.size();
+    });
+    bench::do_not_optimize(sum);
+    return r;
+}
+
+void report(const char* name, const result& r, size_t n)
+{
+    std::printf("  %-10s insert %7.1f ns  find %7.1f ns  scan %6.2f ns  bulk load %6.2f ns\n",
+                name, ns_per(r.insert_ms, n), ns_per(r.find_ms, n),
+                ns_per(r.scan_ms, n), ns_per(r.bulk_ms, n));
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    std::vector<size_t> sizes;
+    for (int i = 1; i < argc; ++i)
+        sizes.push_back(bench::arg_or(argc, argv, i, 0));
+    if (sizes.empty())
+        sizes = {1000000, 10000000, 100000000};
+
+    typedef ctstl::pair<key_type, key_type> pair_type;
+    for (size_t n : sizes)
+    {
+        std::vector<key_type> keys(n);
+        bench::xorshift64 rng;
+        for (key_type& k : keys)
+            k = rng();
+        std::vector<pair_type> sorted;
+        sorted.reserve(n);
+        for (key_type k : keys)
+            sorted.push_back(pair_type(k, k));
+        std::sort(sorted.begin(), sorted.end());
+        sorted.erase(std::unique(sorted.begin(), sorted.end()), sorted.end());
+
+        std::printf("n = %zu, per element\n", n);
+        typedef ctstl::btree_map<key_type, key_type> btree_type;
+        report("btree_map", run<btree_type>(keys, sorted,
+            [](btree_type& m, key_type k) { m.insert(ctstl::make_pair(k, k)); },
+            [](const std::vector<pair_type>& s)
+            {
+                return btree_type(ctstl::sorted_unique, s.begin(), s.end());
+            }), n);
+        typedef std::map<key_type, key_type> map_type;
+        report("std::map", run<map_type>(keys, sorted,
+            [](map_type& m, key_type k) { m.emplace(k, k); },
+            [](const std::vector<pair_type>& s)
+            {
+                map_type m;
+                for (const pair_type& p : s)
+                    m.emplace_hint(m.end(), p.first, p.second);
+                return m;
+            }), n);
+    }
+}
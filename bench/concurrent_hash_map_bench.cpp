@@ -0,0 +1,124 @@
+// concurrent_hash_map 的可扩展性：1~64 个线程，读写比例 100/0、90/10、50/50
+// 对比一把互斥锁保护的 std::unordered_map
+// 键空间预先填入一半，写操作一半为 insert_or_assign、一半为 erase，总操作数固定，平均分给各个线程
+//
+// 编译：g++ -std=c++11 -O2 -pthread concurrent_hash_map_bench.cpp -o concurrent_hash_map_bench
+// 运行：./concurrent_hash_map_bench [总操作数，缺省 8000000] [最多线程数，缺省 64] [键空间，缺省 1000000]
+
+#include <cstdio>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "../CTSTL/concurrent_hash_map.h"
+#include "bench_util.h"
+
+namespace
+{
+
+typedef unsigned long long key_type;
+
+struct locked_map
+{
+    std::mutex                             mutex;
+    std::unordered_map<key_type, key_type> map;
+
+    bool find(key_type k, key_type& v)
+    {
+        std::lock_guard<std::mutex> guard(mutex);
+        auto it = map.find(k);
+        if (it == map.end())
+            return false;
+        v = it->second;
+        return true;
+    }
+
+    void insert_or_assign(key_type k, key_type v)
+    {
+        std::lock_guard<std::mutex> guard(mutex);
+        map[k] = v;
+    }
+
+    void erase(key_type k)
+    {
+        std::lock_guard<std::mutex> guard(mutex);
+        map.erase(k);
+    }
+};
+
+struct lock_free_map
+{
+    ctstl::concurrent_hash_map<key_type, key_type> map;
+
+    bool find(key_type k, key_type& v) { return map.find(k, v); }
+    void insert_or_assign(key_type k, key_type v) { map.insert_or_assign(k, v); }
+    void erase(key_type k) { map.erase(k); }
+};
+
+// 返回每秒的操作数（百万次）
+template <class Map>
+double run(size_t threads, size_t total_ops, unsigned read_percent, size_t keys)
+{
+    Map m;
+    for (key_type k = 0; k < keys; k += 2)
+        m.insert_or_assign(k, k);
+    const size_t per_thread = total_ops / threads;
+    std::vector<std::thread> workers;
+    const double ms = bench::time_ms([&]
+    {
+        for (size_t t = 0; t < threads; ++t)
+        {
+            workers.emplace_back([&, t]
+            {
+                bench::xorshift64 rng(0x9E3779B97F4A7C15ull * (t + 1));
+                key_type sum = 0;
+                for (size_t i = 0; i < per_thread; ++i)
+                {
+                    const unsigned long long r = rng();
+                    const key_type k = (r >> 8) % keys;
+                    const unsigned op = static_cast<unsigned>(r % 100);
+                    if (op < read_percent)
+                    {
+                        key_type v;
+                        if (m.find(k, v))
+                            sum += v;
+                    }
+                    else if (op & 1)
+                    {
+                        m.insert_or_assign(k, k);
+                    }
+                    else
+                    {
+                        m.erase(k);
+                    }
+                }
+                bench::do_not_optimize(sum);
+            });
+        }
+        for (auto& w : workers)
+            w.join();
+    });
+    return static_cast<double>(per_thread * threads) / ms / 1000.0;
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    const size_t total_ops = bench::arg_or(argc, argv, 1, 8000000);
+    const size_t max_threads = bench::arg_or(argc, argv, 2, 64);
+    const size_t keys = bench::arg_or(argc, argv, 3, 1000000);
+    std::printf("%zu operations, %zu keys\n", total_ops, keys);
+    for (unsigned read_percent : {100u, 90u, 50u})
+    {
+        std::printf("reads %u%%\n%8s %24s %24s\n", read_percent, "threads",
+                    "concurrent_hash_map", "mutex + unordered_map");
+        for (size_t threads = 1; threads <= max_threads; threads *= 2)
+        {
+            const double c = run<lock_free_map>(threads, total_ops, read_percent, keys);
+            const double l = run<locked_map>(threads, total_ops, read_percent, keys);
+            std::printf("%8zu %17.2f Mops/s %17.2f Mops/s\n", threads, c, l);
+        }
+    }
+}
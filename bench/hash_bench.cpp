@@ -0,0 +1,112 @@
+// 哈希函数的吞吐量与分布质量
+// 1. 吞吐量：hash<uint64_t> 与 identity_hash 每个键的耗时；bitwise_hash 与逐字节的 FNV-1a（原来的实现）在不同长度上的 GB/s
+// 2. 分布质量：把有规律的整数键（步长为 2 的幂、只有高位变化）放进 2^k 个桶，按低位取桶号，
+//    统计空桶比例与最长的桶，与理想的随机分布对比
+//
+// 编译：g++ -std=c++11 -O2 hash_bench.cpp -o hash_bench
+// 运行：./hash_bench [整数键个数，缺省 20000000]
+
+#include <cstdint>
+#include <cstdio>
+#include <vector>
+
+#include "../CTSTL/functional.h"
+#include "bench_util.h"
+
+namespace
+{
+
+// 原来的 bitwise_hash：逐字节的 FNV-1a
+size_t fnv1a(const unsigned char* first, size_t count)
+{
+    size_t result = static_cast<size_t>(14695981039346656037ull);
+    for (size_t i = 0; i < count; ++i)
+    {
+        result ^= static_cast<size_t>(first[i]);
+        result *= static_cast<size_t>(1099511628211ull);
+    }
+    return result;
+}
+
+template <class Hash>
+void integer_throughput(const char* name, size_t n)
+{
+    Hash h;
+    size_t sum = 0;
+    const double ms = bench::time_ms([&]
+    {
+        for (uint64_t i = 0; i < n; ++i)
+            sum += h(i * 0x9E3779B97F4A7C15ull);
+    });
+    bench::do_not_optimize(sum);
+    std::printf("  %-32s %6.2f ns/key\n", name, ms * 1e6 / static_cast<double>(n));
+}
+
+template <class Fn>
+double bytes_throughput(const std::vector<unsigned char>& buf, size_t len, Fn fn)
+{
+    const size_t rounds = (size_t(1) << 28) / len;  // 每种长度共哈希 256 MiB
+    const size_t span = buf.size() - len;
+    size_t sum = 0;
+    const double ms = bench::time_ms([&]
+    {
+        for (size_t r = 0; r < rounds; ++r)
+            sum += fn(buf.data() + (r * 64) % span, len);
+    });
+    bench::do_not_optimize(sum);
+    return static_cast<double>(rounds * len) / ms / 1e6;
+}
+
+// 按低位取桶号，返回空桶比例与最长的桶
+template <class Hash>
+void bucket_quality(const char* name, unsigned bucket_bits, unsigned stride_bits)
+{
+    const size_t buckets = size_t(1) << bucket_bits;
+    std::vector<unsigned> load(buckets);
+    Hash h;
+    for (uint64_t i = 0; i < buckets; ++i)
+        ++load[h(i << stride_bits) & (buckets - 1)];
+    size_t empty = 0;
+    unsigned longest = 0;
+    for (unsigned c : load)
+    {
+        empty += c == 0;
+        longest = c > longest ? c : longest;
+    }
+    std::printf("  %-32s keys i << %-2u  empty %5.1f%%  longest %u\n", name, stride_bits,
+                100.0 * static_cast<double>(empty) / static_cast<double>(buckets), longest);
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    const size_t n = bench::arg_or(argc, argv, 1, 20000000);
+
+    std::printf("integer keys (%zu)\n", n);
+    integer_throughput<ctstl::identity_hash<uint64_t>>("identity_hash<uint64_t>", n);
+    integer_throughput<ctstl::hash<uint64_t>>("hash<uint64_t> (mixed)", n);
+
+    std::printf("byte ranges, GB/s\n");
+    std::vector<unsigned char> buf((size_t(1) << 20) + 4096);
+    bench::xorshift64 rng;
+    for (unsigned char& c : buf)
+        c = static_cast<unsigned char>(rng());
+    for (size_t len : {8, 16, 32, 64, 256, 1024, 65536})
+    {
+        const double fnv = bytes_throughput(buf, len, fnv1a);
+        const double wide = bytes_throughput(buf, len, [](const unsigned char* p, size_t l)
+        {
+            return ctstl::bitwise_hash(p, l);
+        });
+        std::printf("  len %6zu  FNV-1a %6.2f  bitwise_hash %6.2f\n", len, fnv, wide);
+    }
+
+    // 2^16 个键放进 2^16 个桶，随机分布时约 36.8% 的桶为空，最长的桶通常为 7~8
+    std::printf("bucket distribution (2^16 keys into 2^16 buckets, random: ~36.8%% empty)\n");
+    for (unsigned stride : {0u, 8u, 16u, 32u})
+    {
+        bucket_quality<ctstl::identity_hash<uint64_t>>("identity_hash<uint64_t>", 16, stride);
+        bucket_quality<ctstl::hash<uint64_t>>("hash<uint64_t>", 16, stride);
+    }
+}
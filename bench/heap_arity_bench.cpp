@@ -0,0 +1,94 @@
+// 堆算法的分叉数：2 / 4 / 8 叉堆在 1 万到 1 亿个元素上的 make_heap、push_heap、pop_heap
+// 元素为随机的 unsigned，1 亿个元素约 400 MB，测试时同时存在原始数据与一份工作副本
+// push_heap：从空区间开始逐个插入全部元素；pop_heap：在建好的堆上弹出 min(n, 100 万) 次
+// 以 std::make_heap / push_heap / pop_heap（二叉堆）作为参照
+//
+// 编译：g++ -std=c++11 -O2 heap_arity_bench.cpp -o heap_arity_bench
+// 运行：./heap_arity_bench [元素个数...，缺省 10000 100000 1000000 10000000 100000000]
+
+#include <algorithm>
+#include <cstdio>
+
+#include "../CTSTL/heap_algo.h"
+#include "../CTSTL/vector.h"
+#include "bench_util.h"
+
+namespace
+{
+
+typedef ctstl::vector<unsigned> vector_type;
+
+double ns_per(double ms, size_t n)
+{
+    return ms * 1e6 / static_cast<double>(n);
+}
+
+template <class Make, class Push, class Pop>
+void run(const char* name, const vector_type& src, Make make, Push push, Pop pop)
+{
+    const size_t n = src.size();
+    const size_t pops = n < 1000000 ? n : 1000000;
+    vector_type v(src);
+    const double make_ms = bench::time_ms([&] { make(v.begin(), v.end()); });
+    unsigned long long sum = 0;
+    const double pop_ms = bench::time_ms([&]
+    {
+        vector_type::iterator last = v.end();
+        for (size_t i = 0; i < pops; ++i, --last)
+        {
+            pop(v.begin(), last);
+            sum += *(last - 1);
+        }
+    });
+    const double push_ms = bench::time_ms([&]
+    {
+        v.clear();
+        for (size_t i = 0; i < n; ++i)
+        {
+            v.push_back(src[i]);
+            push(v.begin(), v.end());
+        }
+    });
+    bench::do_not_optimize(sum);
+    bench::do_not_optimize(v);
+    std::printf("  %-12s make %6.2f ns/elem  push %6.2f ns/op  pop %7.1f ns/op\n",
+                name, ns_per(make_ms, n), ns_per(push_ms, n), ns_per(pop_ms, pops));
+}
+
+template <size_t Arity>
+void run_arity(const char* name, const vector_type& src)
+{
+    typedef vector_type::iterator iter;
+    run(name, src,
+        [](iter f, iter l) { ctstl::make_heap<Arity>(f, l); },
+        [](iter f, iter l) { ctstl::push_heap<Arity>(f, l); },
+        [](iter f, iter l) { ctstl::pop_heap<Arity>(f, l); });
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    vector_type sizes;
+    for (int i = 1; i < argc; ++i)
+        sizes.push_back(static_cast<unsigned>(bench::arg_or(argc, argv, i, 0)));
+    if (sizes.empty())
+        sizes = {10000, 100000, 1000000, 10000000, 100000000};
+
+    typedef vector_type::iterator iter;
+    for (size_t n : sizes)
+    {
+        vector_type src(n);
+        bench::xorshift64 rng;
+        for (unsigned& x : src)
+            x = static_cast<unsigned>(rng());
+        std::printf("n = %zu\n", n);
+        run("std (2)", src,
+            [](iter f, iter l) { std::make_heap(f, l); },
+            [](iter f, iter l) { std::push_heap(f, l); },
+            [](iter f, iter l) { std::pop_heap(f, l); });
+        run_arity<2>("arity 2", src);
+        run_arity<4>("arity 4", src);
+        run_arity<8>("arity 8", src);
+    }
+}
@@ -0,0 +1,78 @@
+// 链表的尾部追加与遍历：ctstl::list（slab 节点 / allocator 节点）、std::list，以及 STLNote 中的 List
+// STLNote 的 List::insert_end 每次都从头走到尾，追加是 O(n) 的，节点也从不释放，所以只在较小的规模上参与比较
+//
+// 编译：g++ -std=c++11 -O2 list_bench.cpp -o list_bench
+// 运行：./list_bench [STLNote List 的元素个数，缺省 20000] [其它链表的元素个数，缺省 5000000]
+
+#include <cstdio>
+#include <list>
+
+#include "../CTSTL/list.h"
+#include "../STLNote/3_STL_iterator/3_2_mylist.h"
+#include "bench_util.h"
+
+namespace
+{
+
+void report(const char* name, size_t n, double append_ms, double traverse_ms)
+{
+    std::printf("%-28s n=%-9zu append %9.2f ms (%6.1f ns/elem)  traverse %7.2f ms (%5.2f ns/elem)\n",
+                name, n, append_ms, append_ms * 1e6 / static_cast<double>(n),
+                traverse_ms, traverse_ms * 1e6 / static_cast<double>(n));
+}
+
+template <class List>
+void run(const char* name, size_t n)
+{
+    List l;
+    const double append_ms = bench::time_ms([&]
+    {
+        for (size_t i = 0; i < n; ++i)
+            l.push_back(static_cast<int>(i));
+    });
+    long sum = 0;
+    const double traverse_ms = bench::time_ms([&]
+    {
+        for (typename List::const_iterator it = l.begin(); it != l.end(); ++it)
+            sum += *it;
+    });
+    bench::do_not_optimize(sum);
+    report(name, n, append_ms, traverse_ms);
+}
+
+// STLNote 的 List：空链表上不能 insert_end，第一个元素用 insert_front
+void run_stlnote(size_t n)
+{
+    List<int> l;
+    const double append_ms = bench::time_ms([&]
+    {
+        l.insert_front(0);
+        for (size_t i = 1; i < n; ++i)
+            l.insert_end(static_cast<int>(i));
+    });
+    long sum = 0;
+    const double traverse_ms = bench::time_ms([&]
+    {
+        for (ListItem<int>* p = l.front(); p != nullptr; p = p->next())
+            sum += p->value();
+    });
+    bench::do_not_optimize(sum);
+    report("STLNote List", n, append_ms, traverse_ms);
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    const size_t small_n = bench::arg_or(argc, argv, 1, 20000);
+    const size_t large_n = bench::arg_or(argc, argv, 2, 5000000);
+
+    run_stlnote(small_n);
+    run<std::list<int>>("std::list", small_n);
+    run<ctstl::list<int>>("ctstl::list (slab)", small_n);
+    run<ctstl::list<int, ctstl::allocator<int>>>("ctstl::list (allocator)", small_n);
+
+    run<std::list<int>>("std::list", large_n);
+    run<ctstl::list<int>>("ctstl::list (slab)", large_n);
+    run<ctstl::list<int, ctstl::allocator<int>>>("ctstl::list (allocator)", large_n);
+}
@@ -0,0 +1,84 @@
+// small_vector 的堆分配次数与耗时，内联容量 N = 4 / 8 / 16，与 vector 对比
+// 模拟“每个请求一个短列表”的负载：大多数列表只有几个元素，少数比较长
+//
+// 编译：g++ -std=c++11 -O2 small_vector_bench.cpp -o small_vector_bench
+// 运行：./small_vector_bench [列表个数，缺省 2000000]
+
+#include <cstdio>
+
+#include "../CTSTL/vector.h"
+#include "../CTSTL/small_vector.h"
+#include "bench_util.h"
+
+namespace
+{
+
+// 统计分配次数的配置器，其它行为与 allocator 相同
+struct alloc_counter
+{
+    static size_t count;
+};
+size_t alloc_counter::count = 0;
+
+template <class T>
+class counting_allocator : public ctstl::allocator<T>
+{
+public:
+    template <class U>
+    struct rebind
+    {
+        typedef counting_allocator<U> other;
+    };
+
+    static T* allocate(size_t n)
+    {
+        ++alloc_counter::count;
+        return ctstl::allocator<T>::allocate(n);
+    }
+};
+
+// 列表长度：约 70% 为 1~4 个，20% 为 5~8 个，8% 为 9~16 个，2% 为 17~64 个
+size_t list_length(bench::xorshift64& rng)
+{
+    const unsigned r = static_cast<unsigned>(rng() % 100);
+    if (r < 70) return 1 + rng() % 4;
+    if (r < 90) return 5 + rng() % 4;
+    if (r < 98) return 9 + rng() % 8;
+    return 17 + rng() % 48;
+}
+
+template <class Vec>
+void run(const char* name, size_t lists)
+{
+    bench::xorshift64 rng;
+    alloc_counter::count = 0;
+    long sum = 0;
+    const double ms = bench::time_ms([&]
+    {
+        for (size_t i = 0; i < lists; ++i)
+        {
+            Vec v;
+            const size_t len = list_length(rng);
+            for (size_t k = 0; k < len; ++k)
+                v.push_back(static_cast<int>(k));
+            for (size_t k = 0; k < v.size(); ++k)
+                sum += v[k];
+        }
+    });
+    bench::do_not_optimize(sum);
+    std::printf("%-24s %6zu bytes %10zu allocations (%.2f per list) %8.1f ms\n",
+                name, sizeof(Vec), alloc_counter::count,
+                static_cast<double>(alloc_counter::count) / static_cast<double>(lists), ms);
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    const size_t lists = bench::arg_or(argc, argv, 1, 2000000);
+    std::printf("%zu lists of int\n", lists);
+    run<ctstl::vector<int, counting_allocator<int>>>("vector", lists);
+    run<ctstl::small_vector<int, 4, counting_allocator<int>>>("small_vector<int, 4>", lists);
+    run<ctstl::small_vector<int, 8, counting_allocator<int>>>("small_vector<int, 8>", lists);
+    run<ctstl::small_vector<int, 16, counting_allocator<int>>>("small_vector<int, 16>", lists);
+}
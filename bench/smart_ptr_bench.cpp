@@ -0,0 +1,96 @@
+// 智能指针的创建与复制开销，与 std 版本对比
+// 创建：unique_ptr / make_unique，shared_ptr(new T)（两次分配），make_shared（一次分配），intrusive_ptr
+// 复制：shared_ptr 与 intrusive_ptr 的复制、析构（原子加减引用计数）
+//
+// 程序只有一个线程时 libstdc++ 的 shared_ptr 改用非原子的计数，所以开始时先创建一个线程，两边都使用原子操作
+//
+// 编译：g++ -std=c++14 -O2 -pthread smart_ptr_bench.cpp -o smart_ptr_bench
+// 运行：./smart_ptr_bench [次数，缺省 10000000]
+
+#include <cstdio>
+#include <memory>
+#include <thread>
+
+#include "../CTSTL/memory.h"
+#include "bench_util.h"
+
+namespace
+{
+
+struct payload
+{
+    long value[4];
+    explicit payload(long v) : value{v, v, v, v} {}
+};
+
+struct counted : ctstl::intrusive_ref_counter<counted>
+{
+    long value[4];
+    explicit counted(long v) : value{v, v, v, v} {}
+};
+
+void report(const char* name, size_t n, double ms)
+{
+    std::printf("%-34s %8.1f ms %7.2f ns/op\n", name, ms, ms * 1e6 / static_cast<double>(n));
+}
+
+// 创建并立即销毁 n 个对象
+template <class Make>
+void create(const char* name, size_t n, Make make)
+{
+    long sum = 0;
+    const double ms = bench::time_ms([&]
+    {
+        for (size_t i = 0; i < n; ++i)
+        {
+            auto p = make(static_cast<long>(i));
+            bench::do_not_optimize(p);
+            sum += p->value[0];
+        }
+    });
+    bench::do_not_optimize(sum);
+    report(name, n, ms);
+}
+
+// 复制同一个指针 n 次
+template <class Ptr>
+void copy(const char* name, size_t n, const Ptr& src)
+{
+    long sum = 0;
+    const double ms = bench::time_ms([&]
+    {
+        for (size_t i = 0; i < n; ++i)
+        {
+            Ptr p(src);
+            bench::do_not_optimize(p);
+            sum += p->value[0];
+        }
+    });
+    bench::do_not_optimize(sum);
+    report(name, n, ms);
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    const size_t n = bench::arg_or(argc, argv, 1, 10000000);
+    std::thread([] {}).join();
+    std::printf("%zu operations each, payload %zu bytes\n", n, sizeof(payload));
+
+    create("std::make_unique", n, [](long v) { return std::make_unique<payload>(v); });
+    create("ctstl::make_unique", n, [](long v) { return ctstl::make_unique<payload>(v); });
+    create("std::shared_ptr(new T)", n, [](long v) { return std::shared_ptr<payload>(new payload(v)); });
+    create("ctstl::shared_ptr(new T)", n, [](long v) { return ctstl::shared_ptr<payload>(new payload(v)); });
+    create("std::make_shared", n, [](long v) { return std::make_shared<payload>(v); });
+    create("ctstl::make_shared", n, [](long v) { return ctstl::make_shared<payload>(v); });
+    create("ctstl::intrusive_ptr", n, [](long v) { return ctstl::intrusive_ptr<counted>(new counted(v)); });
+
+    copy("std::shared_ptr copy", n, std::make_shared<payload>(1));
+    copy("ctstl::shared_ptr copy", n, ctstl::make_shared<payload>(1));
+    copy("ctstl::intrusive_ptr copy", n, ctstl::intrusive_ptr<counted>(new counted(1)));
+
+    std::printf("sizeof: std::unique_ptr %zu, ctstl::unique_ptr %zu, std::shared_ptr %zu, ctstl::shared_ptr %zu\n",
+                sizeof(std::unique_ptr<payload>), sizeof(ctstl::unique_ptr<payload>),
+                sizeof(std::shared_ptr<payload>), sizeof(ctstl::shared_ptr<payload>));
+}
@@ -0,0 +1,113 @@
+// 生产者 / 消费者基准测试：节点在生产者线程分配，通过单生产者单消费者队列交给消费者线程释放
+// 对比 allocator（::operator new）、pool_allocator（全局加锁的内存池）与 thread_cache_allocator
+//
+// 编译：g++ -std=c++11 -O2 -pthread thread_cache_alloc_bench.cpp -o thread_cache_alloc_bench
+// 运行：./thread_cache_alloc_bench [生产者/消费者对数，缺省 4] [每个生产者分配的节点数，缺省 2000000]
+
+#include <atomic>
+#include <cstdio>
+#include <thread>
+#include <vector>
+
+#include "../CTSTL/allocator.h"
+#include "../CTSTL/alloc.h"
+#include "../CTSTL/thread_cache_alloc.h"
+#include "bench_util.h"
+
+namespace
+{
+
+struct node
+{
+    size_t payload[6];
+};
+
+// 单生产者单消费者的环形队列，满或空时让出 CPU
+class spsc_ring
+{
+public:
+    enum { ECapacity = 4096 };
+
+    spsc_ring() : head_(0), tail_(0) {}
+
+    void push(node* p)
+    {
+        const size_t t = tail_.load(std::memory_order_relaxed);
+        while (t - head_.load(std::memory_order_acquire) == ECapacity)
+            std::this_thread::yield();
+        slots_[t % ECapacity] = p;
+        tail_.store(t + 1, std::memory_order_release);
+    }
+
+    node* pop()
+    {
+        const size_t h = head_.load(std::memory_order_relaxed);
+        while (tail_.load(std::memory_order_acquire) == h)
+            std::this_thread::yield();
+        node* p = slots_[h % ECapacity];
+        head_.store(h + 1, std::memory_order_release);
+        return p;
+    }
+
+private:
+    node*               slots_[ECapacity];
+    alignas(64) std::atomic<size_t> head_;
+    alignas(64) std::atomic<size_t> tail_;
+};
+
+template <class Alloc>
+double run(size_t pairs, size_t count)
+{
+    std::vector<spsc_ring> rings(pairs);
+    std::vector<std::thread> threads;
+    return bench::time_ms([&]
+    {
+        for (size_t i = 0; i < pairs; ++i)
+        {
+            spsc_ring& ring = rings[i];
+            threads.emplace_back([&ring, count]
+            {
+                for (size_t k = 0; k < count; ++k)
+                {
+                    node* p = Alloc::allocate();
+                    p->payload[0] = k;
+                    ring.push(p);
+                }
+            });
+            threads.emplace_back([&ring, count]
+            {
+                size_t sum = 0;
+                for (size_t k = 0; k < count; ++k)
+                {
+                    node* p = ring.pop();
+                    sum += p->payload[0];
+                    Alloc::deallocate(p);
+                }
+                bench::do_not_optimize(sum);
+            });
+        }
+        for (auto& t : threads)
+            t.join();
+    });
+}
+
+template <class Alloc>
+void report(const char* name, size_t pairs, size_t count)
+{
+    const double ms = run<Alloc>(pairs, count);
+    const double ops = static_cast<double>(pairs * count);
+    std::printf("%-24s %10.1f ms %8.1f Mnodes/s\n", name, ms, ops / ms / 1000.0);
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    const size_t pairs = bench::arg_or(argc, argv, 1, 4);
+    const size_t count = bench::arg_or(argc, argv, 2, 2000000);
+    std::printf("%zu producer/consumer pairs, %zu nodes of %zu bytes per pair\n",
+                pairs, count, sizeof(node));
+    report<ctstl::allocator<node>>("allocator", pairs, count);
+    report<ctstl::pool_allocator<node>>("pool_allocator", pairs, count);
+    report<ctstl::thread_cache_allocator<node>>("thread_cache_allocator", pairs, count);
+}
@@ -0,0 +1,65 @@
+// flat_hash_table 在很小的最大负载因子下的行为
+// 容量 15、负载因子 0.05 时 growth_of(15) == 0，原来的实现会在原容量上反复重建，
+// growth_left_ 减到 0 以下回绕，第 16 次插入永远不会返回
+//
+// 编译：g++ -std=c++11 -O2 flat_hash_table_test.cpp -o flat_hash_table_test
+// 运行：./flat_hash_table_test，全部通过时输出 ok
+
+#include <cassert>
+#include <cstdio>
+
+#include "../CTSTL/flat_hash_map.h"
+
+namespace
+{
+
+// 先设置很小的负载因子再插入
+void tiny_load_factor_then_insert()
+{
+    ctstl::flat_hash_map<int, int> m(15);
+    m.max_load_factor(0.05f);
+    for (int i = 0; i < 40; ++i)
+        m[i] = i;
+    assert(m.size() == 40);
+    assert(m.load_factor() <= m.max_load_factor());
+    for (int i = 0; i < 40; ++i)
+        assert(m.at(i) == i);
+
+    // 留下墓碑后继续插入
+    for (int i = 0; i < 40; i += 2)
+        m.erase(i);
+    for (int i = 100; i < 200; ++i)
+        m[i] = i;
+    assert(m.size() == 120);
+}
+
+// 已有元素时调小负载因子，以及 rehash / reserve
+void tiny_load_factor_on_filled_table()
+{
+    ctstl::flat_hash_map<int, int> m(15);
+    for (int i = 0; i < 10; ++i)
+        m[i] = i;
+    m.max_load_factor(0.02f);
+    assert(m.load_factor() <= m.max_load_factor());
+    for (int i = 10; i < 20; ++i)
+        m[i] = i;
+    assert(m.size() == 20);
+
+    ctstl::flat_hash_map<int, int> e;
+    e.max_load_factor(0.01f);
+    e.rehash(3);
+    e.reserve(1);
+    for (int i = 0; i < 10; ++i)
+        e.emplace(i, i);
+    assert(e.size() == 10);
+    assert(e.load_factor() <= e.max_load_factor());
+}
+
+} // namespace
+
+int main()
+{
+    tiny_load_factor_then_insert();
+    tiny_load_factor_on_filled_table();
+    std::puts("ok");
+}